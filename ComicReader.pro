@@ -27,14 +27,18 @@ SOURCES += \
     src/ui/mainwindow/MainWindow.cpp \
     src/core/config/ConfigManager.cpp \
     src/core/utils/FileUtils.cpp \
-    src/core/parsers/ComicParser.cpp
+    src/core/parsers/ComicParser.cpp \
+    src/core/cache/MemoryGovernor.cpp \
+    src/core/cache/MemoryPressureMonitor.cpp
 
 # 头文件
 HEADERS += \
     include/ui/MainWindow.h \
     include/core/config/ConfigManager.h \
     include/core/utils/FileUtils.h \
-    include/core/parsers/ComicParser.h
+    include/core/parsers/ComicParser.h \
+    include/core/cache/MemoryGovernor.h \
+    include/core/cache/MemoryPressureMonitor.h
 
 # 资源文件（暂时注释掉）
 # RESOURCES += \
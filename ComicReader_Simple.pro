@@ -1,4 +1,4 @@
-QT += core widgets network
+QT += core widgets network gui-private
 
 CONFIG += c++17
 
@@ -26,22 +26,80 @@ SOURCES += \
     src/main.cpp \
     src/ui/mainwindow/MainWindow.cpp \
     src/ui/reader/ReaderWidget.cpp \
+    src/ui/reader/PagePipeline.cpp \
+    src/ui/reader/TiledPageView.cpp \
+    src/ui/reader/ContinuousPageView.cpp \
+    src/ui/reader/SpreadLayout.cpp \
+    src/ui/reader/AnimatedPagePlayer.cpp \
     src/ui/browser/BrowserWidget.cpp \
     src/ui/settings/SettingsWidget.cpp \
     src/core/network/NetworkManager.cpp \
     src/core/config/ConfigManager.cpp \
-    src/utils/FileUtils.cpp
+    src/core/parser/ComicParser.cpp \
+    src/core/cache/CacheManager.cpp \
+    src/core/cache/CacheCompressor.cpp \
+    src/core/cache/CacheEvictionPolicy.cpp \
+    src/core/cache/FrequencySketch.cpp \
+    src/core/cache/CacheStatistics.cpp \
+    src/core/cache/LatencyHistogram.cpp \
+    src/core/cache/MemoryPressureMonitor.cpp \
+    src/core/cache/TimerWheel.cpp \
+    src/core/cache/DiskCacheIndex.cpp \
+    src/core/cache/MurmurHash3.cpp \
+    src/core/cache/CacheKey.cpp \
+    src/core/cache/CacheWarmup.cpp \
+    src/core/bookmark/BookmarkManager.cpp \
+    src/core/cache/MemoryGovernor.cpp \
+    src/core/cache/MappedImageStore.cpp \
+    src/core/metrics/PageTurnMetrics.cpp \
+    src/core/image/AnimatedImageDecoder.cpp \
+    src/core/image/ContentBounds.cpp \
+    src/core/image/ImageDecoder.cpp \
+    src/core/image/ImagePyramid.cpp \
+    src/core/image/ImageScaler.cpp \
+    src/core/image/PanelDetector.cpp \
+    src/utils/FileUtils.cpp \
+    src/utils/error/ErrorHandler.cpp
 
 # 头文件
 HEADERS += \
     include/ui/MainWindow.h \
     include/ui/ReaderWidget.h \
+    include/ui/reader/PagePipeline.h \
+    include/ui/reader/TiledPageView.h \
+    include/ui/reader/ContinuousPageView.h \
+    include/ui/reader/SpreadLayout.h \
+    include/ui/reader/AnimatedPagePlayer.h \
     include/ui/BrowserWidget.h \
     include/ui/DownloadManagerWidget.h \
     include/ui/SettingsWidget.h \
     include/core/NetworkManager.h \
-    include/core/ConfigManager.h \
-    include/utils/FileUtils.h
+    include/core/config/ConfigManager.h \
+    include/core/ComicParser.h \
+    include/core/CacheManager.h \
+    include/core/cache/CacheCompressor.h \
+    include/core/cache/CacheEvictionPolicy.h \
+    include/core/cache/FrequencySketch.h \
+    include/core/cache/CacheStatistics.h \
+    include/core/cache/LatencyHistogram.h \
+    include/core/cache/MemoryPressureMonitor.h \
+    include/core/cache/TimerWheel.h \
+    include/core/cache/DiskCacheIndex.h \
+    include/core/cache/MurmurHash3.h \
+    include/core/cache/CacheKey.h \
+    include/core/cache/CacheWarmup.h \
+    include/core/bookmark/BookmarkManager.h \
+    include/core/cache/MemoryGovernor.h \
+    include/core/cache/MappedImageStore.h \
+    include/core/metrics/PageTurnMetrics.h \
+    include/core/image/AnimatedImageDecoder.h \
+    include/core/image/ContentBounds.h \
+    include/core/image/ImageDecoder.h \
+    include/core/image/ImagePyramid.h \
+    include/core/image/ImageScaler.h \
+    include/core/image/PanelDetector.h \
+    include/utils/FileUtils.h \
+    include/utils/error/ErrorHandler.h
 
 # 资源文件
 RESOURCES += resources/resources.qrc
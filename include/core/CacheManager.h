@@ -3,10 +3,24 @@
 
 #include <QObject>
 #include <QPixmap>
+#include <QImage>
 #include <QHash>
+#include <QVector>
 #include <QMutex>
 #include <QTimer>
 #include <QDir>
+#include <QSet>
+#include <QElapsedTimer>
+#include "core/cache/CacheStatistics.h"
+#include "core/cache/MemoryPressureMonitor.h"
+#include "core/cache/TimerWheel.h"
+#include "core/cache/CacheKey.h"
+
+class CacheEvictionPolicy;
+class DiskCacheIndex;
+class MappedImageStore;
+class QThread;
+class QFile;
 
 /**
  * @brief 缓存管理器
@@ -17,26 +31,75 @@ class CacheManager : public QObject
     Q_OBJECT
 
 public:
+    /**
+     * @brief 磁盘缓存内容类型
+     * 决定磁盘条目是否压缩：已压缩的图片原样存储，像素缓冲和元数据压缩存储
+     */
+    enum DiskContentType {
+        AutoDetect,      // 根据数据头自动判断
+        EncodedImage,    // 已编码图片（JPEG/PNG/WebP等），原样存储
+        DecodedPixels,   // 解码后的像素缓冲，压缩存储
+        Metadata         // 元数据等文本/二进制块，压缩存储
+    };
+
+    /**
+     * @brief 内存缓存淘汰策略
+     */
+    enum EvictionPolicy {
+        LruPolicy,       // 最近最少使用
+        TinyLfuPolicy    // W-TinyLFU，按访问频率准入，抵抗一次性扫描
+    };
+
     static CacheManager* instance();
     
     // 图片缓存
-    void cachePixmap(const QString &key, const QPixmap &pixmap);
+    // ttlSeconds <= 0 时使用默认保留时间
+    void cachePixmap(const QString &key, const QPixmap &pixmap, int ttlSeconds = -1);
     QPixmap getCachedPixmap(const QString &key) const;
     bool hasPixmap(const QString &key) const;
     void removeCachedPixmap(const QString &key);
     
     // 数据缓存
-    void cacheData(const QString &key, const QByteArray &data);
+    void cacheData(const QString &key, const QByteArray &data, int ttlSeconds = -1);
     QByteArray getCachedData(const QString &key) const;
     bool hasData(const QString &key) const;
     void removeCachedData(const QString &key);
     
     // 磁盘缓存
-    void saveToDisk(const QString &key, const QByteArray &data);
+    void saveToDisk(const QString &key, const QByteArray &data, DiskContentType type = AutoDetect, int ttlSeconds = -1);
     QByteArray loadFromDisk(const QString &key) const;
     bool existsOnDisk(const QString &key) const;
     void removeFromDisk(const QString &key);
     
+    // 解码图片的磁盘缓存（像素缓冲压缩后存储）
+    void saveImageToDisk(const QString &key, const QImage &image);
+    QImage loadImageFromDisk(const QString &key) const;
+    
+    // 结构化缓存键：键中包含归档指纹，归档变化后旧条目自动失效
+    void cachePixmap(const CacheKey &key, const QPixmap &pixmap, int ttlSeconds = -1);
+    QPixmap getCachedPixmap(const CacheKey &key);
+    void cacheData(const CacheKey &key, const QByteArray &data, int ttlSeconds = -1);
+    QByteArray getCachedData(const CacheKey &key);
+    void saveToDisk(const CacheKey &key, const QByteArray &data, DiskContentType type = AutoDetect, int ttlSeconds = -1);
+    QByteArray loadFromDisk(const CacheKey &key);
+    bool existsOnDisk(const CacheKey &key) const;
+    void saveImageToDisk(const CacheKey &key, const QImage &image);
+    QImage loadImageFromDisk(const CacheKey &key);
+    
+    // 映射到文件的解码图片：返回的图片直接引用映射内存，内存紧张时由内核回收，其他进程可复用
+    QImage cacheDecodedImage(const CacheKey &key, const QImage &image);
+    QImage getDecodedImage(const CacheKey &key);
+    void setMappedImageStoreEnabled(bool enabled);
+    bool isMappedImageStoreEnabled() const;
+    MappedImageStore *mappedImageStore() const;
+    
+    // 移除某个归档的全部结构化缓存条目
+    void invalidateArchive(const QString &archivePath);
+    
+    // 磁盘缓存压缩
+    void setCompressionEnabled(bool enabled);
+    bool isCompressionEnabled() const;
+    
     // 缓存管理
     void clearMemoryCache();
     void clearDiskCache();
@@ -45,55 +108,132 @@ public:
     // 缓存统计
     int getMemoryCacheSize() const;
     qint64 getDiskCacheSize() const;
+    bool isDiskUsagePending() const;    // 磁盘索引尚在建立，getDiskCacheSize() 偏小
     int getPixmapCacheCount() const;
     int getDataCacheCount() const;
+    CacheStatistics getStatistics() const;
+    bool exportStatistics(const QString &filePath) const;
+    void resetStatistics();
     
     // 设置缓存限制
     void setMaxMemoryCacheSize(int sizeMB);
     void setMaxDiskCacheSize(qint64 sizeMB);
     void setCacheDirectory(const QString &path);
     
-    // 缓存清理
+    // 内存缓存淘汰策略
+    void setEvictionPolicy(EvictionPolicy policy);
+    EvictionPolicy evictionPolicy() const;
+    
+    // 内存压力自适应：压力下先缩减解码图片，再缩减整体内存缓存
+    void setAdaptToMemoryPressure(bool enabled);
+    bool isAdaptingToMemoryPressure() const;
+    void applyMemoryPressure(MemoryPressureMonitor::PressureLevel level);
+    int memoryPressureStep() const;
+    MemoryPressureMonitor *memoryPressureMonitor() const;
+    
+    // 缓存清理（到期由时间轮管理，只处理真正到期的条目）
     void cleanupExpiredCache();
     void setAutoCleanupInterval(int minutes);
+    void setMemoryEntryTtl(int seconds);
+    int memoryEntryTtl() const;
+    void setDiskCacheMaxAge(int days);
+    int diskCacheMaxAge() const;
+    DiskCacheIndex *diskIndex() const;
 
 signals:
     void cacheCleared();
     void cacheSizeLimitReached();
+    void memoryPressureStepChanged(int step);
 
 private slots:
     void onCleanupTimer();
+    void onMemorySampled(const MemorySample &sample, MemoryPressureMonitor::PressureLevel level);
 
 private:
     explicit CacheManager(QObject *parent = nullptr);
     ~CacheManager();
     
     void ensureCacheDirectory();
-    void cleanupOldFiles();
     void enforceMemoryLimit();
+    void enforcePressureLimitsLocked();
+    qint64 memoryLimitLocked() const;
+    qint64 decodedLimitLocked() const;
+    void applyEvictions(const QStringList &evictedKeys);
+    qint64 reclaimMemory(qint64 bytes);
+    void removeEntryLocked(const QString &policyKey, bool evicted = false);
+    void releasePixmapLocked(QPixmap &pixmap);
+    void releaseEvictedPixmaps();
+    void recordTrace(char op, const QString &policyKey, qint64 bytes) const;
+    static CacheEvictionPolicy *createPolicy(EvictionPolicy policy);
+    static qint64 pixmapCost(const QPixmap &pixmap);
     void enforceDiskLimit();
     QString generateCacheFileName(const QString &key) const;
+    QString generateCacheFileName(const CacheKey &key) const;
+    void checkArchiveFingerprint(const CacheKey &key);
+    void writeDiskFile(const QString &fileName, const QByteArray &data, DiskContentType type, int ttlSeconds);
+    QByteArray readDiskFile(const QString &fileName) const;
+    void removeDiskFile(const QString &fileName);
+    static QByteArray encodeImage(const QImage &image);
+    static QImage decodeImage(const QByteArray &buffer, const QString &key);
+    QByteArray encodeDiskEntry(const QByteArray &data, DiskContentType type) const;
+    static QByteArray decodeDiskEntry(const QByteArray &entry);
     
     static CacheManager *m_instance;
     
-    // 内存缓存
-    mutable QMutex m_pixmapCacheMutex;
-    mutable QMutex m_dataCacheMutex;
+    // 内存缓存（图片和数据共用一个锁和一个淘汰策略）
+    mutable QMutex m_memoryCacheMutex;
     QHash<QString, QPixmap> m_pixmapCache;
+    QVector<QPixmap> m_pixmapsToRelease;        // 在其他线程淘汰、等待GUI线程释放的图片
     QHash<QString, QByteArray> m_dataCache;
-    QHash<QString, qint64> m_cacheTimestamps;
+    TimerWheel m_memoryExpiry;                  // 以策略键为键
+    qint64 m_memoryTtlMs;
+    EvictionPolicy m_evictionPolicyType;
+    CacheEvictionPolicy *m_evictionPolicy;
+    
+    // 访问轨迹记录（设置 COMICREADER_CACHE_TRACE 环境变量时启用）
+    QFile *m_traceFile;
+    
+    // 统计
+    mutable CacheTierCounters m_memoryCounters;
+    mutable CacheTierCounters m_diskCounters;
+    mutable LatencyHistogram m_diskReadLatency;
+    mutable LatencyHistogram m_diskWriteLatency;
+    mutable QSet<QString> m_unusedEntries;      // 插入后尚未命中的策略键
+    QElapsedTimer m_statisticsTimer;
     
     // 缓存设置
     int m_maxMemoryCacheSize;      // MB
     qint64 m_maxDiskCacheSize;     // MB
     QString m_cacheDirectory;
+    bool m_compressionEnabled;
     
-    // 清理定时器
+    // 清理定时器（内存条目到期）
     QTimer *m_cleanupTimer;
-    int m_autoCleanupInterval;     // minutes
+    int m_autoCleanupInterval;     // minutes，磁盘到期检查间隔
+    
+    // 磁盘索引，运行在I/O线程
+    QThread *m_ioThread;
+    DiskCacheIndex *m_diskIndex;
+    int m_diskMaxAgeDays;
+    
+    // 最近见过的归档指纹（以归档路径哈希为键），指纹变化时使旧条目失效
+    QMutex m_fingerprintMutex;
+    QHash<quint64, ArchiveFingerprint> m_archiveFingerprints;
+    
+    // 映射到文件的解码图片
+    MappedImageStore *m_mappedImages;
+    bool m_mappedImagesEnabled;
+    
+    // 内存压力
+    MemoryPressureMonitor *m_pressureMonitor;
+    bool m_adaptToMemoryPressure;
+    int m_pressureStep;             // 0 为不缩减
+    int m_relaxedSamples;           // 连续无压力的采样次数
+    int m_governorId;               // MemoryGovernor 注册号
     
-    // 当前缓存大小（估算）
-    mutable int m_currentMemorySize;
+    // 当前缓存大小（估算，字节）
+    qint64 m_currentMemorySize;
+    qint64 m_decodedMemorySize;     // 其中解码图片占用的部分
 };
 
 #endif // CACHEMANAGER_H
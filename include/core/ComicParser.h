@@ -13,6 +13,9 @@ class QZipReader;
 /**
  * @brief 漫画文件解析器
  * 支持解析 CBZ, CBR, ZIP, RAR 格式的漫画文件
+ * 解析器本身不缓存页面数据，每次 getPageData() 都从归档读取；阅读器、预热和书库
+ * 读出的页面都放在 CacheManager 中，由它计入 MemoryGovernor 的全局预算，
+ * 因此这里不向 MemoryGovernor 注册。
  */
 class ComicParser : public QObject
 {
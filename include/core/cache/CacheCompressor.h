@@ -0,0 +1,34 @@
+#ifndef CACHECOMPRESSOR_H
+#define CACHECOMPRESSOR_H
+
+#include <QByteArray>
+
+/**
+ * @brief 缓存压缩器
+ * 为磁盘缓存提供快速的LZ4块格式压缩，只依赖Qt，不引入第三方库。
+ * 已经压缩过的图片（JPEG/PNG/WebP/GIF）不值得再压缩，由 isAlreadyCompressed() 识别。
+ */
+class CacheCompressor
+{
+public:
+    // 压缩数据，失败或没有收益时返回空数组
+    static QByteArray compress(const QByteArray &data);
+
+    // 解压数据，originalSize 为压缩前的大小，数据损坏时返回空数组
+    static QByteArray decompress(const QByteArray &data, int originalSize);
+
+    // 压缩后数据的最大可能大小
+    static int compressBound(int inputSize);
+
+    // 根据文件头判断是否为已压缩的图片格式
+    static bool isAlreadyCompressed(const QByteArray &data);
+
+    // 原始缓冲区接口，返回写入的字节数（失败返回0或-1）
+    static int compressBlock(const char *src, int srcSize, char *dst, int dstCapacity);
+    static int decompressBlock(const char *src, int srcSize, char *dst, int dstCapacity);
+
+private:
+    CacheCompressor() = delete;
+};
+
+#endif // CACHECOMPRESSOR_H
@@ -0,0 +1,143 @@
+#ifndef CACHEEVICTIONPOLICY_H
+#define CACHEEVICTIONPOLICY_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <list>
+#include <functional>
+#include "core/cache/FrequencySketch.h"
+
+/**
+ * @brief 内存缓存淘汰策略接口
+ * 策略只管理键和权重（字节数），真正的数据由 CacheManager 持有。
+ * insert() 返回需要淘汰的键，其中可能包含刚插入的键（表示拒绝准入）。
+ */
+class CacheEvictionPolicy
+{
+public:
+    typedef std::function<bool(const QString &)> KeyFilter;
+
+    virtual ~CacheEvictionPolicy() {}
+
+    virtual QString name() const = 0;
+
+    // 容量（字节）
+    void setCapacity(qint64 bytes) { m_capacity = qMax<qint64>(0, bytes); }
+    qint64 capacity() const { return m_capacity; }
+    qint64 weightedSize() const { return m_weightedSize; }
+
+    // 记录一次查找（命中和未命中都要记录，用于频率统计）
+    virtual void recordAccess(const QString &key) = 0;
+
+    // 插入或更新条目，返回被淘汰的键
+    virtual QStringList insert(const QString &key, qint64 weight) = 0;
+
+    // 移除条目
+    virtual void remove(const QString &key) = 0;
+
+    // 淘汰条目直到总大小不超过容量（容量缩小后调用）
+    virtual QStringList evictToCapacity() = 0;
+
+    // 按淘汰顺序淘汰满足条件的条目，直到释放至少 bytes 字节（内存压力下使用）
+    virtual QStringList evictMatching(qint64 bytes, const KeyFilter &filter) = 0;
+
+    virtual bool contains(const QString &key) const = 0;
+    virtual void clear() = 0;
+
+protected:
+    CacheEvictionPolicy() : m_capacity(0), m_weightedSize(0) {}
+
+    qint64 m_capacity;
+    qint64 m_weightedSize;
+};
+
+/**
+ * @brief LRU淘汰策略
+ * refreshOnAccess 为 false 时退化为按插入时间淘汰，与旧版 CacheManager 的行为一致。
+ */
+class LruEvictionPolicy : public CacheEvictionPolicy
+{
+public:
+    explicit LruEvictionPolicy(bool refreshOnAccess = true);
+
+    QString name() const override;
+    void recordAccess(const QString &key) override;
+    QStringList insert(const QString &key, qint64 weight) override;
+    void remove(const QString &key) override;
+    QStringList evictToCapacity() override;
+    QStringList evictMatching(qint64 bytes, const KeyFilter &filter) override;
+    bool contains(const QString &key) const override;
+    void clear() override;
+
+private:
+    struct Node {
+        std::list<QString>::iterator position;
+        qint64 weight;
+    };
+
+    bool m_refreshOnAccess;
+    std::list<QString> m_order;     // 头部为最近使用
+    QHash<QString, Node> m_nodes;
+};
+
+/**
+ * @brief W-TinyLFU淘汰策略
+ * 新条目先进入窗口LRU；窗口溢出的条目作为候选者，与主区试用段的淘汰者比较
+ * 估计频率，只有更“热”的候选者才能进入主区。主区分为试用段和保护段（SLRU），
+ * 一次性的扫描（如整库缩略图重建）只会在窗口和试用段中流动，不会冲掉保护段。
+ */
+class TinyLfuEvictionPolicy : public CacheEvictionPolicy
+{
+public:
+    explicit TinyLfuEvictionPolicy(int windowPercent = 20);
+
+    QString name() const override;
+    void recordAccess(const QString &key) override;
+    QStringList insert(const QString &key, qint64 weight) override;
+    void remove(const QString &key) override;
+    QStringList evictToCapacity() override;
+    QStringList evictMatching(qint64 bytes, const KeyFilter &filter) override;
+    bool contains(const QString &key) const override;
+    void clear() override;
+
+    int frequency(const QString &key) const;
+
+private:
+    enum Segment {
+        Window,
+        Probation,
+        Protected
+    };
+
+    struct Node {
+        std::list<QString>::iterator position;
+        qint64 weight;
+        Segment segment;
+    };
+
+    std::list<QString> &listFor(Segment segment);
+    void moveToFront(const QString &key, Node &node, Segment segment);
+    void detach(const QString &key, Node &node);
+    qint64 windowCapacity() const;
+    qint64 protectedCapacity() const;
+    void demoteProtectedOverflow();
+    void evictFromWindow();
+    void evictFromMain(QStringList &evicted);
+    void evictKey(const QString &key, QStringList &evicted);
+
+    int m_windowPercent;
+    FrequencySketch m_sketch;
+
+    std::list<QString> m_window;
+    std::list<QString> m_probation;
+    std::list<QString> m_protected;
+    QHash<QString, Node> m_nodes;
+    QStringList m_candidates;       // 本轮从窗口进入试用段的候选者
+    int m_sketchEntries;
+
+    qint64 m_windowSize;
+    qint64 m_protectedSize;
+};
+
+#endif // CACHEEVICTIONPOLICY_H
@@ -0,0 +1,82 @@
+#ifndef CACHEKEY_H
+#define CACHEKEY_H
+
+#include <QString>
+#include "core/cache/MurmurHash3.h"
+
+/**
+ * @brief 归档文件指纹
+ * 由文件大小、修改时间和inode（Windows上为文件索引）组成。
+ * 归档被替换或修改后指纹改变，以它为基础的缓存键随之失效。
+ */
+struct ArchiveFingerprint
+{
+    qint64 size = -1;
+    qint64 modifiedMs = 0;
+    quint64 inode = 0;
+
+    bool isValid() const { return size >= 0; }
+
+    // 读取文件当前的指纹，文件不存在时返回无效指纹
+    static ArchiveFingerprint fromFile(const QString &filePath);
+
+    bool operator==(const ArchiveFingerprint &other) const
+    {
+        return size == other.size && modifiedMs == other.modifiedMs && inode == other.inode;
+    }
+    bool operator!=(const ArchiveFingerprint &other) const { return !(*this == other); }
+};
+
+/**
+ * @brief 结构化缓存键
+ * 归档路径 + 归档指纹 + 条目序号 + 变体（缩略图尺寸、缩放比例等）。
+ * 键在构造时计算一次128位哈希，之后查找和生成文件名都不再重新哈希。
+ * 文件名以归档路径的哈希开头，同一归档的条目可以按前缀整体失效。
+ */
+class CacheKey
+{
+public:
+    CacheKey();
+    CacheKey(const QString &archivePath, const ArchiveFingerprint &fingerprint,
+             int entryIndex, const QString &variant = QString());
+
+    // 便捷构造：读取归档的当前指纹（每次调用都会stat文件，批量使用时应先取指纹）
+    static CacheKey forArchiveEntry(const QString &archivePath, int entryIndex,
+                                    const QString &variant = QString());
+
+    bool isValid() const;
+
+    QString archivePath() const { return m_archivePath; }
+    ArchiveFingerprint fingerprint() const { return m_fingerprint; }
+    int entryIndex() const { return m_entryIndex; }
+    QString variant() const { return m_variant; }
+
+    // 归档路径的哈希（与指纹无关，用于按归档失效）
+    quint64 archiveId() const { return m_archiveId; }
+    QString archivePrefix() const;
+    static QString archivePrefix(const QString &archivePath);
+
+    // 包含指纹的完整键哈希
+    Hash128 hash() const { return m_hash; }
+
+    // 内存缓存使用的字符串键，形如 "a:<归档哈希>:<键哈希>"
+    QString toString() const;
+
+    // 磁盘缓存文件名（不含分片目录）
+    QString fileName() const;
+
+    bool operator==(const CacheKey &other) const;
+    bool operator!=(const CacheKey &other) const { return !(*this == other); }
+
+private:
+    static quint64 hashArchivePath(const QString &archivePath);
+
+    QString m_archivePath;
+    ArchiveFingerprint m_fingerprint;
+    int m_entryIndex;
+    QString m_variant;
+    quint64 m_archiveId;
+    Hash128 m_hash;
+};
+
+#endif // CACHEKEY_H
@@ -0,0 +1,85 @@
+#ifndef CACHESTATISTICS_H
+#define CACHESTATISTICS_H
+
+#include <QtGlobal>
+#include <QAtomicInteger>
+#include <QJsonObject>
+#include <QString>
+#include "core/cache/LatencyHistogram.h"
+
+/**
+ * @brief 单个缓存层的计数器快照
+ * bytesIn 为写入该层的字节数，bytesOut 为命中时从该层读出的字节数。
+ */
+struct CacheTierStatistics {
+    qint64 hits = 0;
+    qint64 misses = 0;
+    qint64 insertions = 0;
+    qint64 evictions = 0;
+    qint64 unusedEvictions = 0;     // 插入后从未命中就被淘汰（如无效的预加载）
+    qint64 bytesIn = 0;
+    qint64 bytesOut = 0;
+
+    double hitRatio() const;
+    QJsonObject toJson() const;
+};
+
+/**
+ * @brief 单个缓存层的计数器
+ * 所有操作都是原子的，磁盘读写可以在任意线程记录。
+ */
+class CacheTierCounters
+{
+public:
+    CacheTierCounters();
+
+    void recordHit(qint64 bytes);
+    void recordMiss();
+    void recordInsertion(qint64 bytes);
+    void recordEviction(bool unused = false);
+
+    void reset();
+    CacheTierStatistics snapshot() const;
+
+private:
+    QAtomicInteger<qint64> m_hits;
+    QAtomicInteger<qint64> m_misses;
+    QAtomicInteger<qint64> m_insertions;
+    QAtomicInteger<qint64> m_evictions;
+    QAtomicInteger<qint64> m_unusedEvictions;
+    QAtomicInteger<qint64> m_bytesIn;
+    QAtomicInteger<qint64> m_bytesOut;
+};
+
+/**
+ * @brief 缓存统计快照
+ * 由 CacheManager::getStatistics() 生成，可导出为JSON。
+ */
+struct CacheStatistics {
+    // 汇总
+    int memoryCacheCount = 0;
+    qint64 memoryCacheSize = 0;     // 字节
+    qint64 memoryCacheLimit = 0;    // 字节（内存压力下为缩减后的值）
+    qint64 decodedCacheSize = 0;    // 解码图片占用，字节
+    int memoryPressureStep = 0;     // 0 为不缩减
+    int diskCacheCount = 0;
+    qint64 diskCacheSize = 0;       // 字节
+    bool diskUsagePending = false;  // 磁盘索引尚在建立，磁盘条目数和大小不完整
+    qint64 hitCount = 0;            // 内存层和磁盘层命中之和
+    qint64 missCount = 0;           // 内存层和磁盘层未命中之和
+    QString evictionPolicy;
+
+    // 分层计数
+    CacheTierStatistics memory;
+    CacheTierStatistics disk;
+
+    // 磁盘读写延迟（包括编解码）
+    LatencyHistogram::Snapshot diskReadLatency;
+    LatencyHistogram::Snapshot diskWriteLatency;
+
+    qint64 uptimeMs = 0;            // 统计开始（或上次重置）以来的时间
+
+    QJsonObject toJson() const;
+};
+
+#endif // CACHESTATISTICS_H
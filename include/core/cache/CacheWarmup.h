@@ -0,0 +1,76 @@
+#ifndef CACHEWARMUP_H
+#define CACHEWARMUP_H
+
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QImage>
+#include <QAtomicInt>
+#include "core/cache/CacheKey.h"
+
+class QThread;
+struct ReadingProgress;
+
+/**
+ * @brief 预热目标：一本漫画及其上次阅读到的页面（从0开始）
+ */
+struct WarmupTarget
+{
+    QString comicPath;
+    int page = 0;
+};
+
+/**
+ * @brief 启动缓存预热
+ * 启动后在低优先级线程中打开最近阅读的漫画，把上次阅读的页面及其前后几页
+ * 的原始数据放入 CacheManager（内存和磁盘），第一本漫画的当前页还会解码成图片
+ * 压缩写入磁盘缓存（重启后也不必重新解码），使"继续阅读"无需等待解码。
+ * 用户打开其他漫画时调用 cancel()，当前页处理完即停止。
+ */
+class CacheWarmup : public QObject
+{
+    Q_OBJECT
+
+public:
+    static CacheWarmup* instance();
+
+    // 从最近文件和阅读进度中选出预热目标（按最近阅读排序，跳过已读完的漫画）
+    static QList<WarmupTarget> collectTargets(const QStringList &recentFiles,
+                                              const QList<ReadingProgress> &recentProgress,
+                                              int maxComics);
+
+    // 结构化缓存键的变体名
+    static QString rawPageVariant();
+    static QString pageVariant();
+
+    void start(int maxComics = 3);
+    void start(const QList<WarmupTarget> &targets);
+    void cancel();
+    bool isRunning() const;
+
+    // 预热当前页之前/之后的页数
+    void setNeighbourRange(int before, int after);
+
+signals:
+    void pageWarmed(const QString &comicPath, int page);
+    void finished(int pagesWarmed);
+    void cancelled();
+
+private:
+    explicit CacheWarmup(QObject *parent = nullptr);
+    ~CacheWarmup();
+
+    void run(const QList<WarmupTarget> &targets);
+    bool warmComic(const WarmupTarget &target, bool decodeCurrentPage);
+    void storeDecodedPage(const CacheKey &key, const QImage &image);
+
+    static CacheWarmup *m_instance;
+
+    QThread *m_thread;
+    QAtomicInt m_cancelled;
+    QAtomicInt m_pagesWarmed;
+    int m_pagesBefore;
+    int m_pagesAfter;
+};
+
+#endif // CACHEWARMUP_H
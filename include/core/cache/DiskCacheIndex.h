@@ -0,0 +1,85 @@
+#ifndef DISKCACHEINDEX_H
+#define DISKCACHEINDEX_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QMutex>
+#include <QTimer>
+#include <list>
+#include "core/cache/TimerWheel.h"
+
+/**
+ * @brief 磁盘缓存索引
+ * 在内存中记录磁盘缓存目录（含分片子目录）中每个文件的大小、写入顺序和到期时间，
+ * 统计大小、按写入顺序淘汰、到期清理都不再需要遍历目录。
+ * 对象运行在 CacheManager 的I/O线程上：目录扫描和到期清理在该线程执行，
+ * recordWrite() 等记录接口加锁后可以从任意线程调用。
+ */
+class DiskCacheIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DiskCacheIndex(QObject *parent = nullptr);
+
+    // 记录接口（线程安全）
+    void recordWrite(const QString &fileName, qint64 size, qint64 ttlMs = -1);
+    void recordRemove(const QString &fileName);
+    void clear();
+
+    // 取出最早写入的文件，直到累计至少 bytesToFree 字节；返回的文件已从索引中移除，
+    // 由调用方交给 removeFiles() 删除
+    QStringList takeOldest(qint64 bytesToFree);
+
+    // 取出文件名（不含分片目录）以 baseNamePrefix 开头的全部文件，由调用方交给 removeFiles() 删除
+    QStringList takeMatching(const QString &baseNamePrefix);
+
+    bool isReady() const;
+    bool contains(const QString &fileName) const;
+    qint64 totalSize() const;
+    int count() const;
+
+    // 修改默认保留时间；未指定TTL的已有条目按写入时间重新计算到期时间
+    void setDefaultTtl(qint64 ttlMs);
+    qint64 defaultTtl() const;
+
+public slots:
+    // 以下在I/O线程执行
+    void rebuild(const QString &directory);
+    void startExpiryTimer(int intervalMs);
+    void stopExpiryTimer();
+    void expireNow();
+    void removeFiles(const QStringList &fileNames);
+
+signals:
+    void rebuilt(int count, qint64 totalSize);
+    void entriesExpired(int count, qint64 bytes);
+
+private:
+    struct Entry {
+        qint64 size;
+        qint64 writtenMs;
+        qint64 ttlMs;       // <= 0 表示使用默认保留时间
+        std::list<QString>::iterator order;
+    };
+
+    void insertLocked(const QString &fileName, qint64 size, qint64 writtenMs, qint64 ttlMs);
+    void removeLocked(const QString &fileName);
+    // 删除 fileNames 中当前不在索引里的文件，返回删除的个数（I/O线程）
+    int removeUnindexedFiles(const QString &directory, const QStringList &fileNames);
+
+    mutable QMutex m_mutex;
+    QString m_directory;
+    QHash<QString, Entry> m_entries;
+    std::list<QString> m_writeOrder;    // 头部为最早写入
+    TimerWheel m_expiry;
+    qint64 m_totalSize;
+    qint64 m_defaultTtlMs;
+    bool m_ready;
+
+    QTimer *m_expiryTimer;
+};
+
+#endif // DISKCACHEINDEX_H
@@ -0,0 +1,44 @@
+#ifndef FREQUENCYSKETCH_H
+#define FREQUENCYSKETCH_H
+
+#include <QtGlobal>
+#include <QString>
+#include <vector>
+
+/**
+ * @brief 访问频率估计器
+ * 4位计数器的Count-Min Sketch，为TinyLFU准入策略估计条目的近期访问频率。
+ * 计数次数达到采样上限后所有计数器减半，使旧的热点逐渐冷却。
+ */
+class FrequencySketch
+{
+public:
+    explicit FrequencySketch(int expectedEntries = 1024);
+
+    // 根据预计条目数调整表大小（已有统计随之迁移，扩大时估计频率不变）
+    void ensureCapacity(int expectedEntries);
+
+    // 估计频率（0-15）
+    int frequency(const QString &key) const;
+    int frequency(quint64 hash) const;
+
+    // 记录一次访问
+    void increment(const QString &key);
+    void increment(quint64 hash);
+
+    void clear();
+
+    static quint64 hashKey(const QString &key);
+
+private:
+    int counterIndex(quint64 hash, int row) const;
+    int counterValue(int index) const;
+    void reset();
+
+    std::vector<quint64> m_table;   // 每个字包含16个4位计数器
+    quint64 m_counterMask;
+    int m_sampleSize;
+    int m_additions;
+};
+
+#endif // FREQUENCYSKETCH_H
@@ -0,0 +1,53 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <QtGlobal>
+#include <QAtomicInteger>
+#include <QJsonObject>
+#include <QVector>
+
+/**
+ * @brief 延迟直方图
+ * 以微秒为单位的对数分桶：桶0为小于1微秒，桶i为 [2^(i-1), 2^i) 微秒。
+ * 记录操作只做原子加法，可以在任意线程调用。
+ */
+class LatencyHistogram
+{
+public:
+    static const int BUCKET_COUNT = 32;
+
+    /**
+     * @brief 直方图某一时刻的副本
+     */
+    struct Snapshot {
+        qint64 count = 0;
+        qint64 totalNs = 0;
+        qint64 maxNs = 0;
+        QVector<qint64> buckets;
+
+        double meanMicros() const;
+        // 估算百分位（0-100），返回微秒，桶内线性插值
+        double percentileMicros(double percentile) const;
+        QJsonObject toJson() const;
+        // 累加另一个快照（合并多个直方图）
+        void merge(const Snapshot &other);
+    };
+
+    LatencyHistogram();
+
+    void record(qint64 nanoseconds);
+    void reset();
+    Snapshot snapshot() const;
+
+    // 桶的上界（微秒）
+    static qint64 bucketUpperBoundMicros(int bucket);
+
+private:
+    static int bucketFor(qint64 nanoseconds);
+
+    QAtomicInteger<qint64> m_buckets[BUCKET_COUNT];
+    QAtomicInteger<qint64> m_totalNs;
+    QAtomicInteger<qint64> m_maxNs;
+};
+
+#endif // LATENCYHISTOGRAM_H
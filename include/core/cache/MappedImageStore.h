@@ -0,0 +1,60 @@
+#ifndef MAPPEDIMAGESTORE_H
+#define MAPPEDIMAGESTORE_H
+
+#include <QString>
+#include <QImage>
+#include <QAtomicInteger>
+#include "core/cache/DiskCacheIndex.h"
+
+/**
+ * @brief 基于文件映射的解码图片存储
+ * 解码后的像素写入缓存目录（默认为运行时目录，Linux上通常是tmpfs）中的文件，
+ * 读取时以 MAP_SHARED 只读映射，返回的 QImage 直接引用映射内存，不做拷贝。
+ * 这些页面由文件支撑，内存紧张时内核可以直接丢弃而不是换出到交换区；
+ * 共享同一目录的其他阅读器进程也能直接复用已解码的像素。
+ *
+ * 文件先写入临时文件再原子重命名，已有文件不会被原地截断，映射期间读取是安全的。
+ * 文件在目录中的大小和使用顺序由 DiskCacheIndex 记录，超出上限时先删除最久未用的文件
+ * （已映射的图片在解除映射前仍然有效）。
+ * 接口可以从任意线程调用。
+ */
+class MappedImageStore
+{
+public:
+    // directory 为空时使用 defaultDirectory()
+    explicit MappedImageStore(const QString &directory = QString(), qint64 maxSizeBytes = DEFAULT_MAX_SIZE);
+
+    static QString defaultDirectory();
+    QString directory() const { return m_directory; }
+
+    // 写入解码图片，返回引用映射内存的图片；映射失败时返回原图
+    QImage insert(const QString &fileName, const QImage &image);
+
+    // 映射已有的解码图片，不存在或格式不符时返回空图片
+    QImage find(const QString &fileName);
+
+    bool contains(const QString &fileName) const;
+    void remove(const QString &fileName);
+    void removeMatching(const QString &fileNamePrefix);
+    void clear();
+
+    void setMaxSize(qint64 bytes);
+    qint64 maxSize() const;
+    qint64 totalSize() const;
+    int count() const;
+
+    static const qint64 DEFAULT_MAX_SIZE = 256LL * 1024 * 1024;
+
+private:
+    MappedImageStore(const MappedImageStore &) = delete;
+    MappedImageStore &operator=(const MappedImageStore &) = delete;
+
+    static QImage mapImage(const QString &filePath, qint64 *fileSize);
+    void enforceLimit();
+
+    QString m_directory;
+    DiskCacheIndex m_index;         // 不移动到其他线程，只使用其加锁的记录接口
+    QAtomicInteger<qint64> m_maxSize;
+};
+
+#endif // MAPPEDIMAGESTORE_H
@@ -0,0 +1,102 @@
+#ifndef MEMORYGOVERNOR_H
+#define MEMORYGOVERNOR_H
+
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QHash>
+#include <QMutex>
+#include <functional>
+#include "core/cache/MemoryPressureMonitor.h"
+
+/**
+ * @brief 进程级内存调度器
+ * CacheManager、书库缩略图缓存、页面金字塔、解析器页面缓存等各自注册，报告当前占用并提供回收回调。
+ * 总占用超过全局预算（ConfigManager::getMaxCacheSize）时按优先级从低到高回收，
+ * 同一优先级内先回收占用最大的缓存。系统内存紧张时预算按压力等级缩小。
+ *
+ * 锁顺序：缓存自身的锁 -> 调度器锁。缓存可以在持有自身锁时调用 updateUsage()，
+ * 但必须在释放自身锁之后才能调用 checkBudget()：回收回调在调用 checkBudget() 的线程中
+ * 同步执行（可能是任意工作线程），并在其中获取缓存的锁。
+ */
+class MemoryGovernor : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 回收优先级，低优先级先被回收
+     */
+    enum Priority {
+        LowPriority,        // 可随时重建（缩略图等）
+        NormalPriority,     // 重建需要解压
+        HighPriority        // 重建需要解压和解码（当前阅读的页面）
+    };
+
+    // 请求回收 bytes 字节，返回实际释放的字节数
+    typedef std::function<qint64(qint64 bytes)> ReclaimCallback;
+
+    /**
+     * @brief 已注册缓存的占用情况
+     */
+    struct CacheUsage {
+        int id = -1;
+        QString name;
+        Priority priority = NormalPriority;
+        qint64 bytes = 0;
+        qint64 reclaimedBytes = 0;  // 累计被回收的字节数
+    };
+
+    static MemoryGovernor* instance();
+
+    int registerCache(const QString &name, Priority priority, const ReclaimCallback &reclaim);
+    void unregisterCache(int id);
+
+    // 报告占用（线程安全，开销很小，可以在每次插入/删除后调用）
+    void updateUsage(int id, qint64 bytes);
+
+    // 超出预算时立即回收；不能在持有已注册缓存的锁时调用
+    qint64 checkBudget();
+
+    // 预算（字节）；设置后立即检查
+    void setBudget(qint64 bytes);
+    qint64 budget() const;
+    qint64 effectiveBudget() const;
+    qint64 totalUsage() const;
+    QList<CacheUsage> usage() const;
+
+    // 使用已有的内存压力监视器，压力下缩小有效预算
+    void setPressureMonitor(MemoryPressureMonitor *monitor);
+    void applyMemoryPressure(MemoryPressureMonitor::PressureLevel level);
+
+signals:
+    void reclaimed(qint64 bytes);
+
+private slots:
+    void onPressureChanged(MemoryPressureMonitor::PressureLevel level);
+    void onConfigChanged(const QString &key, const QVariant &value);
+
+private:
+    explicit MemoryGovernor(QObject *parent = nullptr);
+    qint64 effectiveBudgetLocked() const;
+
+    struct Registration {
+        QString name;
+        Priority priority;
+        ReclaimCallback reclaim;
+        qint64 bytes;
+        qint64 reclaimedBytes;
+    };
+
+    mutable QMutex m_mutex;         // 保护注册表和占用统计
+    QMutex m_reclaimMutex;          // 同一时间只进行一次回收，也防止回收回调中重入
+    QHash<int, Registration> m_registrations;
+    int m_nextId;
+    qint64 m_totalUsage;
+    qint64 m_budget;
+    int m_budgetPercent;            // 内存压力下的预算比例
+
+    MemoryPressureMonitor *m_pressureMonitor;
+};
+
+#endif // MEMORYGOVERNOR_H
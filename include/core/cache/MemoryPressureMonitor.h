@@ -0,0 +1,76 @@
+#ifndef MEMORYPRESSUREMONITOR_H
+#define MEMORYPRESSUREMONITOR_H
+
+#include <QObject>
+#include <QTimer>
+#include <QString>
+#include <QByteArray>
+
+/**
+ * @brief 一次内存状态采样
+ * 不可用的字段为 -1。
+ */
+struct MemorySample {
+    qint64 totalBytes = -1;         // 系统物理内存
+    qint64 availableBytes = -1;     // 系统可用内存（MemAvailable）
+    qint64 cgroupCurrentBytes = -1; // cgroup v2 memory.current
+    qint64 cgroupLimitBytes = -1;   // cgroup v2 memory.max / memory.high 中较小者，无限制为 -1
+    double psiSomeAvg10 = -1.0;     // PSI some avg10（百分比）
+    double psiFullAvg10 = -1.0;     // PSI full avg10（百分比）
+
+    // 系统和cgroup中较紧张的一方的剩余比例（0-1），无数据时为 -1
+    double headroomRatio() const;
+};
+
+/**
+ * @brief 内存压力监视器
+ * 定时读取系统内存、cgroup v2 限制和 PSI（Linux），或 GlobalMemoryStatusEx（Windows），
+ * 压力等级变化时发出信号。共享工作站上同时打开多个大压缩包时，缓存据此主动缩小。
+ */
+class MemoryPressureMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum PressureLevel {
+        NoPressure,         // 内存充足
+        ModeratePressure,   // 开始紧张，逐步缩减缓存
+        CriticalPressure    // 即将触发OOM或大量换页
+    };
+
+    explicit MemoryPressureMonitor(QObject *parent = nullptr);
+
+    void start(int intervalMs = 2000);
+    void stop();
+    bool isRunning() const;
+
+    PressureLevel level() const;
+    MemorySample lastSample() const;
+
+    // 立即采样一次并更新等级
+    PressureLevel poll();
+
+    // 采样和判定，可单独测试
+    static MemorySample readSample();
+    static PressureLevel classify(const MemorySample &sample);
+
+    // 解析函数（输入为对应文件的内容）
+    static bool parseMemInfo(const QByteArray &content, qint64 &totalBytes, qint64 &availableBytes);
+    static bool parsePressure(const QByteArray &content, double &someAvg10, double &fullAvg10);
+    static QString parseCgroupPath(const QByteArray &content);
+    static qint64 parseCgroupLimit(const QByteArray &content);
+
+signals:
+    void pressureChanged(MemoryPressureMonitor::PressureLevel level);
+    void sampled(const MemorySample &sample, MemoryPressureMonitor::PressureLevel level);
+
+private slots:
+    void onTimer();
+
+private:
+    QTimer *m_timer;
+    PressureLevel m_level;
+    MemorySample m_lastSample;
+};
+
+#endif // MEMORYPRESSUREMONITOR_H
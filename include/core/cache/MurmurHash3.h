@@ -0,0 +1,36 @@
+#ifndef MURMURHASH3_H
+#define MURMURHASH3_H
+
+#include <QByteArray>
+#include <QString>
+
+/**
+ * @brief 128位哈希值
+ */
+struct Hash128
+{
+    quint64 h1 = 0;
+    quint64 h2 = 0;
+
+    // 32位十六进制字符串（按字节小端顺序输出，与参考实现一致）
+    QString toHex() const;
+
+    bool operator==(const Hash128 &other) const { return h1 == other.h1 && h2 == other.h2; }
+    bool operator!=(const Hash128 &other) const { return !(*this == other); }
+};
+
+/**
+ * @brief MurmurHash3 x64 128位哈希
+ * 非加密哈希，用于缓存键和文件名；比MD5快一个数量级，分布足够均匀。
+ */
+class MurmurHash3
+{
+public:
+    static Hash128 hash128(const void *data, int length, quint32 seed = 0);
+    static Hash128 hash128(const QByteArray &data, quint32 seed = 0);
+
+private:
+    MurmurHash3() = delete;
+};
+
+#endif // MURMURHASH3_H
@@ -0,0 +1,56 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <list>
+
+/**
+ * @brief 分层时间轮
+ * 4层、每层64个槽，默认1秒一格，最大跨度约194天（更远的到期时间按最大跨度处理，届时重新放置）。
+ * 调度和取消为O(1)；advance() 只处理经过的格子和真正到期的条目，不扫描全部条目。
+ * 不是线程安全的，由调用方加锁。
+ */
+class TimerWheel
+{
+public:
+    explicit TimerWheel(qint64 nowMs, qint64 tickMs = 1000);
+
+    // 设置（或重新设置）条目的到期时间
+    void schedule(const QString &key, qint64 expiryMs);
+    void cancel(const QString &key);
+    bool contains(const QString &key) const;
+    qint64 expiryOf(const QString &key) const;
+
+    // 推进到 nowMs，返回到期的键（按到期先后）
+    QStringList advance(qint64 nowMs);
+
+    int size() const;
+    void clear();
+
+private:
+    static const int LEVELS = 4;
+    static const int SLOT_BITS = 6;
+    static const int SLOTS = 1 << SLOT_BITS;
+    static const int SLOT_MASK = SLOTS - 1;
+
+    struct Timer {
+        qint64 expiryTick;
+        int level;
+        int slot;
+        std::list<QString>::iterator position;
+    };
+
+    void place(const QString &key, Timer &timer, qint64 baseTick);
+    void cascade(int level, qint64 tick);
+    void expireSlot(qint64 tick, QStringList &expired);
+
+    qint64 m_tickMs;
+    qint64 m_currentTick;   // 已处理到的格子
+    std::list<QString> m_slots[LEVELS][SLOTS];
+    int m_levelCounts[LEVELS];
+    QHash<QString, Timer> m_timers;
+};
+
+#endif // TIMERWHEEL_H
@@ -0,0 +1,57 @@
+#ifndef ANIMATEDIMAGEDECODER_H
+#define ANIMATEDIMAGEDECODER_H
+
+#include <QBuffer>
+#include <QByteArray>
+#include <QImage>
+#include <QSize>
+
+class QImageReader;
+
+/**
+ * @brief 动画图片（GIF/WebP）的逐帧解码器
+ * 每次只解码一帧，内存中只有压缩数据和解码器合成用的一帧画布，与总帧数无关；
+ * 300帧的 GIF 一次全部展开可能需要数GB内存。
+ * 到达最后一帧后按图片中的循环次数从头重新解码。
+ * 同一个对象同一时间只能在一个线程中使用。
+ */
+class AnimatedImageDecoder
+{
+public:
+    struct Frame {
+        QImage image;
+        int delay = 0;      // 毫秒
+    };
+
+    explicit AnimatedImageDecoder(const QByteArray &data);
+    ~AnimatedImageDecoder();
+
+    // 只读取图片头：格式支持动画且多于一帧
+    static bool isAnimated(const QByteArray &data);
+
+    bool isValid() const;
+    QSize size() const;
+    // 总帧数，未知时为0
+    int frameCount() const;
+    // 重复播放的次数，-1 为无限循环
+    int loopCount() const;
+
+    // 解码下一帧；播放结束或解码失败时返回 false
+    bool readFrame(Frame *frame);
+
+private:
+    Q_DISABLE_COPY(AnimatedImageDecoder)
+
+    void openReader();
+
+    QByteArray m_data;
+    QBuffer m_buffer;
+    QImageReader *m_reader;
+    QSize m_size;
+    int m_frameCount;
+    int m_loopCount;
+    int m_loopsCompleted;
+    int m_frameIndex;           // 本轮已经解码的帧数
+};
+
+#endif // ANIMATEDIMAGEDECODER_H
@@ -0,0 +1,44 @@
+#ifndef CONTENTBOUNDS_H
+#define CONTENTBOUNDS_H
+
+#include <QByteArray>
+#include <QImage>
+#include <QRect>
+#include <QSize>
+#include <QVector>
+
+/**
+ * @brief 检测页面四周的空白边距（自动裁边）
+ * 在长边不超过 ANALYSIS_SIZE 的灰度副本上逐行、逐列统计亮度的均值和方差：
+ * 从每条边向内，方差很小且均值接近最外一行（列）的都算作边距，遇到第一条有内容的行（列）为止。
+ * 只比较同一条边上的亮度，白边、黑边和扫描仪盖板的灰边都能识别；零星的灰尘和噪点在缩小后
+ * 方差很小，不会被当作内容。
+ *
+ * 行、列的像素和与平方和有 AVX2、SSE4.1、NEON 和标量几种实现（按 ImageScaler::instructionSet() 选择），
+ * 结果完全一致。分析一页只需要不到1毫秒，主要开销在解码，JPEG 按缩小的分辨率解码。
+ * 只使用调用线程，可以在多个线程中同时分析不同的页面。
+ */
+class ContentBounds
+{
+public:
+    // 分析用的灰度副本的长边
+    static const int ANALYSIS_SIZE = 512;
+
+    // 各行、各列的像素和与平方和（每行、每列不超过65536像素时不会溢出）
+    struct Profile {
+        QVector<quint32> rowSum;
+        QVector<quint32> rowSumSq;
+        QVector<quint32> columnSum;
+        QVector<quint32> columnSumSq;
+    };
+
+    // image 中内容的范围（image 的坐标）；没有值得裁掉的边距或整页空白时为整张图片，image 为空时为空矩形
+    static QRect detect(const QImage &image);
+    // 按分析需要的分辨率解码 data 后检测，结果为原图坐标；fullSize 返回原图尺寸，解码失败时返回空矩形
+    static QRect detect(const QByteArray &data, QSize *fullSize = nullptr);
+
+    // 统计 gray（Format_Grayscale8）的各行、各列，列只统计 firstRow～lastRow 之间的行（基准测试和单元测试用）
+    static Profile profile(const QImage &gray, int firstRow = 0, int lastRow = -1);
+};
+
+#endif // CONTENTBOUNDS_H
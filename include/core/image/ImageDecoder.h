@@ -0,0 +1,34 @@
+#ifndef IMAGEDECODER_H
+#define IMAGEDECODER_H
+
+#include <QByteArray>
+#include <QImage>
+#include <QSize>
+
+/**
+ * @brief 按需要的分辨率解码图片
+ * 显示尺寸比原图小时不必解码全部像素：JPEG 可以在DCT域中直接按 1/2、1/4、1/8 解码，
+ * 6000像素宽的页面生成128像素的缩略图时解码的像素约少64倍。
+ * 其他格式的解码器不支持缩小解码，仍按原始分辨率解码。
+ * 结果只保证不小于需要的尺寸，最终尺寸由调用方再用 ImageScaler 缩放。
+ */
+class ImageDecoder
+{
+public:
+    // 只读取图片头得到原始尺寸，失败时无效
+    static QSize imageSize(const QByteArray &data);
+
+    // 解码后只需要 scale 倍大小时使用的解码尺寸（scale 不小于1时为原始尺寸）
+    static QSize reducedSize(const QSize &fullSize, qreal scale);
+
+    // 解码 data，结果不小于原图的 scale 倍；fullSize 返回原始尺寸
+    static QImage decode(const QByteArray &data, qreal scale = 1.0, QSize *fullSize = nullptr);
+
+    // 同 decode()，但只在能够缩小解码时才解码，否则返回空图片（快速翻页的预览用，不能比正常加载更慢）
+    static QImage decodeReduced(const QByteArray &data, qreal scale, QSize *fullSize = nullptr);
+
+    // 解码并保持宽高比缩放到 bounds 以内（缩略图用）
+    static QImage decodeToFit(const QByteArray &data, const QSize &bounds);
+};
+
+#endif // IMAGEDECODER_H
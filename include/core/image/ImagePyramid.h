@@ -0,0 +1,53 @@
+#ifndef IMAGEPYRAMID_H
+#define IMAGEPYRAMID_H
+
+#include <QImage>
+#include <QMutex>
+#include <QSize>
+
+/**
+ * @brief 图片金字塔（mipmap）
+ * 第0层为原图，第1～3层依次为 1/2、1/4、1/8 大小，按面积平均生成。
+ * 各层在第一次用到时才生成（在调用线程中，通常是工作线程），之后一直保留。
+ * 缩放到任意尺寸时从不小于目标尺寸的最小一层重采样，读取的像素最多约为输出的4倍，
+ * 缩放开销取决于输出大小而不是原图大小；只有生成某一层时需要读取一次更细的一层。
+ *
+ * 阅读器的缩放、分块绘制和缩略图都通过它缩小图片。可以在多个线程中同时使用。
+ * 各层共占原图约1/3的内存。
+ */
+class ImagePyramid
+{
+public:
+    static const int LEVEL_COUNT = 4;
+
+    explicit ImagePyramid(const QImage &base);
+
+    QImage base() const { return m_levels[0]; }
+    QSize size() const { return m_levels[0].size(); }
+
+    // 第 index 层的尺寸（每层宽高减半，向上取整）
+    QSize levelSize(int index) const;
+    // 缩放到 scale 倍时应该使用的层：不小于目标尺寸的最小一层
+    static int levelFor(qreal scale);
+
+    // 第 index 层，尚未生成时先生成
+    QImage level(int index);
+    bool hasLevel(int index) const;
+    // 已经生成的层中满足 scale 倍的最小一层，不生成新的层（预览用）
+    QImage builtLevel(qreal scale) const;
+
+    // 缩放到 size（宽高比可以与原图略有不同），放大时从原图双线性插值
+    QImage scaled(const QSize &size);
+    // 保持宽高比缩放到 bounds 以内
+    QImage scaledToFit(const QSize &bounds);
+
+    // 已经生成的各层（不含原图）占用的字节数
+    qint64 levelBytes() const;
+
+private:
+    mutable QMutex m_mutex;         // 保护 m_levels
+    QMutex m_buildMutex;            // 同一时间只生成一层
+    QImage m_levels[LEVEL_COUNT];
+};
+
+#endif // IMAGEPYRAMID_H
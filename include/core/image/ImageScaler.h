@@ -0,0 +1,46 @@
+#ifndef IMAGESCALER_H
+#define IMAGESCALER_H
+
+#include <QImage>
+#include <QSize>
+#include <QString>
+
+/**
+ * @brief 高质量图片缩放
+ * 可分离的重采样（先水平后垂直），权重为14位定点数，常数颜色缩放后保持不变。
+ * 内核有 AVX2、SSE4.1、NEON 和标量几种实现，运行时按CPU选择，各实现的结果逐字节一致。
+ * 大图按行分段在多个线程中处理；调用线程本身也参与处理，在线程池内部调用不会死锁。
+ *
+ * 只处理 Format_ARGB32_Premultiplied 和 Format_RGB32，其他格式先转换为其中之一。
+ * Area 为面积平均，缩小时与 Qt 的平滑缩放相比不丢失细节；Lanczos3 更锐利，
+ * 但会在边缘附近产生轻微振铃。放大时 Area 退化为双线性插值。
+ */
+class ImageScaler
+{
+public:
+    enum Filter {
+        Area,
+        Lanczos3
+    };
+
+    enum InstructionSet {
+        Scalar,
+        SSE41,
+        AVX2,
+        NEON
+    };
+
+    // threads 为0时使用所有核心
+    static QImage scale(const QImage &source, const QSize &size, Filter filter = Area, int threads = 0);
+    // 保持宽高比缩放到 bounds 以内
+    static QImage scaleToFit(const QImage &source, const QSize &bounds, Filter filter = Area, int threads = 0);
+
+    // 当前CPU支持的最佳实现
+    static InstructionSet supportedInstructionSet();
+    static InstructionSet instructionSet();
+    // 限制使用的实现（基准测试和单元测试用），超出CPU支持范围时使用支持的最佳实现
+    static void setInstructionSet(InstructionSet set);
+    static QString instructionSetName(InstructionSet set);
+};
+
+#endif // IMAGESCALER_H
@@ -0,0 +1,42 @@
+#ifndef PANELDETECTOR_H
+#define PANELDETECTOR_H
+
+#include <QByteArray>
+#include <QImage>
+#include <QRect>
+#include <QSize>
+#include <QVector>
+
+/**
+ * @brief 漫画分格检测（分格阅读用）
+ * 在长边不超过 ANALYSIS_SIZE 的灰度副本上，把与页面背景（四周边框上最多的亮度）相差较大的像素
+ * 二值化为墨迹，再递归地按格间空白切分（XY-cut）：先找横贯整个区域、几乎没有墨迹的行，
+ * 把区域分成上下几段；没有时再找竖直的空白列分成左右几段，直到不能再分。
+ * 切不开的区域去掉四周的空白后作为一格，面积很小的（页码、零星的文字）不算。
+ * 结果按阅读顺序排列：从上到下，同一行中从左到右（从右到左阅读时相反）。
+ *
+ * 斜线分格和跨越格间空白的对话框会使相邻的几格合并为一格，这时分格阅读仍然可用，只是步子大一些。
+ * 二值化和行、列墨迹计数有 AVX2、SSE4.1、NEON 和标量几种实现（按 ImageScaler::instructionSet() 选择），
+ * 结果完全一致。只使用调用线程，可以在多个线程中同时分析不同的页面。
+ */
+class PanelDetector
+{
+public:
+    // 分析用的灰度副本的长边：2000×3000 的页面约缩小到 1/4，常见的格间空白仍有几个像素宽
+    static const int ANALYSIS_SIZE = 768;
+
+    // 按阅读顺序排列的各格（image 的坐标）；少于两格时为空
+    static QVector<QRect> detect(const QImage &image, bool rightToLeft = false);
+    // 按分析需要的分辨率解码 data 后检测，结果为原图坐标；fullSize 返回原图尺寸（解码失败时无效）
+    static QVector<QRect> detect(const QByteArray &data, bool rightToLeft = false, QSize *fullSize = nullptr);
+
+    // 以下分开了检测的各个步骤（基准测试和单元测试用）
+    // 分析用的灰度副本（Format_Grayscale8）
+    static QImage analysisImage(const QImage &image);
+    // 与 background 相差超过 threshold 的像素为1，其余为0
+    static QImage binarize(const QImage &gray, int background, int threshold);
+    // 在分析用的灰度副本上检测，结果为 gray 的坐标
+    static QVector<QRect> detectInAnalysisImage(const QImage &gray, bool rightToLeft = false);
+};
+
+#endif // PANELDETECTOR_H
@@ -0,0 +1,74 @@
+#ifndef PAGETURNMETRICS_H
+#define PAGETURNMETRICS_H
+
+#include <QtGlobal>
+#include <QJsonObject>
+#include <QMutex>
+#include <QString>
+#include "core/cache/LatencyHistogram.h"
+
+/**
+ * @brief 翻页延迟统计
+ * 记录翻页各阶段的耗时和页面数据的来源，供阅读器的性能浮层显示和导出。
+ * 每个阶段用两个直方图轮换：当前窗口记满 WINDOW_SIZE 个样本后清空另一个并切换，
+ * 快照合并两个窗口，反映最近 WINDOW_SIZE 到 2×WINDOW_SIZE 次的情况。
+ * 可以在任意线程记录。
+ */
+class PageTurnMetrics
+{
+public:
+    enum Stage {
+        Turn,           // 输入事件到新页面开始绘制
+        CacheLookup,    // 查找内存中的位图和映射的解码图片
+        Fetch,          // 从内存或磁盘缓存读取原始数据
+        Inflate,        // 从归档中解压
+        Decode,
+        Scale,          // 缩放或合成跨页
+        Paint,          // 结果交给界面到开始绘制
+        StageCount
+    };
+
+    enum Source {
+        PixmapCache,    // 内存中已有显示用的位图
+        DecodedCache,   // 映射的解码图片
+        RawMemory,      // 内存中的原始数据
+        RawDisk,        // 磁盘缓存中的原始数据
+        Archive,
+        SourceCount
+    };
+
+    static const int WINDOW_SIZE = 256;
+
+    /**
+     * @brief 统计某一时刻的副本
+     */
+    struct Snapshot {
+        LatencyHistogram::Snapshot stages[StageCount];
+        qint64 sources[SourceCount] = {};
+
+        qint64 sourceTotal() const;
+        QJsonObject toJson() const;
+    };
+
+    PageTurnMetrics();
+
+    void record(Stage stage, qint64 nanoseconds);
+    void recordSource(Source source);
+    void reset();
+    Snapshot snapshot() const;
+
+    // 导出为 JSON（附带版本信息，便于比较不同版本）
+    bool exportToFile(const QString &filePath) const;
+
+    static QString stageName(Stage stage);
+    static QString sourceName(Source source);
+
+private:
+    mutable QMutex m_mutex;
+    LatencyHistogram m_windows[StageCount][2];
+    int m_current[StageCount];
+    int m_windowCount[StageCount];
+    qint64 m_sources[SourceCount];
+};
+
+#endif // PAGETURNMETRICS_H
@@ -61,6 +61,8 @@ struct ComicInfo
 /**
  * @brief 漫画解析器类
  * 支持CBZ、CBR、ZIP、RAR格式的漫画文件解析
+ * 带有自己的页面缓存（MainWindow 构建使用），缓存以 NormalPriority 注册到 MemoryGovernor；
+ * 阅读器使用的 core/ComicParser.h 没有页面缓存。
  */
 class ComicParser : public QObject
 {
@@ -165,6 +167,8 @@ private:
     ComicPage getFromCache(int pageNumber) const;
     bool isInCache(int pageNumber) const;
     void cleanCache();
+    void removeFromCacheLocked(QMap<int, ComicPage>::iterator it) const;
+    qint64 reclaimCache(qint64 bytes);
     
     // RAR工具查找
     QString findRarTool() const;
@@ -211,6 +215,9 @@ private:
     int m_maxCacheSize;
     mutable QMap<int, ComicPage> m_pageCache;
     mutable QMutex m_cacheMutex;
+    mutable qint64 m_cacheBytes;        // 缓存页面数据的总字节数
+    mutable int m_lastAccessedPage;     // 回收时优先丢弃离它最远的页面
+    int m_governorId;                   // MemoryGovernor 注册号
     
     // 支持的图片格式
     static const QStringList SUPPORTED_IMAGE_FORMATS;
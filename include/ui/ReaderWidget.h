@@ -10,8 +10,21 @@
 #include <QPushButton>
 #include <QSlider>
 #include <QSpinBox>
+#include <QImage>
+#include <QHash>
+#include <QRect>
+#include <QSet>
+#include <QElapsedTimer>
+#include "core/cache/CacheKey.h"
+#include "ui/reader/SpreadLayout.h"
 
 class ComicParser;
+class PagePipeline;
+class AnimatedPagePlayer;
+class TiledPageView;
+class ContinuousPageView;
+class QStackedWidget;
+class QTimer;
 
 class ReaderWidget : public QWidget
 {
@@ -19,6 +32,7 @@ class ReaderWidget : public QWidget
 
 public:
     explicit ReaderWidget(QWidget *parent = nullptr);
+    ~ReaderWidget();
 
 public slots:
     void openComic(const QString &filePath);
@@ -30,21 +44,85 @@ public slots:
     void resetZoom();
     void fitToWidth();
     void fitToHeight();
+    void setContinuousMode(bool enabled);
+    void setSpreadMode(bool enabled);
+    void setPerformanceOverlay(bool enabled);
+    // 适应宽度/高度时忽略页面四周的空白边距
+    void setAutoCrop(bool enabled);
+    // 分格阅读：翻页键逐格移动，每格放大到适应窗口
+    void setPanelMode(bool enabled);
+    // 导出翻页延迟统计（JSON）
+    bool exportTurnMetrics(const QString &filePath) const;
+
+protected:
+    void resizeEvent(QResizeEvent *event) override;
+    void changeEvent(QEvent *event) override;
+    bool eventFilter(QObject *watched, QEvent *event) override;
 
 private slots:
     void onPageChanged();
     void onZoomChanged(int value);
+    void onPageReady(int generation, int page, qreal zoom, const QSize &size,
+                     const QImage &original, const QImage &display);
+    void onPageFailed(int generation, int page);
+    void onScalePrepared(int page, qreal zoom, const QImage &display);
+    void onPreviewReady(int generation, int page, const QSize &size, const QImage &preview);
+    void startSmoothRescale();
+    void onSpreadReady(int generation, const QVector<int> &pages, const QImage &spread);
+    void onSpreadPrepared(const QVector<int> &pages, const QSize &bounds, bool rightToLeft, const QImage &spread);
+    void onPageSizeProbed(int page, const QSize &size);
+    void onContentBoundsDetected(int page, const QSize &size, const QRect &bounds);
+    void onPanelsDetected(int page, bool rightToLeft, const QSize &size, const QVector<QRect> &panels);
+    void onAnimationReady(int generation, int page, const QByteArray &data);
+    void onAnimationFrame(const QImage &frame);
 
 private:
+    // 分格阅读时预先检测当前页之后的页数
+    static const int PANEL_LOOKAHEAD = 6;
+    // currentPanel 的特殊值：该页的最后一格（向前翻到上一页时）
+    static const int LAST_PANEL = -1;
+
     void setupUI();
     void updatePageDisplay();
+    void showNavigatedPage();
+    bool showCachedPage();
+    void markPresented();
+    void requestPageAnimation();
+    void updatePerformanceOverlay();
+    void positionPerformanceOverlay();
     void updateZoomDisplay();
+    CacheKey pageCacheKey(int page) const;
+    CacheKey zoomCacheKey(int page, int zoomPercent, qreal ratio) const;
+    CacheKey spreadCacheKey(const QVector<int> &pages, const QSize &bounds, bool rightToLeft, qreal ratio) const;
+    void showSpread();
+    void prepareSpreadsAhead(int spread, const QSize &bounds);
+    void updateZoomControls();
+    int fitZoomValue(Qt::Orientation orientation) const;
+    QRect contentRect() const;
+    void scrollToContent();
+    void scrollToRect(const QRect &rect);
+    bool panelNavigation() const;
+    QVector<QRect> currentPanels() const;
+    bool stepPanel(int step);
+    void showCurrentPanel();
+    void requestPanelsAhead();
+    void prescaleFitTargets();
+    void showPixmap(const QPixmap &pixmap);
+    void showTiled(const QImage &image);
+    void showMessage(const QString &text);
+    bool needsTiling(qreal zoom) const;
+    bool isNativeScale(qreal zoom) const;
+    QPixmap nativeOriginal() const;
+    QSize viewportSize() const;
 
     // UI 组件
     QVBoxLayout *mainLayout;
     QToolBar *toolBar;
+    QStackedWidget *displayStack;   // 普通页面用 scrollArea，超大页面用 pageView，条漫模式用 continuousView
     QScrollArea *scrollArea;
     QLabel *imageLabel;
+    TiledPageView *pageView;
+    ContinuousPageView *continuousView;
     
     // 控制组件
     QPushButton *prevButton;
@@ -56,13 +134,50 @@ private:
     QPushButton *fitWidthButton;
     QPushButton *fitHeightButton;
     QPushButton *resetZoomButton;
+    QPushButton *continuousButton;
+    QPushButton *spreadButton;
+    QPushButton *autoCropButton;
+    QPushButton *panelButton;
+    QPushButton *performanceButton;
+    QLabel *performanceOverlay;     // 翻页延迟和数据来源，浮在页面上方
     
     // 数据
     ComicParser *comicParser;
+    ArchiveFingerprint archiveFingerprint;
     int currentPage;
     double zoomFactor;
     QPixmap currentPixmap;
     QPixmap originalPixmap;
+    QImage originalImage;           // 解码后的原图，缩放在工作线程进行（按缩小的分辨率解码时为空）
+    QSize pageSize;                 // 当前页原图尺寸，页面加载完成前无效
+    bool tiledPage;                 // 当前页是否分块绘制
+    bool continuousMode;            // 条漫（连续滚动）模式
+    bool spreadMode;                // 双页模式
+    bool rightToLeft;               // 阅读方向从右到左（双页模式中右页在前）
+    bool autoCrop;                  // 适应宽度/高度时裁掉空白边距（只用于单页显示）
+    QHash<int, QRect> contentBounds;    // 已经检测出的各页内容范围（原图坐标）
+    bool panelMode;                 // 分格阅读（只用于单页显示）
+    int currentPanel;               // 当前页显示的格，分格尚未检测出时为该页显示后要显示的格
+    QHash<int, QVector<QRect>> pagePanels;  // 已经检测出的各页分格（原图坐标，按当前阅读方向排列）
+    QSet<int> panelRequests;        // 已经请求检测、结果还没有回来的页面
+    SpreadLayout spreadLayout;
+    QVector<int> spreadPages;       // 当前显示的跨页包含的页面
+    QSet<QString> preparingSpreads; // 正在预先合成的跨页（缓存键）
+    
+    // 页面加载流水线
+    PagePipeline *pagePipeline;
+    AnimatedPagePlayer *animationPlayer;    // 当前页是动画（GIF/WebP）时逐帧播放
+    QTimer *loadingTimer;           // 加载超过一定时间才显示"加载中..."
+    QTimer *rescaleTimer;           // 缩放停止变化后再做高质量缩放
+    QTimer *settleTimer;            // 连续翻页停下后再完整加载
+    QElapsedTimer navigationClock;  // 距上一次翻页的时间
+    QTimer *overlayTimer;           // 定时刷新性能浮层
+    
+    // 翻页延迟：从输入事件开始，到新页面（不含预览）开始绘制为止
+    QElapsedTimer turnClock;
+    QElapsedTimer presentClock;     // 结果交给界面的时刻
+    bool turnPending;
+    bool presentPending;
 };
 
 #endif // READERWIDGET_H
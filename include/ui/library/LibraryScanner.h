@@ -0,0 +1,122 @@
+#ifndef LIBRARYSCANNER_H
+#define LIBRARYSCANNER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QSet>
+#include <QSize>
+#include <QImage>
+#include <QVector>
+#include <QThreadPool>
+#include <QSharedPointer>
+#include <functional>
+#include "core/cache/CacheKey.h"
+
+/**
+ * @brief 漫画库的后台扫描器
+ * 目录遍历和元数据提取都不在GUI线程执行：
+ * 几个遍历线程各有一个待扫描目录的双端队列，从自己队列的尾部取目录（深度优先，相邻目录连续访问），
+ * 自己的队列空了就从其他线程队列的头部窃取（窃取到的通常是较大的子树），NAS 上单个目录的延迟
+ * 不会让其他线程空等。目录用 readdir 读取，按 d_type 区分文件和子目录，只有类型未知或符号链接
+ * 时才 stat；Windows 等其他平台使用 QDirIterator。
+ *
+ * 重新扫描是增量的：读目录时顺便取得每个漫画文件的指纹（设备号、inode、大小、纳秒级修改时间），
+ * 与库中记录的指纹相同的文件直接跳过，只有新增和变化的文件才交给另一个线程池打开归档、
+ * 提取元数据（页数、作者和类型），并按缩略图尺寸解码封面写入 CacheManager。
+ * 完整读过的目录中不再出现的已知文件通过 filesMissing() 报告；verifyKnown 时不在扫描目录中的
+ * 已知文件也在工作线程中逐个检查，库中的文件是否还存在不必在启动时由GUI线程逐个确认。
+ * 结果每 BATCH_SIZE 条通过 batchReady() 交给GUI线程一次，进度最多每 PROGRESS_INTERVAL_MS
+ * 报告一次；扫描结束（或取消）时发出 finished()。
+ *
+ * 所有信号都在GUI线程发出。cancel() 之后不会再收到这次扫描的任何结果，可以立即开始新的扫描。
+ */
+class LibraryScanner : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 文件指纹：几项都相同时认为文件没有变化，不必重新打开
+    struct Fingerprint {
+        quint64 device = 0;
+        quint64 inode = 0;
+        qint64 size = -1;
+        qint64 modifiedNs = 0;
+
+        bool isValid() const { return size >= 0; }
+
+        // 读取文件当前的指纹，文件不存在或无法访问时返回无效指纹
+        static Fingerprint fromFile(const QString &filePath);
+        // 保存到库文件用的文本形式（JSON 的数字放不下64位整数），无法解析时返回无效指纹
+        QString toString() const;
+        static Fingerprint fromString(const QString &text);
+
+        bool operator==(const Fingerprint &other) const
+        {
+            return size == other.size && modifiedNs == other.modifiedNs
+                && inode == other.inode && device == other.device;
+        }
+        bool operator!=(const Fingerprint &other) const { return !(*this == other); }
+    };
+
+    struct Entry {
+        QString filePath;
+        Fingerprint fingerprint;
+        int pageCount;
+        QStringList metadata;       // 作者、类型（由 MetadataExtractor 给出）
+        QImage cover;               // 封面缩略图（映射在缓存中），没有要求缩略图或解码失败时为空
+
+        Entry() : pageCount(0) {}
+    };
+
+    // 从文件路径提取作者、类型等，会在多个工作线程中同时调用
+    using MetadataExtractor = std::function<QStringList(const QString &filePath)>;
+
+    static const int BATCH_SIZE = 256;
+    static const int PROGRESS_INTERVAL_MS = 100;
+
+    explicit LibraryScanner(QObject *parent = nullptr);
+    ~LibraryScanner();
+
+    void setMetadataExtractor(const MetadataExtractor &extractor);
+
+    // 扫描 roots 下的漫画文件（recursive 为 false 时不进入子目录），known 中指纹没有变化的文件跳过；
+    // verifyKnown 时 known 中其余的文件也检查一遍（roots 为空时只检查已知文件）。
+    // thumbnailSize 有效时同时生成封面缩略图的缓存。正在扫描时之前的扫描直接作废（不发出 finished()）
+    void start(const QStringList &roots, bool recursive, const QHash<QString, Fingerprint> &known,
+               const QSize &thumbnailSize = QSize(), bool verifyKnown = false);
+    void cancel();
+    bool isScanning() const { return !m_scan.isNull(); }
+
+    // 按扩展名判断是否为漫画文件（cbz/cbr/zip/rar，不区分大小写）
+    static bool isComicFileName(const QString &fileName);
+    // 封面缩略图在 CacheManager 中的键
+    static CacheKey thumbnailKey(const QString &filePath, const QSize &size);
+
+signals:
+    void batchReady(const QVector<LibraryScanner::Entry> &entries);
+    void progress(int processed, int found);
+    void filesMissing(const QStringList &filePaths);
+    void finished(bool cancelled);
+
+private:
+    struct Scan;
+
+    void walk(const QSharedPointer<Scan> &scan, int worker);
+    bool takeDirectory(Scan *scan, int worker, QString *dirPath);
+    void listDirectory(const QSharedPointer<Scan> &scan, int worker, const QString &dirPath);
+    void submitFiles(const QSharedPointer<Scan> &scan, const QVector<Entry> &files);
+    void submitUnlisted(const QSharedPointer<Scan> &scan);
+    void extractMetadata(const QSharedPointer<Scan> &scan, QVector<Entry> entries);
+    void verifyFiles(const QSharedPointer<Scan> &scan, const QStringList &files);
+    void publishResults(const QSharedPointer<Scan> &scan, bool force);
+    void release(const QSharedPointer<Scan> &scan);
+
+    QThreadPool m_walkPool;         // 遍历目录
+    QThreadPool m_metadataPool;     // 提取元数据和封面
+    MetadataExtractor m_extractor;
+    QSharedPointer<Scan> m_scan;    // 当前的扫描，只在GUI线程访问
+};
+
+#endif // LIBRARYSCANNER_H
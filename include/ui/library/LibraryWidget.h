@@ -16,6 +16,8 @@
 #include <QTimer>
 #include <QFileSystemWatcher>
 #include <QDateTime>
+#include <QCache>
+#include "ui/library/LibraryScanner.h"
 
 class ComicLibraryModel;
 class ComicItemDelegate;
@@ -37,6 +39,7 @@ struct ComicInfo {
     QStringList tags;
     QString description;
     double rating;
+    LibraryScanner::Fingerprint fingerprint;    // 上次读取元数据时的文件指纹，重新扫描时没有变化的文件不再打开
     
     ComicInfo() : totalPages(0), currentPage(0), fileSize(0), isFavorite(false), rating(0.0) {}
 };
@@ -94,6 +97,9 @@ public:
     void setThumbnailSize(const QSize &size);
     void setAutoScanDirectories(const QStringList &directories);
     void refreshLibrary();
+    void verifyLibrary();
+    void cancelScan();
+    bool isScanning() const { return m_isScanning; }
 
 signals:
     void comicSelected(const QString &filePath);
@@ -124,6 +130,10 @@ private slots:
     void onDirectoryChanged(const QString &path);
     void onFileChanged(const QString &path);
     void onThumbnailGenerated(const QString &filePath, const QPixmap &thumbnail);
+    void onScanBatch(const QVector<LibraryScanner::Entry> &entries);
+    void onScanProgress(int processed, int found);
+    void onFilesMissing(const QStringList &filePaths);
+    void onScanFinished(bool cancelled);
 
 private:
     void setupUI();
@@ -137,13 +147,18 @@ private:
     void loadLibraryData();
     void saveLibraryData();
     void generateThumbnail(const QString &filePath);
-    void scanDirectory(const QString &dirPath, bool recursive);
+    void insertThumbnail(const QString &filePath, const QPixmap &thumbnail);
+    void updateThumbnailCacheLimit();
+    void reportThumbnailUsage();
+    qint64 reclaimThumbnails(qint64 bytes);
+    void startScan(const QStringList &directories, bool recursive, bool verifyKnown);
     void applyFilters();
     void createContextMenu();
     
-    QString getGenreFromFile(const QString &filePath) const;
-    QString getAuthorFromFile(const QString &filePath) const;
-    QStringList extractMetadata(const QString &filePath) const;
+    // 只依赖文件路径，扫描器在工作线程中调用
+    static QString getGenreFromFile(const QString &filePath);
+    static QString getAuthorFromFile(const QString &filePath);
+    static QStringList extractMetadata(const QString &filePath);
     bool isComicFile(const QString &filePath) const;
     
     // UI组件
@@ -196,6 +211,10 @@ private:
     QStringList m_scanDirectories;
     QFileSystemWatcher *m_fileWatcher;
     QTimer *m_scanTimer;
+    LibraryScanner *m_scanner;
+    QStringList m_scanRoots;    // 正在扫描的目录，扫描中又添加目录时一起重新扫描
+    bool m_scanRecursive;
+    bool m_scanVerify;          // 同时检查不在扫描目录中的已知文件
     bool m_isScanning;
     int m_scanCurrentItem;
     int m_scanTotal;
@@ -203,8 +222,9 @@ private:
     // 缓存和性能
     QTimer *m_searchTimer;
     QString m_pendingSearch;
-    QHash<QString, QPixmap> m_thumbnailCache;
-    int m_maxThumbnailCacheSize;
+    QCache<QString, QPixmap> m_thumbnailCache;  // 代价为字节数，超出上限时按LRU淘汰
+    int m_maxThumbnailCacheSize;                // 缩略图数量上限
+    int m_governorId;                           // MemoryGovernor 注册号
 };
 
 #endif // LIBRARYWIDGET_H
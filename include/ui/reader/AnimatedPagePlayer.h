@@ -0,0 +1,57 @@
+#ifndef ANIMATEDPAGEPLAYER_H
+#define ANIMATEDPAGEPLAYER_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QImage>
+#include <QSharedPointer>
+#include <QSize>
+#include <QThreadPool>
+
+class QTimer;
+
+/**
+ * @brief 动画页面（GIF/WebP）的播放器
+ * 帧在工作线程中逐帧解码（AnimatedImageDecoder），缩放到显示尺寸后放入最多 RING_SIZE 帧的
+ * 环形缓冲区；GUI线程按各帧的延迟取出显示，取出一帧后再解码后面的帧。
+ * 内存中始终只有几帧显示尺寸的图片，与动画的总帧数和原图尺寸无关。
+ *
+ * 解码跟不上时停在当前帧，下一帧解码完成后立即显示。
+ * 播放结束（按图片中的循环次数）后停在最后一帧。
+ */
+class AnimatedPagePlayer : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const int RING_SIZE = 4;
+
+    explicit AnimatedPagePlayer(QObject *parent = nullptr);
+    ~AnimatedPagePlayer();
+
+    // 播放 data；帧缩放到 size（设备像素）并标记设备像素比 ratio
+    void start(const QByteArray &data, const QSize &size, qreal ratio);
+    // 改变之后各帧的显示尺寸（缩放时），已经解码的帧显示时再快速缩放
+    void setFrameSize(const QSize &size, qreal ratio);
+    void stop();
+
+    bool isPlaying() const;
+    int bufferedFrames() const;
+
+signals:
+    void frameReady(const QImage &frame);
+
+private:
+    struct Session;
+
+    void fill(const QSharedPointer<Session> &session);
+    void decodeAhead(const QSharedPointer<Session> &session);
+    void showNextFrame();
+
+    QSharedPointer<Session> m_session;
+    QThreadPool m_decodePool;       // 单线程：解码器只在这个线程中使用
+    QTimer *m_frameTimer;
+    bool m_waiting;                 // 到了显示下一帧的时间但缓冲区为空
+};
+
+#endif // ANIMATEDPAGEPLAYER_H
@@ -0,0 +1,107 @@
+#ifndef CONTINUOUSPAGEVIEW_H
+#define CONTINUOUSPAGEVIEW_H
+
+#include <QAbstractScrollArea>
+#include <QImage>
+#include <QList>
+#include <QVector>
+#include <QThreadPool>
+#include <QAtomicInt>
+#include <QElapsedTimer>
+
+class PagePipeline;
+class QTimer;
+
+/**
+ * @brief 连续滚动（条漫）页面视图
+ * 所有页面按视口宽度纵向排列。打开漫画时先按估计尺寸排版，再由 PagePipeline 在后台
+ * 读取各页图片头得到真实尺寸并修正，修正时保持视口顶部的页面位置不变。
+ *
+ * 只有视口附近窗口内的页面会被加载：窗口向滚动方向延伸的距离随滚动速度增加
+ * （最多6个视口），停止滚动后收缩；离开窗口的页面释放原图，缩放缓冲区回收给后续页面。
+ * 页面在工作线程中缩放到排版宽度，超大页面不生成缩放图，绘制时直接从（映射的）原图
+ * 缩放可见区域。排版使用逻辑像素，缩放结果按设备像素生成。
+ */
+class ContinuousPageView : public QAbstractScrollArea
+{
+    Q_OBJECT
+
+public:
+    explicit ContinuousPageView(PagePipeline *pipeline, QWidget *parent = nullptr);
+    ~ContinuousPageView();
+
+    // 设置页数并开始读取页面尺寸（当前漫画由 PagePipeline::setComic() 决定）
+    void setPageCount(int count);
+    int pageCount() const { return m_pages.size(); }
+    void clear();
+
+    void setPageSize(int page, const QSize &size);
+    void scrollToPage(int page);
+    int currentPage() const { return m_currentPage; }
+
+    // 当前持有原图的页面数
+    int loadedPageCount() const;
+
+signals:
+    void currentPageChanged(int page);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void scrollContentsBy(int dx, int dy) override;
+
+private:
+    struct Page {
+        QSize size;                 // 原图尺寸，未读取到时为估计值
+        bool sizeKnown = false;
+        bool requested = false;     // 已向流水线请求
+        bool rendering = false;
+        bool failed = false;
+        QImage original;
+        QImage buffer;              // 回收的缓冲区，display 引用它的像素
+        QImage display;             // 缩放到排版宽度的结果（设备像素）
+    };
+
+    void onPageFetched(int page, const QImage &original);
+    void onPageRendered(int serial, int page, qint64 originalKey, const QImage &buffer, const QImage &display);
+
+    int pageHeight(int page) const;
+    int pageAt(int y) const;
+    void relayout();
+    void updateScrollBar();
+    void updateVelocity();
+    void updateWindow();
+    void updateCurrentPage();
+    void requestRender(int page, int priority);
+    void releasePage(int page);
+    QSize renderSize(int page) const;
+    bool paintsFromOriginal(int page) const;
+    void invalidateRendering();
+    void recycleBuffer(const QImage &buffer);
+    QImage takeBuffer(const QSize &size);
+
+    PagePipeline *m_pipeline;
+    QVector<Page> m_pages;
+    QVector<int> m_offsets;         // 各页顶部的位置，最后一项为总高度
+    int m_layoutWidth;
+    qreal m_devicePixelRatio;       // 缩放结果对应的设备像素比
+    qreal m_estimatedAspect;        // 尺寸未知页面的高宽比
+    int m_currentPage;
+
+    // 加载窗口（页码闭区间）
+    int m_windowFirst;
+    int m_windowLast;
+
+    // 滚动速度（像素/秒，向下为正）
+    QElapsedTimer m_scrollClock;
+    int m_lastScrollValue;
+    qreal m_velocity;
+    int m_scrollDirection;          // 最近一次滚动的方向，1 向下，-1 向上
+    QTimer *m_idleTimer;            // 停止滚动后收缩窗口
+
+    QList<QImage> m_freeBuffers;
+    QThreadPool m_renderPool;
+    QAtomicInt m_layoutSerial;      // 排版宽度、设备像素比改变或清空时递增，丢弃过期的缩放结果
+};
+
+#endif // CONTINUOUSPAGEVIEW_H
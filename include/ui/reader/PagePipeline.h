@@ -0,0 +1,219 @@
+#ifndef PAGEPIPELINE_H
+#define PAGEPIPELINE_H
+
+#include <QObject>
+#include <QString>
+#include <QImage>
+#include <QByteArray>
+#include <QThreadPool>
+#include <QAtomicInt>
+#include <QMutex>
+#include <QList>
+#include <QSet>
+#include <QRect>
+#include <QSharedPointer>
+#include <QSize>
+#include <QVector>
+#include "core/cache/CacheKey.h"
+#include "core/metrics/PageTurnMetrics.h"
+
+class QElapsedTimer;
+
+class ComicParser;
+class ImagePyramid;
+
+/**
+ * @brief 阅读器页面加载流水线
+ * 读取（归档/缓存）→ 解码 → 缩放三个阶段都在工作线程执行，GUI线程只负责发起请求和显示结果。
+ * 读取阶段在单独的单线程池中串行执行，归档按顺序读取，工作线程自己的解析器不会被并发访问；
+ * 解码和缩放在另一个线程池中并行执行。
+ *
+ * 每次请求都会递增代数（generation），各阶段开始前检查代数，用户已经翻走的页面
+ * 不再继续处理，晚到的结果也会被丢弃。结果转换为32位预乘格式后交给GUI线程，
+ * 转成 QPixmap 时不需要再做格式转换。
+ * 原图或缩放结果超过 isLargeImage() 的页面不生成整张缩放图（display 为空），
+ * 由 TiledPageView 分块绘制。
+ * 缩小显示的页面按需要的分辨率解码（ImageDecoder），这时没有原图（original 为空），
+ * 之后放大到需要更高分辨率时再重新请求。
+ *
+ * 连续滚动模式同时需要多页，使用 fetchPage()/releasePage()：这类请求不受代数影响，
+ * 只在页面被释放或切换漫画后作废，结果为未缩放的原图。
+ * probePageSizes() 只读取图片头得到各页尺寸，结果写入缓存，供连续滚动模式预先排版。
+ * detectContentBounds() 在所有工作线程中并行检测各页四周的空白边距（ContentBounds），
+ * 结果与页面尺寸一样按归档指纹写入缓存，再次打开同一个归档时不必重新分析。
+ * requestPanels() 同样在后台检测并缓存各页的分格（PanelDetector），供分格阅读预先取得。
+ *
+ * 动画页面（GIF/WebP）先按普通页面显示第一帧，再由 requestAnimation() 取出原始数据交给
+ * AnimatedPagePlayer 逐帧播放。
+ *
+ * 双页模式的跨页在工作线程中按显示分辨率合成（composeSpread()），翻页时只需显示合成好的图片；
+ * prepareSpread() 以较低优先级预先合成后面的跨页。
+ *
+ * 缩小已经解码的页面时从该页的图片金字塔（ImagePyramid）重采样：最近用过的几页的金字塔保留下来，
+ * 反复改变缩放比例时开销只与输出大小有关；TiledPageView 通过 pyramidFor() 使用同一个金字塔。
+ * 金字塔占用的内存向 MemoryGovernor 报告，可以随时回收。
+ *
+ * 翻页请求（受代数影响的请求）各阶段的耗时和数据来源记入 metrics()，
+ * 预取和连续滚动模式的请求不计入；界面上的阶段（绘制等）由阅读器记入同一个对象。
+ *
+ * zoom 和 bounds 都以逻辑像素为单位；缩放和合成按 setDevicePixelRatio() 设置的比例
+ * 直接生成设备像素的图片并标记相应的 devicePixelRatio，显示时不会再被缩放一次。
+ */
+class PagePipeline : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PagePipeline(QObject *parent = nullptr);
+    ~PagePipeline();
+
+    // 切换漫画（使之前的请求全部失效）
+    void setComic(const QString &filePath, const ArchiveFingerprint &fingerprint);
+
+    // 显示器的设备像素比，之后的请求按此生成图片
+    void setDevicePixelRatio(qreal ratio);
+    qreal devicePixelRatio() const;
+
+    // original 的图片金字塔（可以在任意线程调用），最近用过的几个保留下来供再次缩放
+    QSharedPointer<ImagePyramid> pyramidFor(const QImage &original);
+
+    // 翻页延迟统计（可以在任意线程读取和记录）
+    PageTurnMetrics *metrics() { return &m_metrics; }
+    const PageTurnMetrics *metrics() const { return &m_metrics; }
+
+    // 加载页面并按 zoom 缩放，返回本次请求的代数
+    int requestPage(int page, qreal zoom);
+
+    // 只重新缩放已经解码的页面
+    int requestScale(int page, const QImage &original, qreal zoom);
+
+    // 快速翻页时的预览：只按 1/8 分辨率解码（不支持缩小解码的格式不生成预览），返回本次请求的代数
+    int requestPreview(int page);
+
+    // 读取页面的原始数据，确实是动画时发出 animationReady；generation 为当前显示的页面的代数，
+    // 本身不递增代数，之后的请求会使它作废
+    void requestAnimation(int generation, int page);
+
+    // 以较低优先级预先缩放（如适应宽度/高度），不受代数影响，换漫画后结果作废
+    void prescale(int page, const QImage &original, qreal zoom);
+
+    // 使所有进行中的请求失效（不影响 fetchPage() 的请求）
+    void cancel();
+
+    // 连续滚动模式：加载/释放单独的页面
+    void fetchPage(int page);
+    void releasePage(int page);
+    void releaseAllPages();
+
+    // 在后台读取各页的图片尺寸（优先级低于页面加载）
+    void probePageSizes(int pageCount);
+
+    // 在后台检测各页的内容范围（自动裁边用），优先级最低
+    void detectContentBounds(int pageCount);
+
+    // 在后台检测 page 的分格（按阅读方向排列），urgent 为当前页，优先于预先检测的后面几页
+    void requestPanels(int page, bool rightToLeft, bool urgent = false);
+
+    // 双页模式：把 pages 合成一张适应 bounds 的跨页，返回本次请求的代数
+    int requestSpread(const QVector<int> &pages, const QSize &bounds, bool rightToLeft);
+    // 以较低优先级预先合成跨页，不受代数影响，换漫画后结果作废
+    void prepareSpread(const QVector<int> &pages, const QSize &bounds, bool rightToLeft);
+
+    int generation() const;
+    bool isCurrent(int generation) const;
+
+    // 超过此大小的图片不生成整张缩放图
+    static bool isLargeImage(const QSize &size);
+
+    // 各页缩放到同一高度后并排（从右到左时顺序相反），整体适应 bounds
+    static QImage composeSpread(const QVector<QImage> &pages, const QSize &bounds, bool rightToLeft);
+
+signals:
+    // original 为解码后的原图（按缩小的分辨率解码时为空），display 为按请求缩放后的图片，
+    // pageSize 为原图尺寸
+    void pageReady(int generation, int page, qreal zoom, const QSize &pageSize,
+                   const QImage &original, const QImage &display);
+    void pageFailed(int generation, int page);
+    void scalePrepared(int page, qreal zoom, const QImage &display);
+    // preview 为低分辨率的原图，pageSize 为原图尺寸
+    void previewReady(int generation, int page, const QSize &pageSize, const QImage &preview);
+    void animationReady(int generation, int page, const QByteArray &data);
+    // 失败时 original 为空
+    void pageFetched(int page, const QImage &original);
+    void pageSizeProbed(int page, const QSize &size);
+    // bounds 为内容范围（原图坐标），没有可以裁掉的边距时为整页
+    void contentBoundsDetected(int page, const QSize &pageSize, const QRect &bounds);
+    // panels 为原图坐标，检测不出分格时为空
+    void panelsDetected(int page, bool rightToLeft, const QSize &pageSize, const QVector<QRect> &panels);
+    // 失败时发出 pageFailed(generation, pages.first())
+    void spreadReady(int generation, const QVector<int> &pages, const QImage &spread);
+    void spreadPrepared(const QVector<int> &pages, const QSize &bounds, bool rightToLeft, const QImage &spread);
+
+private:
+    struct Request {
+        int generation;             // fetchPage() 的请求为 -1
+        int serial;                 // 漫画序号，setComic() 时递增
+        bool wanted;                // fetchPage() 的请求，页面被释放后作废
+        int page;
+        qreal zoom;
+        qreal devicePixelRatio;
+        QString filePath;
+        ArchiveFingerprint fingerprint;
+    };
+
+    Request makeRequest(int page, qreal zoom, bool tracked = true);
+    bool isLive(const Request &request) const;
+    QByteArray fetchData(const Request &request);
+    QSize probeSize(const Request &request);
+    void analyzeNextPage(Request request, const QSharedPointer<QAtomicInt> &next, int pageCount);
+    bool loadContentBounds(const Request &request, QSize *pageSize, QRect *bounds);
+    void storeContentBounds(const Request &request, const QSize &pageSize, const QRect &bounds);
+    void publishContentBounds(const Request &request, const QSize &pageSize, const QRect &bounds);
+    bool loadPanels(const Request &request, bool rightToLeft, QSize *pageSize, QVector<QRect> *panels);
+    void storePanels(const Request &request, bool rightToLeft, const QSize &pageSize, const QVector<QRect> &panels);
+    QImage decodePage(const Request &request, const QByteArray &data, qreal scale = 1.0,
+                      QSize *fullSize = nullptr);
+    void startSpread(const Request &request, const QVector<int> &pages, const QSize &bounds,
+                     bool rightToLeft, int priority);
+    void fetchStage(const Request &request);
+    void decodeStage(const Request &request, const QByteArray &data);
+    void scaleStage(const Request &request, const QImage &original);
+    void deliver(const Request &request, const QSize &pageSize, const QImage &original, const QImage &display);
+    void fail(const Request &request);
+    QByteArray readFromArchive(const Request &request);
+    void recordStage(const Request &request, PageTurnMetrics::Stage stage, const QElapsedTimer &timer);
+    void recordSource(const Request &request, PageTurnMetrics::Source source);
+    QImage scaleOriginal(const QImage &original, qreal zoom);
+    void updatePyramidUsage();
+    qint64 reclaimPyramids(qint64 bytes);
+
+    static QImage scaleImage(const QImage &original, qreal zoom);
+    static QImage scaleImage(const QImage &original, qreal zoom, const QSize &size);
+    static QImage toDisplayFormat(const QImage &image);
+
+    QThreadPool m_fetchPool;        // 单线程：读取归档
+    QThreadPool m_workerPool;       // 解码和缩放
+    QAtomicInt m_generation;
+    QAtomicInt m_comicSerial;
+    PageTurnMetrics m_metrics;      // 在析构函数等待工作线程结束之后才销毁
+
+    // fetchPage() 请求中尚未释放的页面
+    mutable QMutex m_wantedMutex;
+    QSet<int> m_wantedPages;
+
+    // 缩小用的图片金字塔，最近使用的在前
+    QMutex m_pyramidMutex;
+    QList<QSharedPointer<ImagePyramid>> m_pyramids;
+    int m_governorId;
+
+    // 以下只在GUI线程访问
+    QString m_filePath;
+    ArchiveFingerprint m_fingerprint;
+    qreal m_devicePixelRatio;
+
+    // 以下只在读取线程访问
+    ComicParser *m_parser;
+    QString m_parserPath;
+};
+
+#endif // PAGEPIPELINE_H
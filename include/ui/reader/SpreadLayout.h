@@ -0,0 +1,37 @@
+#ifndef SPREADLAYOUT_H
+#define SPREADLAYOUT_H
+
+#include <QVector>
+#include <QSize>
+
+/**
+ * @brief 双页模式的跨页划分
+ * 封面单独成页，宽度大于高度的页面视为已经是跨页的单张图片，单独显示；
+ * 其余页面两两组成跨页，遇到宽页面时重新对齐。
+ * 尺寸未知的页面按竖版处理，页面尺寸读到后重新划分。
+ */
+class SpreadLayout
+{
+public:
+    SpreadLayout();
+
+    void reset(int pageCount);
+    // 返回划分是否发生变化
+    bool setPageSize(int page, const QSize &size);
+
+    int pageCount() const { return m_sizes.size(); }
+    int spreadCount() const { return m_spreadStarts.size(); }
+    int spreadOf(int page) const;
+    QVector<int> pages(int spread) const;
+
+    static bool isWidePage(const QSize &size);
+
+private:
+    void rebuild();
+
+    QVector<QSize> m_sizes;
+    QVector<int> m_spreadStarts;    // 各跨页的第一页
+    QVector<int> m_pageSpreads;     // 各页所在的跨页
+};
+
+#endif // SPREADLAYOUT_H
@@ -0,0 +1,95 @@
+#ifndef TILEDPAGEVIEW_H
+#define TILEDPAGEVIEW_H
+
+#include <QAbstractScrollArea>
+#include <QImage>
+#include <QHash>
+#include <QSet>
+#include <QList>
+#include <QThreadPool>
+#include <QAtomicInt>
+#include <QSharedPointer>
+#include <list>
+
+class ImagePyramid;
+
+/**
+ * @brief 分块绘制的页面视图
+ * 用于超长条漫和超大扫描页：不生成整张缩放图，只绘制与视口（及周围一圈）相交的
+ * 256×256 分块。分块在工作线程中直接从原图缩放绘制，按LRU缓存，淘汰的分块缓冲区
+ * 回收给后续分块使用；缓存容量由视口大小决定，与图片大小无关。
+ * 原图通常来自 MappedImageStore 的映射内存，只有可见区域对应的页面会被读入内存。
+ * 缩小到一半以下时从图片金字塔中对应的一层绘制，每个分块读取的像素与缩放比例无关。
+ * 分块尚未绘制好时先用低分辨率预览图填充。
+ * 分块以逻辑像素划分，按设备像素绘制；设备像素比改变时分块缓存全部作废。
+ */
+class TiledPageView : public QAbstractScrollArea
+{
+    Q_OBJECT
+
+public:
+    explicit TiledPageView(QWidget *parent = nullptr);
+    ~TiledPageView();
+
+    // pyramid 为 image 的金字塔（与流水线共用），为空时自己生成
+    void setImage(const QImage &image, const QSharedPointer<ImagePyramid> &pyramid = QSharedPointer<ImagePyramid>());
+    QImage image() const { return m_image; }
+    void setZoom(qreal zoom);
+    qreal zoom() const { return m_zoom; }
+    QSize scaledSize() const { return m_scaledSize; }
+    void clear();
+
+    int cachedTileCount() const { return m_tiles.size(); }
+    int tileCapacity() const;
+
+    static const int TILE_SIZE = 256;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void scrollContentsBy(int dx, int dy) override;
+
+private:
+    struct Tile {
+        QImage image;
+        std::list<quint64>::iterator order;
+    };
+
+    static quint64 tileKey(int column, int row);
+    static QImage renderTile(ImagePyramid *pyramid, qreal zoom, qreal ratio, const QRect &tileRect, QImage buffer);
+    static QSize tileBufferSize(qreal ratio);
+
+    QPoint contentOffset() const;
+    QRect visibleContentRect() const;
+    void updateScrollBars();
+    void requestTiles(const QRect &visible);
+    void onTileRendered(int generation, quint64 key, const QImage &tile);
+    void insertTile(quint64 key, const QImage &image);
+    void touchTile(Tile &tile);
+    void trimCache();
+    void invalidateTiles();
+    void recycleBuffer(const QImage &buffer);
+    QImage takeBuffer();
+    void buildPreview();
+    void updateDevicePixelRatio();
+
+    QImage m_image;
+    QSharedPointer<ImagePyramid> m_pyramid;
+    qreal m_zoom;
+    QSize m_scaledSize;
+    qreal m_devicePixelRatio;           // 分块缓存对应的设备像素比
+
+    // 分块缓存（以列、行为键），m_lru 头部为最近使用
+    QHash<quint64, Tile> m_tiles;
+    std::list<quint64> m_lru;
+    QSet<quint64> m_pending;
+    QList<QImage> m_freeBuffers;
+
+    QImage m_preview;
+    int m_imageSerial;                  // 每次 setImage 递增，丢弃旧图片的预览
+
+    QThreadPool m_renderPool;
+    QAtomicInt m_generation;            // 图片或缩放改变时递增，丢弃过期的分块
+};
+
+#endif // TILEDPAGEVIEW_H
@@ -25,6 +25,7 @@
 #include <QTreeWidget>
 #include <QScrollArea>
 #include <QSplitter>
+#include <QTimer>
 
 class ConfigManager;
 
@@ -66,6 +67,8 @@ private slots:
     void onAddDirectoryClicked();
     void onRemoveDirectoryClicked();
     void onTestConnectionClicked();
+    void onExportCacheStatisticsClicked();
+    void updateCacheStatistics();
 
 private:
     void setupUI();
@@ -80,6 +83,7 @@ private:
     
     void updateColorButtons();
     void updateFontLabels();
+    void updateCacheUsage();
     void validateSettings();
     bool hasUnsavedChanges() const;
     
@@ -135,14 +139,20 @@ private:
     // 缓存设置页面
     QWidget *m_cachePage;
     QSpinBox *m_memoryCacheSizeSpinBox;
+    QCheckBox *m_adaptMemoryPressureCheckBox;
     QSpinBox *m_diskCacheSizeSpinBox;
     QLineEdit *m_cacheDirectoryLineEdit;
     QPushButton *m_browseCacheDirectoryButton;
     QCheckBox *m_enableDiskCacheCheckBox;
+    QCheckBox *m_compressDiskCacheCheckBox;
     QSpinBox *m_cacheCleanupIntervalSpinBox;
     QSpinBox *m_cacheMaxAgeSpinBox;
     QPushButton *m_clearCacheButton;
     QLabel *m_cacheUsageLabel;
+    QTreeWidget *m_cacheStatisticsTree;
+    QPushButton *m_exportCacheStatisticsButton;
+    QPushButton *m_resetCacheStatisticsButton;
+    QTimer *m_cacheStatisticsTimer;
     
     // 网络设置页面
     QWidget *m_networkPage;
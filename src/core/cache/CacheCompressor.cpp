@@ -0,0 +1,302 @@
+#include "core/cache/CacheCompressor.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+// LZ4块格式常量
+const int MIN_MATCH = 4;
+const int LAST_LITERALS = 5;
+const int MF_LIMIT = 12;
+const int MAX_DISTANCE = 65535;
+const int HASH_LOG = 14;
+
+inline unsigned int read32(const unsigned char *p)
+{
+    unsigned int value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+inline unsigned int hashSequence(unsigned int sequence)
+{
+    return (sequence * 2654435761U) >> (32 - HASH_LOG);
+}
+
+// 写入长度扩展字节（每255一个字节）
+inline unsigned char *writeLengthExtension(unsigned char *op, int length)
+{
+    while (length >= 255) {
+        *op++ = 255;
+        length -= 255;
+    }
+    *op++ = static_cast<unsigned char>(length);
+    return op;
+}
+
+// 读取长度扩展字节，累加到 length 上；超过 limit（剩余的输入或输出）时立即返回 -1，
+// 损坏或截断的条目不能让长度累加溢出
+inline int readLengthExtension(const unsigned char *&ip, const unsigned char *iend, int length, std::ptrdiff_t limit)
+{
+    std::ptrdiff_t total = length;
+    unsigned char s;
+    do {
+        if (ip >= iend) {
+            return -1;
+        }
+        s = *ip++;
+        total += s;
+        if (total > limit) {
+            return -1;
+        }
+    } while (s == 255);
+    return static_cast<int>(total);
+}
+
+} // namespace
+
+int CacheCompressor::compressBound(int inputSize)
+{
+    return inputSize + inputSize / 255 + 16;
+}
+
+int CacheCompressor::compressBlock(const char *source, int srcSize, char *dest, int dstCapacity)
+{
+    const unsigned char *src = reinterpret_cast<const unsigned char *>(source);
+    unsigned char *dst = reinterpret_cast<unsigned char *>(dest);
+
+    const unsigned char *ip = src;
+    const unsigned char *anchor = src;
+    const unsigned char *const iend = src + srcSize;
+    const unsigned char *const mflimit = iend - MF_LIMIT;
+    const unsigned char *const matchlimit = iend - LAST_LITERALS;
+
+    unsigned char *op = dst;
+    unsigned char *const oend = dst + dstCapacity;
+
+    if (srcSize > MF_LIMIT) {
+        std::vector<int> hashTable(1 << HASH_LOG, -1);
+
+        while (ip < mflimit) {
+            const unsigned int sequence = read32(ip);
+            const unsigned int h = hashSequence(sequence);
+            const int candidate = hashTable[h];
+            hashTable[h] = static_cast<int>(ip - src);
+
+            if (candidate < 0 || (ip - src) - candidate > MAX_DISTANCE
+                || read32(src + candidate) != sequence) {
+                // 未命中时按距离加速跳过，对不可压缩数据保持线性速度
+                ip += 1 + ((ip - anchor) >> 6);
+                continue;
+            }
+
+            const unsigned char *match = src + candidate;
+
+            // 向后扩展匹配
+            while (ip > anchor && match > src && ip[-1] == match[-1]) {
+                --ip;
+                --match;
+            }
+
+            // 向前扩展匹配
+            const unsigned char *matchEnd = ip + MIN_MATCH;
+            const unsigned char *ref = match + MIN_MATCH;
+            while (matchEnd < matchlimit && *matchEnd == *ref) {
+                ++matchEnd;
+                ++ref;
+            }
+
+            const int literalLength = static_cast<int>(ip - anchor);
+            const int matchLength = static_cast<int>(matchEnd - ip) - MIN_MATCH;
+
+            // 检查输出空间
+            const int needed = 1 + literalLength / 255 + 1 + literalLength + 2 + matchLength / 255 + 1;
+            if (op + needed > oend) {
+                return 0;
+            }
+
+            unsigned char *token = op++;
+            if (literalLength >= 15) {
+                *token = 15 << 4;
+                op = writeLengthExtension(op, literalLength - 15);
+            } else {
+                *token = static_cast<unsigned char>(literalLength << 4);
+            }
+            std::memcpy(op, anchor, literalLength);
+            op += literalLength;
+
+            const int offset = static_cast<int>(ip - match);
+            *op++ = static_cast<unsigned char>(offset & 0xFF);
+            *op++ = static_cast<unsigned char>(offset >> 8);
+
+            if (matchLength >= 15) {
+                *token |= 15;
+                op = writeLengthExtension(op, matchLength - 15);
+            } else {
+                *token |= static_cast<unsigned char>(matchLength);
+            }
+
+            ip = matchEnd;
+            anchor = ip;
+
+            if (ip < mflimit) {
+                hashTable[hashSequence(read32(ip - 2))] = static_cast<int>(ip - 2 - src);
+            }
+        }
+    }
+
+    // 最后的字面量
+    const int lastLiterals = static_cast<int>(iend - anchor);
+    if (op + 1 + lastLiterals / 255 + 1 + lastLiterals > oend) {
+        return 0;
+    }
+    if (lastLiterals >= 15) {
+        *op++ = 15 << 4;
+        op = writeLengthExtension(op, lastLiterals - 15);
+    } else {
+        *op++ = static_cast<unsigned char>(lastLiterals << 4);
+    }
+    std::memcpy(op, anchor, lastLiterals);
+    op += lastLiterals;
+
+    return static_cast<int>(op - dst);
+}
+
+int CacheCompressor::decompressBlock(const char *source, int srcSize, char *dest, int dstCapacity)
+{
+    const unsigned char *ip = reinterpret_cast<const unsigned char *>(source);
+    const unsigned char *const iend = ip + srcSize;
+    unsigned char *const dst = reinterpret_cast<unsigned char *>(dest);
+    unsigned char *op = dst;
+    unsigned char *const oend = dst + dstCapacity;
+
+    while (ip < iend) {
+        const unsigned int token = *ip++;
+
+        // 字面量
+        int literalLength = static_cast<int>(token >> 4);
+        if (literalLength == 15) {
+            literalLength = readLengthExtension(ip, iend, literalLength, std::min(iend - ip, oend - op));
+            if (literalLength < 0) {
+                return -1;
+            }
+        }
+        if (literalLength > iend - ip || literalLength > oend - op) {
+            return -1;
+        }
+        std::memcpy(op, ip, literalLength);
+        op += literalLength;
+        ip += literalLength;
+
+        // 块以字面量结束
+        if (ip >= iend) {
+            break;
+        }
+
+        // 匹配
+        if (iend - ip < 2) {
+            return -1;
+        }
+        const int offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > op - dst) {
+            return -1;
+        }
+
+        int matchLength = static_cast<int>(token & 15);
+        if (matchLength == 15) {
+            matchLength = readLengthExtension(ip, iend, matchLength, (oend - op) - MIN_MATCH);
+            if (matchLength < 0) {
+                return -1;
+            }
+        }
+        matchLength += MIN_MATCH;
+        if (matchLength > oend - op) {
+            return -1;
+        }
+
+        const unsigned char *match = op - offset;
+        if (offset >= matchLength) {
+            std::memcpy(op, match, matchLength);
+            op += matchLength;
+        } else {
+            // 重叠复制（如连续重复的像素）必须逐字节进行
+            for (int i = 0; i < matchLength; ++i) {
+                *op++ = *match++;
+            }
+        }
+    }
+
+    return static_cast<int>(op - dst);
+}
+
+QByteArray CacheCompressor::compress(const QByteArray &data)
+{
+    if (data.isEmpty()) {
+        return QByteArray();
+    }
+
+    QByteArray output;
+    output.resize(compressBound(data.size()));
+
+    const int written = compressBlock(data.constData(), data.size(), output.data(), output.size());
+    if (written <= 0 || written >= data.size()) {
+        return QByteArray();
+    }
+
+    output.resize(written);
+    return output;
+}
+
+QByteArray CacheCompressor::decompress(const QByteArray &data, int originalSize)
+{
+    if (originalSize <= 0) {
+        return QByteArray();
+    }
+
+    QByteArray output;
+    output.resize(originalSize);
+
+    const int written = decompressBlock(data.constData(), data.size(), output.data(), originalSize);
+    if (written != originalSize) {
+        return QByteArray();
+    }
+
+    return output;
+}
+
+bool CacheCompressor::isAlreadyCompressed(const QByteArray &data)
+{
+    if (data.size() < 12) {
+        return false;
+    }
+
+    const unsigned char *p = reinterpret_cast<const unsigned char *>(data.constData());
+
+    // JPEG
+    if (p[0] == 0xFF && p[1] == 0xD8 && p[2] == 0xFF) {
+        return true;
+    }
+    // PNG
+    if (p[0] == 0x89 && p[1] == 'P' && p[2] == 'N' && p[3] == 'G') {
+        return true;
+    }
+    // GIF
+    if (p[0] == 'G' && p[1] == 'I' && p[2] == 'F' && p[3] == '8') {
+        return true;
+    }
+    // WebP (RIFF....WEBP)
+    if (std::memcmp(p, "RIFF", 4) == 0 && std::memcmp(p + 8, "WEBP", 4) == 0) {
+        return true;
+    }
+    // ZIP / RAR / 7z 等压缩包
+    if ((p[0] == 'P' && p[1] == 'K' && p[2] == 3 && p[3] == 4)
+        || std::memcmp(p, "Rar!", 4) == 0
+        || (p[0] == '7' && p[1] == 'z' && p[2] == 0xBC && p[3] == 0xAF)) {
+        return true;
+    }
+
+    return false;
+}
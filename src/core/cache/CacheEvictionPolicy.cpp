@@ -0,0 +1,366 @@
+#include "core/cache/CacheEvictionPolicy.h"
+
+// ==================== LruEvictionPolicy ====================
+
+LruEvictionPolicy::LruEvictionPolicy(bool refreshOnAccess)
+    : m_refreshOnAccess(refreshOnAccess)
+{
+}
+
+QString LruEvictionPolicy::name() const
+{
+    return m_refreshOnAccess ? QStringLiteral("LRU") : QStringLiteral("FIFO");
+}
+
+void LruEvictionPolicy::recordAccess(const QString &key)
+{
+    if (!m_refreshOnAccess) {
+        return;
+    }
+
+    auto it = m_nodes.find(key);
+    if (it != m_nodes.end()) {
+        m_order.splice(m_order.begin(), m_order, it->position);
+    }
+}
+
+QStringList LruEvictionPolicy::insert(const QString &key, qint64 weight)
+{
+    auto it = m_nodes.find(key);
+    if (it != m_nodes.end()) {
+        m_weightedSize += weight - it->weight;
+        it->weight = weight;
+        m_order.splice(m_order.begin(), m_order, it->position);
+    } else {
+        m_order.push_front(key);
+        Node node;
+        node.position = m_order.begin();
+        node.weight = weight;
+        m_nodes.insert(key, node);
+        m_weightedSize += weight;
+    }
+
+    return evictToCapacity();
+}
+
+void LruEvictionPolicy::remove(const QString &key)
+{
+    auto it = m_nodes.find(key);
+    if (it == m_nodes.end()) {
+        return;
+    }
+
+    m_weightedSize -= it->weight;
+    m_order.erase(it->position);
+    m_nodes.erase(it);
+}
+
+QStringList LruEvictionPolicy::evictToCapacity()
+{
+    QStringList evicted;
+    while (m_weightedSize > m_capacity && !m_order.empty()) {
+        const QString victim = m_order.back();
+        remove(victim);
+        evicted.append(victim);
+    }
+    return evicted;
+}
+
+QStringList LruEvictionPolicy::evictMatching(qint64 bytes, const KeyFilter &filter)
+{
+    QStringList evicted;
+    qint64 freed = 0;
+    for (auto it = m_order.rbegin(); it != m_order.rend() && freed < bytes; ++it) {
+        if (filter(*it)) {
+            freed += m_nodes.value(*it).weight;
+            evicted.append(*it);
+        }
+    }
+
+    for (const QString &key : evicted) {
+        remove(key);
+    }
+    return evicted;
+}
+
+bool LruEvictionPolicy::contains(const QString &key) const
+{
+    return m_nodes.contains(key);
+}
+
+void LruEvictionPolicy::clear()
+{
+    m_order.clear();
+    m_nodes.clear();
+    m_weightedSize = 0;
+}
+
+// ==================== TinyLfuEvictionPolicy ====================
+
+TinyLfuEvictionPolicy::TinyLfuEvictionPolicy(int windowPercent)
+    : m_windowPercent(qBound(1, windowPercent, 80))
+    , m_sketch(1024)
+    , m_sketchEntries(1024)
+    , m_windowSize(0)
+    , m_protectedSize(0)
+{
+}
+
+QString TinyLfuEvictionPolicy::name() const
+{
+    return QStringLiteral("W-TinyLFU");
+}
+
+int TinyLfuEvictionPolicy::frequency(const QString &key) const
+{
+    return m_sketch.frequency(key);
+}
+
+void TinyLfuEvictionPolicy::recordAccess(const QString &key)
+{
+    m_sketch.increment(key);
+
+    auto it = m_nodes.find(key);
+    if (it == m_nodes.end()) {
+        return;
+    }
+
+    Node &node = it.value();
+    switch (node.segment) {
+        case Window:
+            moveToFront(key, node, Window);
+            break;
+        case Probation:
+            // 试用段再次命中，晋升到保护段
+            moveToFront(key, node, Protected);
+            demoteProtectedOverflow();
+            break;
+        case Protected:
+            moveToFront(key, node, Protected);
+            break;
+    }
+}
+
+QStringList TinyLfuEvictionPolicy::insert(const QString &key, qint64 weight)
+{
+    QStringList evicted;
+
+    auto it = m_nodes.find(key);
+    if (it != m_nodes.end()) {
+        // 更新已有条目的权重
+        Node &node = it.value();
+        const qint64 delta = weight - node.weight;
+        m_weightedSize += delta;
+        if (node.segment == Window) {
+            m_windowSize += delta;
+        } else if (node.segment == Protected) {
+            m_protectedSize += delta;
+        }
+        node.weight = weight;
+        recordAccess(key);
+    } else {
+        if (weight > m_capacity) {
+            evicted.append(key);
+            return evicted;
+        }
+
+        // 条目数明显超过估计器容量时扩大表
+        if (m_nodes.size() >= m_sketchEntries) {
+            m_sketchEntries = m_nodes.size() * 2;
+            m_sketch.ensureCapacity(m_sketchEntries);
+        }
+        m_sketch.increment(key);
+
+        m_window.push_front(key);
+        Node node;
+        node.position = m_window.begin();
+        node.weight = weight;
+        node.segment = Window;
+        m_nodes.insert(key, node);
+        m_windowSize += weight;
+        m_weightedSize += weight;
+    }
+
+    evictFromWindow();
+    evictFromMain(evicted);
+    return evicted;
+}
+
+void TinyLfuEvictionPolicy::remove(const QString &key)
+{
+    auto it = m_nodes.find(key);
+    if (it == m_nodes.end()) {
+        return;
+    }
+
+    detach(key, it.value());
+    m_weightedSize -= it->weight;
+    m_nodes.erase(it);
+}
+
+QStringList TinyLfuEvictionPolicy::evictToCapacity()
+{
+    QStringList evicted;
+    evictFromWindow();
+    evictFromMain(evicted);
+    return evicted;
+}
+
+QStringList TinyLfuEvictionPolicy::evictMatching(qint64 bytes, const KeyFilter &filter)
+{
+    // 试用段最先淘汰，其次是窗口，保护段最后
+    QStringList evicted;
+    qint64 freed = 0;
+    const std::list<QString> *segments[] = { &m_probation, &m_window, &m_protected };
+    for (const std::list<QString> *segment : segments) {
+        for (auto it = segment->rbegin(); it != segment->rend() && freed < bytes; ++it) {
+            if (filter(*it)) {
+                freed += m_nodes.value(*it).weight;
+                evicted.append(*it);
+            }
+        }
+    }
+
+    for (const QString &key : evicted) {
+        remove(key);
+    }
+    return evicted;
+}
+
+bool TinyLfuEvictionPolicy::contains(const QString &key) const
+{
+    return m_nodes.contains(key);
+}
+
+void TinyLfuEvictionPolicy::clear()
+{
+    m_window.clear();
+    m_probation.clear();
+    m_protected.clear();
+    m_nodes.clear();
+    m_sketch.clear();
+    m_weightedSize = 0;
+    m_windowSize = 0;
+    m_protectedSize = 0;
+}
+
+std::list<QString> &TinyLfuEvictionPolicy::listFor(Segment segment)
+{
+    switch (segment) {
+        case Window:
+            return m_window;
+        case Probation:
+            return m_probation;
+        case Protected:
+        default:
+            return m_protected;
+    }
+}
+
+void TinyLfuEvictionPolicy::moveToFront(const QString &key, Node &node, Segment segment)
+{
+    Q_UNUSED(key)
+
+    std::list<QString> &from = listFor(node.segment);
+    std::list<QString> &to = listFor(segment);
+    to.splice(to.begin(), from, node.position);
+
+    if (node.segment != segment) {
+        if (node.segment == Window) {
+            m_windowSize -= node.weight;
+        } else if (node.segment == Protected) {
+            m_protectedSize -= node.weight;
+        }
+        if (segment == Window) {
+            m_windowSize += node.weight;
+        } else if (segment == Protected) {
+            m_protectedSize += node.weight;
+        }
+        node.segment = segment;
+    }
+}
+
+void TinyLfuEvictionPolicy::detach(const QString &key, Node &node)
+{
+    Q_UNUSED(key)
+
+    listFor(node.segment).erase(node.position);
+    if (node.segment == Window) {
+        m_windowSize -= node.weight;
+    } else if (node.segment == Protected) {
+        m_protectedSize -= node.weight;
+    }
+}
+
+qint64 TinyLfuEvictionPolicy::windowCapacity() const
+{
+    return m_capacity * m_windowPercent / 100;
+}
+
+qint64 TinyLfuEvictionPolicy::protectedCapacity() const
+{
+    return (m_capacity - windowCapacity()) * 80 / 100;
+}
+
+void TinyLfuEvictionPolicy::demoteProtectedOverflow()
+{
+    while (m_protectedSize > protectedCapacity() && m_protected.size() > 1) {
+        const QString key = m_protected.back();
+        moveToFront(key, m_nodes[key], Probation);
+    }
+}
+
+void TinyLfuEvictionPolicy::evictFromWindow()
+{
+    // 窗口溢出的条目进入试用段头部，成为准入候选者
+    while (m_windowSize > windowCapacity() && !m_window.empty()) {
+        const QString key = m_window.back();
+        Node &node = m_nodes[key];
+        moveToFront(key, node, Probation);
+        m_candidates.push_back(key);
+    }
+}
+
+void TinyLfuEvictionPolicy::evictFromMain(QStringList &evicted)
+{
+    while (m_weightedSize > m_capacity) {
+        // 最早进入试用段的条目是淘汰者
+        QString victim;
+        if (!m_probation.empty()) {
+            victim = m_probation.back();
+        } else if (!m_protected.empty()) {
+            victim = m_protected.back();
+        } else if (!m_window.empty()) {
+            victim = m_window.back();
+        } else {
+            break;
+        }
+
+        // 最新的候选者与淘汰者比较频率，频率相同时保留老条目
+        QString candidate;
+        while (!m_candidates.empty()) {
+            const QString last = m_candidates.back();
+            auto it = m_nodes.constFind(last);
+            if (it != m_nodes.constEnd() && it->segment == Probation && last != victim) {
+                candidate = last;
+                break;
+            }
+            m_candidates.pop_back();
+        }
+
+        if (candidate.isEmpty() || m_sketch.frequency(candidate) > m_sketch.frequency(victim)) {
+            evictKey(victim, evicted);
+        } else {
+            m_candidates.pop_back();
+            evictKey(candidate, evicted);
+        }
+    }
+
+    m_candidates.clear();
+}
+
+void TinyLfuEvictionPolicy::evictKey(const QString &key, QStringList &evicted)
+{
+    remove(key);
+    evicted.append(key);
+}
@@ -0,0 +1,129 @@
+#include "core/cache/CacheKey.h"
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace {
+
+const QString MEMORY_KEY_PREFIX = QStringLiteral("a:");
+const quint32 KEY_HASH_SEED = 0x43524b31;   // "CRK1"，键格式变化时修改
+
+quint64 readInode(const QString &filePath)
+{
+#ifdef Q_OS_WIN
+    HANDLE handle = CreateFileW(reinterpret_cast<const wchar_t *>(QDir::toNativeSeparators(filePath).utf16()),
+                                0, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return 0;
+    }
+    BY_HANDLE_FILE_INFORMATION info;
+    quint64 index = 0;
+    if (GetFileInformationByHandle(handle, &info)) {
+        index = (quint64(info.nFileIndexHigh) << 32) | info.nFileIndexLow;
+    }
+    CloseHandle(handle);
+    return index;
+#else
+    struct stat st;
+    if (::stat(QFile::encodeName(filePath).constData(), &st) != 0) {
+        return 0;
+    }
+    return quint64(st.st_ino);
+#endif
+}
+
+} // namespace
+
+// ==================== ArchiveFingerprint ====================
+
+ArchiveFingerprint ArchiveFingerprint::fromFile(const QString &filePath)
+{
+    ArchiveFingerprint fingerprint;
+    const QFileInfo info(filePath);
+    if (!info.exists()) {
+        return fingerprint;
+    }
+
+    fingerprint.size = info.size();
+    fingerprint.modifiedMs = info.lastModified().toMSecsSinceEpoch();
+    fingerprint.inode = readInode(info.absoluteFilePath());
+    return fingerprint;
+}
+
+// ==================== CacheKey ====================
+
+CacheKey::CacheKey()
+    : m_entryIndex(-1)
+    , m_archiveId(0)
+{
+}
+
+CacheKey::CacheKey(const QString &archivePath, const ArchiveFingerprint &fingerprint,
+                   int entryIndex, const QString &variant)
+    : m_archivePath(QDir::cleanPath(archivePath))
+    , m_fingerprint(fingerprint)
+    , m_entryIndex(entryIndex)
+    , m_variant(variant)
+    , m_archiveId(hashArchivePath(m_archivePath))
+{
+    // 序列化所有字段后一次性哈希
+    QByteArray buffer;
+    QDataStream stream(&buffer, QIODevice::WriteOnly);
+    stream << m_archivePath
+           << m_fingerprint.size << m_fingerprint.modifiedMs << m_fingerprint.inode
+           << qint32(m_entryIndex) << m_variant;
+    m_hash = MurmurHash3::hash128(buffer, KEY_HASH_SEED);
+}
+
+CacheKey CacheKey::forArchiveEntry(const QString &archivePath, int entryIndex, const QString &variant)
+{
+    return CacheKey(archivePath, ArchiveFingerprint::fromFile(archivePath), entryIndex, variant);
+}
+
+bool CacheKey::isValid() const
+{
+    return !m_archivePath.isEmpty() && m_fingerprint.isValid();
+}
+
+QString CacheKey::archivePrefix() const
+{
+    return QString::number(m_archiveId, 16).rightJustified(16, QLatin1Char('0'));
+}
+
+QString CacheKey::archivePrefix(const QString &archivePath)
+{
+    return QString::number(hashArchivePath(QDir::cleanPath(archivePath)), 16).rightJustified(16, QLatin1Char('0'));
+}
+
+QString CacheKey::toString() const
+{
+    return MEMORY_KEY_PREFIX + archivePrefix() + QLatin1Char(':') + m_hash.toHex();
+}
+
+QString CacheKey::fileName() const
+{
+    return archivePrefix() + m_hash.toHex() + QStringLiteral(".cache");
+}
+
+bool CacheKey::operator==(const CacheKey &other) const
+{
+    return m_hash == other.m_hash
+        && m_entryIndex == other.m_entryIndex
+        && m_fingerprint == other.m_fingerprint
+        && m_archivePath == other.m_archivePath
+        && m_variant == other.m_variant;
+}
+
+quint64 CacheKey::hashArchivePath(const QString &archivePath)
+{
+    return MurmurHash3::hash128(archivePath.toUtf8(), KEY_HASH_SEED).h1;
+}
@@ -1,15 +1,73 @@
 #include "../../include/core/CacheManager.h"
-#include "../../include/core/ConfigManager.h"
+#include "core/config/ConfigManager.h"
+#include "core/cache/CacheCompressor.h"
+#include "core/cache/CacheEvictionPolicy.h"
+#include "core/cache/DiskCacheIndex.h"
+#include "core/cache/MappedImageStore.h"
+#include "core/cache/MurmurHash3.h"
+#include "core/cache/MemoryGovernor.h"
+#include "core/cache/FrequencySketch.h"
 #include <QStandardPaths>
 #include <QDir>
 #include <QFileInfo>
 #include <QDateTime>
-#include <QCryptographicHash>
 #include <QDebug>
 #include <QMutexLocker>
+#include <QFile>
+#include <QThread>
+#include <QJsonDocument>
+#include <QtEndian>
+#include <cstring>
+#include <utility>
 
 CacheManager* CacheManager::m_instance = nullptr;
 
+namespace {
+
+// 磁盘条目头：魔数(4) 版本(1) 编码(1) 内容类型(1) 保留(1) 原始大小(4)
+const char DISK_ENTRY_MAGIC[4] = { 'C', 'R', 'C', 'E' };
+const int DISK_ENTRY_HEADER_SIZE = 12;
+const quint8 DISK_ENTRY_VERSION = 1;
+
+enum DiskEntryCodec : quint8 {
+    CodecStored = 0,
+    CodecLZ4 = 1
+};
+
+// 解码图片头：宽(4) 高(4) 格式(4) 每行字节数(4)
+const int IMAGE_HEADER_SIZE = 16;
+
+// 策略键前缀：图片和数据可能使用同一个键，在策略中需要区分
+const QString PIXMAP_KEY_PREFIX = QStringLiteral("p:");
+const QString DATA_KEY_PREFIX = QStringLiteral("d:");
+
+// 内存压力缩减：每一级对应的解码图片上限和整体上限（占设定容量的百分比）
+// 先逐级缩减解码图片（可以从压缩数据重新解码），解码图片清空后再缩减整体容量
+const int PRESSURE_STEP_COUNT = 6;
+const int DECODED_LIMIT_PERCENT[PRESSURE_STEP_COUNT] = { 100, 50, 25, 0, 0, 0 };
+const int TOTAL_LIMIT_PERCENT[PRESSURE_STEP_COUNT] = { 100, 100, 100, 100, 50, 25 };
+const int CRITICAL_PRESSURE_STEP = 3;
+const int RELAX_SAMPLES = 3;    // 连续多少次无压力采样后恢复一级
+
+// 条目保留时间
+const qint64 DEFAULT_MEMORY_TTL_MS = 24LL * 60 * 60 * 1000;    // 24小时
+const int DEFAULT_DISK_MAX_AGE_DAYS = 7;
+const int MEMORY_EXPIRY_CHECK_MS = 60 * 1000;                   // 内存时间轮推进间隔
+const qint64 MS_PER_DAY = 24LL * 60 * 60 * 1000;
+
+bool isPixmapPolicyKey(const QString &policyKey)
+{
+    return policyKey.startsWith(PIXMAP_KEY_PREFIX);
+}
+
+// 两级分片目录：哈希的前两个字节各一级，每级256个子目录
+QString shardedFileName(const QString &hashHex, const QString &baseName)
+{
+    return hashHex.left(2) + QLatin1Char('/') + hashHex.mid(2, 2) + QLatin1Char('/') + baseName;
+}
+
+} // namespace
+
 CacheManager* CacheManager::instance()
 {
     if (!m_instance) {
@@ -20,129 +78,439 @@ CacheManager* CacheManager::instance()
 
 CacheManager::CacheManager(QObject *parent)
     : QObject(parent)
+    , m_memoryExpiry(QDateTime::currentMSecsSinceEpoch())
+    , m_memoryTtlMs(DEFAULT_MEMORY_TTL_MS)
+    , m_evictionPolicyType(TinyLfuPolicy)
+    , m_evictionPolicy(nullptr)
+    , m_traceFile(nullptr)
     , m_maxMemoryCacheSize(100)  // 100MB
     , m_maxDiskCacheSize(500)    // 500MB
+    , m_compressionEnabled(true)
     , m_cleanupTimer(new QTimer(this))
     , m_autoCleanupInterval(30)  // 30分钟
+    , m_ioThread(new QThread(this))
+    , m_diskIndex(new DiskCacheIndex())
+    , m_diskMaxAgeDays(DEFAULT_DISK_MAX_AGE_DAYS)
+    , m_mappedImages(nullptr)
+    , m_mappedImagesEnabled(true)
+    , m_pressureMonitor(new MemoryPressureMonitor(this))
+    , m_adaptToMemoryPressure(true)
+    , m_pressureStep(0)
+    , m_relaxedSamples(0)
+    , m_governorId(-1)
     , m_currentMemorySize(0)
+    , m_decodedMemorySize(0)
 {
     // 设置缓存目录
     ConfigManager *config = ConfigManager::instance();
-    m_cacheDirectory = config->getCachePath();
+    m_cacheDirectory = config->getCacheDirectory();
+    m_compressionEnabled = config->getValue("cache/compressDiskCache", true).toBool();
+    m_diskMaxAgeDays = qMax(1, config->getValue("cache/maxAge", DEFAULT_DISK_MAX_AGE_DAYS).toInt());
+    m_autoCleanupInterval = qMax(1, config->getValue("cache/cleanupInterval", m_autoCleanupInterval).toInt());
     ensureCacheDirectory();
     
-    // 设置自动清理定时器
+    // 解码图片映射存储（默认在运行时目录，上限单位MB）
+    m_mappedImagesEnabled = config->getValue("cache/mappedImages", true).toBool();
+    m_mappedImages = new MappedImageStore(
+        config->getValue("cache/mappedImageDirectory", QString()).toString(),
+        qint64(qMax(0, config->getValue("cache/mappedImageSize", 256).toInt())) * 1024 * 1024);
+    
+    // 内存缓存淘汰策略
+    const QString policyName = config->getValue("cache/evictionPolicy", "tinylfu").toString();
+    m_evictionPolicyType = (policyName.compare("lru", Qt::CaseInsensitive) == 0) ? LruPolicy : TinyLfuPolicy;
+    m_evictionPolicy = createPolicy(m_evictionPolicyType);
+    m_evictionPolicy->setCapacity(qint64(m_maxMemoryCacheSize) * 1024 * 1024);
+    
+    // 访问轨迹，供 CacheTraceBenchmark 回放
+    const QString tracePath = qEnvironmentVariable("COMICREADER_CACHE_TRACE");
+    if (!tracePath.isEmpty()) {
+        m_traceFile = new QFile(tracePath);
+        if (m_traceFile->open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+            m_traceFile->write("# ComicReader cache trace v1\n");
+        } else {
+            qWarning() << "Failed to open cache trace file:" << tracePath;
+            delete m_traceFile;
+            m_traceFile = nullptr;
+        }
+    }
+    
+    m_statisticsTimer.start();
+    
+    // 内存压力监视
+    connect(m_pressureMonitor, &MemoryPressureMonitor::sampled, this, &CacheManager::onMemorySampled);
+    
+    // 全局内存预算：解码页面重建代价最高，最后回收
+    MemoryGovernor *governor = MemoryGovernor::instance();
+    m_governorId = governor->registerCache("CacheManager", MemoryGovernor::HighPriority,
+                                           [this](qint64 bytes) { return reclaimMemory(bytes); });
+    governor->setPressureMonitor(m_pressureMonitor);
+    setAdaptToMemoryPressure(config->getValue("cache/adaptToMemoryPressure", true).toBool());
+    
+    // 内存条目到期：定时推进时间轮，每次只处理到期的条目
     m_cleanupTimer->setSingleShot(false);
-    m_cleanupTimer->setInterval(m_autoCleanupInterval * 60 * 1000);
+    m_cleanupTimer->setInterval(MEMORY_EXPIRY_CHECK_MS);
     connect(m_cleanupTimer, &QTimer::timeout, this, &CacheManager::onCleanupTimer);
     m_cleanupTimer->start();
+    
+    // 磁盘索引在I/O线程上构建并负责磁盘到期清理，GUI线程不再遍历缓存目录
+    m_diskIndex->setDefaultTtl(m_diskMaxAgeDays * MS_PER_DAY);
+    m_diskIndex->moveToThread(m_ioThread);
+    connect(m_ioThread, &QThread::finished, m_diskIndex, &QObject::deleteLater);
+    connect(m_diskIndex, &DiskCacheIndex::entriesExpired, this, [this](int count, qint64) {
+        for (int i = 0; i < count; ++i) {
+            m_diskCounters.recordEviction();
+        }
+    });
+    // 索引建立之前无法按写入顺序淘汰，建立后补做一次
+    connect(m_diskIndex, &DiskCacheIndex::rebuilt, this, &CacheManager::enforceDiskLimit);
+    m_ioThread->setObjectName("CacheIO");
+    m_ioThread->start(QThread::LowPriority);
+    QMetaObject::invokeMethod(m_diskIndex, "rebuild", Qt::QueuedConnection,
+                              Q_ARG(QString, m_cacheDirectory));
+    QMetaObject::invokeMethod(m_diskIndex, "startExpiryTimer", Qt::QueuedConnection,
+                              Q_ARG(int, m_autoCleanupInterval * 60 * 1000));
 }
 
 CacheManager::~CacheManager()
 {
+    MemoryGovernor::instance()->unregisterCache(m_governorId);
+    m_ioThread->quit();
+    m_ioThread->wait();
     clearMemoryCache();
+    delete m_evictionPolicy;
+    delete m_traceFile;
+    delete m_mappedImages;
 }
 
-void CacheManager::cachePixmap(const QString &key, const QPixmap &pixmap)
+void CacheManager::cachePixmap(const QString &key, const QPixmap &pixmap, int ttlSeconds)
 {
-    QMutexLocker locker(&m_pixmapCacheMutex);
+    QMutexLocker locker(&m_memoryCacheMutex);
     
-    // 估算内存使用
-    int pixmapSize = pixmap.width() * pixmap.height() * 4; // 假设32位色深
+    const QString policyKey = PIXMAP_KEY_PREFIX + key;
+    const qint64 pixmapSize = pixmapCost(pixmap);
     
-    // 检查内存限制
-    if (m_currentMemorySize + pixmapSize > m_maxMemoryCacheSize * 1024 * 1024) {
-        enforceMemoryLimit();
+    // 如果键已存在，先扣除旧的大小；旧图片同样要交给GUI线程释放
+    auto it = m_pixmapCache.find(key);
+    if (it != m_pixmapCache.end()) {
+        m_currentMemorySize -= pixmapCost(it.value());
+        m_decodedMemorySize -= pixmapCost(it.value());
+        releasePixmapLocked(it.value());
+        it.value() = pixmap;
+    } else {
+        m_pixmapCache.insert(key, pixmap);
     }
+    m_memoryExpiry.schedule(policyKey, QDateTime::currentMSecsSinceEpoch()
+                            + (ttlSeconds > 0 ? ttlSeconds * 1000LL : m_memoryTtlMs));
+    m_currentMemorySize += pixmapSize;
+    m_decodedMemorySize += pixmapSize;
+    m_memoryCounters.recordInsertion(pixmapSize);
+    m_unusedEntries.insert(policyKey);
+    recordTrace('P', policyKey, pixmapSize);
     
-    // 如果键已存在，先移除旧的
-    if (m_pixmapCache.contains(key)) {
-        m_pixmapCache.remove(key);
+    // 策略决定淘汰哪些条目，可能包括刚插入的条目（准入被拒绝）
+    applyEvictions(m_evictionPolicy->insert(policyKey, pixmapSize));
+    
+    // 内存压力下解码图片有单独的上限
+    if (m_pressureStep > 0) {
+        enforcePressureLimitsLocked();
     }
     
-    m_pixmapCache.insert(key, pixmap);
-    m_cacheTimestamps.insert(key, QDateTime::currentMSecsSinceEpoch());
-    m_currentMemorySize += pixmapSize;
+    MemoryGovernor::instance()->updateUsage(m_governorId, m_currentMemorySize);
+    locker.unlock();
+    MemoryGovernor::instance()->checkBudget();
 }
 
 QPixmap CacheManager::getCachedPixmap(const QString &key) const
 {
-    QMutexLocker locker(&m_pixmapCacheMutex);
-    return m_pixmapCache.value(key);
+    QMutexLocker locker(&m_memoryCacheMutex);
+    
+    // 命中和未命中都计入访问频率
+    const QString policyKey = PIXMAP_KEY_PREFIX + key;
+    m_evictionPolicy->recordAccess(policyKey);
+    
+    auto it = m_pixmapCache.constFind(key);
+    if (it == m_pixmapCache.constEnd()) {
+        m_memoryCounters.recordMiss();
+        recordTrace('G', policyKey, 0);
+        return QPixmap();
+    }
+    
+    const qint64 pixmapSize = pixmapCost(it.value());
+    m_memoryCounters.recordHit(pixmapSize);
+    m_unusedEntries.remove(policyKey);
+    recordTrace('G', policyKey, pixmapSize);
+    return it.value();
 }
 
 bool CacheManager::hasPixmap(const QString &key) const
 {
-    QMutexLocker locker(&m_pixmapCacheMutex);
+    QMutexLocker locker(&m_memoryCacheMutex);
     return m_pixmapCache.contains(key);
 }
 
 void CacheManager::removeCachedPixmap(const QString &key)
 {
-    QMutexLocker locker(&m_pixmapCacheMutex);
-    if (m_pixmapCache.contains(key)) {
-        const QPixmap &pixmap = m_pixmapCache.value(key);
-        int pixmapSize = pixmap.width() * pixmap.height() * 4;
-        m_currentMemorySize -= pixmapSize;
-        
-        m_pixmapCache.remove(key);
-        m_cacheTimestamps.remove(key);
-    }
+    QMutexLocker locker(&m_memoryCacheMutex);
+    removeEntryLocked(PIXMAP_KEY_PREFIX + key);
 }
 
-void CacheManager::cacheData(const QString &key, const QByteArray &data)
+void CacheManager::cacheData(const QString &key, const QByteArray &data, int ttlSeconds)
 {
-    QMutexLocker locker(&m_dataCacheMutex);
+    QMutexLocker locker(&m_memoryCacheMutex);
     
-    // 检查内存限制
-    if (m_currentMemorySize + data.size() > m_maxMemoryCacheSize * 1024 * 1024) {
-        enforceMemoryLimit();
-    }
+    const QString policyKey = DATA_KEY_PREFIX + key;
     
-    // 如果键已存在，先移除旧的
-    if (m_dataCache.contains(key)) {
-        m_currentMemorySize -= m_dataCache.value(key).size();
-        m_dataCache.remove(key);
+    // 如果键已存在，先扣除旧的大小
+    auto it = m_dataCache.find(key);
+    if (it != m_dataCache.end()) {
+        m_currentMemorySize -= it.value().size();
     }
     
     m_dataCache.insert(key, data);
-    m_cacheTimestamps.insert(key, QDateTime::currentMSecsSinceEpoch());
+    m_memoryExpiry.schedule(policyKey, QDateTime::currentMSecsSinceEpoch()
+                            + (ttlSeconds > 0 ? ttlSeconds * 1000LL : m_memoryTtlMs));
     m_currentMemorySize += data.size();
+    m_memoryCounters.recordInsertion(data.size());
+    m_unusedEntries.insert(policyKey);
+    recordTrace('P', policyKey, data.size());
+    
+    applyEvictions(m_evictionPolicy->insert(policyKey, data.size()));
+    
+    MemoryGovernor::instance()->updateUsage(m_governorId, m_currentMemorySize);
+    locker.unlock();
+    MemoryGovernor::instance()->checkBudget();
 }
 
 QByteArray CacheManager::getCachedData(const QString &key) const
 {
-    QMutexLocker locker(&m_dataCacheMutex);
-    return m_dataCache.value(key);
+    QMutexLocker locker(&m_memoryCacheMutex);
+    
+    const QString policyKey = DATA_KEY_PREFIX + key;
+    m_evictionPolicy->recordAccess(policyKey);
+    
+    auto it = m_dataCache.constFind(key);
+    if (it == m_dataCache.constEnd()) {
+        m_memoryCounters.recordMiss();
+        recordTrace('G', policyKey, 0);
+        return QByteArray();
+    }
+    
+    m_memoryCounters.recordHit(it.value().size());
+    m_unusedEntries.remove(policyKey);
+    recordTrace('G', policyKey, it.value().size());
+    return it.value();
 }
 
 bool CacheManager::hasData(const QString &key) const
 {
-    QMutexLocker locker(&m_dataCacheMutex);
+    QMutexLocker locker(&m_memoryCacheMutex);
     return m_dataCache.contains(key);
 }
 
 void CacheManager::removeCachedData(const QString &key)
 {
-    QMutexLocker locker(&m_dataCacheMutex);
-    if (m_dataCache.contains(key)) {
-        m_currentMemorySize -= m_dataCache.value(key).size();
-        m_dataCache.remove(key);
-        m_cacheTimestamps.remove(key);
+    QMutexLocker locker(&m_memoryCacheMutex);
+    removeEntryLocked(DATA_KEY_PREFIX + key);
+}
+
+void CacheManager::saveToDisk(const QString &key, const QByteArray &data, DiskContentType type, int ttlSeconds)
+{
+    writeDiskFile(generateCacheFileName(key), data, type, ttlSeconds);
+}
+
+QByteArray CacheManager::loadFromDisk(const QString &key) const
+{
+    return readDiskFile(generateCacheFileName(key));
+}
+
+bool CacheManager::existsOnDisk(const QString &key) const
+{
+    return QFile::exists(QDir(m_cacheDirectory).absoluteFilePath(generateCacheFileName(key)));
+}
+
+void CacheManager::removeFromDisk(const QString &key)
+{
+    removeDiskFile(generateCacheFileName(key));
+}
+
+void CacheManager::saveImageToDisk(const QString &key, const QImage &image)
+{
+    if (image.isNull()) {
+        return;
     }
+    saveToDisk(key, encodeImage(image), DecodedPixels);
 }
 
-void CacheManager::saveToDisk(const QString &key, const QByteArray &data)
+QImage CacheManager::loadImageFromDisk(const QString &key) const
 {
-    ensureCacheDirectory();
+    return decodeImage(loadFromDisk(key), key);
+}
+
+// ==================== 结构化缓存键 ====================
+
+void CacheManager::cachePixmap(const CacheKey &key, const QPixmap &pixmap, int ttlSeconds)
+{
+    checkArchiveFingerprint(key);
+    cachePixmap(key.toString(), pixmap, ttlSeconds);
+}
+
+QPixmap CacheManager::getCachedPixmap(const CacheKey &key)
+{
+    checkArchiveFingerprint(key);
+    return getCachedPixmap(key.toString());
+}
+
+void CacheManager::cacheData(const CacheKey &key, const QByteArray &data, int ttlSeconds)
+{
+    checkArchiveFingerprint(key);
+    cacheData(key.toString(), data, ttlSeconds);
+}
+
+QByteArray CacheManager::getCachedData(const CacheKey &key)
+{
+    checkArchiveFingerprint(key);
+    return getCachedData(key.toString());
+}
+
+void CacheManager::saveToDisk(const CacheKey &key, const QByteArray &data, DiskContentType type, int ttlSeconds)
+{
+    checkArchiveFingerprint(key);
+    writeDiskFile(generateCacheFileName(key), data, type, ttlSeconds);
+}
+
+QByteArray CacheManager::loadFromDisk(const CacheKey &key)
+{
+    checkArchiveFingerprint(key);
+    return readDiskFile(generateCacheFileName(key));
+}
+
+bool CacheManager::existsOnDisk(const CacheKey &key) const
+{
+    return QFile::exists(QDir(m_cacheDirectory).absoluteFilePath(generateCacheFileName(key)));
+}
+
+void CacheManager::saveImageToDisk(const CacheKey &key, const QImage &image)
+{
+    if (image.isNull()) {
+        return;
+    }
+    saveToDisk(key, encodeImage(image), DecodedPixels);
+}
+
+QImage CacheManager::loadImageFromDisk(const CacheKey &key)
+{
+    return decodeImage(loadFromDisk(key), key.toString());
+}
+
+QImage CacheManager::cacheDecodedImage(const CacheKey &key, const QImage &image)
+{
+    if (!m_mappedImagesEnabled || !key.isValid() || image.isNull()) {
+        return image;
+    }
+    checkArchiveFingerprint(key);
+    return m_mappedImages->insert(key.fileName(), image);
+}
+
+QImage CacheManager::getDecodedImage(const CacheKey &key)
+{
+    if (!m_mappedImagesEnabled || !key.isValid()) {
+        return QImage();
+    }
+    checkArchiveFingerprint(key);
+    return m_mappedImages->find(key.fileName());
+}
+
+void CacheManager::setMappedImageStoreEnabled(bool enabled)
+{
+    m_mappedImagesEnabled = enabled;
+}
+
+bool CacheManager::isMappedImageStoreEnabled() const
+{
+    return m_mappedImagesEnabled;
+}
+
+MappedImageStore *CacheManager::mappedImageStore() const
+{
+    return m_mappedImages;
+}
+
+void CacheManager::invalidateArchive(const QString &archivePath)
+{
+    const QString prefix = CacheKey::archivePrefix(archivePath);
     
-    QString fileName = generateCacheFileName(key);
+    // 内存：结构化键形如 "a:<归档哈希>:<键哈希>"
+    {
+        const QString memoryPrefix = QStringLiteral("a:") + prefix + QLatin1Char(':');
+        QMutexLocker locker(&m_memoryCacheMutex);
+        QStringList policyKeys;
+        for (auto it = m_pixmapCache.constBegin(); it != m_pixmapCache.constEnd(); ++it) {
+            if (it.key().startsWith(memoryPrefix)) {
+                policyKeys.append(PIXMAP_KEY_PREFIX + it.key());
+            }
+        }
+        for (auto it = m_dataCache.constBegin(); it != m_dataCache.constEnd(); ++it) {
+            if (it.key().startsWith(memoryPrefix)) {
+                policyKeys.append(DATA_KEY_PREFIX + it.key());
+            }
+        }
+        for (const QString &policyKey : policyKeys) {
+            removeEntryLocked(policyKey);
+        }
+    }
+    
+    // 磁盘：文件名以归档哈希开头；先从索引中取出，文件在I/O线程上删除
+    const QStringList files = m_diskIndex->takeMatching(prefix);
+    if (!files.isEmpty()) {
+        QMetaObject::invokeMethod(m_diskIndex, "removeFiles", Qt::QueuedConnection,
+                                  Q_ARG(QStringList, files));
+    }
+    
+    // 映射的解码图片使用相同的文件名前缀
+    m_mappedImages->removeMatching(prefix);
+}
+
+void CacheManager::checkArchiveFingerprint(const CacheKey &key)
+{
+    if (!key.isValid()) {
+        return;
+    }
+    
+    {
+        QMutexLocker locker(&m_fingerprintMutex);
+        auto it = m_archiveFingerprints.find(key.archiveId());
+        if (it == m_archiveFingerprints.end()) {
+            m_archiveFingerprints.insert(key.archiveId(), key.fingerprint());
+            return;
+        }
+        if (it.value() == key.fingerprint()) {
+            return;
+        }
+        it.value() = key.fingerprint();
+    }
+    
+    // 归档在磁盘上发生了变化，旧指纹下的条目全部失效
+    invalidateArchive(key.archivePath());
+}
+
+// ==================== 磁盘文件 ====================
+
+void CacheManager::writeDiskFile(const QString &fileName, const QByteArray &data, DiskContentType type, int ttlSeconds)
+{
     QString filePath = QDir(m_cacheDirectory).absoluteFilePath(fileName);
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+    
+    QElapsedTimer timer;
+    timer.start();
     
     QFile file(filePath);
     if (file.open(QIODevice::WriteOnly)) {
-        file.write(data);
+        const QByteArray entry = encodeDiskEntry(data, type);
+        file.write(entry);
         file.close();
+        m_diskWriteLatency.record(timer.nsecsElapsed());
+        m_diskCounters.recordInsertion(entry.size());
+        m_diskIndex->recordWrite(fileName, entry.size(), ttlSeconds > 0 ? ttlSeconds * 1000LL : -1);
     } else {
         qWarning() << "Failed to write cache file:" << filePath;
     }
@@ -151,48 +519,99 @@ void CacheManager::saveToDisk(const QString &key, const QByteArray &data)
     enforceDiskLimit();
 }
 
-QByteArray CacheManager::loadFromDisk(const QString &key) const
+QByteArray CacheManager::readDiskFile(const QString &fileName) const
 {
-    QString fileName = generateCacheFileName(key);
     QString filePath = QDir(m_cacheDirectory).absoluteFilePath(fileName);
     
+    QElapsedTimer timer;
+    timer.start();
+    
     QFile file(filePath);
     if (file.open(QIODevice::ReadOnly)) {
-        return file.readAll();
+        const QByteArray entry = file.readAll();
+        QByteArray data = decodeDiskEntry(entry);
+        m_diskReadLatency.record(timer.nsecsElapsed());
+        m_diskCounters.recordHit(entry.size());
+        return data;
     }
     
+    m_diskCounters.recordMiss();
     return QByteArray();
 }
 
-bool CacheManager::existsOnDisk(const QString &key) const
+void CacheManager::removeDiskFile(const QString &fileName)
 {
-    QString fileName = generateCacheFileName(key);
     QString filePath = QDir(m_cacheDirectory).absoluteFilePath(fileName);
-    return QFile::exists(filePath);
+    QFile::remove(filePath);
+    m_diskIndex->recordRemove(fileName);
 }
 
-void CacheManager::removeFromDisk(const QString &key)
+QByteArray CacheManager::encodeImage(const QImage &image)
 {
-    QString fileName = generateCacheFileName(key);
-    QString filePath = QDir(m_cacheDirectory).absoluteFilePath(fileName);
-    QFile::remove(filePath);
+    // 像素缓冲前加上尺寸和格式，读取时无需再解码
+    QByteArray buffer;
+    buffer.resize(IMAGE_HEADER_SIZE + int(image.sizeInBytes()));
+    uchar *header = reinterpret_cast<uchar *>(buffer.data());
+    qToLittleEndian<quint32>(quint32(image.width()), header);
+    qToLittleEndian<quint32>(quint32(image.height()), header + 4);
+    qToLittleEndian<quint32>(quint32(image.format()), header + 8);
+    qToLittleEndian<quint32>(quint32(image.bytesPerLine()), header + 12);
+    memcpy(buffer.data() + IMAGE_HEADER_SIZE, image.constBits(), size_t(image.sizeInBytes()));
+    return buffer;
 }
 
-void CacheManager::clearMemoryCache()
+QImage CacheManager::decodeImage(const QByteArray &buffer, const QString &key)
 {
-    {
-        QMutexLocker locker(&m_pixmapCacheMutex);
-        m_pixmapCache.clear();
+    if (buffer.size() < IMAGE_HEADER_SIZE) {
+        return QImage();
     }
     
+    const uchar *header = reinterpret_cast<const uchar *>(buffer.constData());
+    const int width = int(qFromLittleEndian<quint32>(header));
+    const int height = int(qFromLittleEndian<quint32>(header + 4));
+    const QImage::Format format = QImage::Format(qFromLittleEndian<quint32>(header + 8));
+    const int bytesPerLine = int(qFromLittleEndian<quint32>(header + 12));
+    
+    if (width <= 0 || height <= 0 || format <= QImage::Format_Invalid || format >= QImage::NImageFormats
+        || qint64(bytesPerLine) * height != buffer.size() - IMAGE_HEADER_SIZE) {
+        qWarning() << "Invalid decoded image cache entry:" << key;
+        return QImage();
+    }
+    
+    QImage image(width, height, format);
+    if (image.isNull() || image.bytesPerLine() != bytesPerLine) {
+        return QImage();
+    }
+    memcpy(image.bits(), buffer.constData() + IMAGE_HEADER_SIZE, size_t(image.sizeInBytes()));
+    return image;
+}
+
+void CacheManager::setCompressionEnabled(bool enabled)
+{
+    m_compressionEnabled = enabled;
+}
+
+bool CacheManager::isCompressionEnabled() const
+{
+    return m_compressionEnabled;
+}
+
+void CacheManager::clearMemoryCache()
+{
     {
-        QMutexLocker locker(&m_dataCacheMutex);
+        QMutexLocker locker(&m_memoryCacheMutex);
+        m_pixmapCache.clear();
         m_dataCache.clear();
+        m_memoryExpiry.clear();
+        m_unusedEntries.clear();
+        if (m_evictionPolicy) {
+            m_evictionPolicy->clear();
+        }
+        m_currentMemorySize = 0;
+        m_decodedMemorySize = 0;
+        MemoryGovernor::instance()->updateUsage(m_governorId, 0);
     }
     
-    m_cacheTimestamps.clear();
-    m_currentMemorySize = 0;
-    
     emit cacheCleared();
 }
 
@@ -200,11 +619,18 @@ void CacheManager::clearDiskCache()
 {
     QDir cacheDir(m_cacheDirectory);
     if (cacheDir.exists()) {
-        QStringList files = cacheDir.entryList(QDir::Files);
+        const QStringList files = cacheDir.entryList(QDir::Files);
         for (const QString &file : files) {
             cacheDir.remove(file);
         }
+        // 分片子目录
+        const QStringList shards = cacheDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+        for (const QString &shard : shards) {
+            QDir(cacheDir.absoluteFilePath(shard)).removeRecursively();
+        }
     }
+    m_diskIndex->clear();
+    m_mappedImages->clear();
     
     emit cacheCleared();
 }
@@ -217,40 +643,89 @@ void CacheManager::clearAllCache()
 
 int CacheManager::getMemoryCacheSize() const
 {
-    return m_currentMemorySize / (1024 * 1024); // 返回MB
+    QMutexLocker locker(&m_memoryCacheMutex);
+    return int(m_currentMemorySize / (1024 * 1024)); // 返回MB
 }
 
 qint64 CacheManager::getDiskCacheSize() const
 {
-    qint64 totalSize = 0;
-    QDir cacheDir(m_cacheDirectory);
+    // 索引建立之前只包含已记录的写入，由 isDiskUsagePending() 标明
+    return m_diskIndex->totalSize() / (1024 * 1024); // 返回MB
+}
+
+bool CacheManager::isDiskUsagePending() const
+{
+    return !m_diskIndex->isReady();
+}
+
+CacheStatistics CacheManager::getStatistics() const
+{
+    CacheStatistics stats;
     
-    if (cacheDir.exists()) {
-        QFileInfoList files = cacheDir.entryInfoList(QDir::Files);
-        for (const QFileInfo &fileInfo : files) {
-            totalSize += fileInfo.size();
-        }
+    {
+        QMutexLocker locker(&m_memoryCacheMutex);
+        stats.memoryCacheCount = m_pixmapCache.size() + m_dataCache.size();
+        stats.memoryCacheSize = m_currentMemorySize;
+        stats.memoryCacheLimit = m_evictionPolicy->capacity();
+        stats.decodedCacheSize = m_decodedMemorySize;
+        stats.memoryPressureStep = m_pressureStep;
+        stats.evictionPolicy = m_evictionPolicy->name();
     }
     
-    return totalSize / (1024 * 1024); // 返回MB
+    // 不在调用线程遍历目录：索引建立之前返回当前的累计值并标记为未完成
+    stats.diskCacheCount = m_diskIndex->count();
+    stats.diskCacheSize = m_diskIndex->totalSize();
+    stats.diskUsagePending = !m_diskIndex->isReady();
+    
+    stats.memory = m_memoryCounters.snapshot();
+    stats.disk = m_diskCounters.snapshot();
+    stats.diskReadLatency = m_diskReadLatency.snapshot();
+    stats.diskWriteLatency = m_diskWriteLatency.snapshot();
+    stats.hitCount = stats.memory.hits + stats.disk.hits;
+    stats.missCount = stats.memory.misses + stats.disk.misses;
+    stats.uptimeMs = m_statisticsTimer.elapsed();
+    
+    return stats;
+}
+
+bool CacheManager::exportStatistics(const QString &filePath) const
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Failed to export cache statistics:" << filePath;
+        return false;
+    }
+    
+    file.write(QJsonDocument(getStatistics().toJson()).toJson(QJsonDocument::Indented));
+    return true;
+}
+
+void CacheManager::resetStatistics()
+{
+    m_memoryCounters.reset();
+    m_diskCounters.reset();
+    m_diskReadLatency.reset();
+    m_diskWriteLatency.reset();
+    m_statisticsTimer.restart();
 }
 
 int CacheManager::getPixmapCacheCount() const
 {
-    QMutexLocker locker(&m_pixmapCacheMutex);
+    QMutexLocker locker(&m_memoryCacheMutex);
     return m_pixmapCache.size();
 }
 
 int CacheManager::getDataCacheCount() const
 {
-    QMutexLocker locker(&m_dataCacheMutex);
+    QMutexLocker locker(&m_memoryCacheMutex);
     return m_dataCache.size();
 }
 
 void CacheManager::setMaxMemoryCacheSize(int sizeMB)
 {
+    QMutexLocker locker(&m_memoryCacheMutex);
     m_maxMemoryCacheSize = sizeMB;
-    enforceMemoryLimit();
+    enforcePressureLimitsLocked();
 }
 
 void CacheManager::setMaxDiskCacheSize(qint64 sizeMB)
@@ -261,41 +736,190 @@ void CacheManager::setMaxDiskCacheSize(qint64 sizeMB)
 
 void CacheManager::setCacheDirectory(const QString &path)
 {
+    const bool changed = (path != m_cacheDirectory);
     m_cacheDirectory = path;
     ensureCacheDirectory();
+    if (!changed) {
+        return;
+    }
+    QMetaObject::invokeMethod(m_diskIndex, "rebuild", Qt::QueuedConnection,
+                              Q_ARG(QString, m_cacheDirectory));
 }
 
-void CacheManager::cleanupExpiredCache()
+void CacheManager::setEvictionPolicy(EvictionPolicy policy)
+{
+    QMutexLocker locker(&m_memoryCacheMutex);
+    if (policy == m_evictionPolicyType) {
+        return;
+    }
+    
+    // 新策略没有历史频率，按现有条目重新插入
+    CacheEvictionPolicy *newPolicy = createPolicy(policy);
+    newPolicy->setCapacity(m_evictionPolicy->capacity());
+    
+    QStringList evictedKeys;
+    for (auto it = m_pixmapCache.constBegin(); it != m_pixmapCache.constEnd(); ++it) {
+        evictedKeys += newPolicy->insert(PIXMAP_KEY_PREFIX + it.key(), pixmapCost(it.value()));
+    }
+    for (auto it = m_dataCache.constBegin(); it != m_dataCache.constEnd(); ++it) {
+        evictedKeys += newPolicy->insert(DATA_KEY_PREFIX + it.key(), it.value().size());
+    }
+    
+    delete m_evictionPolicy;
+    m_evictionPolicy = newPolicy;
+    m_evictionPolicyType = policy;
+    applyEvictions(evictedKeys);
+}
+
+CacheManager::EvictionPolicy CacheManager::evictionPolicy() const
+{
+    return m_evictionPolicyType;
+}
+
+void CacheManager::setAdaptToMemoryPressure(bool enabled)
 {
-    // 清理超过24小时的内存缓存
-    qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
-    qint64 expireTime = 24 * 60 * 60 * 1000; // 24小时
+    m_adaptToMemoryPressure = enabled;
     
-    QStringList expiredKeys;
-    for (auto it = m_cacheTimestamps.begin(); it != m_cacheTimestamps.end(); ++it) {
-        if (currentTime - it.value() > expireTime) {
-            expiredKeys.append(it.key());
+    if (enabled) {
+        if (!m_pressureMonitor->isRunning()) {
+            m_pressureMonitor->start();
         }
+    } else {
+        m_pressureMonitor->stop();
+        
+        // 关闭后恢复设定的容量
+        QMutexLocker locker(&m_memoryCacheMutex);
+        if (m_pressureStep != 0) {
+            m_pressureStep = 0;
+            m_relaxedSamples = 0;
+            enforcePressureLimitsLocked();
+            locker.unlock();
+            emit memoryPressureStepChanged(0);
+        }
+    }
+}
+
+bool CacheManager::isAdaptingToMemoryPressure() const
+{
+    return m_adaptToMemoryPressure;
+}
+
+void CacheManager::applyMemoryPressure(MemoryPressureMonitor::PressureLevel level)
+{
+    QMutexLocker locker(&m_memoryCacheMutex);
+    
+    int step = m_pressureStep;
+    switch (level) {
+        case MemoryPressureMonitor::CriticalPressure:
+            // 严重时直接丢弃全部解码图片，之后继续逐级缩减
+            step = qMax(step + 1, CRITICAL_PRESSURE_STEP);
+            m_relaxedSamples = 0;
+            break;
+        case MemoryPressureMonitor::ModeratePressure:
+            step = step + 1;
+            m_relaxedSamples = 0;
+            break;
+        case MemoryPressureMonitor::NoPressure:
+            // 压力消失后缓慢恢复，避免在阈值附近来回抖动
+            if (step > 0 && ++m_relaxedSamples >= RELAX_SAMPLES) {
+                --step;
+                m_relaxedSamples = 0;
+            }
+            break;
     }
+    step = qBound(0, step, PRESSURE_STEP_COUNT - 1);
     
-    for (const QString &key : expiredKeys) {
-        removeCachedPixmap(key);
-        removeCachedData(key);
+    if (step == m_pressureStep) {
+        return;
     }
     
-    // 清理磁盘上的旧文件
-    cleanupOldFiles();
+    m_pressureStep = step;
+    enforcePressureLimitsLocked();
+    locker.unlock();
+    
+    emit memoryPressureStepChanged(step);
+}
+
+int CacheManager::memoryPressureStep() const
+{
+    QMutexLocker locker(&m_memoryCacheMutex);
+    return m_pressureStep;
+}
+
+MemoryPressureMonitor *CacheManager::memoryPressureMonitor() const
+{
+    return m_pressureMonitor;
+}
+
+void CacheManager::onMemorySampled(const MemorySample &sample, MemoryPressureMonitor::PressureLevel level)
+{
+    Q_UNUSED(sample)
+    
+    if (m_adaptToMemoryPressure) {
+        applyMemoryPressure(level);
+    }
+}
+
+void CacheManager::cleanupExpiredCache()
+{
+    onCleanupTimer();
+    
+    // 磁盘条目：在I/O线程上由磁盘索引处理
+    QMetaObject::invokeMethod(m_diskIndex, "expireNow", Qt::QueuedConnection);
 }
 
 void CacheManager::setAutoCleanupInterval(int minutes)
 {
-    m_autoCleanupInterval = minutes;
-    m_cleanupTimer->setInterval(minutes * 60 * 1000);
+    m_autoCleanupInterval = qMax(1, minutes);
+    QMetaObject::invokeMethod(m_diskIndex, "startExpiryTimer", Qt::QueuedConnection,
+                              Q_ARG(int, m_autoCleanupInterval * 60 * 1000));
+}
+
+void CacheManager::setMemoryEntryTtl(int seconds)
+{
+    QMutexLocker locker(&m_memoryCacheMutex);
+    // 只影响之后插入的条目
+    m_memoryTtlMs = seconds > 0 ? seconds * 1000LL : DEFAULT_MEMORY_TTL_MS;
+}
+
+int CacheManager::memoryEntryTtl() const
+{
+    QMutexLocker locker(&m_memoryCacheMutex);
+    return int(m_memoryTtlMs / 1000);
+}
+
+void CacheManager::setDiskCacheMaxAge(int days)
+{
+    days = qMax(1, days);
+    if (days == m_diskMaxAgeDays) {
+        return;
+    }
+    
+    m_diskMaxAgeDays = days;
+    // 索引按写入时间重新计算已有条目的到期时间，单独指定TTL的条目不受影响；
+    // 缩短保留时间后已经到期的文件在I/O线程立即清理
+    m_diskIndex->setDefaultTtl(days * MS_PER_DAY);
+    QMetaObject::invokeMethod(m_diskIndex, "expireNow", Qt::QueuedConnection);
+}
+
+int CacheManager::diskCacheMaxAge() const
+{
+    return m_diskMaxAgeDays;
+}
+
+DiskCacheIndex *CacheManager::diskIndex() const
+{
+    return m_diskIndex;
 }
 
 void CacheManager::onCleanupTimer()
 {
-    cleanupExpiredCache();
+    // 推进内存时间轮，只处理到期的条目
+    QMutexLocker locker(&m_memoryCacheMutex);
+    const QStringList expiredKeys = m_memoryExpiry.advance(QDateTime::currentMSecsSinceEpoch());
+    for (const QString &policyKey : expiredKeys) {
+        removeEntryLocked(policyKey, true);
+    }
 }
 
 void CacheManager::ensureCacheDirectory()
@@ -306,73 +930,247 @@ void CacheManager::ensureCacheDirectory()
     }
 }
 
-void CacheManager::cleanupOldFiles()
+void CacheManager::enforceMemoryLimit()
 {
-    QDir cacheDir(m_cacheDirectory);
-    if (!cacheDir.exists()) return;
+    // 调用方需持有 m_memoryCacheMutex
+    applyEvictions(m_evictionPolicy->evictToCapacity());
     
-    QDateTime cutoffTime = QDateTime::currentDateTime().addDays(-7); // 7天前
-    QFileInfoList files = cacheDir.entryInfoList(QDir::Files);
+    if (m_currentMemorySize > m_evictionPolicy->capacity()) {
+        emit cacheSizeLimitReached();
+    }
+}
+
+void CacheManager::enforcePressureLimitsLocked()
+{
+    // 调用方需持有 m_memoryCacheMutex
+    m_evictionPolicy->setCapacity(memoryLimitLocked());
+    enforceMemoryLimit();
     
-    for (const QFileInfo &fileInfo : files) {
-        if (fileInfo.lastModified() < cutoffTime) {
-            QFile::remove(fileInfo.absoluteFilePath());
-        }
+    const qint64 decodedLimit = decodedLimitLocked();
+    if (m_decodedMemorySize > decodedLimit) {
+        applyEvictions(m_evictionPolicy->evictMatching(m_decodedMemorySize - decodedLimit, isPixmapPolicyKey));
     }
 }
 
-void CacheManager::enforceMemoryLimit()
+qint64 CacheManager::memoryLimitLocked() const
+{
+    return qint64(m_maxMemoryCacheSize) * 1024 * 1024 * TOTAL_LIMIT_PERCENT[m_pressureStep] / 100;
+}
+
+qint64 CacheManager::decodedLimitLocked() const
 {
-    int maxSizeBytes = m_maxMemoryCacheSize * 1024 * 1024;
+    return qint64(m_maxMemoryCacheSize) * 1024 * 1024 * DECODED_LIMIT_PERCENT[m_pressureStep] / 100;
+}
+
+qint64 CacheManager::reclaimMemory(qint64 bytes)
+{
+    // 由 MemoryGovernor 调用：先回收解码图片（可以从压缩数据重新解码），不够再回收其他条目
+    QMutexLocker locker(&m_memoryCacheMutex);
+    const qint64 before = m_currentMemorySize;
     
-    while (m_currentMemorySize > maxSizeBytes && (!m_pixmapCache.isEmpty() || !m_dataCache.isEmpty())) {
-        // 找到最旧的缓存项并移除
-        QString oldestKey;
-        qint64 oldestTime = QDateTime::currentMSecsSinceEpoch();
-        
-        for (auto it = m_cacheTimestamps.begin(); it != m_cacheTimestamps.end(); ++it) {
-            if (it.value() < oldestTime) {
-                oldestTime = it.value();
-                oldestKey = it.key();
-            }
+    applyEvictions(m_evictionPolicy->evictMatching(bytes, isPixmapPolicyKey));
+    const qint64 remaining = bytes - (before - m_currentMemorySize);
+    if (remaining > 0) {
+        applyEvictions(m_evictionPolicy->evictMatching(remaining, [](const QString &) { return true; }));
+    }
+    
+    return before - m_currentMemorySize;
+}
+
+void CacheManager::applyEvictions(const QStringList &evictedKeys)
+{
+    for (const QString &policyKey : evictedKeys) {
+        removeEntryLocked(policyKey, true);
+    }
+}
+
+void CacheManager::releasePixmapLocked(QPixmap &pixmap)
+{
+    // 调用方需持有 m_memoryCacheMutex
+    // MemoryGovernor 和 cacheData() 可能在工作线程中触发淘汰或替换，而 QPixmap 只能在GUI线程释放：
+    // 移出（不复制，也不经过 QPixmap 的线程检查）后交给GUI线程
+    if (QThread::currentThread() != thread()) {
+        if (m_pixmapsToRelease.isEmpty()) {
+            QMetaObject::invokeMethod(this, [this]() { releaseEvictedPixmaps(); }, Qt::QueuedConnection);
         }
-        
-        if (!oldestKey.isEmpty()) {
-            removeCachedPixmap(oldestKey);
-            removeCachedData(oldestKey);
-        } else {
-            break;
+        m_pixmapsToRelease.append(std::move(pixmap));
+    }
+}
+
+void CacheManager::removeEntryLocked(const QString &policyKey, bool evicted)
+{
+    // 调用方需持有 m_memoryCacheMutex
+    bool removed = false;
+    if (policyKey.startsWith(PIXMAP_KEY_PREFIX)) {
+        auto it = m_pixmapCache.find(policyKey.mid(PIXMAP_KEY_PREFIX.size()));
+        if (it != m_pixmapCache.end()) {
+            m_currentMemorySize -= pixmapCost(it.value());
+            m_decodedMemorySize -= pixmapCost(it.value());
+            releasePixmapLocked(it.value());
+            m_pixmapCache.erase(it);
+            removed = true;
+        }
+    } else {
+        auto it = m_dataCache.find(policyKey.mid(DATA_KEY_PREFIX.size()));
+        if (it != m_dataCache.end()) {
+            m_currentMemorySize -= it.value().size();
+            m_dataCache.erase(it);
+            removed = true;
         }
     }
     
-    if (m_currentMemorySize > maxSizeBytes) {
-        emit cacheSizeLimitReached();
+    const bool unused = m_unusedEntries.remove(policyKey);
+    if (removed && evicted) {
+        m_memoryCounters.recordEviction(unused);
+    }
+    
+    m_memoryExpiry.cancel(policyKey);
+    m_evictionPolicy->remove(policyKey);
+    
+    if (removed) {
+        MemoryGovernor::instance()->updateUsage(m_governorId, m_currentMemorySize);
     }
 }
 
+void CacheManager::releaseEvictedPixmaps()
+{
+    QVector<QPixmap> released;
+    {
+        QMutexLocker locker(&m_memoryCacheMutex);
+        released.swap(m_pixmapsToRelease);
+    }
+    // released 在GUI线程析构
+}
+
+void CacheManager::recordTrace(char op, const QString &policyKey, qint64 bytes) const
+{
+    if (!m_traceFile) {
+        return;
+    }
+    
+    // 只记录键的哈希，轨迹中不出现文件路径
+    const QByteArray line = QByteArray(1, op) + ' '
+        + QByteArray::number(FrequencySketch::hashKey(policyKey), 16) + ' '
+        + QByteArray::number(bytes) + '\n';
+    m_traceFile->write(line);
+}
+
+CacheEvictionPolicy *CacheManager::createPolicy(EvictionPolicy policy)
+{
+    if (policy == LruPolicy) {
+        return new LruEvictionPolicy();
+    }
+    return new TinyLfuEvictionPolicy();
+}
+
+qint64 CacheManager::pixmapCost(const QPixmap &pixmap)
+{
+    return qint64(pixmap.width()) * pixmap.height() * 4; // 假设32位色深
+}
+
 void CacheManager::enforceDiskLimit()
 {
-    qint64 maxSizeBytes = m_maxDiskCacheSize * 1024 * 1024;
-    qint64 currentSize = getDiskCacheSize() * 1024 * 1024;
+    // 索引建立之前不淘汰，建立完成后由 rebuilt 信号再次触发
+    if (!m_diskIndex->isReady()) {
+        return;
+    }
     
-    if (currentSize > maxSizeBytes) {
-        // 删除最旧的文件直到符合限制
-        QDir cacheDir(m_cacheDirectory);
-        QFileInfoList files = cacheDir.entryInfoList(QDir::Files, QDir::Time);
-        
-        for (const QFileInfo &fileInfo : files) {
-            if (currentSize <= maxSizeBytes) break;
-            
-            currentSize -= fileInfo.size();
-            QFile::remove(fileInfo.absoluteFilePath());
+    // 按写入顺序淘汰最早的文件
+    const qint64 maxSizeBytes = m_maxDiskCacheSize * 1024 * 1024;
+    const qint64 excess = m_diskIndex->totalSize() - maxSizeBytes;
+    if (excess > 0) {
+        // 取出的文件已不在索引中，删除交给I/O线程，GUI线程不等待磁盘
+        const QStringList oldest = m_diskIndex->takeOldest(excess);
+        for (int i = 0; i < oldest.size(); ++i) {
+            m_diskCounters.recordEviction();
+        }
+        if (!oldest.isEmpty()) {
+            QMetaObject::invokeMethod(m_diskIndex, "removeFiles", Qt::QueuedConnection,
+                                      Q_ARG(QStringList, oldest));
         }
     }
 }
 
 QString CacheManager::generateCacheFileName(const QString &key) const
 {
-    // 使用MD5哈希生成文件名，避免特殊字符问题
-    QCryptographicHash hash(QCryptographicHash::Md5);
-    hash.addData(key.toUtf8());
-    return hash.result().toHex() + ".cache";
+    // 非加密的128位哈希，避免特殊字符问题；按哈希分片到两级子目录
+    const QString hashHex = MurmurHash3::hash128(key.toUtf8()).toHex();
+    return shardedFileName(hashHex, hashHex + QStringLiteral(".cache"));
+}
+
+QString CacheManager::generateCacheFileName(const CacheKey &key) const
+{
+    // 键哈希已在构造时算好；文件名以归档哈希开头，分片按键哈希保证均匀
+    return shardedFileName(key.hash().toHex(), key.fileName());
+}
+
+QByteArray CacheManager::encodeDiskEntry(const QByteArray &data, DiskContentType type) const
+{
+    if (type == AutoDetect) {
+        type = CacheCompressor::isAlreadyCompressed(data) ? EncodedImage : Metadata;
+    }
+    
+    // 已编码的图片再压缩几乎没有收益，只会浪费CPU
+    QByteArray payload;
+    quint8 codec = CodecStored;
+    if (m_compressionEnabled && type != EncodedImage) {
+        payload = CacheCompressor::compress(data);
+        if (!payload.isEmpty()) {
+            codec = CodecLZ4;
+        }
+    }
+    
+    const QByteArray &body = (codec == CodecStored) ? data : payload;
+    
+    QByteArray entry;
+    entry.reserve(DISK_ENTRY_HEADER_SIZE + body.size());
+    entry.append(DISK_ENTRY_MAGIC, sizeof(DISK_ENTRY_MAGIC));
+    entry.append(char(DISK_ENTRY_VERSION));
+    entry.append(char(codec));
+    entry.append(char(type));
+    entry.append(char(0));
+    
+    uchar rawSize[4];
+    qToLittleEndian<quint32>(quint32(data.size()), rawSize);
+    entry.append(reinterpret_cast<const char *>(rawSize), sizeof(rawSize));
+    entry.append(body);
+    
+    return entry;
+}
+
+QByteArray CacheManager::decodeDiskEntry(const QByteArray &entry)
+{
+    // 没有条目头的旧缓存文件按原始数据返回
+    if (entry.size() < DISK_ENTRY_HEADER_SIZE
+        || memcmp(entry.constData(), DISK_ENTRY_MAGIC, sizeof(DISK_ENTRY_MAGIC)) != 0) {
+        return entry;
+    }
+    
+    const quint8 version = quint8(entry.at(4));
+    const quint8 codec = quint8(entry.at(5));
+    const quint32 rawSize = qFromLittleEndian<quint32>(
+        reinterpret_cast<const uchar *>(entry.constData()) + 8);
+    
+    if (version != DISK_ENTRY_VERSION) {
+        qWarning() << "Unsupported cache entry version:" << version;
+        return QByteArray();
+    }
+    
+    switch (codec) {
+        case CodecStored:
+            return entry.mid(DISK_ENTRY_HEADER_SIZE);
+        case CodecLZ4: {
+            // 压缩体只在解压期间使用，不必复制
+            const QByteArray body = QByteArray::fromRawData(entry.constData() + DISK_ENTRY_HEADER_SIZE,
+                                                            entry.size() - DISK_ENTRY_HEADER_SIZE);
+            QByteArray data = CacheCompressor::decompress(body, int(rawSize));
+            if (data.isEmpty()) {
+                qWarning() << "Corrupted compressed cache entry";
+            }
+            return data;
+        }
+        default:
+            qWarning() << "Unknown cache entry codec:" << codec;
+            return QByteArray();
+    }
 }
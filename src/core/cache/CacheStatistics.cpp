@@ -0,0 +1,113 @@
+#include "core/cache/CacheStatistics.h"
+
+// ==================== CacheTierStatistics ====================
+
+double CacheTierStatistics::hitRatio() const
+{
+    const qint64 lookups = hits + misses;
+    return lookups > 0 ? double(hits) / lookups : 0.0;
+}
+
+QJsonObject CacheTierStatistics::toJson() const
+{
+    QJsonObject json;
+    json["hits"] = hits;
+    json["misses"] = misses;
+    json["hitRatio"] = hitRatio();
+    json["insertions"] = insertions;
+    json["evictions"] = evictions;
+    json["unusedEvictions"] = unusedEvictions;
+    json["bytesIn"] = bytesIn;
+    json["bytesOut"] = bytesOut;
+    return json;
+}
+
+// ==================== CacheTierCounters ====================
+
+CacheTierCounters::CacheTierCounters()
+    : m_hits(0)
+    , m_misses(0)
+    , m_insertions(0)
+    , m_evictions(0)
+    , m_unusedEvictions(0)
+    , m_bytesIn(0)
+    , m_bytesOut(0)
+{
+}
+
+void CacheTierCounters::recordHit(qint64 bytes)
+{
+    m_hits.fetchAndAddRelaxed(1);
+    m_bytesOut.fetchAndAddRelaxed(bytes);
+}
+
+void CacheTierCounters::recordMiss()
+{
+    m_misses.fetchAndAddRelaxed(1);
+}
+
+void CacheTierCounters::recordInsertion(qint64 bytes)
+{
+    m_insertions.fetchAndAddRelaxed(1);
+    m_bytesIn.fetchAndAddRelaxed(bytes);
+}
+
+void CacheTierCounters::recordEviction(bool unused)
+{
+    m_evictions.fetchAndAddRelaxed(1);
+    if (unused) {
+        m_unusedEvictions.fetchAndAddRelaxed(1);
+    }
+}
+
+void CacheTierCounters::reset()
+{
+    m_hits.storeRelaxed(0);
+    m_misses.storeRelaxed(0);
+    m_insertions.storeRelaxed(0);
+    m_evictions.storeRelaxed(0);
+    m_unusedEvictions.storeRelaxed(0);
+    m_bytesIn.storeRelaxed(0);
+    m_bytesOut.storeRelaxed(0);
+}
+
+CacheTierStatistics CacheTierCounters::snapshot() const
+{
+    CacheTierStatistics result;
+    result.hits = m_hits.loadRelaxed();
+    result.misses = m_misses.loadRelaxed();
+    result.insertions = m_insertions.loadRelaxed();
+    result.evictions = m_evictions.loadRelaxed();
+    result.unusedEvictions = m_unusedEvictions.loadRelaxed();
+    result.bytesIn = m_bytesIn.loadRelaxed();
+    result.bytesOut = m_bytesOut.loadRelaxed();
+    return result;
+}
+
+// ==================== CacheStatistics ====================
+
+QJsonObject CacheStatistics::toJson() const
+{
+    QJsonObject memoryJson = memory.toJson();
+    memoryJson["entries"] = memoryCacheCount;
+    memoryJson["sizeBytes"] = memoryCacheSize;
+    memoryJson["limitBytes"] = memoryCacheLimit;
+    memoryJson["decodedBytes"] = decodedCacheSize;
+    memoryJson["pressureStep"] = memoryPressureStep;
+    memoryJson["evictionPolicy"] = evictionPolicy;
+
+    QJsonObject diskJson = disk.toJson();
+    diskJson["entries"] = diskCacheCount;
+    diskJson["sizeBytes"] = diskCacheSize;
+    diskJson["pending"] = diskUsagePending;
+    diskJson["readLatency"] = diskReadLatency.toJson();
+    diskJson["writeLatency"] = diskWriteLatency.toJson();
+
+    QJsonObject json;
+    json["uptimeMs"] = uptimeMs;
+    json["hitCount"] = hitCount;
+    json["missCount"] = missCount;
+    json["memory"] = memoryJson;
+    json["disk"] = diskJson;
+    return json;
+}
@@ -0,0 +1,233 @@
+#include "core/cache/CacheWarmup.h"
+#include "core/CacheManager.h"
+#include "core/ComicParser.h"
+#include "core/config/ConfigManager.h"
+#include "core/bookmark/BookmarkManager.h"
+#include <QThread>
+#include <QSet>
+#include <QDebug>
+
+CacheWarmup* CacheWarmup::m_instance = nullptr;
+
+CacheWarmup* CacheWarmup::instance()
+{
+    if (!m_instance) {
+        m_instance = new CacheWarmup();
+    }
+    return m_instance;
+}
+
+CacheWarmup::CacheWarmup(QObject *parent)
+    : QObject(parent)
+    , m_thread(nullptr)
+    , m_cancelled(0)
+    , m_pagesWarmed(0)
+    , m_pagesBefore(1)
+    , m_pagesAfter(2)
+{
+}
+
+CacheWarmup::~CacheWarmup()
+{
+    cancel();
+    if (m_thread) {
+        m_thread->wait();
+    }
+}
+
+QList<WarmupTarget> CacheWarmup::collectTargets(const QStringList &recentFiles,
+                                                const QList<ReadingProgress> &recentProgress,
+                                                int maxComics)
+{
+    QList<WarmupTarget> targets;
+    QSet<QString> seen;
+    
+    // 有阅读进度的漫画优先，从上次阅读的页面开始
+    for (const ReadingProgress &progress : recentProgress) {
+        if (targets.size() >= maxComics) {
+            return targets;
+        }
+        if (progress.comicPath.isEmpty() || seen.contains(progress.comicPath)) {
+            continue;
+        }
+        seen.insert(progress.comicPath);    // 已读完的漫画也不再从最近文件中选出
+        if (progress.isCompleted) {
+            continue;
+        }
+        
+        WarmupTarget target;
+        target.comicPath = progress.comicPath;
+        target.page = qMax(0, progress.currentPage);
+        targets.append(target);
+    }
+    
+    // 其余最近打开的文件从第一页开始
+    for (const QString &filePath : recentFiles) {
+        if (targets.size() >= maxComics) {
+            break;
+        }
+        if (filePath.isEmpty() || seen.contains(filePath)) {
+            continue;
+        }
+        seen.insert(filePath);
+        
+        WarmupTarget target;
+        target.comicPath = filePath;
+        targets.append(target);
+    }
+    
+    return targets;
+}
+
+QString CacheWarmup::rawPageVariant()
+{
+    return QStringLiteral("raw");
+}
+
+QString CacheWarmup::pageVariant()
+{
+    return QStringLiteral("page");
+}
+
+void CacheWarmup::start(int maxComics)
+{
+    const QStringList recentFiles = ConfigManager::instance()->getRecentFiles();
+    const QList<ReadingProgress> recentProgress = BookmarkManager::instance()->getRecentReadingProgress(maxComics * 2);
+    start(collectTargets(recentFiles, recentProgress, maxComics));
+}
+
+void CacheWarmup::start(const QList<WarmupTarget> &targets)
+{
+    cancel();
+    if (targets.isEmpty()) {
+        emit finished(0);
+        return;
+    }
+    
+    // 上一次的线程仍在收尾时等它结束，之后才能复用取消标志
+    if (m_thread) {
+        m_thread->wait();
+    }
+    
+    m_cancelled.storeRelaxed(0);
+    m_pagesWarmed.storeRelaxed(0);
+    
+    QThread *thread = QThread::create([this, targets]() { run(targets); });
+    thread->setObjectName("CacheWarmup");
+    m_thread = thread;
+    
+    connect(thread, &QThread::finished, this, [this, thread]() {
+        thread->deleteLater();
+        if (m_thread != thread) {
+            return; // 已被新的预热取代
+        }
+        m_thread = nullptr;
+        
+        if (m_cancelled.loadRelaxed()) {
+            emit cancelled();
+        } else {
+            emit finished(m_pagesWarmed.loadRelaxed());
+        }
+    });
+    
+    thread->start(QThread::LowestPriority);
+}
+
+void CacheWarmup::cancel()
+{
+    // 不等待线程：正在处理的页面完成后线程自行退出
+    m_cancelled.storeRelaxed(1);
+}
+
+bool CacheWarmup::isRunning() const
+{
+    return m_thread && m_thread->isRunning();
+}
+
+void CacheWarmup::setNeighbourRange(int before, int after)
+{
+    m_pagesBefore = qMax(0, before);
+    m_pagesAfter = qMax(0, after);
+}
+
+void CacheWarmup::run(const QList<WarmupTarget> &targets)
+{
+    for (int i = 0; i < targets.size(); ++i) {
+        if (m_cancelled.loadRelaxed()) {
+            return;
+        }
+        // 只有最近阅读的那本解码当前页，其余只缓存原始数据
+        warmComic(targets.at(i), i == 0);
+    }
+}
+
+bool CacheWarmup::warmComic(const WarmupTarget &target, bool decodeCurrentPage)
+{
+    const ArchiveFingerprint fingerprint = ArchiveFingerprint::fromFile(target.comicPath);
+    if (!fingerprint.isValid()) {
+        return false; // 文件已被移动或删除
+    }
+    
+    ComicParser parser;
+    if (!parser.parseComic(target.comicPath)) {
+        qWarning() << "Cache warm-up failed to open:" << target.comicPath;
+        return false;
+    }
+    
+    const int pageCount = parser.getComicInfo().pageCount;
+    const int current = qBound(0, target.page, pageCount - 1);
+    
+    // 先当前页，再往后，最后往前
+    QList<int> pages;
+    pages.append(current);
+    for (int i = 1; i <= m_pagesAfter && current + i < pageCount; ++i) {
+        pages.append(current + i);
+    }
+    for (int i = 1; i <= m_pagesBefore && current - i >= 0; ++i) {
+        pages.append(current - i);
+    }
+    
+    CacheManager *cache = CacheManager::instance();
+    for (int page : pages) {
+        if (m_cancelled.loadRelaxed()) {
+            return false;
+        }
+        
+        const CacheKey rawKey(target.comicPath, fingerprint, page, rawPageVariant());
+        QByteArray data = cache->getCachedData(rawKey);
+        if (data.isEmpty()) {
+            data = cache->loadFromDisk(rawKey);
+        }
+        if (data.isEmpty()) {
+            data = parser.getPageData(page);
+            if (data.isEmpty()) {
+                continue;
+            }
+            cache->saveToDisk(rawKey, data, CacheManager::EncodedImage);
+        }
+        cache->cacheData(rawKey, data);
+        
+        if (decodeCurrentPage && page == current) {
+            // 上次写入磁盘的解码页面不必重新解码
+            const CacheKey pageKey(target.comicPath, fingerprint, page, pageVariant());
+            QImage image;
+            if (!cache->existsOnDisk(pageKey) && image.loadFromData(data)) {
+                storeDecodedPage(pageKey, image);
+            }
+        }
+        
+        m_pagesWarmed.fetchAndAddRelaxed(1);
+        emit pageWarmed(target.comicPath, page);
+    }
+    
+    return true;
+}
+
+void CacheWarmup::storeDecodedPage(const CacheKey &key, const QImage &image)
+{
+    // 与 PagePipeline 解码结果的格式一致，阅读器取出后直接映射、缩放，不必再转换；
+    // 只写入压缩的磁盘缓存：映射存储在重启后为空，阅读器取页时从这里重新映射
+    const QImage::Format format = image.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied
+                                                          : QImage::Format_RGB32;
+    CacheManager::instance()->saveImageToDisk(key, image.convertToFormat(format));
+}
@@ -0,0 +1,295 @@
+#include "core/cache/DiskCacheIndex.h"
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <algorithm>
+
+namespace {
+
+const qint64 DEFAULT_TTL_MS = 7LL * 24 * 60 * 60 * 1000;   // 7天
+
+struct ScannedFile {
+    QString fileName;
+    qint64 size;
+    qint64 modifiedMs;
+};
+
+} // namespace
+
+DiskCacheIndex::DiskCacheIndex(QObject *parent)
+    : QObject(parent)
+    , m_expiry(QDateTime::currentMSecsSinceEpoch())
+    , m_totalSize(0)
+    , m_defaultTtlMs(DEFAULT_TTL_MS)
+    , m_ready(false)
+    , m_expiryTimer(nullptr)
+{
+}
+
+void DiskCacheIndex::recordWrite(const QString &fileName, qint64 size, qint64 ttlMs)
+{
+    QMutexLocker locker(&m_mutex);
+    insertLocked(fileName, size, QDateTime::currentMSecsSinceEpoch(), ttlMs);
+}
+
+void DiskCacheIndex::recordRemove(const QString &fileName)
+{
+    QMutexLocker locker(&m_mutex);
+    removeLocked(fileName);
+}
+
+void DiskCacheIndex::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_entries.clear();
+    m_writeOrder.clear();
+    m_expiry.clear();
+    m_totalSize = 0;
+}
+
+QStringList DiskCacheIndex::takeOldest(qint64 bytesToFree)
+{
+    QMutexLocker locker(&m_mutex);
+
+    QStringList taken;
+    qint64 freed = 0;
+    while (freed < bytesToFree && !m_writeOrder.empty()) {
+        const QString fileName = m_writeOrder.front();
+        freed += m_entries.value(fileName).size;
+        removeLocked(fileName);
+        taken.append(fileName);
+    }
+    return taken;
+}
+
+QStringList DiskCacheIndex::takeMatching(const QString &baseNamePrefix)
+{
+    QMutexLocker locker(&m_mutex);
+
+    QStringList taken;
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+        const QString &fileName = it.key();
+        const int slash = fileName.lastIndexOf(QLatin1Char('/'));
+        if (QStringView(fileName).mid(slash + 1).startsWith(baseNamePrefix)) {
+            taken.append(fileName);
+        }
+    }
+    for (const QString &fileName : taken) {
+        removeLocked(fileName);
+    }
+    return taken;
+}
+
+bool DiskCacheIndex::isReady() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_ready;
+}
+
+bool DiskCacheIndex::contains(const QString &fileName) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_entries.contains(fileName);
+}
+
+qint64 DiskCacheIndex::totalSize() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_totalSize;
+}
+
+int DiskCacheIndex::count() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_entries.size();
+}
+
+void DiskCacheIndex::setDefaultTtl(qint64 ttlMs)
+{
+    QMutexLocker locker(&m_mutex);
+    m_defaultTtlMs = ttlMs > 0 ? ttlMs : DEFAULT_TTL_MS;
+
+    // 单独指定了TTL的条目保持原来的到期时间
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+        if (it->ttlMs <= 0) {
+            m_expiry.schedule(it.key(), it->writtenMs + m_defaultTtlMs);
+        }
+    }
+}
+
+qint64 DiskCacheIndex::defaultTtl() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_defaultTtlMs;
+}
+
+void DiskCacheIndex::rebuild(const QString &directory)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_directory = directory;
+        m_ready = false;
+        m_entries.clear();
+        m_writeOrder.clear();
+        m_expiry.clear();
+        m_totalSize = 0;
+    }
+
+    // 扫描在锁外进行，期间的写入照常记录
+    // 文件名记为相对缓存目录的路径（含分片子目录）
+    QList<ScannedFile> scanned;
+    const QDir root(directory);
+    QDirIterator it(directory, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        const QFileInfo fileInfo = it.fileInfo();
+        scanned.append({root.relativeFilePath(fileInfo.absoluteFilePath()), fileInfo.size(),
+                        fileInfo.lastModified().toMSecsSinceEpoch()});
+    }
+    std::sort(scanned.begin(), scanned.end(), [](const ScannedFile &a, const ScannedFile &b) {
+        return a.modifiedMs < b.modifiedMs;
+    });
+
+    int count = 0;
+    qint64 totalSize = 0;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_directory != directory) {
+            return; // 扫描期间目录又变了，由新的 rebuild 负责
+        }
+
+        // 扫描期间写入的条目比磁盘上已有的新，保持在写入顺序的尾部
+        // （std::list 的 swap/splice 不会使已有迭代器失效）
+        std::list<QString> recentWrites;
+        recentWrites.swap(m_writeOrder);
+
+        // 扫描之后被删除的文件不能再加回索引：删除方先删文件再 recordRemove()，
+        // 持锁检查时文件已不存在，或者删除发生在合并之后、由 recordRemove() 移除
+        for (const ScannedFile &file : scanned) {
+            if (!m_entries.contains(file.fileName) && QFileInfo::exists(root.absoluteFilePath(file.fileName))) {
+                insertLocked(file.fileName, file.size, file.modifiedMs, -1);
+            }
+        }
+        m_writeOrder.splice(m_writeOrder.end(), recentWrites);
+
+        m_ready = true;
+        count = m_entries.size();
+        totalSize = m_totalSize;
+    }
+
+    emit rebuilt(count, totalSize);
+
+    // 已经超过保留时间的文件立即清理
+    expireNow();
+}
+
+void DiskCacheIndex::startExpiryTimer(int intervalMs)
+{
+    if (!m_expiryTimer) {
+        m_expiryTimer = new QTimer(this);
+        m_expiryTimer->setSingleShot(false);
+        connect(m_expiryTimer, &QTimer::timeout, this, &DiskCacheIndex::expireNow);
+    }
+    m_expiryTimer->start(intervalMs);
+}
+
+void DiskCacheIndex::stopExpiryTimer()
+{
+    if (m_expiryTimer) {
+        m_expiryTimer->stop();
+    }
+}
+
+void DiskCacheIndex::expireNow()
+{
+    QString directory;
+    QStringList expired;
+    qint64 bytes = 0;
+
+    {
+        // 锁内只从索引中取出到期的文件，删除在锁外进行，不阻塞其他线程的 recordWrite()
+        QMutexLocker locker(&m_mutex);
+        if (!m_ready) {
+            return;
+        }
+
+        directory = m_directory;
+        const QStringList due = m_expiry.advance(QDateTime::currentMSecsSinceEpoch());
+        for (const QString &fileName : due) {
+            auto it = m_entries.find(fileName);
+            if (it == m_entries.end()) {
+                continue;
+            }
+            bytes += it->size;
+            m_totalSize -= it->size;
+            m_writeOrder.erase(it->order);
+            m_entries.erase(it);
+            expired.append(fileName);
+        }
+    }
+
+    const int count = removeUnindexedFiles(directory, expired);
+    if (count > 0) {
+        emit entriesExpired(count, bytes);
+    }
+}
+
+void DiskCacheIndex::removeFiles(const QStringList &fileNames)
+{
+    QString directory;
+    {
+        QMutexLocker locker(&m_mutex);
+        directory = m_directory;
+    }
+
+    removeUnindexedFiles(directory, fileNames);
+}
+
+int DiskCacheIndex::removeUnindexedFiles(const QString &directory, const QStringList &fileNames)
+{
+    const QDir dir(directory);
+    int removed = 0;
+    for (const QString &fileName : fileNames) {
+        // 取出之后又被重新写入的文件已经回到索引中，不能删除；
+        // 检查和删除之间持有锁，只锁一个文件的时间
+        QMutexLocker locker(&m_mutex);
+        if (m_entries.contains(fileName)) {
+            continue;
+        }
+        if (QFile::remove(dir.absoluteFilePath(fileName))) {
+            ++removed;
+        }
+    }
+    return removed;
+}
+
+void DiskCacheIndex::insertLocked(const QString &fileName, qint64 size, qint64 writtenMs, qint64 ttlMs)
+{
+    removeLocked(fileName);
+
+    m_writeOrder.push_back(fileName);
+    Entry entry;
+    entry.size = size;
+    entry.writtenMs = writtenMs;
+    entry.ttlMs = ttlMs;
+    entry.order = std::prev(m_writeOrder.end());
+    m_entries.insert(fileName, entry);
+    m_totalSize += size;
+    m_expiry.schedule(fileName, writtenMs + (ttlMs > 0 ? ttlMs : m_defaultTtlMs));
+}
+
+void DiskCacheIndex::removeLocked(const QString &fileName)
+{
+    auto it = m_entries.find(fileName);
+    if (it == m_entries.end()) {
+        return;
+    }
+
+    m_totalSize -= it->size;
+    m_writeOrder.erase(it->order);
+    m_entries.erase(it);
+    m_expiry.cancel(fileName);
+}
@@ -0,0 +1,157 @@
+#include "core/cache/FrequencySketch.h"
+#include <QHash>
+#include <algorithm>
+
+namespace {
+
+const int SKETCH_DEPTH = 4;
+const quint64 ROW_SEEDS[SKETCH_DEPTH] = {
+    0xc3a5c85c97cb3127ULL, 0xb492b66fbe98f273ULL,
+    0x9ae16a3b2f90404fULL, 0xcbf29ce484222325ULL
+};
+
+inline quint64 mix64(quint64 x)
+{
+    // splitmix64 终结函数
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+inline quint64 nextPowerOfTwo(quint64 value)
+{
+    quint64 result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+} // namespace
+
+FrequencySketch::FrequencySketch(int expectedEntries)
+    : m_counterMask(0)
+    , m_sampleSize(0)
+    , m_additions(0)
+{
+    ensureCapacity(expectedEntries);
+}
+
+void FrequencySketch::ensureCapacity(int expectedEntries)
+{
+    // 每个条目约4个计数器，至少16个字
+    const quint64 counters = nextPowerOfTwo(quint64(qMax(expectedEntries, 64)) * 4);
+    const size_t words = size_t(counters / 16);
+    if (words == m_table.size()) {
+        return;
+    }
+
+    // 计数器下标是哈希值与掩码相与，表大小都是2的幂：扩大后新下标的低位就是原来的下标，
+    // 直接复制原计数器，所有键的估计频率保持不变；缩小时合并到同一下标的计数器取最大值
+    std::vector<quint64> table(words, 0);
+    if (!m_table.empty()) {
+        const std::vector<quint64> &old = m_table;
+        const quint64 oldMask = m_counterMask;
+        const quint64 newMask = counters - 1;
+        const auto valueAt = [](const std::vector<quint64> &t, quint64 index) {
+            return (t[size_t(index >> 4)] >> ((index & 15) * 4)) & 0xF;
+        };
+        if (newMask > oldMask) {
+            for (quint64 index = 0; index <= newMask; ++index) {
+                table[size_t(index >> 4)] |= valueAt(old, index & oldMask) << ((index & 15) * 4);
+            }
+        } else {
+            for (quint64 index = 0; index <= oldMask; ++index) {
+                const quint64 target = index & newMask;
+                const quint64 value = valueAt(old, index);
+                if (value > valueAt(table, target)) {
+                    quint64 &word = table[size_t(target >> 4)];
+                    word = (word & ~(quint64(0xF) << ((target & 15) * 4))) | (value << ((target & 15) * 4));
+                }
+            }
+        }
+    }
+
+    m_table.swap(table);
+    m_counterMask = counters - 1;
+    m_sampleSize = int(qMin<quint64>(counters * 10 / 4, quint64(1) << 30));
+    m_additions = qMin(m_additions, m_sampleSize - 1);
+}
+
+int FrequencySketch::frequency(const QString &key) const
+{
+    return frequency(hashKey(key));
+}
+
+int FrequencySketch::frequency(quint64 hash) const
+{
+    int result = 15;
+    for (int row = 0; row < SKETCH_DEPTH; ++row) {
+        result = qMin(result, counterValue(counterIndex(hash, row)));
+    }
+    return result;
+}
+
+void FrequencySketch::increment(const QString &key)
+{
+    increment(hashKey(key));
+}
+
+void FrequencySketch::increment(quint64 hash)
+{
+    int indexes[SKETCH_DEPTH];
+    int minimum = 15;
+    for (int row = 0; row < SKETCH_DEPTH; ++row) {
+        indexes[row] = counterIndex(hash, row);
+        minimum = qMin(minimum, counterValue(indexes[row]));
+    }
+
+    if (minimum == 15) {
+        return;
+    }
+
+    // 保守更新：只增加等于最小值的计数器，减少哈希冲突带来的高估
+    for (int row = 0; row < SKETCH_DEPTH; ++row) {
+        if (counterValue(indexes[row]) == minimum) {
+            const int index = indexes[row];
+            m_table[size_t(index >> 4)] += quint64(1) << ((index & 15) * 4);
+        }
+    }
+
+    if (++m_additions >= m_sampleSize) {
+        reset();
+    }
+}
+
+void FrequencySketch::clear()
+{
+    std::fill(m_table.begin(), m_table.end(), 0);
+    m_additions = 0;
+}
+
+quint64 FrequencySketch::hashKey(const QString &key)
+{
+    return mix64(quint64(qHash(key)) ^ (quint64(key.size()) << 32));
+}
+
+int FrequencySketch::counterIndex(quint64 hash, int row) const
+{
+    return int(mix64(hash + ROW_SEEDS[row]) & m_counterMask);
+}
+
+int FrequencySketch::counterValue(int index) const
+{
+    return int((m_table[size_t(index >> 4)] >> ((index & 15) * 4)) & 0xF);
+}
+
+void FrequencySketch::reset()
+{
+    // 所有计数器减半
+    for (quint64 &word : m_table) {
+        word = (word >> 1) & 0x7777777777777777ULL;
+    }
+    m_additions /= 2;
+}
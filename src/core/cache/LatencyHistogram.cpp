@@ -0,0 +1,128 @@
+#include "core/cache/LatencyHistogram.h"
+
+LatencyHistogram::LatencyHistogram()
+    : m_totalNs(0)
+    , m_maxNs(0)
+{
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        m_buckets[i].storeRelaxed(0);
+    }
+}
+
+void LatencyHistogram::record(qint64 nanoseconds)
+{
+    if (nanoseconds < 0) {
+        nanoseconds = 0;
+    }
+
+    m_buckets[bucketFor(nanoseconds)].fetchAndAddRelaxed(1);
+    m_totalNs.fetchAndAddRelaxed(nanoseconds);
+
+    qint64 currentMax = m_maxNs.loadRelaxed();
+    while (nanoseconds > currentMax && !m_maxNs.testAndSetRelaxed(currentMax, nanoseconds, currentMax)) {
+    }
+}
+
+void LatencyHistogram::reset()
+{
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        m_buckets[i].storeRelaxed(0);
+    }
+    m_totalNs.storeRelaxed(0);
+    m_maxNs.storeRelaxed(0);
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::snapshot() const
+{
+    Snapshot result;
+    result.buckets.resize(BUCKET_COUNT);
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        result.buckets[i] = m_buckets[i].loadRelaxed();
+        result.count += result.buckets[i];
+    }
+    result.totalNs = m_totalNs.loadRelaxed();
+    result.maxNs = m_maxNs.loadRelaxed();
+    return result;
+}
+
+qint64 LatencyHistogram::bucketUpperBoundMicros(int bucket)
+{
+    return qint64(1) << qBound(0, bucket, BUCKET_COUNT - 1);
+}
+
+int LatencyHistogram::bucketFor(qint64 nanoseconds)
+{
+    qint64 micros = nanoseconds / 1000;
+    int bucket = 0;
+    while (micros > 0 && bucket < BUCKET_COUNT - 1) {
+        micros >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+double LatencyHistogram::Snapshot::meanMicros() const
+{
+    return count > 0 ? double(totalNs) / count / 1000.0 : 0.0;
+}
+
+double LatencyHistogram::Snapshot::percentileMicros(double percentile) const
+{
+    if (count <= 0 || buckets.isEmpty()) {
+        return 0.0;
+    }
+
+    const double target = qBound(0.0, percentile, 100.0) / 100.0 * count;
+    qint64 seen = 0;
+    for (int i = 0; i < buckets.size(); ++i) {
+        if (buckets[i] == 0) {
+            continue;
+        }
+        if (seen + buckets[i] >= target) {
+            const double lower = (i == 0) ? 0.0 : double(bucketUpperBoundMicros(i - 1));
+            const double upper = double(bucketUpperBoundMicros(i));
+            const double fraction = (target - seen) / buckets[i];
+            // 不超过实际记录到的最大值
+            return qMin(lower + (upper - lower) * fraction, maxNs / 1000.0);
+        }
+        seen += buckets[i];
+    }
+
+    return maxNs / 1000.0;
+}
+
+void LatencyHistogram::Snapshot::merge(const Snapshot &other)
+{
+    if (buckets.size() < other.buckets.size()) {
+        buckets.resize(other.buckets.size());
+    }
+    for (int i = 0; i < other.buckets.size(); ++i) {
+        buckets[i] += other.buckets[i];
+    }
+    count += other.count;
+    totalNs += other.totalNs;
+    maxNs = qMax(maxNs, other.maxNs);
+}
+
+QJsonObject LatencyHistogram::Snapshot::toJson() const
+{
+    QJsonObject json;
+    json["count"] = count;
+    json["meanUs"] = meanMicros();
+    json["p50Us"] = percentileMicros(50);
+    json["p90Us"] = percentileMicros(90);
+    json["p95Us"] = percentileMicros(95);
+    json["p99Us"] = percentileMicros(99);
+    json["maxUs"] = maxNs / 1000.0;
+
+    // 只导出非空桶，键为桶上界（微秒）
+    QJsonObject bucketJson;
+    for (int i = 0; i < buckets.size(); ++i) {
+        if (buckets[i] > 0) {
+            bucketJson[QString::number(bucketUpperBoundMicros(i))] = buckets[i];
+        }
+    }
+    json["bucketsUs"] = bucketJson;
+
+    return json;
+}
@@ -0,0 +1,300 @@
+#include "core/cache/MappedImageStore.h"
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QtEndian>
+#include <QDebug>
+#include <cstring>
+
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// 文件头：魔数(4) 版本(4) 宽(4) 高(4) 格式(4) 每行字节数(4) 设备像素比×1000(4)，补齐到64字节
+// 像素数据从64字节处开始，映射后每行仍按4字节对齐
+const char MAPPED_IMAGE_MAGIC[4] = { 'C', 'R', 'M', 'I' };
+const quint32 MAPPED_IMAGE_VERSION = 1;
+const int MAPPED_IMAGE_HEADER_SIZE = 64;
+
+const qint64 MAPPED_IMAGE_TTL_MS = 24LL * 60 * 60 * 1000;     // 24小时未使用的文件由索引清理
+
+struct MappedRegion {
+    void *address;
+    qint64 size;
+#ifndef Q_OS_UNIX
+    QFile *file;
+#endif
+};
+
+// QImage 的最后一个副本销毁时解除映射
+void releaseMapping(void *info)
+{
+    MappedRegion *region = static_cast<MappedRegion *>(info);
+#ifdef Q_OS_UNIX
+    ::munmap(region->address, size_t(region->size));
+#else
+    region->file->unmap(static_cast<uchar *>(region->address));
+    delete region->file;
+#endif
+    delete region;
+}
+
+bool isValidHeader(const uchar *header, qint64 fileSize, int *width, int *height,
+                   QImage::Format *format, int *bytesPerLine, qreal *devicePixelRatio)
+{
+    if (memcmp(header, MAPPED_IMAGE_MAGIC, 4) != 0
+        || qFromLittleEndian<quint32>(header + 4) != MAPPED_IMAGE_VERSION) {
+        return false;
+    }
+
+    const quint32 w = qFromLittleEndian<quint32>(header + 8);
+    const quint32 h = qFromLittleEndian<quint32>(header + 12);
+    const quint32 f = qFromLittleEndian<quint32>(header + 16);
+    const quint32 bpl = qFromLittleEndian<quint32>(header + 20);
+    const quint32 dpr = qFromLittleEndian<quint32>(header + 24);
+
+    if (w == 0 || h == 0 || w > 65535 || h > 65535
+        || f == QImage::Format_Invalid || f >= QImage::NImageFormats || bpl % 4 != 0) {
+        return false;
+    }
+    const int depth = QImage::toPixelFormat(QImage::Format(f)).bitsPerPixel();
+    if (bpl < (quint64(w) * depth + 7) / 8
+        || MAPPED_IMAGE_HEADER_SIZE + quint64(bpl) * h > quint64(fileSize)) {
+        return false;
+    }
+
+    *width = int(w);
+    *height = int(h);
+    *format = QImage::Format(f);
+    *bytesPerLine = int(bpl);
+    *devicePixelRatio = dpr > 0 ? dpr / 1000.0 : 1.0;
+    return true;
+}
+
+} // namespace
+
+MappedImageStore::MappedImageStore(const QString &directory, qint64 maxSizeBytes)
+    : m_directory(directory.isEmpty() ? defaultDirectory() : directory)
+    , m_maxSize(qMax<qint64>(0, maxSizeBytes))
+{
+    QDir().mkpath(m_directory);
+
+    // 目录通常在tmpfs上且受大小上限约束，直接在当前线程建立索引
+    m_index.setDefaultTtl(MAPPED_IMAGE_TTL_MS);
+    m_index.rebuild(m_directory);
+    enforceLimit();
+}
+
+QString MappedImageStore::defaultDirectory()
+{
+    // 运行时目录（XDG_RUNTIME_DIR）在Linux上一般是按用户划分的tmpfs
+    QString base = QStandardPaths::writableLocation(QStandardPaths::RuntimeLocation);
+    if (base.isEmpty()) {
+        base = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    }
+    return base + QStringLiteral("/ComicReader/decoded");
+}
+
+QImage MappedImageStore::insert(const QString &fileName, const QImage &image)
+{
+    if (image.isNull() || fileName.isEmpty()) {
+        return image;
+    }
+
+    // 带调色板的格式无法只靠像素还原，统一转换成32位格式
+    QImage source = image;
+    if (source.colorCount() > 0) {
+        source = source.convertToFormat(source.hasAlphaChannel()
+                                        ? QImage::Format_ARGB32_Premultiplied
+                                        : QImage::Format_RGB32);
+    }
+
+    uchar header[MAPPED_IMAGE_HEADER_SIZE];
+    memset(header, 0, sizeof(header));
+    memcpy(header, MAPPED_IMAGE_MAGIC, 4);
+    qToLittleEndian<quint32>(MAPPED_IMAGE_VERSION, header + 4);
+    qToLittleEndian<quint32>(quint32(source.width()), header + 8);
+    qToLittleEndian<quint32>(quint32(source.height()), header + 12);
+    qToLittleEndian<quint32>(quint32(source.format()), header + 16);
+    qToLittleEndian<quint32>(quint32(source.bytesPerLine()), header + 20);
+    qToLittleEndian<quint32>(quint32(qRound(source.devicePixelRatio() * 1000)), header + 24);
+
+    // 先写临时文件再重命名：其他进程看到的总是完整的文件，已映射的旧文件不受影响。
+    // 不能启用 setDirectWriteFallback()，原地写入会截断正被映射的文件（见 mapImage()）
+    const QString filePath = QDir(m_directory).absoluteFilePath(fileName);
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to write mapped image:" << filePath;
+        return image;
+    }
+    file.write(reinterpret_cast<const char *>(header), MAPPED_IMAGE_HEADER_SIZE);
+    file.write(reinterpret_cast<const char *>(source.constBits()), source.sizeInBytes());
+    if (!file.commit()) {
+        qWarning() << "Failed to write mapped image:" << filePath;
+        return image;
+    }
+
+    m_index.recordWrite(fileName, MAPPED_IMAGE_HEADER_SIZE + source.sizeInBytes());
+    enforceLimit();
+
+    qint64 fileSize = 0;
+    const QImage mapped = mapImage(filePath, &fileSize);
+    return mapped.isNull() ? image : mapped;
+}
+
+QImage MappedImageStore::find(const QString &fileName)
+{
+    if (fileName.isEmpty()) {
+        return QImage();
+    }
+
+    qint64 fileSize = 0;
+    const QImage mapped = mapImage(QDir(m_directory).absoluteFilePath(fileName), &fileSize);
+    if (mapped.isNull()) {
+        m_index.recordRemove(fileName);
+        return QImage();
+    }
+
+    // 重新记录一次，移到使用顺序的尾部；其他进程写入的文件也在这里纳入索引
+    m_index.recordWrite(fileName, fileSize);
+    return mapped;
+}
+
+bool MappedImageStore::contains(const QString &fileName) const
+{
+    return m_index.contains(fileName) || QFile::exists(QDir(m_directory).absoluteFilePath(fileName));
+}
+
+void MappedImageStore::remove(const QString &fileName)
+{
+    // 已映射的图片不受影响，解除映射后由内核回收
+    m_index.recordRemove(fileName);
+    QFile::remove(QDir(m_directory).absoluteFilePath(fileName));
+}
+
+void MappedImageStore::removeMatching(const QString &fileNamePrefix)
+{
+    const QDir dir(m_directory);
+    const QStringList files = m_index.takeMatching(fileNamePrefix);
+    for (const QString &fileName : files) {
+        QFile::remove(dir.absoluteFilePath(fileName));
+    }
+}
+
+void MappedImageStore::clear()
+{
+    QDir dir(m_directory);
+    const QStringList files = dir.entryList(QDir::Files);
+    for (const QString &fileName : files) {
+        dir.remove(fileName);
+    }
+    m_index.clear();
+}
+
+void MappedImageStore::setMaxSize(qint64 bytes)
+{
+    m_maxSize.storeRelaxed(qMax<qint64>(0, bytes));
+    enforceLimit();
+}
+
+qint64 MappedImageStore::maxSize() const
+{
+    return m_maxSize.loadRelaxed();
+}
+
+qint64 MappedImageStore::totalSize() const
+{
+    return m_index.totalSize();
+}
+
+int MappedImageStore::count() const
+{
+    return m_index.count();
+}
+
+QImage MappedImageStore::mapImage(const QString &filePath, qint64 *fileSize)
+{
+    // 文件以 MAP_SHARED 映射，返回的图片直接读取页缓存：文件一旦在原地截断，
+    // 读取截断部分的像素会触发 SIGBUS。因此存储中的文件只能整体替换
+    // （insert() 用 QSaveFile 写临时文件后重命名，已映射的旧 inode 保持不变）
+    // 或删除，绝不能原地覆盖写入或截断；其他进程写入同一目录时也必须遵守
+    MappedRegion *region = nullptr;
+
+#ifdef Q_OS_UNIX
+    const int fd = ::open(QFile::encodeName(filePath).constData(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return QImage();
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size < MAPPED_IMAGE_HEADER_SIZE) {
+        ::close(fd);
+        return QImage();
+    }
+    // 映射建立后即可关闭文件描述符，映射一直有效到 munmap
+    void *address = ::mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        return QImage();
+    }
+    region = new MappedRegion;
+    region->address = address;
+    region->size = qint64(st.st_size);
+#else
+    QFile *file = new QFile(filePath);
+    if (!file->open(QIODevice::ReadOnly) || file->size() < MAPPED_IMAGE_HEADER_SIZE) {
+        delete file;
+        return QImage();
+    }
+    uchar *address = file->map(0, file->size());
+    if (!address) {
+        delete file;
+        return QImage();
+    }
+    region = new MappedRegion;
+    region->address = address;
+    region->size = file->size();
+    region->file = file;
+#endif
+
+    const uchar *data = static_cast<const uchar *>(region->address);
+    int width = 0;
+    int height = 0;
+    QImage::Format format = QImage::Format_Invalid;
+    int bytesPerLine = 0;
+    qreal devicePixelRatio = 1.0;
+    if (!isValidHeader(data, region->size, &width, &height, &format, &bytesPerLine, &devicePixelRatio)) {
+        releaseMapping(region);
+        return QImage();
+    }
+
+    // 只读图片：修改像素时 QImage 会先拷贝一份，不会写回映射
+    QImage image(data + MAPPED_IMAGE_HEADER_SIZE, width, height, bytesPerLine, format,
+                 releaseMapping, region);
+    if (image.isNull()) {
+        releaseMapping(region);
+        return QImage();
+    }
+    image.setDevicePixelRatio(devicePixelRatio);
+    *fileSize = region->size;
+    return image;
+}
+
+void MappedImageStore::enforceLimit()
+{
+    const qint64 excess = m_index.totalSize() - m_maxSize.loadRelaxed();
+    if (excess <= 0) {
+        return;
+    }
+
+    const QDir dir(m_directory);
+    const QStringList oldest = m_index.takeOldest(excess);
+    for (const QString &fileName : oldest) {
+        QFile::remove(dir.absoluteFilePath(fileName));
+    }
+}
@@ -0,0 +1,244 @@
+#include "core/cache/MemoryGovernor.h"
+#include "core/config/ConfigManager.h"
+#include <QCoreApplication>
+#include <QMutexLocker>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+
+// 各压力等级下的预算比例
+const int MODERATE_PRESSURE_PERCENT = 75;
+const int CRITICAL_PRESSURE_PERCENT = 50;
+
+} // namespace
+
+MemoryGovernor* MemoryGovernor::instance()
+{
+    // 解码线程、预热线程都可能最先调用：局部静态变量的初始化是线程安全的。
+    // 对象归属主线程，配置变化和内存压力信号在主线程处理
+    static MemoryGovernor *governor = []() {
+        MemoryGovernor *created = new MemoryGovernor();
+        if (QCoreApplication *app = QCoreApplication::instance()) {
+            created->moveToThread(app->thread());
+        }
+        return created;
+    }();
+    return governor;
+}
+
+MemoryGovernor::MemoryGovernor(QObject *parent)
+    : QObject(parent)
+    , m_nextId(1)
+    , m_totalUsage(0)
+    , m_budget(0)
+    , m_budgetPercent(100)
+    , m_pressureMonitor(nullptr)
+{
+    ConfigManager *config = ConfigManager::instance();
+    m_budget = qint64(qMax(1, config->getMaxCacheSize())) * 1024 * 1024;
+    connect(config, &ConfigManager::configChanged, this, &MemoryGovernor::onConfigChanged);
+}
+
+int MemoryGovernor::registerCache(const QString &name, Priority priority, const ReclaimCallback &reclaim)
+{
+    QMutexLocker locker(&m_mutex);
+    
+    Registration registration;
+    registration.name = name;
+    registration.priority = priority;
+    registration.reclaim = reclaim;
+    registration.bytes = 0;
+    registration.reclaimedBytes = 0;
+    
+    const int id = m_nextId++;
+    m_registrations.insert(id, registration);
+    return id;
+}
+
+void MemoryGovernor::unregisterCache(int id)
+{
+    // 等待正在进行的回收结束，之后不会再调用该缓存的回调
+    QMutexLocker reclaimLocker(&m_reclaimMutex);
+    QMutexLocker locker(&m_mutex);
+    
+    auto it = m_registrations.find(id);
+    if (it != m_registrations.end()) {
+        m_totalUsage -= it->bytes;
+        m_registrations.erase(it);
+    }
+}
+
+void MemoryGovernor::updateUsage(int id, qint64 bytes)
+{
+    QMutexLocker locker(&m_mutex);
+    
+    auto it = m_registrations.find(id);
+    if (it != m_registrations.end()) {
+        m_totalUsage += bytes - it->bytes;
+        it->bytes = bytes;
+    }
+}
+
+qint64 MemoryGovernor::checkBudget()
+{
+    // 回收进行中（包括在回收回调中被调用）时直接返回
+    if (!m_reclaimMutex.tryLock()) {
+        return 0;
+    }
+    
+    struct Candidate {
+        int id;
+        Priority priority;
+        qint64 bytes;
+        ReclaimCallback reclaim;
+    };
+    
+    QList<Candidate> candidates;
+    qint64 excess = 0;
+    {
+        QMutexLocker locker(&m_mutex);
+        excess = m_totalUsage - effectiveBudgetLocked();
+        if (excess > 0) {
+            for (auto it = m_registrations.constBegin(); it != m_registrations.constEnd(); ++it) {
+                if (it->bytes > 0 && it->reclaim) {
+                    candidates.append({it.key(), it->priority, it->bytes, it->reclaim});
+                }
+            }
+        }
+    }
+    
+    qint64 totalFreed = 0;
+    if (excess > 0) {
+        // 低优先级先回收；同一优先级内占用大的先回收
+        std::sort(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b) {
+            if (a.priority != b.priority) {
+                return a.priority < b.priority;
+            }
+            return a.bytes > b.bytes;
+        });
+        
+        for (const Candidate &candidate : candidates) {
+            if (excess <= 0) {
+                break;
+            }
+            // 回调在不持有调度器锁的情况下执行，其中可以调用 updateUsage()
+            const qint64 freed = qMax<qint64>(0, candidate.reclaim(qMin(excess, candidate.bytes)));
+            excess -= freed;
+            totalFreed += freed;
+            
+            QMutexLocker locker(&m_mutex);
+            auto it = m_registrations.find(candidate.id);
+            if (it != m_registrations.end()) {
+                it->reclaimedBytes += freed;
+            }
+        }
+    }
+    
+    m_reclaimMutex.unlock();
+    
+    if (totalFreed > 0) {
+        emit reclaimed(totalFreed);
+    }
+    return totalFreed;
+}
+
+void MemoryGovernor::setBudget(qint64 bytes)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_budget = qMax<qint64>(1, bytes);
+    }
+    checkBudget();
+}
+
+qint64 MemoryGovernor::budget() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_budget;
+}
+
+qint64 MemoryGovernor::effectiveBudget() const
+{
+    QMutexLocker locker(&m_mutex);
+    return effectiveBudgetLocked();
+}
+
+qint64 MemoryGovernor::effectiveBudgetLocked() const
+{
+    return m_budget * m_budgetPercent / 100;
+}
+
+qint64 MemoryGovernor::totalUsage() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_totalUsage;
+}
+
+QList<MemoryGovernor::CacheUsage> MemoryGovernor::usage() const
+{
+    QMutexLocker locker(&m_mutex);
+    
+    QList<CacheUsage> result;
+    for (auto it = m_registrations.constBegin(); it != m_registrations.constEnd(); ++it) {
+        CacheUsage entry;
+        entry.id = it.key();
+        entry.name = it->name;
+        entry.priority = it->priority;
+        entry.bytes = it->bytes;
+        entry.reclaimedBytes = it->reclaimedBytes;
+        result.append(entry);
+    }
+    std::sort(result.begin(), result.end(), [](const CacheUsage &a, const CacheUsage &b) {
+        return a.id < b.id;
+    });
+    return result;
+}
+
+void MemoryGovernor::setPressureMonitor(MemoryPressureMonitor *monitor)
+{
+    if (m_pressureMonitor == monitor) {
+        return;
+    }
+    if (m_pressureMonitor) {
+        disconnect(m_pressureMonitor, nullptr, this, nullptr);
+    }
+    
+    m_pressureMonitor = monitor;
+    if (m_pressureMonitor) {
+        connect(m_pressureMonitor, &MemoryPressureMonitor::pressureChanged,
+                this, &MemoryGovernor::onPressureChanged);
+        connect(m_pressureMonitor, &QObject::destroyed, this, [this]() {
+            m_pressureMonitor = nullptr;
+        });
+        applyMemoryPressure(m_pressureMonitor->level());
+    }
+}
+
+void MemoryGovernor::applyMemoryPressure(MemoryPressureMonitor::PressureLevel level)
+{
+    int percent = 100;
+    if (level == MemoryPressureMonitor::CriticalPressure) {
+        percent = CRITICAL_PRESSURE_PERCENT;
+    } else if (level == MemoryPressureMonitor::ModeratePressure) {
+        percent = MODERATE_PRESSURE_PERCENT;
+    }
+    
+    {
+        QMutexLocker locker(&m_mutex);
+        m_budgetPercent = percent;
+    }
+    checkBudget();
+}
+
+void MemoryGovernor::onPressureChanged(MemoryPressureMonitor::PressureLevel level)
+{
+    applyMemoryPressure(level);
+}
+
+void MemoryGovernor::onConfigChanged(const QString &key, const QVariant &value)
+{
+    if (key == "Cache/MaxSize") {
+        setBudget(qint64(qMax(1, value.toInt())) * 1024 * 1024);
+    }
+}
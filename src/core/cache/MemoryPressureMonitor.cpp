@@ -0,0 +1,286 @@
+#include "core/cache/MemoryPressureMonitor.h"
+#include <QFile>
+#include <QList>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#endif
+
+namespace {
+
+// 压力判定阈值
+const double CRITICAL_HEADROOM = 0.05;
+const double MODERATE_HEADROOM = 0.15;
+const double CRITICAL_PSI_SOME = 40.0;
+const double CRITICAL_PSI_FULL = 10.0;
+const double MODERATE_PSI_SOME = 10.0;
+
+QByteArray readSmallFile(const QString &path)
+{
+    // /proc 和 /sys 下的文件大小报告为0，只能读到结尾
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    return file.readAll();
+}
+
+// 在 "key value" 形式的内容中查找某个键（如 memory.stat）
+qint64 findStatValue(const QByteArray &content, const QByteArray &key)
+{
+    const QList<QByteArray> lines = content.split('\n');
+    for (const QByteArray &line : lines) {
+        const QList<QByteArray> fields = line.simplified().split(' ');
+        if (fields.size() >= 2 && fields[0] == key) {
+            bool ok = false;
+            const qint64 value = fields[1].toLongLong(&ok);
+            return ok ? value : -1;
+        }
+    }
+    return -1;
+}
+
+} // namespace
+
+double MemorySample::headroomRatio() const
+{
+    double ratio = -1.0;
+
+    if (totalBytes > 0 && availableBytes >= 0) {
+        ratio = double(availableBytes) / totalBytes;
+    }
+
+    if (cgroupLimitBytes > 0 && cgroupCurrentBytes >= 0) {
+        const double cgroupRatio = qMax(0.0, double(cgroupLimitBytes - cgroupCurrentBytes) / cgroupLimitBytes);
+        ratio = (ratio < 0.0) ? cgroupRatio : qMin(ratio, cgroupRatio);
+    }
+
+    return ratio;
+}
+
+MemoryPressureMonitor::MemoryPressureMonitor(QObject *parent)
+    : QObject(parent)
+    , m_timer(new QTimer(this))
+    , m_level(NoPressure)
+{
+    m_timer->setSingleShot(false);
+    connect(m_timer, &QTimer::timeout, this, &MemoryPressureMonitor::onTimer);
+}
+
+void MemoryPressureMonitor::start(int intervalMs)
+{
+    m_timer->setInterval(intervalMs);
+    m_timer->start();
+    poll();
+}
+
+void MemoryPressureMonitor::stop()
+{
+    m_timer->stop();
+}
+
+bool MemoryPressureMonitor::isRunning() const
+{
+    return m_timer->isActive();
+}
+
+MemoryPressureMonitor::PressureLevel MemoryPressureMonitor::level() const
+{
+    return m_level;
+}
+
+MemorySample MemoryPressureMonitor::lastSample() const
+{
+    return m_lastSample;
+}
+
+MemoryPressureMonitor::PressureLevel MemoryPressureMonitor::poll()
+{
+    m_lastSample = readSample();
+    const PressureLevel newLevel = classify(m_lastSample);
+
+    emit sampled(m_lastSample, newLevel);
+
+    if (newLevel != m_level) {
+        m_level = newLevel;
+        emit pressureChanged(m_level);
+    }
+
+    return m_level;
+}
+
+void MemoryPressureMonitor::onTimer()
+{
+    poll();
+}
+
+MemorySample MemoryPressureMonitor::readSample()
+{
+    MemorySample sample;
+
+#if defined(Q_OS_LINUX)
+    qint64 totalBytes = -1;
+    qint64 availableBytes = -1;
+    if (parseMemInfo(readSmallFile("/proc/meminfo"), totalBytes, availableBytes)) {
+        sample.totalBytes = totalBytes;
+        sample.availableBytes = availableBytes;
+    }
+
+    // cgroup v2：进程所在组的用量和限制
+    const QString cgroupPath = parseCgroupPath(readSmallFile("/proc/self/cgroup"));
+    QByteArray pressure;
+    if (!cgroupPath.isNull()) {
+        const QString cgroupDir = "/sys/fs/cgroup" + cgroupPath;
+        const QByteArray current = readSmallFile(cgroupDir + "/memory.current").trimmed();
+        if (!current.isEmpty()) {
+            // 不活跃的文件页可以随时回收，不计入用量
+            qint64 used = current.toLongLong();
+            const qint64 inactiveFile = findStatValue(readSmallFile(cgroupDir + "/memory.stat"), "inactive_file");
+            if (inactiveFile > 0) {
+                used = qMax<qint64>(0, used - inactiveFile);
+            }
+            sample.cgroupCurrentBytes = used;
+
+            const qint64 maxLimit = parseCgroupLimit(readSmallFile(cgroupDir + "/memory.max"));
+            const qint64 highLimit = parseCgroupLimit(readSmallFile(cgroupDir + "/memory.high"));
+            if (maxLimit > 0 && highLimit > 0) {
+                sample.cgroupLimitBytes = qMin(maxLimit, highLimit);
+            } else {
+                sample.cgroupLimitBytes = qMax(maxLimit, highLimit);
+            }
+        }
+        pressure = readSmallFile(cgroupDir + "/memory.pressure");
+    }
+
+    // PSI：优先使用cgroup的，没有时使用全系统的
+    if (pressure.isEmpty()) {
+        pressure = readSmallFile("/proc/pressure/memory");
+    }
+    double someAvg10 = -1.0;
+    double fullAvg10 = -1.0;
+    if (parsePressure(pressure, someAvg10, fullAvg10)) {
+        sample.psiSomeAvg10 = someAvg10;
+        sample.psiFullAvg10 = fullAvg10;
+    }
+#elif defined(Q_OS_WIN)
+    MEMORYSTATUSEX status;
+    status.dwLength = sizeof(status);
+    if (GlobalMemoryStatusEx(&status)) {
+        sample.totalBytes = qint64(status.ullTotalPhys);
+        sample.availableBytes = qint64(status.ullAvailPhys);
+    }
+#endif
+
+    return sample;
+}
+
+MemoryPressureMonitor::PressureLevel MemoryPressureMonitor::classify(const MemorySample &sample)
+{
+    const double headroom = sample.headroomRatio();
+
+    if ((headroom >= 0.0 && headroom < CRITICAL_HEADROOM)
+        || sample.psiSomeAvg10 >= CRITICAL_PSI_SOME
+        || sample.psiFullAvg10 >= CRITICAL_PSI_FULL) {
+        return CriticalPressure;
+    }
+
+    if ((headroom >= 0.0 && headroom < MODERATE_HEADROOM)
+        || sample.psiSomeAvg10 >= MODERATE_PSI_SOME) {
+        return ModeratePressure;
+    }
+
+    return NoPressure;
+}
+
+bool MemoryPressureMonitor::parseMemInfo(const QByteArray &content, qint64 &totalBytes, qint64 &availableBytes)
+{
+    totalBytes = -1;
+    availableBytes = -1;
+    qint64 freeBytes = -1;
+    qint64 cachedBytes = -1;
+
+    const QList<QByteArray> lines = content.split('\n');
+    for (const QByteArray &line : lines) {
+        // 形如 "MemAvailable:   12345678 kB"
+        const QList<QByteArray> fields = line.simplified().split(' ');
+        if (fields.size() < 2) {
+            continue;
+        }
+
+        qint64 value = fields[1].toLongLong();
+        if (fields.size() >= 3 && fields[2] == "kB") {
+            value *= 1024;
+        }
+
+        if (fields[0] == "MemTotal:") {
+            totalBytes = value;
+        } else if (fields[0] == "MemAvailable:") {
+            availableBytes = value;
+        } else if (fields[0] == "MemFree:") {
+            freeBytes = value;
+        } else if (fields[0] == "Cached:") {
+            cachedBytes = value;
+        }
+    }
+
+    // 3.14 之前的内核没有 MemAvailable
+    if (availableBytes < 0 && freeBytes >= 0) {
+        availableBytes = freeBytes + qMax<qint64>(0, cachedBytes);
+    }
+
+    return totalBytes > 0 && availableBytes >= 0;
+}
+
+bool MemoryPressureMonitor::parsePressure(const QByteArray &content, double &someAvg10, double &fullAvg10)
+{
+    someAvg10 = -1.0;
+    fullAvg10 = -1.0;
+
+    const QList<QByteArray> lines = content.split('\n');
+    for (const QByteArray &line : lines) {
+        // 形如 "some avg10=1.23 avg60=0.50 avg300=0.10 total=123456"
+        const QList<QByteArray> fields = line.simplified().split(' ');
+        if (fields.size() < 2 || !fields[1].startsWith("avg10=")) {
+            continue;
+        }
+
+        bool ok = false;
+        const double value = fields[1].mid(6).toDouble(&ok);
+        if (!ok) {
+            continue;
+        }
+
+        if (fields[0] == "some") {
+            someAvg10 = value;
+        } else if (fields[0] == "full") {
+            fullAvg10 = value;
+        }
+    }
+
+    return someAvg10 >= 0.0;
+}
+
+QString MemoryPressureMonitor::parseCgroupPath(const QByteArray &content)
+{
+    // cgroup v2 的条目形如 "0::/user.slice/user-1000.slice/session-2.scope"
+    const QList<QByteArray> lines = content.split('\n');
+    for (const QByteArray &line : lines) {
+        if (line.startsWith("0::")) {
+            const QString path = QString::fromUtf8(line.mid(3).trimmed());
+            return path.isEmpty() ? QString("/") : path;
+        }
+    }
+    return QString();
+}
+
+qint64 MemoryPressureMonitor::parseCgroupLimit(const QByteArray &content)
+{
+    const QByteArray value = content.trimmed();
+    if (value.isEmpty() || value == "max") {
+        return -1;
+    }
+
+    bool ok = false;
+    const qint64 limit = value.toLongLong(&ok);
+    return ok ? limit : -1;
+}
@@ -0,0 +1,103 @@
+#include "core/cache/MurmurHash3.h"
+#include <QtEndian>
+
+namespace {
+
+inline quint64 rotl64(quint64 x, int r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+inline quint64 fmix64(quint64 k)
+{
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+}
+
+const quint64 C1 = 0x87c37b91114253d5ULL;
+const quint64 C2 = 0x4cf5ad432745937fULL;
+
+} // namespace
+
+QString Hash128::toHex() const
+{
+    uchar bytes[16];
+    qToLittleEndian(h1, bytes);
+    qToLittleEndian(h2, bytes + 8);
+    return QString::fromLatin1(QByteArray(reinterpret_cast<const char *>(bytes), 16).toHex());
+}
+
+Hash128 MurmurHash3::hash128(const QByteArray &data, quint32 seed)
+{
+    return hash128(data.constData(), data.size(), seed);
+}
+
+Hash128 MurmurHash3::hash128(const void *data, int length, quint32 seed)
+{
+    const uchar *bytes = static_cast<const uchar *>(data);
+    const int blockCount = length / 16;
+
+    quint64 h1 = seed;
+    quint64 h2 = seed;
+
+    // 16字节块
+    for (int i = 0; i < blockCount; ++i) {
+        quint64 k1 = qFromLittleEndian<quint64>(bytes + i * 16);
+        quint64 k2 = qFromLittleEndian<quint64>(bytes + i * 16 + 8);
+
+        k1 *= C1; k1 = rotl64(k1, 31); k1 *= C2; h1 ^= k1;
+        h1 = rotl64(h1, 27); h1 += h2; h1 = h1 * 5 + 0x52dce729;
+
+        k2 *= C2; k2 = rotl64(k2, 33); k2 *= C1; h2 ^= k2;
+        h2 = rotl64(h2, 31); h2 += h1; h2 = h2 * 5 + 0x38495ab5;
+    }
+
+    // 尾部
+    const uchar *tail = bytes + blockCount * 16;
+    quint64 k1 = 0;
+    quint64 k2 = 0;
+    switch (length & 15) {
+    case 15: k2 ^= quint64(tail[14]) << 48; Q_FALLTHROUGH();
+    case 14: k2 ^= quint64(tail[13]) << 40; Q_FALLTHROUGH();
+    case 13: k2 ^= quint64(tail[12]) << 32; Q_FALLTHROUGH();
+    case 12: k2 ^= quint64(tail[11]) << 24; Q_FALLTHROUGH();
+    case 11: k2 ^= quint64(tail[10]) << 16; Q_FALLTHROUGH();
+    case 10: k2 ^= quint64(tail[9]) << 8; Q_FALLTHROUGH();
+    case 9:
+        k2 ^= quint64(tail[8]);
+        k2 *= C2; k2 = rotl64(k2, 33); k2 *= C1; h2 ^= k2;
+        Q_FALLTHROUGH();
+    case 8: k1 ^= quint64(tail[7]) << 56; Q_FALLTHROUGH();
+    case 7: k1 ^= quint64(tail[6]) << 48; Q_FALLTHROUGH();
+    case 6: k1 ^= quint64(tail[5]) << 40; Q_FALLTHROUGH();
+    case 5: k1 ^= quint64(tail[4]) << 32; Q_FALLTHROUGH();
+    case 4: k1 ^= quint64(tail[3]) << 24; Q_FALLTHROUGH();
+    case 3: k1 ^= quint64(tail[2]) << 16; Q_FALLTHROUGH();
+    case 2: k1 ^= quint64(tail[1]) << 8; Q_FALLTHROUGH();
+    case 1:
+        k1 ^= quint64(tail[0]);
+        k1 *= C1; k1 = rotl64(k1, 31); k1 *= C2; h1 ^= k1;
+        break;
+    default:
+        break;
+    }
+
+    // 终结
+    h1 ^= quint64(length);
+    h2 ^= quint64(length);
+    h1 += h2;
+    h2 += h1;
+    h1 = fmix64(h1);
+    h2 = fmix64(h2);
+    h1 += h2;
+    h2 += h1;
+
+    Hash128 result;
+    result.h1 = h1;
+    result.h2 = h2;
+    return result;
+}
@@ -0,0 +1,161 @@
+#include "core/cache/TimerWheel.h"
+
+TimerWheel::TimerWheel(qint64 nowMs, qint64 tickMs)
+    : m_tickMs(qMax<qint64>(1, tickMs))
+    , m_currentTick(nowMs / m_tickMs)
+{
+    for (int level = 0; level < LEVELS; ++level) {
+        m_levelCounts[level] = 0;
+    }
+}
+
+void TimerWheel::schedule(const QString &key, qint64 expiryMs)
+{
+    cancel(key);
+
+    Timer timer;
+    // 向上取整，保证不会提前到期
+    timer.expiryTick = (expiryMs + m_tickMs - 1) / m_tickMs;
+    timer.level = 0;
+    timer.slot = 0;
+
+    auto it = m_timers.insert(key, timer);
+    place(key, it.value(), m_currentTick + 1);
+}
+
+void TimerWheel::cancel(const QString &key)
+{
+    auto it = m_timers.find(key);
+    if (it == m_timers.end()) {
+        return;
+    }
+
+    m_slots[it->level][it->slot].erase(it->position);
+    --m_levelCounts[it->level];
+    m_timers.erase(it);
+}
+
+bool TimerWheel::contains(const QString &key) const
+{
+    return m_timers.contains(key);
+}
+
+qint64 TimerWheel::expiryOf(const QString &key) const
+{
+    auto it = m_timers.constFind(key);
+    return it == m_timers.constEnd() ? -1 : it->expiryTick * m_tickMs;
+}
+
+QStringList TimerWheel::advance(qint64 nowMs)
+{
+    QStringList expired;
+    const qint64 targetTick = nowMs / m_tickMs;
+
+    // 调度时已经到期的条目放在当前格子
+    expireSlot(m_currentTick, expired);
+
+    while (m_currentTick < targetTick && !m_timers.isEmpty()) {
+        // 低层全空时直接跳到下一个需要级联的边界
+        int emptyLevels = 0;
+        while (emptyLevels < LEVELS - 1 && m_levelCounts[emptyLevels] == 0) {
+            ++emptyLevels;
+        }
+        if (emptyLevels > 0) {
+            const int shift = SLOT_BITS * emptyLevels;
+            const qint64 boundary = ((m_currentTick >> shift) + 1) << shift;
+            m_currentTick = qMin(targetTick, boundary - 1);
+            if (m_currentTick == targetTick) {
+                break;
+            }
+        }
+
+        const qint64 tick = ++m_currentTick;
+
+        // 低层转完一圈时，把上一层对应槽中的条目重新分配到低层（从高层往低层）
+        for (int level = LEVELS - 1; level > 0; --level) {
+            const qint64 lowerSpan = qint64(1) << (SLOT_BITS * level);
+            if ((tick & (lowerSpan - 1)) == 0) {
+                cascade(level, tick);
+            }
+        }
+
+        expireSlot(tick, expired);
+    }
+
+    m_currentTick = qMax(m_currentTick, targetTick);
+    return expired;
+}
+
+int TimerWheel::size() const
+{
+    return m_timers.size();
+}
+
+void TimerWheel::clear()
+{
+    for (int level = 0; level < LEVELS; ++level) {
+        for (int slot = 0; slot < SLOTS; ++slot) {
+            m_slots[level][slot].clear();
+        }
+        m_levelCounts[level] = 0;
+    }
+    m_timers.clear();
+}
+
+void TimerWheel::place(const QString &key, Timer &timer, qint64 baseTick)
+{
+    // baseTick 为下一个将被处理的格子
+    qint64 expiryTick = timer.expiryTick;
+    int level = 0;
+
+    if (expiryTick < baseTick) {
+        // 已经到期：放在当前格子，下次 advance() 时返回
+        expiryTick = baseTick - 1;
+    } else {
+        const qint64 delta = expiryTick - baseTick;
+        while (level < LEVELS - 1 && delta >= (qint64(1) << (SLOT_BITS * (level + 1)))) {
+            ++level;
+        }
+
+        // 超出最大跨度的条目放在最高层最远的槽，转到时再重新放置
+        const qint64 maxSpan = qint64(1) << (SLOT_BITS * LEVELS);
+        if (delta >= maxSpan) {
+            expiryTick = baseTick + maxSpan - 1;
+        }
+    }
+
+    timer.level = level;
+    timer.slot = int((expiryTick >> (SLOT_BITS * level)) & SLOT_MASK);
+    std::list<QString> &slot = m_slots[timer.level][timer.slot];
+    slot.push_back(key);
+    timer.position = std::prev(slot.end());
+    ++m_levelCounts[level];
+}
+
+void TimerWheel::cascade(int level, qint64 tick)
+{
+    const int slotIndex = int((tick >> (SLOT_BITS * level)) & SLOT_MASK);
+    std::list<QString> pending;
+    pending.swap(m_slots[level][slotIndex]);
+    m_levelCounts[level] -= int(pending.size());
+
+    for (const QString &key : pending) {
+        place(key, m_timers[key], tick);
+    }
+}
+
+void TimerWheel::expireSlot(qint64 tick, QStringList &expired)
+{
+    std::list<QString> &slot = m_slots[0][tick & SLOT_MASK];
+    for (auto it = slot.begin(); it != slot.end();) {
+        auto timerIt = m_timers.find(*it);
+        if (timerIt->expiryTick <= tick) {
+            expired.append(*it);
+            m_timers.erase(timerIt);
+            it = slot.erase(it);
+            --m_levelCounts[0];
+        } else {
+            ++it;
+        }
+    }
+}
@@ -0,0 +1,103 @@
+#include "core/image/AnimatedImageDecoder.h"
+#include <QImageReader>
+
+namespace {
+
+// 延迟不超过10毫秒的帧按浏览器的惯例显示100毫秒，否则不少 GIF 会播放得过快
+const int MIN_FRAME_DELAY = 10;
+const int DEFAULT_FRAME_DELAY = 100;
+
+} // namespace
+
+AnimatedImageDecoder::AnimatedImageDecoder(const QByteArray &data)
+    : m_data(data)
+    , m_reader(nullptr)
+    , m_frameCount(0)
+    , m_loopCount(0)
+    , m_loopsCompleted(0)
+    , m_frameIndex(0)
+{
+    // QBuffer 引用 m_data，不复制压缩数据
+    m_buffer.setBuffer(&m_data);
+    m_buffer.open(QIODevice::ReadOnly);
+    openReader();
+    if (m_reader->canRead()) {
+        m_size = m_reader->size();
+        m_frameCount = qMax(0, m_reader->imageCount());
+        m_loopCount = m_reader->loopCount();
+    }
+    // 统计帧数时读取器可能已经扫描过整个文件，从头开始解码
+    openReader();
+}
+
+AnimatedImageDecoder::~AnimatedImageDecoder()
+{
+    delete m_reader;
+}
+
+bool AnimatedImageDecoder::isAnimated(const QByteArray &data)
+{
+    QBuffer buffer;
+    buffer.setData(data);
+    buffer.open(QIODevice::ReadOnly);
+    QImageReader reader(&buffer);
+    return reader.supportsAnimation() && reader.imageCount() > 1;
+}
+
+bool AnimatedImageDecoder::isValid() const
+{
+    return m_size.isValid();
+}
+
+QSize AnimatedImageDecoder::size() const
+{
+    return m_size;
+}
+
+int AnimatedImageDecoder::frameCount() const
+{
+    return m_frameCount;
+}
+
+int AnimatedImageDecoder::loopCount() const
+{
+    return m_loopCount;
+}
+
+bool AnimatedImageDecoder::readFrame(Frame *frame)
+{
+    if (!isValid()) {
+        return false;
+    }
+
+    QImage image;
+    if (!m_reader->read(&image)) {
+        // 第一帧就失败说明数据有误；否则是到达了末尾，还有循环次数时从头开始
+        if (m_frameIndex == 0) {
+            return false;
+        }
+        if (m_loopCount >= 0 && m_loopsCompleted >= m_loopCount) {
+            return false;
+        }
+        ++m_loopsCompleted;
+        openReader();
+        if (!m_reader->read(&image)) {
+            return false;
+        }
+    }
+    ++m_frameIndex;
+
+    const int delay = m_reader->nextImageDelay();
+    frame->image = image;
+    frame->delay = delay <= MIN_FRAME_DELAY ? DEFAULT_FRAME_DELAY : delay;
+    return true;
+}
+
+void AnimatedImageDecoder::openReader()
+{
+    // GIF 等格式不支持跳回第一帧，重新创建读取器
+    delete m_reader;
+    m_buffer.seek(0);
+    m_reader = new QImageReader(&m_buffer);
+    m_frameIndex = 0;
+}
@@ -0,0 +1,397 @@
+#include "core/image/ContentBounds.h"
+#include "core/image/ImageDecoder.h"
+#include "core/image/ImageScaler.h"
+#include <cmath>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CONTENTBOUNDS_X86
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#define CONTENTBOUNDS_TARGET(isa)
+#else
+#define CONTENTBOUNDS_TARGET(isa) __attribute__((target(isa)))
+#endif
+#elif defined(__ARM_NEON) || defined(__aarch64__) || defined(_M_ARM64)
+#define CONTENTBOUNDS_NEON
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+// 方差不超过此值（标准差约10）的行、列看作没有内容；JPEG 噪声和零星的灰尘缩小后都在此以下
+const quint64 VARIANCE_THRESHOLD = 100;
+// 均值与最外一行（列）相差不超过此值时看作同一种背景
+const quint64 MEAN_TOLERANCE = 24;
+// 内容外保留的边距（分析图的像素），缩放误差不会裁到内容
+const int PADDING = 2;
+// 内容不足整页的此比例时看作空白页（或只有页码），不裁切
+const qreal MIN_CONTENT_FRACTION = 0.2;
+// 不足此比例的边距不值得裁掉
+const qreal MIN_MARGIN_FRACTION = 0.01;
+
+// 一行像素的和与平方和
+typedef void (*LineKernel)(const uint8_t *, int, uint32_t *, uint32_t *);
+// 一行像素逐个加到各列的和与平方和上
+typedef void (*ColumnKernel)(const uint8_t *, int, uint32_t *, uint32_t *);
+
+struct Kernels {
+    LineKernel line;
+    ColumnKernel columns;
+};
+
+void lineScalar(const uint8_t *pixels, int count, uint32_t *sum, uint32_t *sumSq)
+{
+    uint32_t s = 0;
+    uint32_t q = 0;
+    for (int x = 0; x < count; ++x) {
+        s += pixels[x];
+        q += uint32_t(pixels[x]) * pixels[x];
+    }
+    *sum = s;
+    *sumSq = q;
+}
+
+void columnsScalar(const uint8_t *pixels, int count, uint32_t *sums, uint32_t *sumSqs)
+{
+    for (int x = 0; x < count; ++x) {
+        sums[x] += pixels[x];
+        sumSqs[x] += uint32_t(pixels[x]) * pixels[x];
+    }
+}
+
+#ifdef CONTENTBOUNDS_X86
+
+// 4个32位数的和
+CONTENTBOUNDS_TARGET("sse4.1")
+inline uint32_t addLanesSse41(__m128i values)
+{
+    values = _mm_add_epi32(values, _mm_shuffle_epi32(values, _MM_SHUFFLE(1, 0, 3, 2)));
+    values = _mm_add_epi32(values, _mm_shuffle_epi32(values, _MM_SHUFFLE(2, 3, 0, 1)));
+    return uint32_t(_mm_cvtsi128_si32(values));
+}
+
+// 8个16位无符号数加到 dst 的8个32位累加器上
+CONTENTBOUNDS_TARGET("sse4.1")
+inline void accumulateSse41(uint32_t *dst, __m128i values)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i *p = reinterpret_cast<__m128i *>(dst);
+    _mm_storeu_si128(p, _mm_add_epi32(_mm_loadu_si128(p), _mm_unpacklo_epi16(values, zero)));
+    _mm_storeu_si128(p + 1, _mm_add_epi32(_mm_loadu_si128(p + 1), _mm_unpackhi_epi16(values, zero)));
+}
+
+CONTENTBOUNDS_TARGET("sse4.1")
+void lineSse41(const uint8_t *pixels, int count, uint32_t *sum, uint32_t *sumSq)
+{
+    // 和用 SAD 对零求得；平方和用16位乘加，两个像素的平方和不超过32位有符号数
+    const __m128i zero = _mm_setzero_si128();
+    __m128i sums = zero;
+    __m128i squares = zero;
+    int x = 0;
+    for (; x + 16 <= count; x += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pixels + x));
+        sums = _mm_add_epi64(sums, _mm_sad_epu8(v, zero));
+        const __m128i lo = _mm_unpacklo_epi8(v, zero);
+        const __m128i hi = _mm_unpackhi_epi8(v, zero);
+        squares = _mm_add_epi32(squares, _mm_add_epi32(_mm_madd_epi16(lo, lo), _mm_madd_epi16(hi, hi)));
+    }
+    uint32_t tailSum;
+    uint32_t tailSq;
+    lineScalar(pixels + x, count - x, &tailSum, &tailSq);
+    *sum = uint32_t(_mm_cvtsi128_si32(sums)) + uint32_t(_mm_extract_epi32(sums, 2)) + tailSum;
+    *sumSq = addLanesSse41(squares) + tailSq;
+}
+
+CONTENTBOUNDS_TARGET("sse4.1")
+void columnsSse41(const uint8_t *pixels, int count, uint32_t *sums, uint32_t *sumSqs)
+{
+    // 8位像素的平方不超过65025，16位无符号乘法不会溢出
+    const __m128i zero = _mm_setzero_si128();
+    int x = 0;
+    for (; x + 16 <= count; x += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pixels + x));
+        const __m128i lo = _mm_unpacklo_epi8(v, zero);
+        const __m128i hi = _mm_unpackhi_epi8(v, zero);
+        accumulateSse41(sums + x, lo);
+        accumulateSse41(sums + x + 8, hi);
+        accumulateSse41(sumSqs + x, _mm_mullo_epi16(lo, lo));
+        accumulateSse41(sumSqs + x + 8, _mm_mullo_epi16(hi, hi));
+    }
+    columnsScalar(pixels + x, count - x, sums + x, sumSqs + x);
+}
+
+// 16个16位无符号数加到 dst 的16个32位累加器上
+CONTENTBOUNDS_TARGET("avx2")
+inline void accumulateAvx2(uint32_t *dst, __m256i values)
+{
+    __m256i *p = reinterpret_cast<__m256i *>(dst);
+    const __m256i lo = _mm256_cvtepu16_epi32(_mm256_castsi256_si128(values));
+    const __m256i hi = _mm256_cvtepu16_epi32(_mm256_extracti128_si256(values, 1));
+    _mm256_storeu_si256(p, _mm256_add_epi32(_mm256_loadu_si256(p), lo));
+    _mm256_storeu_si256(p + 1, _mm256_add_epi32(_mm256_loadu_si256(p + 1), hi));
+}
+
+CONTENTBOUNDS_TARGET("avx2")
+void lineAvx2(const uint8_t *pixels, int count, uint32_t *sum, uint32_t *sumSq)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i sums = zero;
+    __m256i squares = zero;
+    int x = 0;
+    for (; x + 32 <= count; x += 32) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pixels + x));
+        sums = _mm256_add_epi64(sums, _mm256_sad_epu8(v, zero));
+        const __m256i lo = _mm256_unpacklo_epi8(v, zero);
+        const __m256i hi = _mm256_unpackhi_epi8(v, zero);
+        squares = _mm256_add_epi32(squares, _mm256_add_epi32(_mm256_madd_epi16(lo, lo), _mm256_madd_epi16(hi, hi)));
+    }
+    const __m128i sums128 = _mm_add_epi64(_mm256_castsi256_si128(sums), _mm256_extracti128_si256(sums, 1));
+    const __m128i squares128 = _mm_add_epi32(_mm256_castsi256_si128(squares), _mm256_extracti128_si256(squares, 1));
+    uint32_t tailSum;
+    uint32_t tailSq;
+    lineScalar(pixels + x, count - x, &tailSum, &tailSq);
+    *sum = uint32_t(_mm_cvtsi128_si32(sums128)) + uint32_t(_mm_extract_epi32(sums128, 2)) + tailSum;
+    *sumSq = addLanesSse41(squares128) + tailSq;
+}
+
+CONTENTBOUNDS_TARGET("avx2")
+void columnsAvx2(const uint8_t *pixels, int count, uint32_t *sums, uint32_t *sumSqs)
+{
+    int x = 0;
+    for (; x + 16 <= count; x += 16) {
+        const __m256i v = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pixels + x)));
+        accumulateAvx2(sums + x, v);
+        accumulateAvx2(sumSqs + x, _mm256_mullo_epi16(v, v));
+    }
+    columnsScalar(pixels + x, count - x, sums + x, sumSqs + x);
+}
+
+#endif // CONTENTBOUNDS_X86
+
+#ifdef CONTENTBOUNDS_NEON
+
+inline uint32_t addLanesNeon(uint32x4_t values)
+{
+    return vgetq_lane_u32(values, 0) + vgetq_lane_u32(values, 1)
+         + vgetq_lane_u32(values, 2) + vgetq_lane_u32(values, 3);
+}
+
+// 8个16位无符号数加到 dst 的8个32位累加器上
+inline void accumulateNeon(uint32_t *dst, uint16x8_t values)
+{
+    vst1q_u32(dst, vaddw_u16(vld1q_u32(dst), vget_low_u16(values)));
+    vst1q_u32(dst + 4, vaddw_u16(vld1q_u32(dst + 4), vget_high_u16(values)));
+}
+
+void lineNeon(const uint8_t *pixels, int count, uint32_t *sum, uint32_t *sumSq)
+{
+    uint32x4_t sums = vdupq_n_u32(0);
+    uint32x4_t squares = vdupq_n_u32(0);
+    int x = 0;
+    for (; x + 16 <= count; x += 16) {
+        const uint8x16_t v = vld1q_u8(pixels + x);
+        sums = vpadalq_u16(sums, vpaddlq_u8(v));
+        squares = vpadalq_u16(squares, vmull_u8(vget_low_u8(v), vget_low_u8(v)));
+        squares = vpadalq_u16(squares, vmull_u8(vget_high_u8(v), vget_high_u8(v)));
+    }
+    uint32_t tailSum;
+    uint32_t tailSq;
+    lineScalar(pixels + x, count - x, &tailSum, &tailSq);
+    *sum = addLanesNeon(sums) + tailSum;
+    *sumSq = addLanesNeon(squares) + tailSq;
+}
+
+void columnsNeon(const uint8_t *pixels, int count, uint32_t *sums, uint32_t *sumSqs)
+{
+    int x = 0;
+    for (; x + 16 <= count; x += 16) {
+        const uint8x16_t v = vld1q_u8(pixels + x);
+        const uint8x8_t lo = vget_low_u8(v);
+        const uint8x8_t hi = vget_high_u8(v);
+        accumulateNeon(sums + x, vmovl_u8(lo));
+        accumulateNeon(sums + x + 8, vmovl_u8(hi));
+        accumulateNeon(sumSqs + x, vmull_u8(lo, lo));
+        accumulateNeon(sumSqs + x + 8, vmull_u8(hi, hi));
+    }
+    columnsScalar(pixels + x, count - x, sums + x, sumSqs + x);
+}
+
+#endif // CONTENTBOUNDS_NEON
+
+Kernels kernelsFor(ImageScaler::InstructionSet set)
+{
+    switch (set) {
+#ifdef CONTENTBOUNDS_X86
+    case ImageScaler::AVX2:
+        return { lineAvx2, columnsAvx2 };
+    case ImageScaler::SSE41:
+        return { lineSse41, columnsSse41 };
+#endif
+#ifdef CONTENTBOUNDS_NEON
+    case ImageScaler::NEON:
+        return { lineNeon, columnsNeon };
+#endif
+    default:
+        return { lineScalar, columnsScalar };
+    }
+}
+
+void scanRows(const QImage &gray, const Kernels &kernels, ContentBounds::Profile *profile)
+{
+    const int height = gray.height();
+    profile->rowSum.resize(height);
+    profile->rowSumSq.resize(height);
+    for (int y = 0; y < height; ++y) {
+        kernels.line(gray.constScanLine(y), gray.width(), &profile->rowSum[y], &profile->rowSumSq[y]);
+    }
+}
+
+void scanColumns(const QImage &gray, const Kernels &kernels, int firstRow, int lastRow,
+                 ContentBounds::Profile *profile)
+{
+    profile->columnSum.fill(0, gray.width());
+    profile->columnSumSq.fill(0, gray.width());
+    for (int y = firstRow; y <= lastRow; ++y) {
+        kernels.columns(gray.constScanLine(y), gray.width(), profile->columnSum.data(), profile->columnSumSq.data());
+    }
+}
+
+// 一条线（count 个像素）与边缘是同一种背景：方差小且均值接近
+bool isBlank(quint64 sum, quint64 sumSq, quint64 count, quint64 edgeSum)
+{
+    // count²·方差 = count·Σx² − (Σx)²，全部用整数比较
+    const quint64 spread = count * sumSq - sum * sum;
+    const quint64 difference = sum > edgeSum ? sum - edgeSum : edgeSum - sum;
+    return spread <= count * count * VARIANCE_THRESHOLD && difference <= count * MEAN_TOLERANCE;
+}
+
+// 从 first 开始按 step 方向跳过边距，返回第一条有内容的线；全是边距时返回 last + step
+int skipMargin(const QVector<quint32> &sum, const QVector<quint32> &sumSq, int count,
+               int first, int last, int step)
+{
+    const quint64 edgeSum = sum.at(first);
+    int index = first;
+    while (index != last + step && isBlank(sum.at(index), sumSq.at(index), count, edgeSum)) {
+        index += step;
+    }
+    return index;
+}
+
+// 缩小的分析图（灰度）
+QImage analysisCopy(const QImage &image)
+{
+    const int size = ContentBounds::ANALYSIS_SIZE;
+    if (image.width() <= size && image.height() <= size) {
+        return image.convertToFormat(QImage::Format_Grayscale8);
+    }
+    const QImage::Format format = image.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied
+                                                          : QImage::Format_RGB32;
+    // 各页在不同的线程中并行分析，缩放只使用调用线程
+    return ImageScaler::scaleToFit(image.convertToFormat(format), QSize(size, size), ImageScaler::Area, 1)
+        .convertToFormat(QImage::Format_Grayscale8);
+}
+
+// 把 from 尺寸图片中的 rect 换算到 to 尺寸，向外取整
+QRect mapRect(const QRect &rect, const QSize &from, const QSize &to)
+{
+    const qreal sx = qreal(to.width()) / from.width();
+    const qreal sy = qreal(to.height()) / from.height();
+    const QPoint topLeft(int(std::floor(rect.left() * sx)), int(std::floor(rect.top() * sy)));
+    const QPoint bottomRight(int(std::ceil((rect.right() + 1) * sx)) - 1, int(std::ceil((rect.bottom() + 1) * sy)) - 1);
+    return QRect(topLeft, bottomRight) & QRect(QPoint(0, 0), to);
+}
+
+// 分析图中内容的范围
+QRect detectInGray(const QImage &gray)
+{
+    const int width = gray.width();
+    const int height = gray.height();
+    const QRect full(0, 0, width, height);
+    const Kernels kernels = kernelsFor(ImageScaler::instructionSet());
+
+    // 先确定上下边距，列只统计中间有内容的行，页眉、页脚处的背景不影响左右边距
+    ContentBounds::Profile profile;
+    scanRows(gray, kernels, &profile);
+    const int top = skipMargin(profile.rowSum, profile.rowSumSq, width, 0, height - 1, 1);
+    const int bottom = skipMargin(profile.rowSum, profile.rowSumSq, width, height - 1, 0, -1);
+    if (top > bottom) {
+        return full;
+    }
+    scanColumns(gray, kernels, top, bottom, &profile);
+    const int rows = bottom - top + 1;
+    const int left = skipMargin(profile.columnSum, profile.columnSumSq, rows, 0, width - 1, 1);
+    const int right = skipMargin(profile.columnSum, profile.columnSumSq, rows, width - 1, 0, -1);
+    if (left > right) {
+        return full;
+    }
+
+    QRect content = QRect(QPoint(left, top), QPoint(right, bottom)).adjusted(-PADDING, -PADDING, PADDING, PADDING) & full;
+    if (content.width() < width * MIN_CONTENT_FRACTION || content.height() < height * MIN_CONTENT_FRACTION) {
+        return full;
+    }
+    if (content.left() < width * MIN_MARGIN_FRACTION) {
+        content.setLeft(0);
+    }
+    if (content.top() < height * MIN_MARGIN_FRACTION) {
+        content.setTop(0);
+    }
+    if (width - 1 - content.right() < width * MIN_MARGIN_FRACTION) {
+        content.setRight(width - 1);
+    }
+    if (height - 1 - content.bottom() < height * MIN_MARGIN_FRACTION) {
+        content.setBottom(height - 1);
+    }
+    return content;
+}
+
+} // namespace
+
+QRect ContentBounds::detect(const QImage &image)
+{
+    if (image.isNull()) {
+        return QRect();
+    }
+    const QImage gray = analysisCopy(image);
+    const QRect content = detectInGray(gray);
+    if (content == gray.rect()) {
+        return image.rect();
+    }
+    return gray.size() == image.size() ? content : mapRect(content, gray.size(), image.size());
+}
+
+QRect ContentBounds::detect(const QByteArray &data, QSize *fullSize)
+{
+    // 只需要分析图的分辨率：JPEG 按 1/2～1/8 解码
+    const QSize size = ImageDecoder::imageSize(data);
+    qreal scale = 1.0;
+    if (size.isValid()) {
+        scale = qreal(ANALYSIS_SIZE) / qMax(size.width(), size.height());
+    }
+    QSize decodedFull;
+    const QImage image = ImageDecoder::decode(data, scale, &decodedFull);
+    if (fullSize) {
+        *fullSize = decodedFull;
+    }
+    if (image.isNull() || !decodedFull.isValid()) {
+        return QRect();
+    }
+
+    const QRect content = detect(image);
+    return image.size() == decodedFull ? content : mapRect(content, image.size(), decodedFull);
+}
+
+ContentBounds::Profile ContentBounds::profile(const QImage &gray, int firstRow, int lastRow)
+{
+    Profile result;
+    if (gray.isNull() || gray.format() != QImage::Format_Grayscale8) {
+        return result;
+    }
+    if (lastRow < 0 || lastRow >= gray.height()) {
+        lastRow = gray.height() - 1;
+    }
+    const Kernels kernels = kernelsFor(ImageScaler::instructionSet());
+    scanRows(gray, kernels, &result);
+    scanColumns(gray, kernels, qMax(0, firstRow), lastRow, &result);
+    return result;
+}
@@ -0,0 +1,95 @@
+#include "core/image/ImageDecoder.h"
+#include "core/image/ImagePyramid.h"
+#include <QBuffer>
+#include <QImageReader>
+#include <QtMath>
+
+namespace {
+
+// libjpeg 支持的最大缩小倍数
+const int MAX_REDUCTION = 8;
+
+QImage decodeImage(const QByteArray &data, qreal scale, QSize *fullSize, bool reducedOnly)
+{
+    QBuffer buffer;
+    buffer.setData(data);
+    buffer.open(QIODevice::ReadOnly);
+    QImageReader reader(&buffer);
+
+    const QSize size = reader.size();
+    if (fullSize) {
+        *fullSize = size;
+    }
+
+    // 只有 JPEG 能在解码时缩小；其他格式设置 scaledSize 只是解码后再缩放，质量还不如 ImageScaler
+    const QSize target = ImageDecoder::reducedSize(size, scale);
+    const bool reduced = target != size && reader.format() == "jpeg";
+    if (reduced) {
+        reader.setScaledSize(target);
+    } else if (reducedOnly) {
+        return QImage();
+    }
+
+    QImage image;
+    if (!reader.read(&image)) {
+        return QImage();
+    }
+    if (fullSize && !size.isValid()) {
+        *fullSize = image.size();
+    }
+    return image;
+}
+
+} // namespace
+
+QSize ImageDecoder::imageSize(const QByteArray &data)
+{
+    QBuffer buffer;
+    buffer.setData(data);
+    buffer.open(QIODevice::ReadOnly);
+    QImageReader reader(&buffer);
+    return reader.size();
+}
+
+QSize ImageDecoder::reducedSize(const QSize &fullSize, qreal scale)
+{
+    if (!fullSize.isValid() || scale <= 0 || scale >= 1.0) {
+        return fullSize;
+    }
+
+    // 取满足需要的最大缩小倍数；向下取整的尺寸使 Qt 的 JPEG 插件选中同一个 scale_denom
+    const int neededWidth = qCeil(fullSize.width() * scale);
+    const int neededHeight = qCeil(fullSize.height() * scale);
+    for (int factor = MAX_REDUCTION; factor > 1; factor /= 2) {
+        const QSize size(fullSize.width() / factor, fullSize.height() / factor);
+        if (size.width() >= neededWidth && size.height() >= neededHeight) {
+            return size;
+        }
+    }
+    return fullSize;
+}
+
+QImage ImageDecoder::decode(const QByteArray &data, qreal scale, QSize *fullSize)
+{
+    return decodeImage(data, scale, fullSize, false);
+}
+
+QImage ImageDecoder::decodeReduced(const QByteArray &data, qreal scale, QSize *fullSize)
+{
+    return decodeImage(data, scale, fullSize, true);
+}
+
+QImage ImageDecoder::decodeToFit(const QByteArray &data, const QSize &bounds)
+{
+    const QSize size = imageSize(data);
+    qreal scale = 1.0;
+    if (size.isValid() && !bounds.isEmpty()) {
+        scale = qMin(qreal(bounds.width()) / size.width(), qreal(bounds.height()) / size.height());
+    }
+
+    const QImage image = decode(data, scale);
+    if (image.isNull() || bounds.isEmpty()) {
+        return image;
+    }
+    return ImagePyramid(image).scaledToFit(bounds);
+}
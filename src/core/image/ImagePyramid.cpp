@@ -0,0 +1,99 @@
+#include "core/image/ImagePyramid.h"
+#include "core/image/ImageScaler.h"
+#include <QMutexLocker>
+
+ImagePyramid::ImagePyramid(const QImage &base)
+{
+    m_levels[0] = base;
+}
+
+QSize ImagePyramid::levelSize(int index) const
+{
+    const QSize full = size();
+    const int divisor = 1 << qBound(0, index, LEVEL_COUNT - 1);
+    return QSize(qMax(1, (full.width() + divisor - 1) / divisor),
+                 qMax(1, (full.height() + divisor - 1) / divisor));
+}
+
+int ImagePyramid::levelFor(qreal scale)
+{
+    int index = 0;
+    while (index + 1 < LEVEL_COUNT && scale <= 1.0 / (1 << (index + 1))) {
+        ++index;
+    }
+    return index;
+}
+
+QImage ImagePyramid::level(int index)
+{
+    index = qBound(0, index, LEVEL_COUNT - 1);
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_levels[index].isNull() || m_levels[0].isNull()) {
+            return m_levels[index];
+        }
+    }
+
+    // 同一时间只生成一层：多个分块同时需要同一层时只生成一次，其他线程等待结果
+    QMutexLocker buildLocker(&m_buildMutex);
+    QImage source;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_levels[index].isNull()) {
+            return m_levels[index];
+        }
+        // 从已有的最接近的一层生成，不必逐层生成中间层
+        for (int finer = index - 1; finer >= 0 && source.isNull(); --finer) {
+            source = m_levels[finer];
+        }
+    }
+
+    const QImage result = ImageScaler::scale(source, levelSize(index));
+    QMutexLocker locker(&m_mutex);
+    m_levels[index] = result;
+    return result;
+}
+
+bool ImagePyramid::hasLevel(int index) const
+{
+    QMutexLocker locker(&m_mutex);
+    return index >= 0 && index < LEVEL_COUNT && !m_levels[index].isNull();
+}
+
+QImage ImagePyramid::builtLevel(qreal scale) const
+{
+    QMutexLocker locker(&m_mutex);
+    int index = levelFor(scale);
+    while (index > 0 && m_levels[index].isNull()) {
+        --index;
+    }
+    return m_levels[index];
+}
+
+QImage ImagePyramid::scaled(const QSize &size)
+{
+    const QSize full = this->size();
+    if (full.isEmpty() || size.isEmpty()) {
+        return QImage();
+    }
+    const qreal scale = qMax(qreal(size.width()) / full.width(), qreal(size.height()) / full.height());
+    return ImageScaler::scale(level(levelFor(scale)), size);
+}
+
+QImage ImagePyramid::scaledToFit(const QSize &bounds)
+{
+    if (bounds.isEmpty()) {
+        return QImage();
+    }
+    return scaled(size().scaled(bounds, Qt::KeepAspectRatio).expandedTo(QSize(1, 1)));
+}
+
+qint64 ImagePyramid::levelBytes() const
+{
+    QMutexLocker locker(&m_mutex);
+    qint64 bytes = 0;
+    for (int index = 1; index < LEVEL_COUNT; ++index) {
+        bytes += m_levels[index].sizeInBytes();
+    }
+    return bytes;
+}
@@ -0,0 +1,617 @@
+#include "core/image/ImageScaler.h"
+#include <QThread>
+#include <QThreadPool>
+#include <QSemaphore>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define IMAGESCALER_X86
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define IMAGESCALER_TARGET(isa)
+#else
+#define IMAGESCALER_TARGET(isa) __attribute__((target(isa)))
+#endif
+#elif defined(__ARM_NEON) || defined(__aarch64__) || defined(_M_ARM64)
+#define IMAGESCALER_NEON
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+// 权重的定点精度：像素(8位) × 权重(14位) × 权重个数，累加不会超出32位
+const int PRECISION_BITS = 14;
+const int32_t ROUNDING = 1 << (PRECISION_BITS - 1);
+
+const double PI = 3.14159265358979323846;
+
+// 少于这么多输出像素时不分段
+const qint64 PARALLEL_THRESHOLD = 256 * 256;
+
+struct Coefficients {
+    int taps = 0;                       // 每个输出像素的权重个数上限（weights 的步长）
+    std::vector<int> starts;            // 第一个参与计算的源像素
+    std::vector<int> counts;            // 实际参与计算的源像素个数
+    std::vector<int32_t> weights;
+};
+
+double boxFilter(double x)
+{
+    return (x > -0.5 && x <= 0.5) ? 1.0 : 0.0;
+}
+
+double triangleFilter(double x)
+{
+    x = std::fabs(x);
+    return x < 1.0 ? 1.0 - x : 0.0;
+}
+
+double sinc(double x)
+{
+    if (x == 0.0) {
+        return 1.0;
+    }
+    x *= PI;
+    return std::sin(x) / x;
+}
+
+double lanczos3Filter(double x)
+{
+    return (x > -3.0 && x < 3.0) ? sinc(x) * sinc(x / 3.0) : 0.0;
+}
+
+Coefficients computeCoefficients(int inSize, int outSize, ImageScaler::Filter filter)
+{
+    // 缩小时按缩放比例放宽滤波器，每个输出像素覆盖对应的整块源像素
+    double (*function)(double) = nullptr;
+    double support = 0;
+    if (filter == ImageScaler::Lanczos3) {
+        function = lanczos3Filter;
+        support = 3.0;
+    } else if (outSize < inSize) {
+        function = boxFilter;
+        support = 0.5;
+    } else {
+        function = triangleFilter;
+        support = 1.0;
+    }
+
+    const double scale = double(inSize) / outSize;
+    const double filterScale = std::max(scale, 1.0);
+    support *= filterScale;
+
+    Coefficients coefficients;
+    coefficients.taps = int(std::ceil(support)) * 2 + 1;
+    coefficients.starts.resize(outSize);
+    coefficients.counts.resize(outSize);
+    coefficients.weights.assign(size_t(outSize) * coefficients.taps, 0);
+
+    std::vector<double> weights(coefficients.taps);
+    for (int out = 0; out < outSize; ++out) {
+        const double center = (out + 0.5) * scale;
+        const int first = std::max(int(center - support + 0.5), 0);
+        const int last = std::min(int(center + support + 0.5), inSize);
+        const int count = std::min(last - first, coefficients.taps);
+
+        double total = 0;
+        for (int k = 0; k < count; ++k) {
+            weights[k] = function((first + k - center + 0.5) / filterScale);
+            total += weights[k];
+        }
+
+        // 量化后调整最大的权重，使权重之和恰好为1，常数颜色保持不变
+        int32_t *fixed = &coefficients.weights[size_t(out) * coefficients.taps];
+        int32_t fixedTotal = 0;
+        int largest = 0;
+        for (int k = 0; k < count; ++k) {
+            fixed[k] = int32_t(std::lround(total != 0 ? weights[k] / total * (1 << PRECISION_BITS) : 0));
+            fixedTotal += fixed[k];
+            if (fixed[k] > fixed[largest]) {
+                largest = k;
+            }
+        }
+        if (count > 0) {
+            fixed[largest] += (1 << PRECISION_BITS) - fixedTotal;
+        }
+
+        coefficients.starts[out] = first;
+        coefficients.counts[out] = std::max(count, 0);
+    }
+    return coefficients;
+}
+
+inline uint8_t clampToByte(int32_t value)
+{
+    value >>= PRECISION_BITS;
+    return uint8_t(value < 0 ? 0 : (value > 255 ? 255 : value));
+}
+
+// ---- 标量实现 ----
+
+void horizontalScalar(const uint8_t *src, uint8_t *dst, int outWidth, const Coefficients &c)
+{
+    for (int x = 0; x < outWidth; ++x) {
+        const uint8_t *pixel = src + size_t(c.starts[x]) * 4;
+        const int32_t *weights = &c.weights[size_t(x) * c.taps];
+        int32_t sum[4] = { ROUNDING, ROUNDING, ROUNDING, ROUNDING };
+        for (int k = 0; k < c.counts[x]; ++k, pixel += 4) {
+            for (int channel = 0; channel < 4; ++channel) {
+                sum[channel] += pixel[channel] * weights[k];
+            }
+        }
+        for (int channel = 0; channel < 4; ++channel) {
+            dst[x * 4 + channel] = clampToByte(sum[channel]);
+        }
+    }
+}
+
+void verticalScalarRange(const uint8_t *src, qsizetype stride, uint8_t *dst, int from, int to,
+                         int first, int count, const int32_t *weights)
+{
+    for (int x = from; x < to; ++x) {
+        int32_t sum = ROUNDING;
+        const uint8_t *column = src + size_t(first) * stride + x;
+        for (int k = 0; k < count; ++k, column += stride) {
+            sum += *column * weights[k];
+        }
+        dst[x] = clampToByte(sum);
+    }
+}
+
+void verticalScalar(const uint8_t *src, qsizetype stride, uint8_t *dst, int bytes,
+                    int first, int count, const int32_t *weights)
+{
+    // 逐行累加，按行顺序读取源图片
+    thread_local std::vector<int32_t> sums;
+    sums.assign(size_t(bytes), ROUNDING);
+    for (int k = 0; k < count; ++k) {
+        const uint8_t *row = src + size_t(first + k) * stride;
+        const int32_t weight = weights[k];
+        for (int x = 0; x < bytes; ++x) {
+            sums[x] += row[x] * weight;
+        }
+    }
+    for (int x = 0; x < bytes; ++x) {
+        dst[x] = clampToByte(sums[x]);
+    }
+}
+
+#ifdef IMAGESCALER_X86
+
+// ---- SSE4.1 ----
+
+IMAGESCALER_TARGET("sse4.1")
+inline __m128i loadPixelSse41(const uint8_t *pixel)
+{
+    int32_t value;
+    memcpy(&value, pixel, 4);
+    return _mm_cvtepu8_epi32(_mm_cvtsi32_si128(value));
+}
+
+IMAGESCALER_TARGET("sse4.1")
+inline void storePixelSse41(uint8_t *dst, __m128i sum)
+{
+    sum = _mm_srai_epi32(sum, PRECISION_BITS);
+    sum = _mm_packs_epi32(sum, sum);
+    sum = _mm_packus_epi16(sum, sum);
+    const int32_t value = _mm_cvtsi128_si32(sum);
+    memcpy(dst, &value, 4);
+}
+
+IMAGESCALER_TARGET("sse4.1")
+void horizontalSse41(const uint8_t *src, uint8_t *dst, int outWidth, const Coefficients &c)
+{
+    for (int x = 0; x < outWidth; ++x) {
+        const uint8_t *pixel = src + size_t(c.starts[x]) * 4;
+        const int32_t *weights = &c.weights[size_t(x) * c.taps];
+        __m128i sum = _mm_set1_epi32(ROUNDING);
+        for (int k = 0; k < c.counts[x]; ++k, pixel += 4) {
+            sum = _mm_add_epi32(sum, _mm_mullo_epi32(loadPixelSse41(pixel), _mm_set1_epi32(weights[k])));
+        }
+        storePixelSse41(dst + x * 4, sum);
+    }
+}
+
+IMAGESCALER_TARGET("sse4.1")
+void verticalSse41(const uint8_t *src, qsizetype stride, uint8_t *dst, int bytes,
+                   int first, int count, const int32_t *weights)
+{
+    const uint8_t *base = src + size_t(first) * stride;
+    int x = 0;
+    for (; x + 16 <= bytes; x += 16) {
+        __m128i s0 = _mm_set1_epi32(ROUNDING);
+        __m128i s1 = s0;
+        __m128i s2 = s0;
+        __m128i s3 = s0;
+        const uint8_t *row = base + x;
+        for (int k = 0; k < count; ++k, row += stride) {
+            const __m128i w = _mm_set1_epi32(weights[k]);
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row));
+            s0 = _mm_add_epi32(s0, _mm_mullo_epi32(_mm_cvtepu8_epi32(v), w));
+            s1 = _mm_add_epi32(s1, _mm_mullo_epi32(_mm_cvtepu8_epi32(_mm_srli_si128(v, 4)), w));
+            s2 = _mm_add_epi32(s2, _mm_mullo_epi32(_mm_cvtepu8_epi32(_mm_srli_si128(v, 8)), w));
+            s3 = _mm_add_epi32(s3, _mm_mullo_epi32(_mm_cvtepu8_epi32(_mm_srli_si128(v, 12)), w));
+        }
+        const __m128i low = _mm_packs_epi32(_mm_srai_epi32(s0, PRECISION_BITS), _mm_srai_epi32(s1, PRECISION_BITS));
+        const __m128i high = _mm_packs_epi32(_mm_srai_epi32(s2, PRECISION_BITS), _mm_srai_epi32(s3, PRECISION_BITS));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x), _mm_packus_epi16(low, high));
+    }
+    verticalScalarRange(src, stride, dst, x, bytes, first, count, weights);
+}
+
+// ---- AVX2 ----
+
+IMAGESCALER_TARGET("avx2")
+void horizontalAvx2(const uint8_t *src, uint8_t *dst, int outWidth, const Coefficients &c)
+{
+    for (int x = 0; x < outWidth; ++x) {
+        const uint8_t *pixel = src + size_t(c.starts[x]) * 4;
+        const int32_t *weights = &c.weights[size_t(x) * c.taps];
+        const int count = c.counts[x];
+
+        // 每次处理两个源像素：低128位为第一个，高128位为第二个
+        __m256i pair = _mm256_setzero_si256();
+        int k = 0;
+        for (; k + 2 <= count; k += 2, pixel += 8) {
+            const __m256i v = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(pixel)));
+            const __m256i w = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_set1_epi32(weights[k])),
+                                                      _mm_set1_epi32(weights[k + 1]), 1);
+            pair = _mm256_add_epi32(pair, _mm256_mullo_epi32(v, w));
+        }
+        __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(pair), _mm256_extracti128_si256(pair, 1));
+        sum = _mm_add_epi32(sum, _mm_set1_epi32(ROUNDING));
+        if (k < count) {
+            sum = _mm_add_epi32(sum, _mm_mullo_epi32(loadPixelSse41(pixel), _mm_set1_epi32(weights[k])));
+        }
+        storePixelSse41(dst + x * 4, sum);
+    }
+}
+
+IMAGESCALER_TARGET("avx2")
+void verticalAvx2(const uint8_t *src, qsizetype stride, uint8_t *dst, int bytes,
+                  int first, int count, const int32_t *weights)
+{
+    const uint8_t *base = src + size_t(first) * stride;
+    // packs/packus 在两个128位通道内分别打包，最后按此顺序重排回原来的像素顺序
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    int x = 0;
+    for (; x + 32 <= bytes; x += 32) {
+        __m256i s0 = _mm256_set1_epi32(ROUNDING);
+        __m256i s1 = s0;
+        __m256i s2 = s0;
+        __m256i s3 = s0;
+        const uint8_t *row = base + x;
+        for (int k = 0; k < count; ++k, row += stride) {
+            const __m256i w = _mm256_set1_epi32(weights[k]);
+            const __m128i *p = reinterpret_cast<const __m128i *>(row);
+            s0 = _mm256_add_epi32(s0, _mm256_mullo_epi32(_mm256_cvtepu8_epi32(_mm_loadl_epi64(p)), w));
+            s1 = _mm256_add_epi32(s1, _mm256_mullo_epi32(
+                     _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(row + 8))), w));
+            s2 = _mm256_add_epi32(s2, _mm256_mullo_epi32(
+                     _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(row + 16))), w));
+            s3 = _mm256_add_epi32(s3, _mm256_mullo_epi32(
+                     _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(row + 24))), w));
+        }
+        const __m256i low = _mm256_packs_epi32(_mm256_srai_epi32(s0, PRECISION_BITS),
+                                               _mm256_srai_epi32(s1, PRECISION_BITS));
+        const __m256i high = _mm256_packs_epi32(_mm256_srai_epi32(s2, PRECISION_BITS),
+                                                _mm256_srai_epi32(s3, PRECISION_BITS));
+        const __m256i packed = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(low, high), order);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + x), packed);
+    }
+    // 剩余不足32字节的部分交给 SSE4.1
+    verticalSse41(src + x, stride, dst + x, bytes - x, first, count, weights);
+}
+
+#endif // IMAGESCALER_X86
+
+#ifdef IMAGESCALER_NEON
+
+// ---- NEON ----
+
+inline int32x4_t loadPixelNeon(const uint8_t *pixel)
+{
+    uint32_t value;
+    memcpy(&value, pixel, 4);
+    const uint16x8_t wide = vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(value)));
+    return vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(wide)));
+}
+
+inline uint8x8_t narrowNeon(int32x4_t low, int32x4_t high)
+{
+    const int16x8_t packed = vcombine_s16(vqmovn_s32(vshrq_n_s32(low, PRECISION_BITS)),
+                                          vqmovn_s32(vshrq_n_s32(high, PRECISION_BITS)));
+    return vqmovun_s16(packed);
+}
+
+void horizontalNeon(const uint8_t *src, uint8_t *dst, int outWidth, const Coefficients &c)
+{
+    for (int x = 0; x < outWidth; ++x) {
+        const uint8_t *pixel = src + size_t(c.starts[x]) * 4;
+        const int32_t *weights = &c.weights[size_t(x) * c.taps];
+        int32x4_t sum = vdupq_n_s32(ROUNDING);
+        for (int k = 0; k < c.counts[x]; ++k, pixel += 4) {
+            sum = vmlaq_n_s32(sum, loadPixelNeon(pixel), weights[k]);
+        }
+        const uint8x8_t packed = narrowNeon(sum, sum);
+        const uint32_t value = vget_lane_u32(vreinterpret_u32_u8(packed), 0);
+        memcpy(dst + x * 4, &value, 4);
+    }
+}
+
+void verticalNeon(const uint8_t *src, qsizetype stride, uint8_t *dst, int bytes,
+                  int first, int count, const int32_t *weights)
+{
+    const uint8_t *base = src + size_t(first) * stride;
+    int x = 0;
+    for (; x + 16 <= bytes; x += 16) {
+        int32x4_t s0 = vdupq_n_s32(ROUNDING);
+        int32x4_t s1 = s0;
+        int32x4_t s2 = s0;
+        int32x4_t s3 = s0;
+        const uint8_t *row = base + x;
+        for (int k = 0; k < count; ++k, row += stride) {
+            const uint8x16_t v = vld1q_u8(row);
+            const uint16x8_t low = vmovl_u8(vget_low_u8(v));
+            const uint16x8_t high = vmovl_u8(vget_high_u8(v));
+            s0 = vmlaq_n_s32(s0, vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(low))), weights[k]);
+            s1 = vmlaq_n_s32(s1, vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(low))), weights[k]);
+            s2 = vmlaq_n_s32(s2, vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(high))), weights[k]);
+            s3 = vmlaq_n_s32(s3, vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(high))), weights[k]);
+        }
+        vst1q_u8(dst + x, vcombine_u8(narrowNeon(s0, s1), narrowNeon(s2, s3)));
+    }
+    verticalScalarRange(src, stride, dst, x, bytes, first, count, weights);
+}
+
+#endif // IMAGESCALER_NEON
+
+typedef void (*HorizontalKernel)(const uint8_t *, uint8_t *, int, const Coefficients &);
+typedef void (*VerticalKernel)(const uint8_t *, qsizetype, uint8_t *, int, int, int, const int32_t *);
+
+struct Kernels {
+    HorizontalKernel horizontal;
+    VerticalKernel vertical;
+};
+
+bool cpuSupports(ImageScaler::InstructionSet set)
+{
+    switch (set) {
+    case ImageScaler::Scalar:
+        return true;
+#ifdef IMAGESCALER_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+    case ImageScaler::SSE41:
+    case ImageScaler::AVX2: {
+        int info[4];
+        __cpuid(info, 1);
+        const bool sse41 = (info[2] & (1 << 19)) != 0;
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        if (set == ImageScaler::SSE41 || !sse41 || !osxsave) {
+            return sse41;
+        }
+        __cpuidex(info, 7, 0);
+        // 还需要操作系统保存YMM寄存器
+        return (info[1] & (1 << 5)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+    }
+#else
+    case ImageScaler::SSE41:
+        return __builtin_cpu_supports("sse4.1");
+    case ImageScaler::AVX2:
+        return __builtin_cpu_supports("avx2");
+#endif
+#endif
+#ifdef IMAGESCALER_NEON
+    case ImageScaler::NEON:
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+Kernels kernelsFor(ImageScaler::InstructionSet set)
+{
+    switch (set) {
+#ifdef IMAGESCALER_X86
+    case ImageScaler::AVX2:
+        return { horizontalAvx2, verticalAvx2 };
+    case ImageScaler::SSE41:
+        return { horizontalSse41, verticalSse41 };
+#endif
+#ifdef IMAGESCALER_NEON
+    case ImageScaler::NEON:
+        return { horizontalNeon, verticalNeon };
+#endif
+    default:
+        return { horizontalScalar, verticalScalar };
+    }
+}
+
+std::atomic<int> g_forcedInstructionSet(-1);
+
+QThreadPool *scalerPool()
+{
+    static QThreadPool pool;
+    return &pool;
+}
+
+// 把 rows 行分段交给线程池，调用线程也参与处理，全部完成后返回
+void runBands(int rows, int threads, qint64 pixels, const std::function<void(int, int)> &work)
+{
+    const int bandCount = std::min(rows, threads * 4);
+    if (threads <= 1 || bandCount <= 1 || pixels < PARALLEL_THRESHOLD) {
+        work(0, rows);
+        return;
+    }
+
+    struct Shared {
+        std::atomic<int> next { 0 };
+        QSemaphore finished;
+    };
+    const std::shared_ptr<Shared> shared = std::make_shared<Shared>();
+    const std::function<void(int, int)> *task = &work;
+
+    // 晚启动的辅助线程领不到分段就直接返回，不会访问已经返回的调用方
+    auto process = [shared, task, rows, bandCount]() {
+        for (int band = shared->next.fetch_add(1); band < bandCount; band = shared->next.fetch_add(1)) {
+            (*task)(int(qint64(rows) * band / bandCount), int(qint64(rows) * (band + 1) / bandCount));
+            shared->finished.release();
+        }
+    };
+
+    const int helpers = std::min(threads, bandCount) - 1;
+    QThreadPool *pool = scalerPool();
+    if (pool->maxThreadCount() < helpers) {
+        pool->setMaxThreadCount(helpers);
+    }
+    for (int i = 0; i < helpers; ++i) {
+        pool->start(process);
+    }
+    process();
+    shared->finished.acquire(bandCount);
+}
+
+// 重采样的振铃可能使颜色分量超过 alpha，预乘格式中需要截断
+void clampPremultiplied(uint8_t *row, int width)
+{
+    uint32_t *pixels = reinterpret_cast<uint32_t *>(row);
+    for (int x = 0; x < width; ++x) {
+        const uint32_t p = pixels[x];
+        const uint32_t a = p >> 24;
+        const uint32_t r = std::min((p >> 16) & 0xff, a);
+        const uint32_t g = std::min((p >> 8) & 0xff, a);
+        const uint32_t b = std::min(p & 0xff, a);
+        pixels[x] = (a << 24) | (r << 16) | (g << 8) | b;
+    }
+}
+
+} // namespace
+
+QImage ImageScaler::scale(const QImage &source, const QSize &size, Filter filter, int threads)
+{
+    if (source.isNull() || size.isEmpty()) {
+        return QImage();
+    }
+
+    const QImage::Format format = source.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied
+                                                           : QImage::Format_RGB32;
+    const QImage input = source.format() == format ? source : source.convertToFormat(format);
+    if (input.size() == size) {
+        return input;
+    }
+
+    if (threads <= 0) {
+        threads = QThread::idealThreadCount();
+    }
+    const Kernels kernels = kernelsFor(instructionSet());
+    const bool clampAlpha = filter == Lanczos3 && format == QImage::Format_ARGB32_Premultiplied;
+    const qint64 pixels = qint64(size.width()) * size.height();
+
+    // 水平方向：每行独立，按源图片的行分段
+    QImage horizontal = input;
+    if (size.width() != input.width()) {
+        const Coefficients coefficients = computeCoefficients(input.width(), size.width(), filter);
+        horizontal = QImage(size.width(), input.height(), format);
+        if (horizontal.isNull()) {
+            return QImage();
+        }
+        uchar *dstBits = horizontal.bits();
+        const qsizetype dstStride = horizontal.bytesPerLine();
+        runBands(input.height(), threads, pixels, [&](int first, int last) {
+            for (int y = first; y < last; ++y) {
+                uint8_t *dst = dstBits + dstStride * y;
+                kernels.horizontal(input.constScanLine(y), dst, size.width(), coefficients);
+                if (clampAlpha && size.height() == input.height()) {
+                    clampPremultiplied(dst, size.width());
+                }
+            }
+        });
+    }
+    if (size.height() == input.height()) {
+        horizontal.setDevicePixelRatio(source.devicePixelRatio());
+        return horizontal;
+    }
+
+    // 垂直方向：每个输出行由若干源行加权得到，按输出行分段
+    const Coefficients coefficients = computeCoefficients(input.height(), size.height(), filter);
+    QImage result(size, format);
+    if (result.isNull()) {
+        return QImage();
+    }
+    const uchar *srcBits = horizontal.constBits();
+    const qsizetype srcStride = horizontal.bytesPerLine();
+    uchar *dstBits = result.bits();
+    const qsizetype dstStride = result.bytesPerLine();
+    const int rowBytes = size.width() * 4;
+    runBands(size.height(), threads, pixels, [&](int first, int last) {
+        for (int y = first; y < last; ++y) {
+            uint8_t *dst = dstBits + dstStride * y;
+            kernels.vertical(srcBits, srcStride, dst, rowBytes, coefficients.starts[y], coefficients.counts[y],
+                             &coefficients.weights[size_t(y) * coefficients.taps]);
+            if (clampAlpha) {
+                clampPremultiplied(dst, size.width());
+            }
+        }
+    });
+    result.setDevicePixelRatio(source.devicePixelRatio());
+    return result;
+}
+
+QImage ImageScaler::scaleToFit(const QImage &source, const QSize &bounds, Filter filter, int threads)
+{
+    if (source.isNull() || bounds.isEmpty()) {
+        return QImage();
+    }
+    const QSize size = source.size().scaled(bounds, Qt::KeepAspectRatio).expandedTo(QSize(1, 1));
+    return scale(source, size, filter, threads);
+}
+
+ImageScaler::InstructionSet ImageScaler::supportedInstructionSet()
+{
+    static const InstructionSet best = []() {
+        for (InstructionSet set : { AVX2, SSE41, NEON }) {
+            if (cpuSupports(set)) {
+                return set;
+            }
+        }
+        return Scalar;
+    }();
+    return best;
+}
+
+ImageScaler::InstructionSet ImageScaler::instructionSet()
+{
+    const int forced = g_forcedInstructionSet.load(std::memory_order_relaxed);
+    if (forced >= 0 && cpuSupports(InstructionSet(forced))) {
+        return InstructionSet(forced);
+    }
+    return supportedInstructionSet();
+}
+
+void ImageScaler::setInstructionSet(InstructionSet set)
+{
+    g_forcedInstructionSet.store(int(set), std::memory_order_relaxed);
+}
+
+QString ImageScaler::instructionSetName(InstructionSet set)
+{
+    switch (set) {
+    case AVX2:
+        return QStringLiteral("AVX2");
+    case SSE41:
+        return QStringLiteral("SSE4.1");
+    case NEON:
+        return QStringLiteral("NEON");
+    default:
+        return QStringLiteral("scalar");
+    }
+}
@@ -0,0 +1,442 @@
+#include "core/image/PanelDetector.h"
+#include "core/image/ImageDecoder.h"
+#include "core/image/ImageScaler.h"
+#include <QPair>
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define PANELDETECTOR_X86
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#define PANELDETECTOR_TARGET(isa)
+#else
+#define PANELDETECTOR_TARGET(isa) __attribute__((target(isa)))
+#endif
+#elif defined(__ARM_NEON) || defined(__aarch64__) || defined(_M_ARM64)
+#define PANELDETECTOR_NEON
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+// 与背景的亮度差超过此值的像素算作墨迹（网点和浅色的底色也算）
+const int INK_THRESHOLD = 40;
+// 格间空白至少这么宽（分析图的像素）
+const int MIN_GUTTER = 3;
+// 墨迹不超过线长的此比例的行、列仍看作空白（灰尘、对话框的尾巴）
+const int NOISE_DIVISOR = 100;
+// 切分的最大层数
+const int MAX_DEPTH = 8;
+// 一格的宽、高至少占整页的此比例
+const qreal MIN_PANEL_FRACTION = 0.05;
+// 一格的面积至少占整页的此比例
+const qreal MIN_PANEL_AREA = 0.01;
+
+// 二值化一行：与 background 相差超过 threshold 的像素为1
+typedef void (*BinarizeKernel)(const uint8_t *, uint8_t *, int, uint8_t, uint8_t);
+// 一行二值像素的和
+typedef uint32_t (*CountKernel)(const uint8_t *, int);
+// 一行二值像素逐个加到各列的计数上
+typedef void (*AccumulateKernel)(const uint8_t *, int, uint16_t *);
+
+struct Kernels {
+    BinarizeKernel binarize;
+    CountKernel count;
+    AccumulateKernel accumulate;
+};
+
+void binarizeScalar(const uint8_t *src, uint8_t *dst, int count, uint8_t background, uint8_t threshold)
+{
+    for (int x = 0; x < count; ++x) {
+        const int difference = src[x] > background ? src[x] - background : background - src[x];
+        dst[x] = difference > threshold ? 1 : 0;
+    }
+}
+
+uint32_t countScalar(const uint8_t *mask, int count)
+{
+    uint32_t sum = 0;
+    for (int x = 0; x < count; ++x) {
+        sum += mask[x];
+    }
+    return sum;
+}
+
+void accumulateScalar(const uint8_t *mask, int count, uint16_t *counts)
+{
+    for (int x = 0; x < count; ++x) {
+        counts[x] += mask[x];
+    }
+}
+
+#ifdef PANELDETECTOR_X86
+
+PANELDETECTOR_TARGET("sse4.1")
+void binarizeSse41(const uint8_t *src, uint8_t *dst, int count, uint8_t background, uint8_t threshold)
+{
+    // 无符号饱和减法的两个方向取或得到差的绝对值，再减去阈值，非零即为墨迹
+    const __m128i bg = _mm_set1_epi8(char(background));
+    const __m128i limit = _mm_set1_epi8(char(threshold));
+    const __m128i one = _mm_set1_epi8(1);
+    int x = 0;
+    for (; x + 16 <= count; x += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + x));
+        const __m128i difference = _mm_or_si128(_mm_subs_epu8(v, bg), _mm_subs_epu8(bg, v));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x), _mm_min_epu8(_mm_subs_epu8(difference, limit), one));
+    }
+    binarizeScalar(src + x, dst + x, count - x, background, threshold);
+}
+
+PANELDETECTOR_TARGET("sse4.1")
+uint32_t countSse41(const uint8_t *mask, int count)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i sums = zero;
+    int x = 0;
+    for (; x + 16 <= count; x += 16) {
+        sums = _mm_add_epi64(sums, _mm_sad_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(mask + x)), zero));
+    }
+    return uint32_t(_mm_cvtsi128_si32(sums)) + uint32_t(_mm_extract_epi32(sums, 2)) + countScalar(mask + x, count - x);
+}
+
+PANELDETECTOR_TARGET("sse4.1")
+void accumulateSse41(const uint8_t *mask, int count, uint16_t *counts)
+{
+    const __m128i zero = _mm_setzero_si128();
+    int x = 0;
+    for (; x + 16 <= count; x += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(mask + x));
+        __m128i *p = reinterpret_cast<__m128i *>(counts + x);
+        _mm_storeu_si128(p, _mm_add_epi16(_mm_loadu_si128(p), _mm_unpacklo_epi8(v, zero)));
+        _mm_storeu_si128(p + 1, _mm_add_epi16(_mm_loadu_si128(p + 1), _mm_unpackhi_epi8(v, zero)));
+    }
+    accumulateScalar(mask + x, count - x, counts + x);
+}
+
+PANELDETECTOR_TARGET("avx2")
+void binarizeAvx2(const uint8_t *src, uint8_t *dst, int count, uint8_t background, uint8_t threshold)
+{
+    const __m256i bg = _mm256_set1_epi8(char(background));
+    const __m256i limit = _mm256_set1_epi8(char(threshold));
+    const __m256i one = _mm256_set1_epi8(1);
+    int x = 0;
+    for (; x + 32 <= count; x += 32) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + x));
+        const __m256i difference = _mm256_or_si256(_mm256_subs_epu8(v, bg), _mm256_subs_epu8(bg, v));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + x),
+                            _mm256_min_epu8(_mm256_subs_epu8(difference, limit), one));
+    }
+    binarizeScalar(src + x, dst + x, count - x, background, threshold);
+}
+
+PANELDETECTOR_TARGET("avx2")
+uint32_t countAvx2(const uint8_t *mask, int count)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i sums = zero;
+    int x = 0;
+    for (; x + 32 <= count; x += 32) {
+        sums = _mm256_add_epi64(sums, _mm256_sad_epu8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(mask + x)),
+                                                      zero));
+    }
+    const __m128i sums128 = _mm_add_epi64(_mm256_castsi256_si128(sums), _mm256_extracti128_si256(sums, 1));
+    return uint32_t(_mm_cvtsi128_si32(sums128)) + uint32_t(_mm_extract_epi32(sums128, 2))
+         + countScalar(mask + x, count - x);
+}
+
+PANELDETECTOR_TARGET("avx2")
+void accumulateAvx2(const uint8_t *mask, int count, uint16_t *counts)
+{
+    int x = 0;
+    for (; x + 16 <= count; x += 16) {
+        const __m256i v = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(mask + x)));
+        __m256i *p = reinterpret_cast<__m256i *>(counts + x);
+        _mm256_storeu_si256(p, _mm256_add_epi16(_mm256_loadu_si256(p), v));
+    }
+    accumulateScalar(mask + x, count - x, counts + x);
+}
+
+#endif // PANELDETECTOR_X86
+
+#ifdef PANELDETECTOR_NEON
+
+void binarizeNeon(const uint8_t *src, uint8_t *dst, int count, uint8_t background, uint8_t threshold)
+{
+    const uint8x16_t bg = vdupq_n_u8(background);
+    const uint8x16_t limit = vdupq_n_u8(threshold);
+    const uint8x16_t one = vdupq_n_u8(1);
+    int x = 0;
+    for (; x + 16 <= count; x += 16) {
+        const uint8x16_t difference = vabdq_u8(vld1q_u8(src + x), bg);
+        vst1q_u8(dst + x, vandq_u8(vcgtq_u8(difference, limit), one));
+    }
+    binarizeScalar(src + x, dst + x, count - x, background, threshold);
+}
+
+uint32_t countNeon(const uint8_t *mask, int count)
+{
+    uint32x4_t sums = vdupq_n_u32(0);
+    int x = 0;
+    for (; x + 16 <= count; x += 16) {
+        sums = vpadalq_u16(sums, vpaddlq_u8(vld1q_u8(mask + x)));
+    }
+    return vgetq_lane_u32(sums, 0) + vgetq_lane_u32(sums, 1) + vgetq_lane_u32(sums, 2) + vgetq_lane_u32(sums, 3)
+         + countScalar(mask + x, count - x);
+}
+
+void accumulateNeon(const uint8_t *mask, int count, uint16_t *counts)
+{
+    int x = 0;
+    for (; x + 16 <= count; x += 16) {
+        const uint8x16_t v = vld1q_u8(mask + x);
+        vst1q_u16(counts + x, vaddw_u8(vld1q_u16(counts + x), vget_low_u8(v)));
+        vst1q_u16(counts + x + 8, vaddw_u8(vld1q_u16(counts + x + 8), vget_high_u8(v)));
+    }
+    accumulateScalar(mask + x, count - x, counts + x);
+}
+
+#endif // PANELDETECTOR_NEON
+
+Kernels kernelsFor(ImageScaler::InstructionSet set)
+{
+    switch (set) {
+#ifdef PANELDETECTOR_X86
+    case ImageScaler::AVX2:
+        return { binarizeAvx2, countAvx2, accumulateAvx2 };
+    case ImageScaler::SSE41:
+        return { binarizeSse41, countSse41, accumulateSse41 };
+#endif
+#ifdef PANELDETECTOR_NEON
+    case ImageScaler::NEON:
+        return { binarizeNeon, countNeon, accumulateNeon };
+#endif
+    default:
+        return { binarizeScalar, countScalar, accumulateScalar };
+    }
+}
+
+// 页面背景：四周边框上出现最多的亮度（白底和黑底都可以）
+int backgroundLevel(const QImage &gray)
+{
+    int histogram[256] = {};
+    const int width = gray.width();
+    const int height = gray.height();
+    const uchar *top = gray.constScanLine(0);
+    const uchar *bottom = gray.constScanLine(height - 1);
+    for (int x = 0; x < width; ++x) {
+        ++histogram[top[x]];
+        ++histogram[bottom[x]];
+    }
+    for (int y = 0; y < height; ++y) {
+        const uchar *line = gray.constScanLine(y);
+        ++histogram[line[0]];
+        ++histogram[line[width - 1]];
+    }
+    // 相邻几级亮度合在一起计数，JPEG 噪声不会把背景分散到多个亮度
+    int best = 0;
+    int bestCount = -1;
+    for (int level = 0; level < 256; ++level) {
+        int count = 0;
+        for (int i = qMax(0, level - 4); i <= qMin(255, level + 4); ++i) {
+            count += histogram[i];
+        }
+        if (count > bestCount) {
+            best = level;
+            bestCount = count;
+        }
+    }
+    return best;
+}
+
+typedef QPair<int, int> Segment;    // [first, last]
+
+// profile 中被至少 MIN_GUTTER 条空白线隔开的各段墨迹，不含两端的空白
+template <typename T>
+QVector<Segment> inkSegments(const QVector<T> &profile, int noise)
+{
+    QVector<Segment> segments;
+    int gap = 0;
+    for (int i = 0; i < profile.size(); ++i) {
+        if (int(profile.at(i)) <= noise) {
+            ++gap;
+            continue;
+        }
+        if (segments.isEmpty() || gap >= MIN_GUTTER) {
+            segments.append(Segment(i, i));
+        } else {
+            segments.last().second = i;
+        }
+        gap = 0;
+    }
+    return segments;
+}
+
+class XYCut
+{
+public:
+    XYCut(const QImage &mask, const Kernels &kernels, bool rightToLeft)
+        : m_mask(mask)
+        , m_kernels(kernels)
+        , m_rightToLeft(rightToLeft)
+        , m_minWidth(qCeil(mask.width() * MIN_PANEL_FRACTION))
+        , m_minHeight(qCeil(mask.height() * MIN_PANEL_FRACTION))
+        , m_minArea(qint64(qreal(mask.width()) * mask.height() * MIN_PANEL_AREA))
+    {
+    }
+
+    QVector<QRect> panels() const { return m_panels; }
+
+    void split(const QRect &region, int depth)
+    {
+        // 先找横贯区域的空白行
+        QVector<quint32> rows(region.height());
+        for (int y = 0; y < region.height(); ++y) {
+            rows[y] = m_kernels.count(m_mask.constScanLine(region.top() + y) + region.left(), region.width());
+        }
+        const QVector<Segment> bands = inkSegments(rows, region.width() / NOISE_DIVISOR);
+        if (bands.isEmpty()) {
+            return;
+        }
+        if (bands.size() > 1 && depth < MAX_DEPTH) {
+            for (const Segment &band : bands) {
+                split(QRect(region.left(), region.top() + band.first, region.width(), band.second - band.first + 1),
+                      depth + 1);
+            }
+            return;
+        }
+
+        // 再在有墨迹的行范围内找空白列
+        const QRect trimmed(region.left(), region.top() + bands.first().first,
+                            region.width(), bands.last().second - bands.first().first + 1);
+        QVector<quint16> columns(trimmed.width(), 0);
+        for (int y = trimmed.top(); y <= trimmed.bottom(); ++y) {
+            m_kernels.accumulate(m_mask.constScanLine(y) + trimmed.left(), trimmed.width(), columns.data());
+        }
+        QVector<Segment> strips = inkSegments(columns, trimmed.height() / NOISE_DIVISOR);
+        if (strips.isEmpty()) {
+            return;
+        }
+        if (strips.size() > 1 && depth < MAX_DEPTH) {
+            if (m_rightToLeft) {
+                std::reverse(strips.begin(), strips.end());
+            }
+            for (const Segment &strip : strips) {
+                split(QRect(trimmed.left() + strip.first, trimmed.top(), strip.second - strip.first + 1, trimmed.height()),
+                      depth + 1);
+            }
+            return;
+        }
+
+        // 切不开：去掉四周空白后作为一格，太小的不算
+        const QRect panel(trimmed.left() + strips.first().first, trimmed.top(),
+                          strips.last().second - strips.first().first + 1, trimmed.height());
+        if (panel.width() >= m_minWidth && panel.height() >= m_minHeight
+            && qint64(panel.width()) * panel.height() >= m_minArea) {
+            m_panels.append(panel);
+        }
+    }
+
+private:
+    const QImage &m_mask;
+    const Kernels &m_kernels;
+    const bool m_rightToLeft;
+    const int m_minWidth;
+    const int m_minHeight;
+    const qint64 m_minArea;
+    QVector<QRect> m_panels;
+};
+
+// 把 from 尺寸图片中的 rect 换算到 to 尺寸，向外取整并多留一个分析图像素
+QRect mapRect(const QRect &rect, const QSize &from, const QSize &to)
+{
+    const qreal sx = qreal(to.width()) / from.width();
+    const qreal sy = qreal(to.height()) / from.height();
+    const QPoint topLeft(int(std::floor((rect.left() - 1) * sx)), int(std::floor((rect.top() - 1) * sy)));
+    const QPoint bottomRight(int(std::ceil((rect.right() + 2) * sx)) - 1, int(std::ceil((rect.bottom() + 2) * sy)) - 1);
+    return QRect(topLeft, bottomRight) & QRect(QPoint(0, 0), to);
+}
+
+QVector<QRect> mapPanels(const QVector<QRect> &panels, const QSize &from, const QSize &to)
+{
+    QVector<QRect> mapped;
+    mapped.reserve(panels.size());
+    for (const QRect &panel : panels) {
+        mapped.append(mapRect(panel, from, to));
+    }
+    return mapped;
+}
+
+} // namespace
+
+QVector<QRect> PanelDetector::detect(const QImage &image, bool rightToLeft)
+{
+    if (image.isNull()) {
+        return QVector<QRect>();
+    }
+    const QImage gray = analysisImage(image);
+    return mapPanels(detectInAnalysisImage(gray, rightToLeft), gray.size(), image.size());
+}
+
+QVector<QRect> PanelDetector::detect(const QByteArray &data, bool rightToLeft, QSize *fullSize)
+{
+    // 只需要分析图的分辨率：JPEG 按 1/2～1/8 解码
+    const QSize size = ImageDecoder::imageSize(data);
+    qreal scale = 1.0;
+    if (size.isValid()) {
+        scale = qreal(ANALYSIS_SIZE) / qMax(size.width(), size.height());
+    }
+    QSize decodedFull;
+    const QImage image = ImageDecoder::decode(data, scale, &decodedFull);
+    if (fullSize) {
+        *fullSize = image.isNull() ? QSize() : decodedFull;
+    }
+    if (image.isNull() || !decodedFull.isValid()) {
+        return QVector<QRect>();
+    }
+    const QImage gray = analysisImage(image);
+    return mapPanels(detectInAnalysisImage(gray, rightToLeft), gray.size(), decodedFull);
+}
+
+QImage PanelDetector::analysisImage(const QImage &image)
+{
+    if (image.width() <= ANALYSIS_SIZE && image.height() <= ANALYSIS_SIZE) {
+        return image.convertToFormat(QImage::Format_Grayscale8);
+    }
+    const QImage::Format format = image.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied
+                                                          : QImage::Format_RGB32;
+    // 各页在不同的线程中并行分析，缩放只使用调用线程
+    return ImageScaler::scaleToFit(image.convertToFormat(format), QSize(ANALYSIS_SIZE, ANALYSIS_SIZE),
+                                   ImageScaler::Area, 1)
+        .convertToFormat(QImage::Format_Grayscale8);
+}
+
+QImage PanelDetector::binarize(const QImage &gray, int background, int threshold)
+{
+    if (gray.isNull() || gray.format() != QImage::Format_Grayscale8) {
+        return QImage();
+    }
+    const Kernels kernels = kernelsFor(ImageScaler::instructionSet());
+    QImage mask(gray.size(), QImage::Format_Grayscale8);
+    for (int y = 0; y < gray.height(); ++y) {
+        kernels.binarize(gray.constScanLine(y), mask.scanLine(y), gray.width(),
+                         uint8_t(qBound(0, background, 255)), uint8_t(qBound(0, threshold, 255)));
+    }
+    return mask;
+}
+
+QVector<QRect> PanelDetector::detectInAnalysisImage(const QImage &gray, bool rightToLeft)
+{
+    // 每列的计数为16位，分析图的高度远小于上限
+    if (gray.isNull() || gray.format() != QImage::Format_Grayscale8 || gray.height() > 65535) {
+        return QVector<QRect>();
+    }
+    const Kernels kernels = kernelsFor(ImageScaler::instructionSet());
+    const QImage mask = binarize(gray, backgroundLevel(gray), INK_THRESHOLD);
+    XYCut cut(mask, kernels, rightToLeft);
+    cut.split(mask.rect(), 0);
+    const QVector<QRect> panels = cut.panels();
+    return panels.size() < 2 ? QVector<QRect>() : panels;
+}
@@ -0,0 +1,141 @@
+#include "core/metrics/PageTurnMetrics.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QFile>
+#include <QJsonDocument>
+#include <QMutexLocker>
+#include <QSysInfo>
+
+PageTurnMetrics::PageTurnMetrics()
+{
+    for (int stage = 0; stage < StageCount; ++stage) {
+        m_current[stage] = 0;
+        m_windowCount[stage] = 0;
+    }
+    for (int source = 0; source < SourceCount; ++source) {
+        m_sources[source] = 0;
+    }
+}
+
+void PageTurnMetrics::record(Stage stage, qint64 nanoseconds)
+{
+    QMutexLocker locker(&m_mutex);
+    m_windows[stage][m_current[stage]].record(nanoseconds);
+    if (++m_windowCount[stage] >= WINDOW_SIZE) {
+        // 当前窗口记满：清空较旧的窗口并切换过去
+        m_current[stage] ^= 1;
+        m_windows[stage][m_current[stage]].reset();
+        m_windowCount[stage] = 0;
+    }
+}
+
+void PageTurnMetrics::recordSource(Source source)
+{
+    QMutexLocker locker(&m_mutex);
+    ++m_sources[source];
+}
+
+void PageTurnMetrics::reset()
+{
+    QMutexLocker locker(&m_mutex);
+    for (int stage = 0; stage < StageCount; ++stage) {
+        m_windows[stage][0].reset();
+        m_windows[stage][1].reset();
+        m_current[stage] = 0;
+        m_windowCount[stage] = 0;
+    }
+    for (int source = 0; source < SourceCount; ++source) {
+        m_sources[source] = 0;
+    }
+}
+
+PageTurnMetrics::Snapshot PageTurnMetrics::snapshot() const
+{
+    QMutexLocker locker(&m_mutex);
+    Snapshot result;
+    for (int stage = 0; stage < StageCount; ++stage) {
+        result.stages[stage] = m_windows[stage][0].snapshot();
+        result.stages[stage].merge(m_windows[stage][1].snapshot());
+    }
+    for (int source = 0; source < SourceCount; ++source) {
+        result.sources[source] = m_sources[source];
+    }
+    return result;
+}
+
+bool PageTurnMetrics::exportToFile(const QString &filePath) const
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+
+    QJsonObject build;
+    build["application"] = QCoreApplication::applicationName();
+    build["version"] = QCoreApplication::applicationVersion();
+    build["qtVersion"] = QString::fromLatin1(qVersion());
+    build["abi"] = QSysInfo::buildAbi();
+    build["cpu"] = QSysInfo::currentCpuArchitecture();
+    build["os"] = QSysInfo::prettyProductName();
+
+    QJsonObject json = snapshot().toJson();
+    json["build"] = build;
+    json["exportedAt"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    file.write(QJsonDocument(json).toJson(QJsonDocument::Indented));
+    return true;
+}
+
+QString PageTurnMetrics::stageName(Stage stage)
+{
+    switch (stage) {
+    case Turn:        return QStringLiteral("turn");
+    case CacheLookup: return QStringLiteral("cacheLookup");
+    case Fetch:       return QStringLiteral("fetch");
+    case Inflate:     return QStringLiteral("inflate");
+    case Decode:      return QStringLiteral("decode");
+    case Scale:       return QStringLiteral("scale");
+    case Paint:       return QStringLiteral("paint");
+    case StageCount:  break;
+    }
+    return QString();
+}
+
+QString PageTurnMetrics::sourceName(Source source)
+{
+    switch (source) {
+    case PixmapCache:  return QStringLiteral("pixmapCache");
+    case DecodedCache: return QStringLiteral("decodedCache");
+    case RawMemory:    return QStringLiteral("rawMemory");
+    case RawDisk:      return QStringLiteral("rawDisk");
+    case Archive:      return QStringLiteral("archive");
+    case SourceCount:  break;
+    }
+    return QString();
+}
+
+qint64 PageTurnMetrics::Snapshot::sourceTotal() const
+{
+    qint64 total = 0;
+    for (int source = 0; source < SourceCount; ++source) {
+        total += sources[source];
+    }
+    return total;
+}
+
+QJsonObject PageTurnMetrics::Snapshot::toJson() const
+{
+    QJsonObject stageJson;
+    for (int stage = 0; stage < StageCount; ++stage) {
+        stageJson[stageName(Stage(stage))] = stages[stage].toJson();
+    }
+    QJsonObject sourceJson;
+    for (int source = 0; source < SourceCount; ++source) {
+        sourceJson[sourceName(Source(source))] = sources[source];
+    }
+
+    QJsonObject json;
+    json["windowSize"] = WINDOW_SIZE;
+    json["stages"] = stageJson;
+    json["sources"] = sourceJson;
+    return json;
+}
@@ -1,5 +1,6 @@
 #include "core/parsers/ComicParser.h"
 #include "core/utils/FileUtils.h"
+#include "core/cache/MemoryGovernor.h"
 #include <QDir>
 #include <QFileInfo>
 #include <QPixmap>
@@ -31,6 +32,9 @@ ComicParser::ComicParser(QObject *parent)
     , m_rarProcess(nullptr)
     , m_cacheEnabled(true)
     , m_maxCacheSize(10)
+    , m_cacheBytes(0)
+    , m_lastAccessedPage(0)
+    , m_governorId(-1)
 {
     // 创建临时目录
     m_tempDir = QStandardPaths::writableLocation(QStandardPaths::TempLocation) + "/ComicReader";
@@ -45,10 +49,15 @@ ComicParser::ComicParser(QObject *parent)
     
     // 设置RAR工具路径（简化实现）
     m_rarToolPath = QString();
+    
+    // 页面缓存计入全局内存预算
+    m_governorId = MemoryGovernor::instance()->registerCache("ComicParser", MemoryGovernor::NormalPriority,
+                                                             [this](qint64 bytes) { return reclaimCache(bytes); });
 }
 
 ComicParser::~ComicParser()
 {
+    MemoryGovernor::instance()->unregisterCache(m_governorId);
     closeFile();
     
     // 清理临时目录
@@ -201,6 +210,8 @@ ComicPage ComicParser::getPage(int pageNumber) const
         return ComicPage();
     }
     
+    m_lastAccessedPage = pageNumber;
+    
     // 检查缓存
     if (m_cacheEnabled && isInCache(pageNumber)) {
         return getFromCache(pageNumber);
@@ -232,6 +243,7 @@ ComicPage ComicParser::getPage(int pageNumber) const
         // 添加到缓存
         if (m_cacheEnabled) {
             addToCache(pageNumber, page);
+            MemoryGovernor::instance()->checkBudget();
         }
     }
     
@@ -271,6 +283,8 @@ void ComicParser::clearCache()
 {
     QMutexLocker locker(&m_cacheMutex);
     m_pageCache.clear();
+    m_cacheBytes = 0;
+    MemoryGovernor::instance()->updateUsage(m_governorId, 0);
 }
 
 void ComicParser::setCacheSize(int maxPages)
@@ -365,12 +379,17 @@ void ComicParser::addToCache(int pageNumber, const ComicPage &page) const
     QMutexLocker locker(&m_cacheMutex);
     
     // 清理缓存空间
+    auto existing = m_pageCache.find(pageNumber);
+    if (existing != m_pageCache.end()) {
+        removeFromCacheLocked(existing);
+    }
     while (m_pageCache.size() >= m_maxCacheSize) {
-        auto it = m_pageCache.begin();
-        m_pageCache.erase(it);
+        removeFromCacheLocked(m_pageCache.begin());
     }
     
     m_pageCache[pageNumber] = page;
+    m_cacheBytes += page.data.size();
+    MemoryGovernor::instance()->updateUsage(m_governorId, m_cacheBytes);
 }
 
 ComicPage ComicParser::getFromCache(int pageNumber) const
@@ -390,9 +409,34 @@ void ComicParser::cleanCache()
     QMutexLocker locker(&m_cacheMutex);
     
     while (m_pageCache.size() > m_maxCacheSize) {
-        auto it = m_pageCache.begin();
-        m_pageCache.erase(it);
+        removeFromCacheLocked(m_pageCache.begin());
+    }
+    MemoryGovernor::instance()->updateUsage(m_governorId, m_cacheBytes);
+}
+
+void ComicParser::removeFromCacheLocked(QMap<int, ComicPage>::iterator it) const
+{
+    // 调用方需持有 m_cacheMutex
+    m_cacheBytes -= it.value().data.size();
+    m_pageCache.erase(it);
+}
+
+qint64 ComicParser::reclaimCache(qint64 bytes)
+{
+    // 由 MemoryGovernor 调用：先丢弃离最近访问页最远的页面
+    QMutexLocker locker(&m_cacheMutex);
+    const qint64 before = m_cacheBytes;
+    
+    while (!m_pageCache.isEmpty() && before - m_cacheBytes < bytes) {
+        auto first = m_pageCache.begin();
+        auto last = std::prev(m_pageCache.end());
+        const int firstDistance = qAbs(first.key() - m_lastAccessedPage);
+        const int lastDistance = qAbs(last.key() - m_lastAccessedPage);
+        removeFromCacheLocked(firstDistance >= lastDistance ? first : last);
     }
+    
+    MemoryGovernor::instance()->updateUsage(m_governorId, m_cacheBytes);
+    return before - m_cacheBytes;
 }
 
 // ZIP操作占位符
@@ -0,0 +1,637 @@
+#include "ui/library/LibraryScanner.h"
+#include "core/ComicParser.h"
+#include "core/CacheManager.h"
+#include "core/image/ImageDecoder.h"
+#include <QAtomicInt>
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+#include <cstring>
+#include <deque>
+#include <memory>
+
+#ifdef Q_OS_UNIX
+#include <cerrno>
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+namespace {
+
+// 遍历线程主要在等待I/O（尤其是网络共享上的目录），数量不按核心数决定
+const int WALKER_COUNT = 8;
+// 每个元数据任务处理的文件数
+const int FILES_PER_TASK = 32;
+// 每个检查任务 stat 的已知文件数
+const int VERIFY_PER_TASK = 256;
+
+const char *const COMIC_SUFFIXES[] = { "cbz", "cbr", "zip", "rar" };
+
+#ifdef Q_OS_UNIX
+// 直接检查 readdir 给出的文件名，不是漫画的文件不必转换成 QString
+bool hasComicSuffix(const char *name)
+{
+    const char *dot = std::strrchr(name, '.');
+    if (!dot) {
+        return false;
+    }
+    for (const char *suffix : COMIC_SUFFIXES) {
+        if (qstricmp(dot + 1, suffix) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+LibraryScanner::Fingerprint fingerprintFromStat(const struct stat &st)
+{
+    LibraryScanner::Fingerprint fingerprint;
+    fingerprint.device = quint64(st.st_dev);
+    fingerprint.inode = quint64(st.st_ino);
+    fingerprint.size = qint64(st.st_size);
+#ifdef Q_OS_DARWIN
+    fingerprint.modifiedNs = qint64(st.st_mtimespec.tv_sec) * 1000000000 + st.st_mtimespec.tv_nsec;
+#else
+    fingerprint.modifiedNs = qint64(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+#endif
+    return fingerprint;
+}
+#else
+// 没有 stat 的平台：设备号和 inode 为0，只比较大小和修改时间
+LibraryScanner::Fingerprint fingerprintFromInfo(const QFileInfo &info)
+{
+    LibraryScanner::Fingerprint fingerprint;
+    fingerprint.size = info.size();
+    fingerprint.modifiedNs = info.lastModified().toMSecsSinceEpoch() * 1000000;
+    return fingerprint;
+}
+#endif
+
+// 读取文件指纹；只有文件确实不存在时 missing 为 true，网络共享暂时无法访问等错误不算丢失
+LibraryScanner::Fingerprint readFingerprint(const QString &filePath, bool *missing)
+{
+    *missing = false;
+#ifdef Q_OS_UNIX
+    struct stat st;
+    if (::stat(QFile::encodeName(filePath).constData(), &st) != 0) {
+        *missing = errno == ENOENT || errno == ENOTDIR;
+        return LibraryScanner::Fingerprint();
+    }
+    if (!S_ISREG(st.st_mode)) {
+        *missing = true;
+        return LibraryScanner::Fingerprint();
+    }
+    return fingerprintFromStat(st);
+#else
+    const QFileInfo info(filePath);
+    if (!info.isFile()) {
+        *missing = true;
+        return LibraryScanner::Fingerprint();
+    }
+    return fingerprintFromInfo(info);
+#endif
+}
+
+} // namespace
+
+// ==================== Fingerprint ====================
+
+LibraryScanner::Fingerprint LibraryScanner::Fingerprint::fromFile(const QString &filePath)
+{
+    bool missing;
+    return readFingerprint(filePath, &missing);
+}
+
+QString LibraryScanner::Fingerprint::toString() const
+{
+    if (!isValid()) {
+        return QString();
+    }
+    return QString("%1:%2:%3:%4").arg(device).arg(inode).arg(size).arg(modifiedNs);
+}
+
+LibraryScanner::Fingerprint LibraryScanner::Fingerprint::fromString(const QString &text)
+{
+    const QStringList fields = text.split(QLatin1Char(':'));
+    if (fields.size() != 4) {
+        return Fingerprint();
+    }
+
+    Fingerprint fingerprint;
+    bool ok[4];
+    fingerprint.device = fields[0].toULongLong(&ok[0]);
+    fingerprint.inode = fields[1].toULongLong(&ok[1]);
+    fingerprint.size = fields[2].toLongLong(&ok[2]);
+    fingerprint.modifiedNs = fields[3].toLongLong(&ok[3]);
+    if (!ok[0] || !ok[1] || !ok[2] || !ok[3]) {
+        return Fingerprint();
+    }
+    return fingerprint;
+}
+
+// ==================== LibraryScanner ====================
+
+struct LibraryScanner::Scan {
+    struct Queue {
+        QMutex mutex;
+        std::deque<QString> directories;
+    };
+
+    bool recursive = true;
+    bool verifyKnown = false;
+    QHash<QString, Fingerprint> known;
+    QSize thumbnailSize;
+    MetadataExtractor extractor;
+
+    std::unique_ptr<Queue[]> queues;    // 每个遍历线程一个
+    QAtomicInt cancelled;
+    QAtomicInt pendingDirectories;      // 已入队、还没有读完的目录
+    QAtomicInt queuedDirectories;       // 还在队列中、没有被取走的目录
+    QAtomicInt walkers;                 // 还没有结束的遍历线程，最后一个结束时检查已知文件
+    QAtomicInt outstanding;             // 还没有结束的遍历线程和元数据任务，减到0时扫描结束
+    QAtomicInt found;                   // 需要提取元数据的文件
+    QAtomicInt processed;
+
+    // 空闲的遍历线程在这里等待新目录入队、所有目录读完或扫描取消
+    QMutex idleMutex;
+    QWaitCondition workAvailable;
+
+    QMutex listingMutex;
+    QSet<QString> listed;               // 完整读过的目录（以 '/' 结尾）
+    QSet<QString> seen;                 // 这些目录中出现过的已知文件
+
+    QMutex resultMutex;
+    QVector<Entry> results;             // 还没有交给GUI线程的结果
+    QStringList missing;                // 已经不存在的已知文件
+    QElapsedTimer progressTimer;
+
+    // 状态改变之后调用；持有 idleMutex 唤醒，等待的线程不会错过
+    void wakeWalkers()
+    {
+        QMutexLocker locker(&idleMutex);
+        workAvailable.wakeAll();
+    }
+};
+
+LibraryScanner::LibraryScanner(QObject *parent)
+    : QObject(parent)
+{
+    m_walkPool.setMaxThreadCount(WALKER_COUNT);
+    m_metadataPool.setMaxThreadCount(qMax(1, QThread::idealThreadCount()));
+}
+
+LibraryScanner::~LibraryScanner()
+{
+    if (m_scan) {
+        m_scan->cancelled.storeRelease(1);
+        m_scan->wakeWalkers();
+    }
+    m_metadataPool.clear();
+    m_walkPool.waitForDone();
+    m_metadataPool.waitForDone();
+}
+
+void LibraryScanner::setMetadataExtractor(const MetadataExtractor &extractor)
+{
+    m_extractor = extractor;
+}
+
+void LibraryScanner::start(const QStringList &roots, bool recursive, const QHash<QString, Fingerprint> &known,
+                           const QSize &thumbnailSize, bool verifyKnown)
+{
+    if (m_scan) {
+        m_scan->cancelled.storeRelease(1);
+        m_scan->wakeWalkers();
+        m_scan.reset();
+    }
+
+    QSharedPointer<Scan> scan(new Scan);
+    scan->recursive = recursive;
+    scan->verifyKnown = verifyKnown;
+    scan->known = known;
+    scan->thumbnailSize = thumbnailSize;
+    scan->extractor = m_extractor;
+    scan->queues.reset(new Scan::Queue[WALKER_COUNT]);
+
+    // 各根目录轮流分给各遍历线程
+    QSet<QString> seen;
+    int next = 0;
+    for (const QString &root : roots) {
+        const QString path = QDir(root).absolutePath();
+        if (root.isEmpty() || seen.contains(path)) {
+            continue;
+        }
+        seen.insert(path);
+        scan->queues[next++ % WALKER_COUNT].directories.push_back(path);
+        scan->pendingDirectories.fetchAndAddOrdered(1);
+        scan->queuedDirectories.fetchAndAddOrdered(1);
+    }
+
+    scan->progressTimer.start();
+    scan->walkers.storeRelease(WALKER_COUNT);
+    scan->outstanding.storeRelease(WALKER_COUNT);
+    m_scan = scan;
+    for (int worker = 0; worker < WALKER_COUNT; ++worker) {
+        m_walkPool.start([this, scan, worker]() { walk(scan, worker); });
+    }
+}
+
+void LibraryScanner::cancel()
+{
+    if (!m_scan) {
+        return;
+    }
+    // 工作线程看到标记后尽快退出，之后晚到的结果因 m_scan 已经改变而被丢弃
+    m_scan->cancelled.storeRelease(1);
+    m_scan->wakeWalkers();
+    m_scan.reset();
+    emit finished(true);
+}
+
+bool LibraryScanner::isComicFileName(const QString &fileName)
+{
+    const int dot = fileName.lastIndexOf(QLatin1Char('.'));
+    if (dot < 0) {
+        return false;
+    }
+    const QStringView suffix = QStringView(fileName).mid(dot + 1);
+    for (const char *comicSuffix : COMIC_SUFFIXES) {
+        if (suffix.compare(QLatin1String(comicSuffix), Qt::CaseInsensitive) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+CacheKey LibraryScanner::thumbnailKey(const QString &filePath, const QSize &size)
+{
+    return CacheKey::forArchiveEntry(filePath, 0, QString("thumbnail:%1x%2").arg(size.width()).arg(size.height()));
+}
+
+void LibraryScanner::walk(const QSharedPointer<Scan> &scan, int worker)
+{
+    QString dirPath;
+    while (!scan->cancelled.loadAcquire()) {
+        if (takeDirectory(scan.data(), worker, &dirPath)) {
+            listDirectory(scan, worker, dirPath);
+            // 子目录在读完父目录之前已经计入，计数到0时不会再有新的目录
+            if (scan->pendingDirectories.fetchAndSubOrdered(1) == 1) {
+                scan->wakeWalkers();
+            }
+            continue;
+        }
+
+        // 其他线程正在读的目录中可能还有子目录：等到有目录入队或全部读完
+        QMutexLocker locker(&scan->idleMutex);
+        if (scan->pendingDirectories.loadAcquire() == 0) {
+            break;
+        }
+        while (!scan->cancelled.loadAcquire() && scan->queuedDirectories.loadAcquire() == 0
+               && scan->pendingDirectories.loadAcquire() != 0) {
+            scan->workAvailable.wait(&scan->idleMutex);
+        }
+    }
+
+    // 目录都读完后，已知文件中哪些丢失、哪些需要单独检查才能确定
+    if (scan->walkers.fetchAndSubOrdered(1) == 1 && !scan->cancelled.loadAcquire()) {
+        submitUnlisted(scan);
+    }
+    release(scan);
+}
+
+bool LibraryScanner::takeDirectory(Scan *scan, int worker, QString *dirPath)
+{
+    // 自己的队列取最后入队的（刚读过的目录的子目录）
+    Scan::Queue &own = scan->queues[worker];
+    {
+        QMutexLocker locker(&own.mutex);
+        if (!own.directories.empty()) {
+            *dirPath = own.directories.back();
+            own.directories.pop_back();
+            scan->queuedDirectories.fetchAndSubOrdered(1);
+            return true;
+        }
+    }
+
+    // 从其他线程的队列窃取最早入队的
+    for (int i = 1; i < WALKER_COUNT; ++i) {
+        Scan::Queue &victim = scan->queues[(worker + i) % WALKER_COUNT];
+        QMutexLocker locker(&victim.mutex);
+        if (!victim.directories.empty()) {
+            *dirPath = victim.directories.front();
+            victim.directories.pop_front();
+            scan->queuedDirectories.fetchAndSubOrdered(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+void LibraryScanner::listDirectory(const QSharedPointer<Scan> &scan, int worker, const QString &dirPath)
+{
+    QVector<Entry> files;
+    QStringList subdirectories;
+    const QString prefix = dirPath.endsWith(QLatin1Char('/')) ? dirPath : dirPath + QLatin1Char('/');
+    bool complete = true;
+
+#ifdef Q_OS_UNIX
+    DIR *dir = ::opendir(QFile::encodeName(dirPath).constData());
+    if (!dir) {
+        return;
+    }
+    const int fd = ::dirfd(dir);
+    for (;;) {
+        if (scan->cancelled.loadRelaxed()) {
+            complete = false;
+            break;
+        }
+        errno = 0;
+        const dirent *entry = ::readdir(dir);
+        if (!entry) {
+            // 读到一半出错的目录不能用来判断文件是否丢失
+            complete = complete && errno == 0;
+            break;
+        }
+        // "."、".." 和隐藏文件（与 QDir 默认的过滤一致）
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+
+        struct stat st;
+        bool hasStat = false;
+        bool isDirectory = entry->d_type == DT_DIR;
+        bool isFile = entry->d_type == DT_REG;
+        if (entry->d_type == DT_UNKNOWN || entry->d_type == DT_LNK) {
+            // 有些文件系统不提供类型；符号链接按目标的类型处理，但不进入链接的目录，避免循环
+            if (::fstatat(fd, entry->d_name, &st, 0) != 0) {
+                complete = complete && (errno == ENOENT || !hasComicSuffix(entry->d_name));
+                continue;
+            }
+            hasStat = true;
+            isDirectory = S_ISDIR(st.st_mode) && entry->d_type != DT_LNK;
+            isFile = S_ISREG(st.st_mode);
+        }
+
+        if (isDirectory) {
+            if (scan->recursive) {
+                subdirectories.append(prefix + QFile::decodeName(entry->d_name));
+            }
+        } else if (isFile && hasComicSuffix(entry->d_name)) {
+            // 指纹只需要 stat，不打开文件
+            if (!hasStat && ::fstatat(fd, entry->d_name, &st, 0) != 0) {
+                complete = complete && errno == ENOENT;
+                continue;
+            }
+            Entry file;
+            file.filePath = prefix + QFile::decodeName(entry->d_name);
+            file.fingerprint = fingerprintFromStat(st);
+            files.append(file);
+        }
+    }
+    ::closedir(dir);
+#else
+    // QDirIterator 不报告错误，打不开的目录（网络共享离线、没有权限）会像空目录一样，
+    // 先确认可以读取，否则其中的已知文件都会被当作丢失
+    const QFileInfo dirInfo(dirPath);
+    if (!dirInfo.isDir() || !dirInfo.isReadable()) {
+        return;
+    }
+    QDirIterator it(dirPath, QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot);
+    while (it.hasNext()) {
+        if (scan->cancelled.loadRelaxed()) {
+            complete = false;
+            break;
+        }
+        it.next();
+        const QFileInfo info = it.fileInfo();
+        if (info.isDir()) {
+            if (scan->recursive && !info.isSymLink()) {
+                subdirectories.append(prefix + info.fileName());
+            }
+        } else if (isComicFileName(info.fileName())) {
+            Entry file;
+            file.filePath = prefix + info.fileName();
+            file.fingerprint = fingerprintFromInfo(info);
+            files.append(file);
+        }
+    }
+#endif
+
+    if (!subdirectories.isEmpty()) {
+        scan->pendingDirectories.fetchAndAddOrdered(subdirectories.size());
+        {
+            Scan::Queue &own = scan->queues[worker];
+            QMutexLocker locker(&own.mutex);
+            for (const QString &subdirectory : subdirectories) {
+                own.directories.push_back(subdirectory);
+            }
+        }
+        scan->queuedDirectories.fetchAndAddOrdered(subdirectories.size());
+        scan->wakeWalkers();
+    }
+
+    // 指纹与库中记录相同的文件不再打开
+    QVector<Entry> changed;
+    QStringList seenKnown;
+    for (const Entry &file : files) {
+        const auto known = scan->known.constFind(file.filePath);
+        if (known != scan->known.constEnd()) {
+            seenKnown.append(file.filePath);
+            if (*known == file.fingerprint) {
+                continue;
+            }
+        }
+        changed.append(file);
+    }
+    if (complete) {
+        QMutexLocker locker(&scan->listingMutex);
+        scan->listed.insert(prefix);
+        for (const QString &filePath : seenKnown) {
+            scan->seen.insert(filePath);
+        }
+    }
+    if (!changed.isEmpty()) {
+        submitFiles(scan, changed);
+    }
+}
+
+void LibraryScanner::submitFiles(const QSharedPointer<Scan> &scan, const QVector<Entry> &files)
+{
+    scan->found.fetchAndAddOrdered(files.size());
+    for (int i = 0; i < files.size(); i += FILES_PER_TASK) {
+        const QVector<Entry> chunk = files.mid(i, FILES_PER_TASK);
+        // 提交之前计入，调用者（遍历线程或检查任务）还没有结束，计数不会提前减到0
+        scan->outstanding.fetchAndAddOrdered(1);
+        m_metadataPool.start([this, scan, chunk]() { extractMetadata(scan, chunk); });
+    }
+}
+
+void LibraryScanner::submitUnlisted(const QSharedPointer<Scan> &scan)
+{
+    // 所在目录完整读过的已知文件没有出现就是丢失了，不必再 stat；
+    // 其余的（单独添加的、所在目录已经不存在或读取失败的、隐藏的）只在 verifyKnown 时逐个检查
+    QStringList missing;
+    QStringList unlisted;
+    {
+        QMutexLocker locker(&scan->listingMutex);
+        for (auto it = scan->known.constBegin(); it != scan->known.constEnd(); ++it) {
+            const QString &filePath = it.key();
+            const int slash = filePath.lastIndexOf(QLatin1Char('/'));
+            if (slash + 1 >= filePath.size()) {
+                continue;   // 空路径或目录形式的路径不是库中的文件
+            }
+            const bool hidden = filePath.at(slash + 1) == QLatin1Char('.');
+            if (!hidden && scan->listed.contains(filePath.left(slash + 1))) {
+                if (!scan->seen.contains(filePath)) {
+                    missing.append(filePath);
+                }
+            } else if (scan->verifyKnown) {
+                unlisted.append(filePath);
+            }
+        }
+    }
+
+    if (!missing.isEmpty()) {
+        QMutexLocker locker(&scan->resultMutex);
+        scan->missing += missing;
+    }
+    for (int i = 0; i < unlisted.size(); i += VERIFY_PER_TASK) {
+        const QStringList chunk = unlisted.mid(i, VERIFY_PER_TASK);
+        scan->outstanding.fetchAndAddOrdered(1);
+        m_metadataPool.start([this, scan, chunk]() { verifyFiles(scan, chunk); });
+    }
+}
+
+void LibraryScanner::extractMetadata(const QSharedPointer<Scan> &scan, QVector<Entry> entries)
+{
+    CacheManager *cache = CacheManager::instance();
+    for (Entry &entry : entries) {
+        if (scan->cancelled.loadAcquire()) {
+            break;
+        }
+
+        const QString &filePath = entry.filePath;
+        if (scan->extractor) {
+            entry.metadata = scan->extractor(filePath);
+        }
+
+        ComicParser parser;
+        if (parser.parseComic(filePath)) {
+            entry.pageCount = parser.getComicInfo().pageCount;
+
+            // 封面缩略图写入缓存，交给GUI线程的是映射的图片，不占用堆内存
+            if (scan->thumbnailSize.isValid()) {
+                const CacheKey key = thumbnailKey(filePath, scan->thumbnailSize);
+                entry.cover = cache->getDecodedImage(key);
+                if (entry.cover.isNull()) {
+                    const QImage cover = ImageDecoder::decodeToFit(parser.getPageData(0), scan->thumbnailSize);
+                    if (!cover.isNull()) {
+                        entry.cover = cache->cacheDecodedImage(key, cover);
+                    }
+                }
+            }
+        }
+
+        {
+            QMutexLocker locker(&scan->resultMutex);
+            scan->results.append(entry);
+        }
+        scan->processed.fetchAndAddOrdered(1);
+        publishResults(scan, false);
+    }
+    release(scan);
+}
+
+void LibraryScanner::verifyFiles(const QSharedPointer<Scan> &scan, const QStringList &files)
+{
+    QVector<Entry> changed;
+    QStringList missing;
+    for (const QString &filePath : files) {
+        if (scan->cancelled.loadAcquire()) {
+            break;
+        }
+        bool fileMissing = false;
+        const Fingerprint fingerprint = readFingerprint(filePath, &fileMissing);
+        if (!fingerprint.isValid()) {
+            if (fileMissing) {
+                missing.append(filePath);
+            }
+        } else if (fingerprint != scan->known.value(filePath)) {
+            Entry entry;
+            entry.filePath = filePath;
+            entry.fingerprint = fingerprint;
+            changed.append(entry);
+        }
+    }
+
+    if (!missing.isEmpty()) {
+        QMutexLocker locker(&scan->resultMutex);
+        scan->missing += missing;
+    }
+    if (!changed.isEmpty() && !scan->cancelled.loadAcquire()) {
+        submitFiles(scan, changed);
+    }
+    release(scan);
+}
+
+void LibraryScanner::publishResults(const QSharedPointer<Scan> &scan, bool force)
+{
+    QMutexLocker locker(&scan->resultMutex);
+
+    QVector<Entry> batch;
+    if (force || scan->results.size() >= BATCH_SIZE) {
+        batch.swap(scan->results);
+    }
+    const bool reportProgress = force || scan->progressTimer.elapsed() >= PROGRESS_INTERVAL_MS;
+    if (batch.isEmpty() && !reportProgress) {
+        return;
+    }
+    if (reportProgress) {
+        scan->progressTimer.restart();
+    }
+
+    // 持有锁时投递，各批结果按产生的顺序到达GUI线程
+    const int processed = scan->processed.loadAcquire();
+    const int found = scan->found.loadAcquire();
+    QMetaObject::invokeMethod(this, [this, scan, batch, reportProgress, processed, found]() {
+        if (scan != m_scan) {
+            return;
+        }
+        if (!batch.isEmpty()) {
+            emit batchReady(batch);
+        }
+        if (reportProgress) {
+            emit progress(processed, found);
+        }
+    }, Qt::QueuedConnection);
+}
+
+void LibraryScanner::release(const QSharedPointer<Scan> &scan)
+{
+    if (scan->outstanding.fetchAndSubOrdered(1) != 1 || scan->cancelled.loadAcquire()) {
+        return;
+    }
+
+    // 最后结束的任务交出剩余的结果和丢失的文件
+    publishResults(scan, true);
+    QStringList missing;
+    {
+        QMutexLocker locker(&scan->resultMutex);
+        missing = scan->missing;
+    }
+    QMetaObject::invokeMethod(this, [this, scan, missing]() {
+        if (scan != m_scan) {
+            return;
+        }
+        m_scan.reset();
+        if (!missing.isEmpty()) {
+            emit filesMissing(missing);
+        }
+        emit finished(false);
+    }, Qt::QueuedConnection);
+}
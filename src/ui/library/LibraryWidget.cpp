@@ -1,7 +1,9 @@
 #include "../../../include/ui/library/LibraryWidget.h"
 #include "../../../include/core/ComicParser.h"
 #include "../../../include/core/ConfigManager.h"
-#include "../../../include/core/cache/CacheManager.h"
+#include "../../../include/core/CacheManager.h"
+#include "../../../include/core/cache/MemoryGovernor.h"
+#include "../../../include/core/image/ImageDecoder.h"
 #include <QApplication>
 #include <QHeaderView>
 #include <QFileDialog>
@@ -18,6 +20,9 @@
 #include <QConcurrentRun>
 #include <QFutureWatcher>
 #include <QDebug>
+#include <QThread>
+#include <QRegularExpression>
+#include <QSet>
 
 LibraryWidget::LibraryWidget(QWidget *parent)
     : QWidget(parent)
@@ -53,12 +58,22 @@ LibraryWidget::LibraryWidget(QWidget *parent)
     , m_thumbnailSize(128, 192)
     , m_fileWatcher(new QFileSystemWatcher(this))
     , m_scanTimer(new QTimer(this))
+    , m_scanner(new LibraryScanner(this))
+    , m_scanRecursive(true)
+    , m_scanVerify(false)
     , m_isScanning(false)
     , m_scanCurrentItem(0)
     , m_scanTotal(0)
     , m_searchTimer(new QTimer(this))
     , m_maxThumbnailCacheSize(100)
+    , m_governorId(-1)
 {
+    updateThumbnailCacheLimit();
+    m_governorId = MemoryGovernor::instance()->registerCache("LibraryThumbnails", MemoryGovernor::LowPriority,
+                                                             [this](qint64 bytes) { return reclaimThumbnails(bytes); });
+    
+    m_scanner->setMetadataExtractor(&LibraryWidget::extractMetadata);
+    
     setupUI();
     connectSignals();
     loadLibraryData();
@@ -71,12 +86,20 @@ LibraryWidget::LibraryWidget(QWidget *parent)
     m_scanTimer->setSingleShot(true);
     m_scanTimer->setInterval(1000); // 1秒延迟扫描
     
+    // 库中的文件是否还存在在启动后由后台检查，加载时不逐个确认
+    QTimer::singleShot(3000, this, [this]() {
+        if (!m_isScanning) {
+            verifyLibrary();
+        }
+    });
+    
     // 启用拖放
     setAcceptDrops(true);
 }
 
 LibraryWidget::~LibraryWidget()
 {
+    MemoryGovernor::instance()->unregisterCache(m_governorId);
     saveLibraryData();
 }
 
@@ -250,6 +273,12 @@ void LibraryWidget::connectSignals()
     connect(m_searchTimer, &QTimer::timeout, this, &LibraryWidget::onSearchTextChanged);
     connect(m_scanTimer, &QTimer::timeout, this, &LibraryWidget::onScanTimer);
     
+    // 后台扫描
+    connect(m_scanner, &LibraryScanner::batchReady, this, &LibraryWidget::onScanBatch);
+    connect(m_scanner, &LibraryScanner::progress, this, &LibraryWidget::onScanProgress);
+    connect(m_scanner, &LibraryScanner::filesMissing, this, &LibraryWidget::onFilesMissing);
+    connect(m_scanner, &LibraryScanner::finished, this, &LibraryWidget::onScanFinished);
+    
     // 文件系统监控
     connect(m_fileWatcher, &QFileSystemWatcher::directoryChanged, 
             this, &LibraryWidget::onDirectoryChanged);
@@ -335,7 +364,8 @@ void LibraryWidget::addComicToLibrary(const QString &filePath)
     info.fileName = QFileInfo(filePath).fileName();
     info.title = QFileInfo(filePath).baseName();
     info.dateAdded = QDateTime::currentDateTime();
-    info.fileSize = QFileInfo(filePath).size();
+    info.fingerprint = LibraryScanner::Fingerprint::fromFile(filePath);
+    info.fileSize = qMax<qint64>(0, info.fingerprint.size);
     
     // 从文件提取元数据
     QStringList metadata = extractMetadata(filePath);
@@ -347,7 +377,7 @@ void LibraryWidget::addComicToLibrary(const QString &filePath)
     // 获取页面数
     ComicParser parser;
     if (parser.parseComic(filePath)) {
-        info.totalPages = parser.getPageCount();
+        info.totalPages = parser.getComicInfo().pageCount;
     }
     
     m_comicDatabase.insert(filePath, info);
@@ -368,18 +398,8 @@ void LibraryWidget::addComicsFromDirectory(const QString &dirPath, bool recursiv
         return;
     }
     
-    m_isScanning = true;
-    m_scanCurrentItem = 0;
-    m_scanTotal = 0;
-    
-    // 显示进度条
-    m_scanProgress->setVisible(true);
-    m_statusLabel->setText("正在扫描目录...");
-    
-    // 开始扫描
-    scanDirectory(dirPath, recursive);
-    
-    emit scanCompleted();
+    // 在后台扫描，结果分批加入，完成时发出 scanCompleted()
+    startScan(QStringList() << dirPath, recursive, false);
 }
 
 void LibraryWidget::removeComicFromLibrary(const QString &filePath)
@@ -387,6 +407,7 @@ void LibraryWidget::removeComicFromLibrary(const QString &filePath)
     if (m_comicDatabase.remove(filePath)) {
         // 从缓存中移除缩略图
         m_thumbnailCache.remove(filePath);
+        reportThumbnailUsage();
         
         // 更新显示
         applyFilters();
@@ -506,6 +527,8 @@ void LibraryWidget::setThumbnailSize(const QSize &size)
     
     // 重新生成缩略图
     m_thumbnailCache.clear();
+    updateThumbnailCacheLimit();
+    reportThumbnailUsage();
     for (const QString &filePath : m_comicDatabase.keys()) {
         generateThumbnail(filePath);
     }
@@ -532,10 +555,20 @@ void LibraryWidget::setAutoScanDirectories(const QStringList &directories)
 
 void LibraryWidget::refreshLibrary()
 {
-    // 重新扫描所有监控目录
-    for (const QString &dir : m_scanDirectories) {
-        addComicsFromDirectory(dir, true);
-    }
+    // 重新扫描所有监控目录，只打开新增和有变化的文件；其他目录中的漫画也检查一遍
+    startScan(m_scanDirectories, true, true);
+}
+
+void LibraryWidget::verifyLibrary()
+{
+    // 只检查库中已有的文件：丢失的移除，有变化的重新读取
+    startScan(QStringList(), true, true);
+}
+
+void LibraryWidget::cancelScan()
+{
+    // 已经加入的漫画保留，扫描器发出 finished(true)
+    m_scanner->cancel();
 }
 
 // 槽函数实现
@@ -759,16 +792,19 @@ void LibraryWidget::onRemoveComicClicked()
 
 void LibraryWidget::onRefreshClicked()
 {
-    refreshLibrary();
+    // 扫描中按钮用于停止扫描
+    if (m_isScanning) {
+        cancelScan();
+    } else {
+        refreshLibrary();
+    }
 }
 
 void LibraryWidget::onScanTimer()
 {
-    // 延迟扫描，避免频繁的文件系统操作
+    // 延迟扫描，避免频繁的文件系统操作；只扫描监控目录，其他文件不必随之检查
     if (!m_scanDirectories.isEmpty()) {
-        for (const QString &dir : m_scanDirectories) {
-            scanDirectory(dir, true);
-        }
+        startScan(m_scanDirectories, true, false);
     }
 }
 
@@ -803,21 +839,96 @@ void LibraryWidget::onFileChanged(const QString &path)
 void LibraryWidget::onThumbnailGenerated(const QString &filePath, const QPixmap &thumbnail)
 {
     if (m_comicDatabase.contains(filePath)) {
-        // 更新缓存
-        m_thumbnailCache.insert(filePath, thumbnail);
-        
-        // 限制缓存大小
-        if (m_thumbnailCache.size() > m_maxThumbnailCacheSize) {
-            // 移除最旧的缓存项（简单实现）
-            auto it = m_thumbnailCache.begin();
-            m_thumbnailCache.erase(it);
-        }
+        insertThumbnail(filePath, thumbnail);
+        reportThumbnailUsage();
+        MemoryGovernor::instance()->checkBudget();
         
         // 更新显示
         applyFilters();
     }
 }
 
+void LibraryWidget::onScanBatch(const QVector<LibraryScanner::Entry> &entries)
+{
+    const QDateTime now = QDateTime::currentDateTime();
+    for (const LibraryScanner::Entry &entry : entries) {
+        // 有变化的文件：更新从文件读取的信息，阅读进度、收藏和评分等保留
+        auto existing = m_comicDatabase.find(entry.filePath);
+        if (existing != m_comicDatabase.end()) {
+            existing->fingerprint = entry.fingerprint;
+            existing->fileSize = entry.fingerprint.size;
+            existing->totalPages = entry.pageCount;
+            m_thumbnailCache.remove(entry.filePath);
+            if (!entry.cover.isNull()) {
+                insertThumbnail(entry.filePath, QPixmap::fromImage(entry.cover));
+            }
+            continue;
+        }
+        
+        const QFileInfo fileInfo(entry.filePath);
+        ComicInfo info;
+        info.filePath = entry.filePath;
+        info.fileName = fileInfo.fileName();
+        info.title = fileInfo.baseName();
+        info.dateAdded = now;
+        info.fileSize = entry.fingerprint.size;
+        info.totalPages = entry.pageCount;
+        info.fingerprint = entry.fingerprint;
+        if (entry.metadata.size() >= 2) {
+            info.author = entry.metadata[0];
+            info.genre = entry.metadata[1];
+        }
+        m_comicDatabase.insert(entry.filePath, info);
+        
+        // 封面已由扫描器解码并映射，这里只需转换
+        if (!entry.cover.isNull()) {
+            insertThumbnail(entry.filePath, QPixmap::fromImage(entry.cover));
+        }
+    }
+    
+    // 每批只更新一次显示
+    reportThumbnailUsage();
+    MemoryGovernor::instance()->checkBudget();
+    applyFilters();
+    updateStatusBar();
+    emit libraryUpdated();
+}
+
+void LibraryWidget::onScanProgress(int processed, int found)
+{
+    m_scanCurrentItem = processed;
+    m_scanTotal = found;
+    updateStatusBar();
+    emit scanProgress(processed, found);
+}
+
+void LibraryWidget::onFilesMissing(const QStringList &filePaths)
+{
+    for (const QString &filePath : filePaths) {
+        if (m_comicDatabase.remove(filePath)) {
+            m_thumbnailCache.remove(filePath);
+        }
+    }
+    
+    reportThumbnailUsage();
+    applyFilters();
+    updateStatusBar();
+    emit libraryUpdated();
+}
+
+void LibraryWidget::onScanFinished(bool cancelled)
+{
+    m_isScanning = false;
+    m_scanRoots.clear();
+    m_refreshBtn->setText("刷新");
+    updateStatusBar();
+    if (cancelled) {
+        m_statusLabel->setText("扫描已停止");
+    }
+    
+    emit scanCompleted();
+}
+
 // 私有方法实现
 void LibraryWidget::updateStatusBar()
 {
@@ -865,6 +976,11 @@ void LibraryWidget::loadLibraryData()
         
         ComicInfo info;
         info.filePath = comicObj["filePath"].toString();
+        // 文件是否存在留给后台检查，但明显无效的路径（空的、目录形式的）直接丢弃
+        if (info.filePath.isEmpty() || info.filePath.endsWith(QLatin1Char('/'))
+            || !isComicFile(info.filePath)) {
+            continue;
+        }
         info.fileName = comicObj["fileName"].toString();
         info.title = comicObj["title"].toString();
         info.series = comicObj["series"].toString();
@@ -878,16 +994,15 @@ void LibraryWidget::loadLibraryData()
         info.isFavorite = comicObj["isFavorite"].toBool();
         info.rating = comicObj["rating"].toDouble();
         info.description = comicObj["description"].toString();
+        info.fingerprint = LibraryScanner::Fingerprint::fromString(comicObj["fingerprint"].toString());
         
         QJsonArray tagsArray = comicObj["tags"].toArray();
         for (const QJsonValue &tagValue : tagsArray) {
             info.tags.append(tagValue.toString());
         }
         
-        // 只添加存在的文件
-        if (QFile::exists(info.filePath)) {
-            m_comicDatabase.insert(info.filePath, info);
-        }
+        // 文件是否还存在由 verifyLibrary() 在后台检查
+        m_comicDatabase.insert(info.filePath, info);
     }
     
     // 加载设置
@@ -940,6 +1055,7 @@ void LibraryWidget::saveLibraryData()
         comicObj["isFavorite"] = info.isFavorite;
         comicObj["rating"] = info.rating;
         comicObj["description"] = info.description;
+        comicObj["fingerprint"] = info.fingerprint.toString();
         
         QJsonArray tagsArray;
         for (const QString &tag : info.tags) {
@@ -982,49 +1098,64 @@ void LibraryWidget::generateThumbnail(const QString &filePath)
         return;
     }
     
+    // 映射存储中已有同尺寸的缩略图时无需重新解析归档
+    const CacheKey thumbnailKey = LibraryScanner::thumbnailKey(filePath, m_thumbnailSize);
+    const QImage mapped = CacheManager::instance()->getDecodedImage(thumbnailKey);
+    if (!mapped.isNull()) {
+        onThumbnailGenerated(filePath, QPixmap::fromImage(mapped));
+        return;
+    }
+    
     // 异步生成缩略图
     ComicParser parser;
     if (parser.parseComic(filePath)) {
-        QPixmap thumbnail = parser.getPagePixmap(0); // 获取第一页
-        if (!thumbnail.isNull()) {
-            // 缩放到合适大小
-            thumbnail = thumbnail.scaled(m_thumbnailSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-            onThumbnailGenerated(filePath, thumbnail);
+        // 获取第一页，只按缩略图需要的分辨率解码
+        const QImage page = ImageDecoder::decodeToFit(parser.getPageData(0), m_thumbnailSize);
+        if (!page.isNull()) {
+            const QImage thumbnail = CacheManager::instance()->cacheDecodedImage(thumbnailKey, page);
+            onThumbnailGenerated(filePath, QPixmap::fromImage(thumbnail));
         }
     }
 }
 
-void LibraryWidget::scanDirectory(const QString &dirPath, bool recursive)
+void LibraryWidget::insertThumbnail(const QString &filePath, const QPixmap &thumbnail)
 {
-    QDir dir(dirPath);
-    if (!dir.exists()) {
-        return;
-    }
-    
-    QStringList filters;
-    filters << "*.cbz" << "*.cbr" << "*.zip" << "*.rar";
-    
-    QFileInfoList files = dir.entryInfoList(filters, QDir::Files);
-    m_scanTotal += files.size();
-    
-    for (const QFileInfo &fileInfo : files) {
-        QString filePath = fileInfo.absoluteFilePath();
-        if (!m_comicDatabase.contains(filePath)) {
-            addComicToLibrary(filePath);
-        }
-        m_scanCurrentItem++;
-        emit scanProgress(m_scanCurrentItem, m_scanTotal);
-    }
-    
-    if (recursive) {
-        QFileInfoList dirs = dir.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot);
-        for (const QFileInfo &dirInfo : dirs) {
-            scanDirectory(dirInfo.absoluteFilePath(), true);
+    // 超出上限时 QCache 淘汰最久未使用的缩略图
+    const qsizetype cost = qsizetype(thumbnail.width()) * thumbnail.height() * 4;
+    m_thumbnailCache.insert(filePath, new QPixmap(thumbnail), cost);
+}
+
+void LibraryWidget::startScan(const QStringList &directories, bool recursive, bool verifyKnown)
+{
+    // 扫描中又要扫描其他目录时合并后重新开始，已经加入的漫画不会再次处理
+    if (m_isScanning) {
+        for (const QString &dir : directories) {
+            if (!m_scanRoots.contains(dir)) {
+                m_scanRoots.append(dir);
+            }
         }
+        m_scanRecursive = m_scanRecursive || recursive;
+        m_scanVerify = m_scanVerify || verifyKnown;
+    } else {
+        m_scanRoots = directories;
+        m_scanRecursive = recursive;
+        m_scanVerify = verifyKnown;
     }
     
-    m_isScanning = false;
+    m_isScanning = true;
+    m_scanCurrentItem = 0;
+    m_scanTotal = 0;
+    m_scanProgress->setVisible(true);
+    m_refreshBtn->setText("停止扫描");
     updateStatusBar();
+    
+    // 库中的文件和上次读取时的指纹，指纹没有变化的不再打开
+    QHash<QString, LibraryScanner::Fingerprint> known;
+    known.reserve(m_comicDatabase.size());
+    for (auto it = m_comicDatabase.cbegin(); it != m_comicDatabase.cend(); ++it) {
+        known.insert(it.key(), it->fingerprint);
+    }
+    m_scanner->start(m_scanRoots, m_scanRecursive, known, m_thumbnailSize, m_scanVerify);
 }
 
 void LibraryWidget::applyFilters()
@@ -1117,8 +1248,8 @@ void LibraryWidget::updateView()
             item->setData(Qt::UserRole, filePath);
             
             // 设置图标
-            if (m_thumbnailCache.contains(filePath)) {
-                item->setIcon(QIcon(m_thumbnailCache.value(filePath)));
+            if (const QPixmap *thumbnail = m_thumbnailCache.object(filePath)) {
+                item->setIcon(QIcon(*thumbnail));
             } else {
                 // 使用默认图标
                 // item->setIcon(QIcon(":/icons/library/comic"));
@@ -1300,7 +1431,7 @@ QString LibraryWidget::formatFileSize(qint64 bytes) const
     }
 }
 
-QString LibraryWidget::getGenreFromFile(const QString &filePath) const
+QString LibraryWidget::getGenreFromFile(const QString &filePath)
 {
     // 简单的类型推测，基于文件路径
     QString path = filePath.toLower();
@@ -1324,14 +1455,15 @@ QString LibraryWidget::getGenreFromFile(const QString &filePath) const
     return "其他";
 }
 
-QString LibraryWidget::getAuthorFromFile(const QString &filePath) const
+QString LibraryWidget::getAuthorFromFile(const QString &filePath)
 {
     // 简单的作者提取，从文件名或路径中提取
     QFileInfo fileInfo(filePath);
     QString fileName = fileInfo.baseName();
     
     // 查找常见的作者标识符
-    QRegularExpression authorRegex(R"(\[([^\]]+)\]|\(([^\)]+)\)|by[\s]+([^\s]+))");
+    // 编译一次，多个扫描线程同时匹配
+    static const QRegularExpression authorRegex(R"(\[([^\]]+)\]|\(([^\)]+)\)|by[\s]+([^\s]+))");
     QRegularExpressionMatch match = authorRegex.match(fileName);
     
     if (match.hasMatch()) {
@@ -1346,7 +1478,7 @@ QString LibraryWidget::getAuthorFromFile(const QString &filePath) const
     return QString();
 }
 
-QStringList LibraryWidget::extractMetadata(const QString &filePath) const
+QStringList LibraryWidget::extractMetadata(const QString &filePath)
 {
     QStringList metadata;
     
@@ -1363,9 +1495,35 @@ QStringList LibraryWidget::extractMetadata(const QString &filePath) const
 
 bool LibraryWidget::isComicFile(const QString &filePath) const
 {
-    QStringList supportedFormats;
-    supportedFormats << "cbz" << "cbr" << "zip" << "rar";
+    return LibraryScanner::isComicFileName(QFileInfo(filePath).fileName());
+}
+
+void LibraryWidget::updateThumbnailCacheLimit()
+{
+    // 数量上限换算成字节
+    const qsizetype thumbnailBytes = qsizetype(m_thumbnailSize.width()) * m_thumbnailSize.height() * 4;
+    m_thumbnailCache.setMaxCost(qMax<qsizetype>(1, thumbnailBytes * m_maxThumbnailCacheSize));
+}
+
+void LibraryWidget::reportThumbnailUsage()
+{
+    MemoryGovernor::instance()->updateUsage(m_governorId, m_thumbnailCache.totalCost());
+}
+
+qint64 LibraryWidget::reclaimThumbnails(qint64 bytes)
+{
+    // 缩略图缓存没有锁，只能在GUI线程修改；其他线程请求时排队处理，本次不计入释放量
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, [this, bytes]() { reclaimThumbnails(bytes); }, Qt::QueuedConnection);
+        return 0;
+    }
+    
+    // 临时调低上限，QCache 按LRU淘汰到新上限以内
+    const qsizetype before = m_thumbnailCache.totalCost();
+    const qsizetype maxCost = m_thumbnailCache.maxCost();
+    m_thumbnailCache.setMaxCost(qMax<qsizetype>(0, before - bytes));
+    m_thumbnailCache.setMaxCost(maxCost);
     
-    QString suffix = QFileInfo(filePath).suffix().toLower();
-    return supportedFormats.contains(suffix);
+    reportThumbnailUsage();
+    return before - m_thumbnailCache.totalCost();
 }
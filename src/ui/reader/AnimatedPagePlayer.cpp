@@ -0,0 +1,211 @@
+#include "ui/reader/AnimatedPagePlayer.h"
+#include "core/image/AnimatedImageDecoder.h"
+#include "core/image/ImageScaler.h"
+#include <QAtomicInt>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QQueue>
+#include <QScopedPointer>
+#include <QTimer>
+
+namespace {
+
+QImage scaleFrame(const QImage &frame, const QSize &size, qreal ratio, Qt::TransformationMode mode)
+{
+    const QImage::Format format = frame.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied
+                                                          : QImage::Format_RGB32;
+    QImage image;
+    if (size.isEmpty() || frame.size() == size) {
+        image = frame.format() == format ? frame : frame.convertToFormat(format);
+    } else if (mode == Qt::SmoothTransformation && size.width() < frame.width()) {
+        image = ImageScaler::scale(frame, size);
+    } else {
+        image = frame.scaled(size, Qt::IgnoreAspectRatio, mode).convertToFormat(format);
+    }
+    image.setDevicePixelRatio(ratio);
+    return image;
+}
+
+} // namespace
+
+/**
+ * @brief 一次播放的状态，由GUI线程和解码任务共享
+ * 停止后解码任务仍可能持有它，不会访问已经销毁的对象。
+ */
+struct AnimatedPagePlayer::Session
+{
+    explicit Session(const QByteArray &data) : data(data), filling(false), finished(false) {}
+
+    // 解码器在解码线程中创建（读取帧数需要扫描整个文件），之后也只在解码线程访问
+    QByteArray data;
+    QScopedPointer<AnimatedImageDecoder> decoder;
+    QAtomicInt stopped;
+
+    // 以下由 mutex 保护
+    QMutex mutex;
+    QQueue<AnimatedImageDecoder::Frame> frames;
+    QSize size;
+    qreal ratio = 1.0;
+    bool filling;                               // 有解码任务正在填充缓冲区
+    bool finished;                              // 播放结束或解码失败，不会再有新的帧
+};
+
+AnimatedPagePlayer::AnimatedPagePlayer(QObject *parent)
+    : QObject(parent)
+    , m_frameTimer(new QTimer(this))
+    , m_waiting(false)
+{
+    m_decodePool.setMaxThreadCount(1);
+    m_frameTimer->setSingleShot(true);
+    connect(m_frameTimer, &QTimer::timeout, this, &AnimatedPagePlayer::showNextFrame);
+}
+
+AnimatedPagePlayer::~AnimatedPagePlayer()
+{
+    stop();
+    m_decodePool.clear();
+    m_decodePool.waitForDone();
+}
+
+void AnimatedPagePlayer::start(const QByteArray &data, const QSize &size, qreal ratio)
+{
+    stop();
+    m_session = QSharedPointer<Session>::create(data);
+    m_session->size = size;
+    m_session->ratio = ratio;
+
+    // 第一帧解码完成后立即显示
+    m_waiting = true;
+    fill(m_session);
+}
+
+void AnimatedPagePlayer::setFrameSize(const QSize &size, qreal ratio)
+{
+    if (!m_session) {
+        return;
+    }
+    QMutexLocker locker(&m_session->mutex);
+    m_session->size = size;
+    m_session->ratio = ratio;
+}
+
+void AnimatedPagePlayer::stop()
+{
+    if (m_session) {
+        m_session->stopped.storeRelease(1);
+        m_session.reset();
+    }
+    m_frameTimer->stop();
+    m_waiting = false;
+}
+
+bool AnimatedPagePlayer::isPlaying() const
+{
+    return !m_session.isNull();
+}
+
+int AnimatedPagePlayer::bufferedFrames() const
+{
+    if (!m_session) {
+        return 0;
+    }
+    QMutexLocker locker(&m_session->mutex);
+    return m_session->frames.size();
+}
+
+void AnimatedPagePlayer::fill(const QSharedPointer<Session> &session)
+{
+    {
+        QMutexLocker locker(&session->mutex);
+        if (session->filling || session->finished || session->frames.size() >= RING_SIZE) {
+            return;
+        }
+        session->filling = true;
+    }
+    m_decodePool.start([this, session]() { decodeAhead(session); });
+}
+
+void AnimatedPagePlayer::decodeAhead(const QSharedPointer<Session> &session)
+{
+    if (!session->decoder) {
+        session->decoder.reset(new AnimatedImageDecoder(session->data));
+    }
+
+    // 解码到缓冲区满为止；是否继续的判断和清除 filling 在同一次加锁中完成，
+    // GUI线程取走一帧后调用 fill() 时不会漏掉
+    while (!session->stopped.loadAcquire()) {
+        QSize size;
+        qreal ratio;
+        {
+            QMutexLocker locker(&session->mutex);
+            if (session->frames.size() >= RING_SIZE) {
+                session->filling = false;
+                return;
+            }
+            size = session->size;
+            ratio = session->ratio;
+        }
+
+        AnimatedImageDecoder::Frame frame;
+        if (!session->decoder->readFrame(&frame)) {
+            QMutexLocker locker(&session->mutex);
+            session->finished = true;
+            break;
+        }
+        frame.image = scaleFrame(frame.image, size, ratio, Qt::SmoothTransformation);
+
+        bool wasEmpty;
+        {
+            QMutexLocker locker(&session->mutex);
+            wasEmpty = session->frames.isEmpty();
+            session->frames.enqueue(frame);
+        }
+        if (wasEmpty) {
+            QMetaObject::invokeMethod(this, [this, session]() {
+                if (session == m_session && m_waiting) {
+                    showNextFrame();
+                }
+            }, Qt::QueuedConnection);
+        }
+    }
+
+    QMutexLocker locker(&session->mutex);
+    session->filling = false;
+}
+
+void AnimatedPagePlayer::showNextFrame()
+{
+    if (!m_session) {
+        return;
+    }
+
+    AnimatedImageDecoder::Frame frame;
+    bool available;
+    bool finished;
+    QSize size;
+    qreal ratio;
+    {
+        QMutexLocker locker(&m_session->mutex);
+        available = !m_session->frames.isEmpty();
+        if (available) {
+            frame = m_session->frames.dequeue();
+        }
+        finished = m_session->finished;
+        size = m_session->size;
+        ratio = m_session->ratio;
+    }
+    if (!available) {
+        // 解码跟不上：下一帧解码完成后立即显示；播放已经结束时停在最后一帧
+        m_waiting = !finished;
+        return;
+    }
+    m_waiting = false;
+
+    // 缩放比例在解码之后改变过的帧：快速缩放，只影响缓冲区中的几帧
+    if (!size.isEmpty() && frame.image.size() != size) {
+        frame.image = scaleFrame(frame.image, size, ratio, Qt::FastTransformation);
+    }
+    emit frameReady(frame.image);
+    fill(m_session);
+    m_frameTimer->start(frame.delay);
+}
@@ -0,0 +1,511 @@
+#include "ui/reader/ContinuousPageView.h"
+#include "ui/reader/PagePipeline.h"
+#include "core/image/ImageScaler.h"
+#include <QPainter>
+#include <QPaintEvent>
+#include <QResizeEvent>
+#include <QScrollBar>
+#include <QThread>
+#include <QTimer>
+#include <algorithm>
+
+namespace {
+
+// 尺寸未知页面默认的高宽比
+const qreal DEFAULT_ASPECT = 1.5;
+
+// 预取距离：按当前速度再滚动这么多秒的距离，最多若干个视口高度
+const qreal PREFETCH_SECONDS = 0.75;
+const int MAX_WINDOW_VIEWPORTS = 6;
+
+// 超过这么久没有滚动视为停止
+const int SCROLL_IDLE_MS = 300;
+
+// 空闲缓冲区最多保留的数量；缓冲区高度按此粒度向上取整，便于不同页面复用
+const int MAX_FREE_BUFFERS = 4;
+const int BUFFER_HEIGHT_GRANULARITY = 256;
+
+} // namespace
+
+ContinuousPageView::ContinuousPageView(PagePipeline *pipeline, QWidget *parent)
+    : QAbstractScrollArea(parent)
+    , m_pipeline(pipeline)
+    , m_layoutWidth(0)
+    , m_devicePixelRatio(1.0)
+    , m_estimatedAspect(DEFAULT_ASPECT)
+    , m_currentPage(0)
+    , m_windowFirst(0)
+    , m_windowLast(-1)
+    , m_lastScrollValue(0)
+    , m_velocity(0)
+    , m_scrollDirection(1)
+    , m_idleTimer(new QTimer(this))
+    , m_layoutSerial(0)
+{
+    viewport()->setAutoFillBackground(false);
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    verticalScrollBar()->setSingleStep(60);
+    m_renderPool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() / 2));
+
+    m_idleTimer->setSingleShot(true);
+    m_idleTimer->setInterval(SCROLL_IDLE_MS);
+    connect(m_idleTimer, &QTimer::timeout, this, [this]() {
+        m_velocity = 0;
+        updateWindow();
+    });
+
+    connect(m_pipeline, &PagePipeline::pageFetched, this, &ContinuousPageView::onPageFetched);
+    connect(m_pipeline, &PagePipeline::pageSizeProbed, this, &ContinuousPageView::setPageSize);
+}
+
+ContinuousPageView::~ContinuousPageView()
+{
+    m_layoutSerial.fetchAndAddOrdered(1);
+    m_renderPool.clear();
+    m_renderPool.waitForDone();
+}
+
+void ContinuousPageView::setPageCount(int count)
+{
+    clear();
+    m_pages.resize(qMax(0, count));
+    relayout();
+    m_pipeline->probePageSizes(m_pages.size());
+}
+
+void ContinuousPageView::clear()
+{
+    m_layoutSerial.fetchAndAddOrdered(1);
+    m_renderPool.clear();
+    m_pipeline->releaseAllPages();
+    m_pages.clear();
+    m_offsets.clear();
+    m_estimatedAspect = DEFAULT_ASPECT;
+    m_currentPage = 0;
+    m_windowFirst = 0;
+    m_windowLast = -1;
+    m_lastScrollValue = 0;
+    m_velocity = 0;
+    updateScrollBar();
+    verticalScrollBar()->setValue(0);
+    viewport()->update();
+}
+
+void ContinuousPageView::setPageSize(int page, const QSize &size)
+{
+    if (page < 0 || page >= m_pages.size() || !size.isValid()) {
+        return;
+    }
+    Page &entry = m_pages[page];
+    if (entry.sizeKnown && entry.size == size) {
+        return;
+    }
+    entry.size = size;
+    entry.sizeKnown = true;
+
+    // 同一章节的页面尺寸通常相近，用最近读到的尺寸估计其余页面
+    m_estimatedAspect = qreal(size.height()) / size.width();
+    relayout();
+}
+
+void ContinuousPageView::scrollToPage(int page)
+{
+    if (m_pages.isEmpty()) {
+        return;
+    }
+    page = qBound(0, page, m_pages.size() - 1);
+    const int value = qMin(m_offsets[page], verticalScrollBar()->maximum());
+
+    // 跳转不计入滚动速度
+    m_lastScrollValue = value;
+    if (verticalScrollBar()->value() == value) {
+        updateCurrentPage();
+        updateWindow();
+    } else {
+        verticalScrollBar()->setValue(value);
+    }
+}
+
+int ContinuousPageView::loadedPageCount() const
+{
+    return int(std::count_if(m_pages.cbegin(), m_pages.cend(),
+                             [](const Page &entry) { return !entry.original.isNull(); }));
+}
+
+void ContinuousPageView::paintEvent(QPaintEvent *event)
+{
+    // 窗口移到设备像素比不同的显示器：之前的缩放结果全部作废
+    if (!qFuzzyCompare(devicePixelRatioF(), m_devicePixelRatio)) {
+        m_devicePixelRatio = devicePixelRatioF();
+        invalidateRendering();
+        updateWindow();
+    }
+
+    QPainter painter(viewport());
+    const QRect dirty = event->rect();
+    painter.fillRect(dirty, Qt::white);
+    if (m_pages.isEmpty() || m_layoutWidth <= 0) {
+        return;
+    }
+
+    const int top = verticalScrollBar()->value();
+    const int first = pageAt(top + dirty.top());
+    const int last = pageAt(top + dirty.bottom());
+
+    for (int page = first; page <= last; ++page) {
+        const Page &entry = m_pages[page];
+        const QRect target(0, m_offsets[page] - top, m_layoutWidth, pageHeight(page));
+        const QRect clip = target & dirty;
+        if (clip.isEmpty()) {
+            continue;
+        }
+
+        if (entry.display.size() == renderSize(page)) {
+            const QRectF source(QPointF(clip.topLeft() - target.topLeft()) * m_devicePixelRatio,
+                                QSizeF(clip.size()) * m_devicePixelRatio);
+            painter.drawImage(QRectF(clip), entry.display, source);
+        } else if (!entry.original.isNull()) {
+            // 缩放结果还没有生成（或超大页面）：只缩放原图中可见的部分
+            const qreal sx = qreal(entry.original.width()) / target.width();
+            const qreal sy = qreal(entry.original.height()) / target.height();
+            const QRectF source((clip.x() - target.x()) * sx, (clip.y() - target.y()) * sy,
+                                clip.width() * sx, clip.height() * sy);
+            painter.setRenderHint(QPainter::SmoothPixmapTransform, paintsFromOriginal(page));
+            painter.drawImage(QRectF(clip), entry.original, source);
+        } else {
+            painter.fillRect(clip, QColor(224, 224, 224));
+            painter.setPen(Qt::darkGray);
+            painter.drawText(target, Qt::AlignCenter,
+                             entry.failed ? QString("无法加载页面 %1").arg(page + 1)
+                                          : QString::number(page + 1));
+        }
+    }
+}
+
+void ContinuousPageView::resizeEvent(QResizeEvent *event)
+{
+    QAbstractScrollArea::resizeEvent(event);
+
+    const int width = viewport()->width();
+    if (width == m_layoutWidth) {
+        updateScrollBar();
+        updateWindow();
+        return;
+    }
+
+    // 排版宽度改变：之前的缩放结果全部作废，重新缩放前先从原图绘制
+    m_layoutWidth = width;
+    invalidateRendering();
+    relayout();
+}
+
+void ContinuousPageView::scrollContentsBy(int dx, int dy)
+{
+    // 已经绘制的内容直接平移，只重绘新露出的区域
+    viewport()->scroll(dx, dy);
+    updateVelocity();
+    updateCurrentPage();
+    updateWindow();
+    m_idleTimer->start();
+}
+
+void ContinuousPageView::onPageFetched(int page, const QImage &original)
+{
+    if (page < 0 || page >= m_pages.size() || !m_pages[page].requested) {
+        return;
+    }
+    Page &entry = m_pages[page];
+    if (original.isNull()) {
+        entry.failed = true;
+    } else {
+        entry.failed = false;
+        entry.original = original;
+        setPageSize(page, original.size());
+        requestRender(page, 1);
+    }
+    viewport()->update(0, m_offsets[page] - verticalScrollBar()->value(), m_layoutWidth, pageHeight(page));
+}
+
+void ContinuousPageView::onPageRendered(int serial, int page, qint64 originalKey,
+                                        const QImage &buffer, const QImage &display)
+{
+    if (serial != m_layoutSerial.loadAcquire() || page >= m_pages.size()
+        || m_pages[page].original.isNull() || m_pages[page].original.cacheKey() != originalKey) {
+        recycleBuffer(buffer);
+        return;
+    }
+
+    Page &entry = m_pages[page];
+    entry.rendering = false;
+    if (display.size() != renderSize(page)) {
+        recycleBuffer(buffer);
+        requestRender(page, 0);
+        return;
+    }
+
+    // 缩小比例较大时结果不在缓冲区中，缓冲区直接回收
+    if (display.constBits() == buffer.constBits()) {
+        entry.buffer = buffer;
+    } else {
+        recycleBuffer(buffer);
+        entry.buffer = QImage();
+    }
+    entry.display = display;
+    viewport()->update(0, m_offsets[page] - verticalScrollBar()->value(), m_layoutWidth, pageHeight(page));
+}
+
+int ContinuousPageView::pageHeight(int page) const
+{
+    const QSize &size = m_pages[page].size;
+    if (size.isValid() && size.width() > 0) {
+        return qMax(1, qRound(qreal(size.height()) * m_layoutWidth / size.width()));
+    }
+    return qMax(1, qRound(m_layoutWidth * m_estimatedAspect));
+}
+
+int ContinuousPageView::pageAt(int y) const
+{
+    if (m_pages.isEmpty()) {
+        return -1;
+    }
+    const auto it = std::upper_bound(m_offsets.cbegin(), m_offsets.cend() - 1, y);
+    return qBound(0, int(it - m_offsets.cbegin()) - 1, m_pages.size() - 1);
+}
+
+void ContinuousPageView::relayout()
+{
+    // 记住视口顶部所在的页面及页内位置，重新排版后恢复
+    int anchorPage = -1;
+    qreal anchorFraction = 0;
+    if (!m_pages.isEmpty() && m_offsets.size() == m_pages.size() + 1) {
+        const int value = verticalScrollBar()->value();
+        anchorPage = pageAt(value);
+        const int height = m_offsets[anchorPage + 1] - m_offsets[anchorPage];
+        anchorFraction = height > 0 ? qreal(value - m_offsets[anchorPage]) / height : 0;
+    }
+
+    m_offsets.resize(m_pages.size() + 1);
+    int y = 0;
+    for (int page = 0; page < m_pages.size(); ++page) {
+        m_offsets[page] = y;
+        y += pageHeight(page);
+    }
+    m_offsets[m_pages.size()] = y;
+    updateScrollBar();
+
+    if (anchorPage >= 0) {
+        const int value = m_offsets[anchorPage] + qRound(anchorFraction * pageHeight(anchorPage));
+        m_lastScrollValue = qBound(0, value, verticalScrollBar()->maximum());
+        verticalScrollBar()->setValue(value);
+    }
+    viewport()->update();
+    updateWindow();
+}
+
+void ContinuousPageView::updateScrollBar()
+{
+    const int total = m_offsets.isEmpty() ? 0 : m_offsets.last();
+    verticalScrollBar()->setRange(0, qMax(0, total - viewport()->height()));
+    verticalScrollBar()->setPageStep(viewport()->height());
+}
+
+void ContinuousPageView::updateVelocity()
+{
+    const int value = verticalScrollBar()->value();
+    const int delta = value - m_lastScrollValue;
+    m_lastScrollValue = value;
+    if (delta == 0) {
+        return;
+    }
+    m_scrollDirection = delta > 0 ? 1 : -1;
+
+    // 指数平滑；停顿之后重新开始计算
+    const qint64 elapsed = m_scrollClock.isValid() ? m_scrollClock.restart() : -1;
+    if (elapsed < 0) {
+        m_scrollClock.start();
+    }
+    if (elapsed <= 0 || elapsed > SCROLL_IDLE_MS) {
+        m_velocity = 0;
+        return;
+    }
+    const qreal instant = delta * 1000.0 / elapsed;
+    m_velocity = m_velocity * 0.6 + instant * 0.4;
+}
+
+void ContinuousPageView::updateWindow()
+{
+    if (m_pages.isEmpty() || m_layoutWidth <= 0) {
+        return;
+    }
+
+    // 滚动方向上多预取一段，距离随速度增加；反方向只保留一个视口
+    const int top = verticalScrollBar()->value();
+    const int viewportHeight = qMax(1, viewport()->height());
+    const int lead = int(qMin<qreal>(viewportHeight + qAbs(m_velocity) * PREFETCH_SECONDS,
+                                     viewportHeight * MAX_WINDOW_VIEWPORTS));
+    const bool down = m_scrollDirection > 0;
+    const int from = top - (down ? viewportHeight : lead);
+    const int to = top + viewportHeight + (down ? lead : viewportHeight);
+    const int first = pageAt(from);
+    const int last = pageAt(to);
+
+    for (int page = m_windowFirst; page <= m_windowLast && page < m_pages.size(); ++page) {
+        if (page < first || page > last) {
+            releasePage(page);
+        }
+    }
+    m_windowFirst = first;
+    m_windowLast = last;
+
+    // 先加载可见页面，再沿滚动方向向外加载
+    const int visibleFirst = pageAt(top);
+    const int visibleLast = pageAt(top + viewportHeight - 1);
+    QVector<int> order;
+    order.reserve(last - first + 1);
+    for (int page = visibleFirst; page <= visibleLast; ++page) {
+        order.append(page);
+    }
+    for (int pass = 0; pass < 2; ++pass) {
+        const bool forward = (pass == 0) == down;
+        if (forward) {
+            for (int page = visibleLast + 1; page <= last; ++page) {
+                order.append(page);
+            }
+        } else {
+            for (int page = visibleFirst - 1; page >= first; --page) {
+                order.append(page);
+            }
+        }
+    }
+
+    for (int page : order) {
+        Page &entry = m_pages[page];
+        if (!entry.requested) {
+            entry.requested = true;
+            m_pipeline->fetchPage(page);
+        } else {
+            requestRender(page, page >= visibleFirst && page <= visibleLast ? 1 : 0);
+        }
+    }
+}
+
+void ContinuousPageView::updateCurrentPage()
+{
+    // 视口上部三分之一处的页面视为当前页
+    const int page = pageAt(verticalScrollBar()->value() + viewport()->height() / 3);
+    if (page >= 0 && page != m_currentPage) {
+        m_currentPage = page;
+        emit currentPageChanged(page);
+    }
+}
+
+void ContinuousPageView::requestRender(int page, int priority)
+{
+    Page &entry = m_pages[page];
+    if (entry.original.isNull() || entry.rendering || paintsFromOriginal(page)) {
+        return;
+    }
+    const QSize target = renderSize(page);
+    if (entry.display.size() == target) {
+        return;
+    }
+    recycleBuffer(entry.buffer);
+    entry.buffer = QImage();
+    entry.display = QImage();
+    entry.rendering = true;
+
+    const int serial = m_layoutSerial.loadAcquire();
+    const QImage original = entry.original;
+    const qreal ratio = m_devicePixelRatio;
+    m_renderPool.start([this, serial, page, original, target, ratio, storage = takeBuffer(target)]() mutable {
+        if (serial != m_layoutSerial.loadAcquire()) {
+            return;
+        }
+
+        QImage display;
+        if (qreal(target.width()) / original.width() < 0.5) {
+            // 缩小比例较大时绘制用的双线性插值会丢失细节，改用面积平均
+            display = ImageScaler::scale(original, target);
+        } else {
+            if (storage.width() != target.width() || storage.height() < target.height()) {
+                const int height = (target.height() + BUFFER_HEIGHT_GRANULARITY - 1)
+                                   / BUFFER_HEIGHT_GRANULARITY * BUFFER_HEIGHT_GRANULARITY;
+                storage = QImage(target.width(), height, QImage::Format_ARGB32_Premultiplied);
+            }
+            // 缓冲区只由本任务持有，按页面高度取用它的前若干行
+            display = QImage(storage.bits(), target.width(), target.height(),
+                             storage.bytesPerLine(), storage.format());
+            display.fill(Qt::white);
+            QPainter painter(&display);
+            painter.setRenderHint(QPainter::SmoothPixmapTransform);
+            painter.drawImage(QRect(QPoint(0, 0), target), original);
+            painter.end();
+        }
+        display.setDevicePixelRatio(ratio);
+
+        const qint64 originalKey = original.cacheKey();
+        QMetaObject::invokeMethod(this, [this, serial, page, originalKey, storage, display]() {
+            onPageRendered(serial, page, originalKey, storage, display);
+        }, Qt::QueuedConnection);
+    }, priority);
+}
+
+void ContinuousPageView::releasePage(int page)
+{
+    Page &entry = m_pages[page];
+    if (!entry.requested) {
+        return;
+    }
+    m_pipeline->releasePage(page);
+    recycleBuffer(entry.buffer);
+    entry.requested = false;
+    entry.rendering = false;
+    entry.failed = false;
+    entry.original = QImage();
+    entry.buffer = QImage();
+    entry.display = QImage();
+}
+
+QSize ContinuousPageView::renderSize(int page) const
+{
+    return QSize(qRound(m_layoutWidth * m_devicePixelRatio), qRound(pageHeight(page) * m_devicePixelRatio));
+}
+
+bool ContinuousPageView::paintsFromOriginal(int page) const
+{
+    return PagePipeline::isLargeImage(renderSize(page));
+}
+
+void ContinuousPageView::invalidateRendering()
+{
+    m_layoutSerial.fetchAndAddOrdered(1);
+    m_renderPool.clear();
+    m_freeBuffers.clear();
+    for (Page &entry : m_pages) {
+        entry.rendering = false;
+        entry.buffer = QImage();
+        entry.display = QImage();
+    }
+}
+
+void ContinuousPageView::recycleBuffer(const QImage &buffer)
+{
+    if (!buffer.isNull() && buffer.width() == qRound(m_layoutWidth * m_devicePixelRatio)
+        && m_freeBuffers.size() < MAX_FREE_BUFFERS) {
+        m_freeBuffers.append(buffer);
+    }
+}
+
+QImage ContinuousPageView::takeBuffer(const QSize &size)
+{
+    // 取能容纳该页面的最小缓冲区
+    int best = -1;
+    for (int i = 0; i < m_freeBuffers.size(); ++i) {
+        const QImage &buffer = m_freeBuffers.at(i);
+        if (buffer.width() == size.width() && buffer.height() >= size.height()
+            && (best < 0 || buffer.height() < m_freeBuffers.at(best).height())) {
+            best = i;
+        }
+    }
+    return best < 0 ? QImage() : m_freeBuffers.takeAt(best);
+}
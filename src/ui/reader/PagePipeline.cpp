@@ -0,0 +1,916 @@
+#include "ui/reader/PagePipeline.h"
+#include "core/ComicParser.h"
+#include "core/CacheManager.h"
+#include "core/cache/CacheWarmup.h"
+#include "core/cache/MemoryGovernor.h"
+#include "core/image/AnimatedImageDecoder.h"
+#include "core/image/ContentBounds.h"
+#include "core/image/ImageDecoder.h"
+#include "core/image/ImageScaler.h"
+#include "core/image/ImagePyramid.h"
+#include "core/image/PanelDetector.h"
+#include <QThread>
+#include <QPainter>
+#include <QBuffer>
+#include <QImageReader>
+#include <QMutexLocker>
+#include <QElapsedTimer>
+#include <QtEndian>
+#include <QDebug>
+
+namespace {
+
+// 整张缩放图的上限：约64MB（32位像素），任一边不超过16384像素
+const qint64 MAX_DISPLAY_PIXELS = 4096LL * 4096;
+const int MAX_DISPLAY_DIMENSION = 16384;
+
+// 页面尺寸缓存条目的变体名，内容为宽、高（各4字节小端）
+const QString SIZE_VARIANT = QStringLiteral("size");
+
+// 内容范围缓存条目的变体名，内容为原图宽、高和内容的 x、y、宽、高（各4字节小端）
+const QString BOUNDS_VARIANT = QStringLiteral("bounds");
+
+// 分格缓存条目的变体名（区分阅读方向），内容为原图宽、高、格数和各格的 x、y、宽、高（各4字节小端）
+QString panelsVariant(bool rightToLeft)
+{
+    return rightToLeft ? QStringLiteral("panels:rtl") : QStringLiteral("panels:ltr");
+}
+
+// 预览的解码比例，JPEG 按 1/8 解码
+const qreal PREVIEW_SCALE = 0.1;
+
+// 保留金字塔的页数：当前页及前后页
+const int MAX_PYRAMIDS = 4;
+
+QImage withDevicePixelRatio(QImage image, qreal ratio)
+{
+    image.setDevicePixelRatio(ratio);
+    return image;
+}
+
+} // namespace
+
+PagePipeline::PagePipeline(QObject *parent)
+    : QObject(parent)
+    , m_generation(0)
+    , m_comicSerial(0)
+    , m_governorId(-1)
+    , m_devicePixelRatio(1.0)
+    , m_parser(nullptr)
+{
+    // 读取线程常驻，解析器一直由同一个线程使用
+    m_fetchPool.setMaxThreadCount(1);
+    m_fetchPool.setExpiryTimeout(-1);
+    m_workerPool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
+
+    // 金字塔随时可以从原图重新生成，优先被回收
+    m_governorId = MemoryGovernor::instance()->registerCache("PagePyramids", MemoryGovernor::LowPriority,
+                                                             [this](qint64 bytes) { return reclaimPyramids(bytes); });
+}
+
+PagePipeline::~PagePipeline()
+{
+    cancel();
+    m_comicSerial.fetchAndAddOrdered(1);
+    m_fetchPool.clear();
+    m_fetchPool.waitForDone();
+    m_workerPool.waitForDone();
+    MemoryGovernor::instance()->unregisterCache(m_governorId);
+    delete m_parser;
+}
+
+void PagePipeline::setComic(const QString &filePath, const ArchiveFingerprint &fingerprint)
+{
+    m_filePath = filePath;
+    m_fingerprint = fingerprint;
+    m_comicSerial.fetchAndAddOrdered(1);
+    releaseAllPages();
+    cancel();
+    {
+        QMutexLocker locker(&m_pyramidMutex);
+        m_pyramids.clear();
+    }
+    updatePyramidUsage();
+}
+
+void PagePipeline::setDevicePixelRatio(qreal ratio)
+{
+    m_devicePixelRatio = ratio > 0 ? ratio : 1.0;
+}
+
+qreal PagePipeline::devicePixelRatio() const
+{
+    return m_devicePixelRatio;
+}
+
+int PagePipeline::requestPage(int page, qreal zoom)
+{
+    const Request request = makeRequest(page, zoom);
+    m_fetchPool.start([this, request]() { fetchStage(request); });
+    return request.generation;
+}
+
+int PagePipeline::requestScale(int page, const QImage &original, qreal zoom)
+{
+    const Request request = makeRequest(page, zoom);
+    m_workerPool.start([this, request, original]() { scaleStage(request, original); });
+    return request.generation;
+}
+
+int PagePipeline::requestPreview(int page)
+{
+    const Request request = makeRequest(page, 1.0);
+    m_fetchPool.start([this, request]() {
+        if (!isLive(request)) {
+            return;
+        }
+        const QByteArray data = fetchData(request);
+        if (data.isEmpty() || !isLive(request)) {
+            return;
+        }
+        m_workerPool.start([this, request, data]() {
+            if (!isLive(request)) {
+                return;
+            }
+            QSize pageSize;
+            QElapsedTimer timer;
+            timer.start();
+            const QImage preview = ImageDecoder::decodeReduced(data, PREVIEW_SCALE, &pageSize);
+            recordStage(request, PageTurnMetrics::Decode, timer);
+            if (preview.isNull()) {
+                return;
+            }
+            QMetaObject::invokeMethod(this, [this, request, pageSize, preview]() {
+                if (isLive(request)) {
+                    emit previewReady(request.generation, request.page, pageSize, preview);
+                }
+            }, Qt::QueuedConnection);
+        });
+    });
+    return request.generation;
+}
+
+void PagePipeline::requestAnimation(int generation, int page)
+{
+    // 不受代数影响的请求，读取的耗时不计入翻页统计
+    const Request request = makeRequest(page, 1.0, false);
+    m_fetchPool.start([this, request, generation]() {
+        if (!isCurrent(generation) || !isLive(request)) {
+            return;
+        }
+        const QByteArray data = fetchData(request);
+        if (data.isEmpty() || !AnimatedImageDecoder::isAnimated(data)) {
+            return;
+        }
+        QMetaObject::invokeMethod(this, [this, request, generation, data]() {
+            if (isCurrent(generation) && isLive(request)) {
+                emit animationReady(generation, request.page, data);
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+void PagePipeline::prescale(int page, const QImage &original, qreal zoom)
+{
+    const QString filePath = m_filePath;
+    const qreal ratio = m_devicePixelRatio;
+    m_workerPool.start([this, filePath, page, original, zoom, ratio]() {
+        const QImage display = withDevicePixelRatio(scaleOriginal(original, zoom * ratio), ratio);
+        QMetaObject::invokeMethod(this, [this, filePath, page, zoom, display]() {
+            if (filePath == m_filePath) {
+                emit scalePrepared(page, zoom, display);
+            }
+        }, Qt::QueuedConnection);
+    }, -1);   // 低于页面请求的优先级
+}
+
+void PagePipeline::cancel()
+{
+    m_generation.fetchAndAddOrdered(1);
+}
+
+void PagePipeline::fetchPage(int page)
+{
+    {
+        QMutexLocker locker(&m_wantedMutex);
+        if (m_wantedPages.contains(page)) {
+            return;
+        }
+        m_wantedPages.insert(page);
+    }
+
+    Request request = makeRequest(page, 1.0, false);
+    request.wanted = true;
+    m_fetchPool.start([this, request]() { fetchStage(request); });
+}
+
+void PagePipeline::releasePage(int page)
+{
+    QMutexLocker locker(&m_wantedMutex);
+    m_wantedPages.remove(page);
+}
+
+void PagePipeline::releaseAllPages()
+{
+    QMutexLocker locker(&m_wantedMutex);
+    m_wantedPages.clear();
+}
+
+void PagePipeline::probePageSizes(int pageCount)
+{
+    for (int page = 0; page < pageCount; ++page) {
+        const Request request = makeRequest(page, 1.0, false);
+        m_fetchPool.start([this, request]() {
+            if (request.serial != m_comicSerial.loadAcquire()) {
+                return;
+            }
+            const QSize size = probeSize(request);
+            if (!size.isValid()) {
+                return;
+            }
+            QMetaObject::invokeMethod(this, [this, request, size]() {
+                if (request.serial == m_comicSerial.loadAcquire()) {
+                    emit pageSizeProbed(request.page, size);
+                }
+            }, Qt::QueuedConnection);
+        }, -1);   // 页面加载优先
+    }
+}
+
+void PagePipeline::detectContentBounds(int pageCount)
+{
+    // 同时只处理与工作线程数相同的页数，分析完一页再读取下一页，读出的数据不会在队列中堆积
+    const Request request = makeRequest(0, 1.0, false);
+    const QSharedPointer<QAtomicInt> next = QSharedPointer<QAtomicInt>::create(0);
+    for (int i = 0; i < m_workerPool.maxThreadCount(); ++i) {
+        analyzeNextPage(request, next, pageCount);
+    }
+}
+
+void PagePipeline::analyzeNextPage(Request request, const QSharedPointer<QAtomicInt> &next, int pageCount)
+{
+    request.page = next->fetchAndAddOrdered(1);
+    if (request.page >= pageCount || !isLive(request)) {
+        return;
+    }
+    m_fetchPool.start([this, request, next, pageCount]() {
+        if (!isLive(request)) {
+            return;
+        }
+        QSize pageSize;
+        QRect bounds;
+        if (loadContentBounds(request, &pageSize, &bounds)) {
+            publishContentBounds(request, pageSize, bounds);
+            analyzeNextPage(request, next, pageCount);
+            return;
+        }
+
+        // 已经解码过的页面直接分析，否则读取原始数据，按分析需要的分辨率解码
+        const CacheKey pageKey(request.filePath, request.fingerprint, request.page, CacheWarmup::pageVariant());
+        const QImage decoded = CacheManager::instance()->getDecodedImage(pageKey);
+        const QByteArray data = decoded.isNull() ? fetchData(request) : QByteArray();
+        if (decoded.isNull() && data.isEmpty()) {
+            analyzeNextPage(request, next, pageCount);
+            return;
+        }
+        m_workerPool.start([this, request, next, pageCount, decoded, data]() {
+            if (isLive(request)) {
+                QSize pageSize = decoded.size();
+                const QRect bounds = decoded.isNull() ? ContentBounds::detect(data, &pageSize)
+                                                      : ContentBounds::detect(decoded);
+                if (bounds.isValid()) {
+                    storeContentBounds(request, pageSize, bounds);
+                    publishContentBounds(request, pageSize, bounds);
+                }
+            }
+            analyzeNextPage(request, next, pageCount);
+        }, -2);
+    }, -2);   // 低于页面加载和尺寸读取
+}
+
+void PagePipeline::requestPanels(int page, bool rightToLeft, bool urgent)
+{
+    const Request request = makeRequest(page, 1.0, false);
+    const int priority = urgent ? -1 : -2;
+    m_fetchPool.start([this, request, rightToLeft, priority]() {
+        if (!isLive(request)) {
+            return;
+        }
+        const auto publish = [this, request, rightToLeft](const QSize &pageSize, const QVector<QRect> &panels) {
+            QMetaObject::invokeMethod(this, [this, request, rightToLeft, pageSize, panels]() {
+                if (isLive(request)) {
+                    emit panelsDetected(request.page, rightToLeft, pageSize, panels);
+                }
+            }, Qt::QueuedConnection);
+        };
+        QSize pageSize;
+        QVector<QRect> panels;
+        if (loadPanels(request, rightToLeft, &pageSize, &panels)) {
+            publish(pageSize, panels);
+            return;
+        }
+
+        // 已经解码过的页面直接分析，否则读取原始数据，按分析需要的分辨率解码
+        const CacheKey pageKey(request.filePath, request.fingerprint, request.page, CacheWarmup::pageVariant());
+        const QImage decoded = CacheManager::instance()->getDecodedImage(pageKey);
+        const QByteArray data = decoded.isNull() ? fetchData(request) : QByteArray();
+        if (decoded.isNull() && data.isEmpty()) {
+            return;
+        }
+        m_workerPool.start([this, request, rightToLeft, decoded, data, publish]() {
+            if (!isLive(request)) {
+                return;
+            }
+            QSize pageSize = decoded.size();
+            const QVector<QRect> panels = decoded.isNull() ? PanelDetector::detect(data, rightToLeft, &pageSize)
+                                                           : PanelDetector::detect(decoded, rightToLeft);
+            if (!pageSize.isValid()) {
+                return;
+            }
+            storePanels(request, rightToLeft, pageSize, panels);
+            publish(pageSize, panels);
+        }, priority);
+    }, priority);   // 低于页面加载
+}
+
+int PagePipeline::requestSpread(const QVector<int> &pages, const QSize &bounds, bool rightToLeft)
+{
+    const Request request = makeRequest(pages.value(0), 1.0);
+    startSpread(request, pages, bounds, rightToLeft, 0);
+    return request.generation;
+}
+
+void PagePipeline::prepareSpread(const QVector<int> &pages, const QSize &bounds, bool rightToLeft)
+{
+    startSpread(makeRequest(pages.value(0), 1.0, false), pages, bounds, rightToLeft, -1);
+}
+
+void PagePipeline::startSpread(const Request &request, const QVector<int> &pages, const QSize &bounds,
+                               bool rightToLeft, int priority)
+{
+    m_fetchPool.start([this, request, pages, bounds, rightToLeft, priority]() {
+        if (!isLive(request) || pages.isEmpty()) {
+            return;
+        }
+
+        // 读取线程只取数据，解码和合成在工作线程进行
+        CacheManager *cache = CacheManager::instance();
+        QVector<QImage> images(pages.size());
+        QVector<QByteArray> data(pages.size());
+        for (int i = 0; i < pages.size(); ++i) {
+            Request pageRequest = request;
+            pageRequest.page = pages.at(i);
+            images[i] = cache->getDecodedImage(
+                CacheKey(request.filePath, request.fingerprint, pageRequest.page, CacheWarmup::pageVariant()));
+            if (images.at(i).isNull()) {
+                data[i] = fetchData(pageRequest);
+            }
+            if (!isLive(request)) {
+                return;
+            }
+        }
+
+        m_workerPool.start([this, request, pages, bounds, rightToLeft, images, data]() mutable {
+            for (int i = 0; i < pages.size() && isLive(request); ++i) {
+                if (images.at(i).isNull()) {
+                    // 合成后的高度不超过 bounds 的高度，按此缩小解码
+                    const QSize size = ImageDecoder::imageSize(data.at(i));
+                    const qreal scale = size.isValid()
+                        ? bounds.height() * request.devicePixelRatio / size.height() : 1.0;
+                    Request pageRequest = request;
+                    pageRequest.page = pages.at(i);
+                    images[i] = decodePage(pageRequest, data.at(i), scale);
+                }
+                if (images.at(i).isNull()) {
+                    // 预先合成的跨页失败时不报告，真正翻到时再由 requestSpread() 报告
+                    if (request.generation >= 0) {
+                        fail(request);
+                    }
+                    return;
+                }
+            }
+            if (!isLive(request)) {
+                return;
+            }
+
+            QElapsedTimer timer;
+            timer.start();
+            const QImage spread = withDevicePixelRatio(
+                composeSpread(images, bounds * request.devicePixelRatio, rightToLeft), request.devicePixelRatio);
+            recordStage(request, PageTurnMetrics::Scale, timer);
+            QMetaObject::invokeMethod(this, [this, request, pages, bounds, rightToLeft, spread]() {
+                if (!isLive(request)) {
+                    return;
+                }
+                if (request.generation >= 0) {
+                    emit spreadReady(request.generation, pages, spread);
+                } else {
+                    emit spreadPrepared(pages, bounds, rightToLeft, spread);
+                }
+            }, Qt::QueuedConnection);
+        }, priority);
+    }, priority);
+}
+
+int PagePipeline::generation() const
+{
+    return m_generation.loadAcquire();
+}
+
+bool PagePipeline::isCurrent(int generation) const
+{
+    return generation == m_generation.loadAcquire();
+}
+
+bool PagePipeline::isLargeImage(const QSize &size)
+{
+    return qint64(size.width()) * size.height() > MAX_DISPLAY_PIXELS
+        || qMax(size.width(), size.height()) > MAX_DISPLAY_DIMENSION;
+}
+
+PagePipeline::Request PagePipeline::makeRequest(int page, qreal zoom, bool tracked)
+{
+    // 不受代数影响的请求不能递增代数，否则会使当前的单页请求失效
+    Request request;
+    request.generation = tracked ? m_generation.fetchAndAddOrdered(1) + 1 : -1;
+    request.serial = m_comicSerial.loadAcquire();
+    request.wanted = false;
+    request.page = page;
+    request.zoom = zoom;
+    request.devicePixelRatio = m_devicePixelRatio;
+    request.filePath = m_filePath;
+    request.fingerprint = m_fingerprint;
+    return request;
+}
+
+bool PagePipeline::isLive(const Request &request) const
+{
+    if (request.generation >= 0) {
+        return isCurrent(request.generation);
+    }
+    if (request.serial != m_comicSerial.loadAcquire()) {
+        return false;
+    }
+    if (!request.wanted) {
+        return true;
+    }
+    QMutexLocker locker(&m_wantedMutex);
+    return m_wantedPages.contains(request.page);
+}
+
+void PagePipeline::fetchStage(const Request &request)
+{
+    if (!isLive(request)) {
+        return;
+    }
+
+    // 映射的解码图片无需再解码；映射存储在重启后为空，预热写入磁盘的解码页面重新映射后使用
+    QElapsedTimer timer;
+    timer.start();
+    CacheManager *cache = CacheManager::instance();
+    const CacheKey pageKey(request.filePath, request.fingerprint, request.page, CacheWarmup::pageVariant());
+    QImage decoded = cache->getDecodedImage(pageKey);
+    if (decoded.isNull()) {
+        const QImage stored = cache->loadImageFromDisk(pageKey);
+        if (!stored.isNull()) {
+            decoded = cache->cacheDecodedImage(pageKey, stored);
+        }
+    }
+    recordStage(request, PageTurnMetrics::CacheLookup, timer);
+    if (!decoded.isNull()) {
+        recordSource(request, PageTurnMetrics::DecodedCache);
+        m_workerPool.start([this, request, decoded]() { scaleStage(request, decoded); });
+        return;
+    }
+
+    const QByteArray data = fetchData(request);
+    if (data.isEmpty()) {
+        fail(request);
+        return;
+    }
+    if (!isLive(request)) {
+        return;
+    }
+    m_workerPool.start([this, request, data]() { decodeStage(request, data); });
+}
+
+void PagePipeline::decodeStage(const Request &request, const QByteArray &data)
+{
+    if (!isLive(request)) {
+        return;
+    }
+
+    // 缩小显示时只按需要的分辨率解码；超大页面由 TiledPageView 从原图分块绘制，仍需完整解码
+    const qreal deviceZoom = request.zoom * request.devicePixelRatio;
+    qreal scale = 1.0;
+    if (request.generation >= 0 && deviceZoom < 1.0 && !isLargeImage(ImageDecoder::imageSize(data))) {
+        scale = deviceZoom;
+    }
+
+    QSize fullSize;
+    const QImage image = decodePage(request, data, scale, &fullSize);
+    if (image.isNull()) {
+        fail(request);
+        return;
+    }
+    if (image.size() != fullSize) {
+        if (isLive(request)) {
+            QElapsedTimer timer;
+            timer.start();
+            const QImage display = withDevicePixelRatio(
+                scaleImage(image, deviceZoom, fullSize * deviceZoom), request.devicePixelRatio);
+            recordStage(request, PageTurnMetrics::Scale, timer);
+            deliver(request, fullSize, QImage(), display);
+        }
+        return;
+    }
+    scaleStage(request, image);
+}
+
+QImage PagePipeline::decodePage(const Request &request, const QByteArray &data, qreal scale, QSize *fullSize)
+{
+    QSize size;
+    QElapsedTimer timer;
+    timer.start();
+    const QImage image = ImageDecoder::decode(data, scale, &size);
+    recordStage(request, PageTurnMetrics::Decode, timer);
+    if (fullSize) {
+        *fullSize = size;
+    }
+    if (image.isNull()) {
+        return QImage();
+    }
+
+    // 缩小解码的结果不能代替原图，不放入缓存
+    if (image.size() != size) {
+        return toDisplayFormat(image);
+    }
+
+    // 解码结果即使已经过期也保留下来，翻回来时不必再解码
+    const CacheKey pageKey(request.filePath, request.fingerprint, request.page, CacheWarmup::pageVariant());
+    return CacheManager::instance()->cacheDecodedImage(pageKey, toDisplayFormat(image));
+}
+
+void PagePipeline::scaleStage(const Request &request, const QImage &original)
+{
+    if (!isLive(request)) {
+        return;
+    }
+
+    // 连续滚动模式由视图自己缩放；大图由 TiledPageView 分块绘制，不生成整张缩放图
+    const qreal deviceZoom = request.zoom * request.devicePixelRatio;
+    if (request.generation < 0 || isLargeImage(original.size())
+        || isLargeImage(original.size() * deviceZoom)) {
+        deliver(request, original.size(), original, QImage());
+        return;
+    }
+    QElapsedTimer timer;
+    timer.start();
+    const QImage display = withDevicePixelRatio(scaleOriginal(original, deviceZoom), request.devicePixelRatio);
+    recordStage(request, PageTurnMetrics::Scale, timer);
+    deliver(request, original.size(), original, display);
+}
+
+void PagePipeline::deliver(const Request &request, const QSize &pageSize, const QImage &original,
+                           const QImage &display)
+{
+    // 在GUI线程上再检查一次：排队期间用户可能已经翻页
+    QMetaObject::invokeMethod(this, [this, request, pageSize, original, display]() {
+        if (!isLive(request)) {
+            return;
+        }
+        if (request.generation < 0) {
+            emit pageFetched(request.page, original);
+        } else {
+            emit pageReady(request.generation, request.page, request.zoom, pageSize, original, display);
+        }
+    }, Qt::QueuedConnection);
+}
+
+void PagePipeline::fail(const Request &request)
+{
+    QMetaObject::invokeMethod(this, [this, request]() {
+        if (!isLive(request)) {
+            return;
+        }
+        if (request.generation < 0) {
+            emit pageFetched(request.page, QImage());
+        } else {
+            emit pageFailed(request.generation, request.page);
+        }
+    }, Qt::QueuedConnection);
+}
+
+QByteArray PagePipeline::fetchData(const Request &request)
+{
+    // 预热过的原始数据无需再从归档中解压
+    CacheManager *cache = CacheManager::instance();
+    const CacheKey rawKey(request.filePath, request.fingerprint, request.page, CacheWarmup::rawPageVariant());
+    QElapsedTimer timer;
+    timer.start();
+    QByteArray data = cache->getCachedData(rawKey);
+    PageTurnMetrics::Source source = PageTurnMetrics::RawMemory;
+    if (data.isEmpty()) {
+        data = cache->loadFromDisk(rawKey);
+        source = PageTurnMetrics::RawDisk;
+    }
+    recordStage(request, PageTurnMetrics::Fetch, timer);
+    if (data.isEmpty()) {
+        timer.restart();
+        data = readFromArchive(request);
+        source = PageTurnMetrics::Archive;
+        recordStage(request, PageTurnMetrics::Inflate, timer);
+    }
+    if (!data.isEmpty()) {
+        recordSource(request, source);
+    }
+    return data;
+}
+
+QSize PagePipeline::probeSize(const Request &request)
+{
+    CacheManager *cache = CacheManager::instance();
+    const CacheKey sizeKey(request.filePath, request.fingerprint, request.page, SIZE_VARIANT);
+
+    QByteArray entry = cache->getCachedData(sizeKey);
+    if (entry.isEmpty()) {
+        entry = cache->loadFromDisk(sizeKey);
+    }
+    if (entry.size() == 8) {
+        const uchar *bytes = reinterpret_cast<const uchar *>(entry.constData());
+        return QSize(int(qFromLittleEndian<quint32>(bytes)), int(qFromLittleEndian<quint32>(bytes + 4)));
+    }
+
+    // 已经解码过的页面直接取尺寸，否则只读取图片头
+    QSize size;
+    const CacheKey pageKey(request.filePath, request.fingerprint, request.page, CacheWarmup::pageVariant());
+    const QImage decoded = cache->getDecodedImage(pageKey);
+    if (!decoded.isNull()) {
+        size = decoded.size();
+    } else {
+        QByteArray data = fetchData(request);
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::ReadOnly);
+        QImageReader reader(&buffer);
+        size = reader.size();
+    }
+    if (!size.isValid()) {
+        return size;
+    }
+
+    entry.resize(8);
+    uchar *bytes = reinterpret_cast<uchar *>(entry.data());
+    qToLittleEndian<quint32>(quint32(size.width()), bytes);
+    qToLittleEndian<quint32>(quint32(size.height()), bytes + 4);
+    cache->cacheData(sizeKey, entry);
+    cache->saveToDisk(sizeKey, entry, CacheManager::Metadata);
+    return size;
+}
+
+bool PagePipeline::loadContentBounds(const Request &request, QSize *pageSize, QRect *bounds)
+{
+    CacheManager *cache = CacheManager::instance();
+    const CacheKey boundsKey(request.filePath, request.fingerprint, request.page, BOUNDS_VARIANT);
+    QByteArray entry = cache->getCachedData(boundsKey);
+    if (entry.isEmpty()) {
+        entry = cache->loadFromDisk(boundsKey);
+    }
+    if (entry.size() != 24) {
+        return false;
+    }
+    const uchar *bytes = reinterpret_cast<const uchar *>(entry.constData());
+    *pageSize = QSize(int(qFromLittleEndian<quint32>(bytes)), int(qFromLittleEndian<quint32>(bytes + 4)));
+    *bounds = QRect(int(qFromLittleEndian<quint32>(bytes + 8)), int(qFromLittleEndian<quint32>(bytes + 12)),
+                    int(qFromLittleEndian<quint32>(bytes + 16)), int(qFromLittleEndian<quint32>(bytes + 20)));
+    return pageSize->isValid() && bounds->isValid();
+}
+
+void PagePipeline::storeContentBounds(const Request &request, const QSize &pageSize, const QRect &bounds)
+{
+    QByteArray entry(24, Qt::Uninitialized);
+    uchar *bytes = reinterpret_cast<uchar *>(entry.data());
+    qToLittleEndian<quint32>(quint32(pageSize.width()), bytes);
+    qToLittleEndian<quint32>(quint32(pageSize.height()), bytes + 4);
+    qToLittleEndian<quint32>(quint32(bounds.x()), bytes + 8);
+    qToLittleEndian<quint32>(quint32(bounds.y()), bytes + 12);
+    qToLittleEndian<quint32>(quint32(bounds.width()), bytes + 16);
+    qToLittleEndian<quint32>(quint32(bounds.height()), bytes + 20);
+
+    CacheManager *cache = CacheManager::instance();
+    const CacheKey boundsKey(request.filePath, request.fingerprint, request.page, BOUNDS_VARIANT);
+    cache->cacheData(boundsKey, entry);
+    cache->saveToDisk(boundsKey, entry, CacheManager::Metadata);
+}
+
+void PagePipeline::publishContentBounds(const Request &request, const QSize &pageSize, const QRect &bounds)
+{
+    QMetaObject::invokeMethod(this, [this, request, pageSize, bounds]() {
+        if (isLive(request)) {
+            emit contentBoundsDetected(request.page, pageSize, bounds);
+        }
+    }, Qt::QueuedConnection);
+}
+
+bool PagePipeline::loadPanels(const Request &request, bool rightToLeft, QSize *pageSize, QVector<QRect> *panels)
+{
+    CacheManager *cache = CacheManager::instance();
+    const CacheKey panelsKey(request.filePath, request.fingerprint, request.page, panelsVariant(rightToLeft));
+    QByteArray entry = cache->getCachedData(panelsKey);
+    if (entry.isEmpty()) {
+        entry = cache->loadFromDisk(panelsKey);
+    }
+    if (entry.size() < 12) {
+        return false;
+    }
+    const uchar *bytes = reinterpret_cast<const uchar *>(entry.constData());
+    const int count = int(qFromLittleEndian<quint32>(bytes + 8));
+    if (entry.size() != 12 + 16 * qint64(count)) {
+        return false;
+    }
+    *pageSize = QSize(int(qFromLittleEndian<quint32>(bytes)), int(qFromLittleEndian<quint32>(bytes + 4)));
+    panels->clear();
+    panels->reserve(count);
+    for (int i = 0; i < count; ++i) {
+        const uchar *rect = bytes + 12 + 16 * i;
+        panels->append(QRect(int(qFromLittleEndian<quint32>(rect)), int(qFromLittleEndian<quint32>(rect + 4)),
+                             int(qFromLittleEndian<quint32>(rect + 8)), int(qFromLittleEndian<quint32>(rect + 12))));
+    }
+    return pageSize->isValid();
+}
+
+void PagePipeline::storePanels(const Request &request, bool rightToLeft, const QSize &pageSize,
+                               const QVector<QRect> &panels)
+{
+    // 检测不出分格的页面也记录下来（格数为0），不会每次都重新分析
+    QByteArray entry(12 + 16 * panels.size(), Qt::Uninitialized);
+    uchar *bytes = reinterpret_cast<uchar *>(entry.data());
+    qToLittleEndian<quint32>(quint32(pageSize.width()), bytes);
+    qToLittleEndian<quint32>(quint32(pageSize.height()), bytes + 4);
+    qToLittleEndian<quint32>(quint32(panels.size()), bytes + 8);
+    for (int i = 0; i < panels.size(); ++i) {
+        uchar *rect = bytes + 12 + 16 * i;
+        qToLittleEndian<quint32>(quint32(panels[i].x()), rect);
+        qToLittleEndian<quint32>(quint32(panels[i].y()), rect + 4);
+        qToLittleEndian<quint32>(quint32(panels[i].width()), rect + 8);
+        qToLittleEndian<quint32>(quint32(panels[i].height()), rect + 12);
+    }
+
+    CacheManager *cache = CacheManager::instance();
+    const CacheKey panelsKey(request.filePath, request.fingerprint, request.page, panelsVariant(rightToLeft));
+    cache->cacheData(panelsKey, entry);
+    cache->saveToDisk(panelsKey, entry, CacheManager::Metadata);
+}
+
+void PagePipeline::recordStage(const Request &request, PageTurnMetrics::Stage stage, const QElapsedTimer &timer)
+{
+    if (request.generation >= 0) {
+        m_metrics.record(stage, timer.nsecsElapsed());
+    }
+}
+
+void PagePipeline::recordSource(const Request &request, PageTurnMetrics::Source source)
+{
+    if (request.generation >= 0) {
+        m_metrics.recordSource(source);
+    }
+}
+
+QByteArray PagePipeline::readFromArchive(const Request &request)
+{
+    // 只在读取线程调用；切换漫画后重新打开归档
+    if (!m_parser || m_parserPath != request.filePath) {
+        delete m_parser;
+        m_parser = new ComicParser();
+        m_parserPath = request.filePath;
+        if (!m_parser->parseComic(request.filePath)) {
+            qWarning() << "Page pipeline failed to open:" << request.filePath;
+            delete m_parser;
+            m_parser = nullptr;
+            m_parserPath.clear();
+            return QByteArray();
+        }
+    }
+    return m_parser->getPageData(request.page);
+}
+
+QSharedPointer<ImagePyramid> PagePipeline::pyramidFor(const QImage &original)
+{
+    QMutexLocker locker(&m_pyramidMutex);
+    for (int i = 0; i < m_pyramids.size(); ++i) {
+        if (m_pyramids.at(i)->base().cacheKey() == original.cacheKey()) {
+            m_pyramids.move(i, 0);
+            return m_pyramids.first();
+        }
+    }
+    const QSharedPointer<ImagePyramid> pyramid = QSharedPointer<ImagePyramid>::create(original);
+    m_pyramids.prepend(pyramid);
+    while (m_pyramids.size() > MAX_PYRAMIDS) {
+        m_pyramids.removeLast();
+    }
+    return pyramid;
+}
+
+QImage PagePipeline::scaleOriginal(const QImage &original, qreal zoom)
+{
+    // 缩小时从金字塔中最接近的一层重采样；第一次用到某一层时顺便生成，之后同一页再缩放时不必读取整张原图
+    if (zoom >= 0.99) {
+        return scaleImage(original, zoom);
+    }
+    const QImage display = pyramidFor(original)->scaled((original.size() * zoom).expandedTo(QSize(1, 1)));
+    updatePyramidUsage();
+    return display;
+}
+
+void PagePipeline::updatePyramidUsage()
+{
+    qint64 bytes = 0;
+    {
+        QMutexLocker locker(&m_pyramidMutex);
+        for (const QSharedPointer<ImagePyramid> &pyramid : m_pyramids) {
+            bytes += pyramid->levelBytes();
+        }
+        MemoryGovernor::instance()->updateUsage(m_governorId, bytes);
+    }
+    MemoryGovernor::instance()->checkBudget();
+}
+
+qint64 PagePipeline::reclaimPyramids(qint64 bytes)
+{
+    // 在调度器线程中调用：从最久未用的开始丢弃（视图仍在使用的金字塔在视图释放后才真正释放）
+    QMutexLocker locker(&m_pyramidMutex);
+    qint64 freed = 0;
+    qint64 remaining = 0;
+    while (!m_pyramids.isEmpty() && freed < bytes) {
+        freed += m_pyramids.takeLast()->levelBytes();
+    }
+    for (const QSharedPointer<ImagePyramid> &pyramid : m_pyramids) {
+        remaining += pyramid->levelBytes();
+    }
+    MemoryGovernor::instance()->updateUsage(m_governorId, remaining);
+    return freed;
+}
+
+QImage PagePipeline::scaleImage(const QImage &original, qreal zoom)
+{
+    if (qAbs(zoom - 1.0) < 0.01) {
+        return toDisplayFormat(original);
+    }
+    return scaleImage(original, zoom, original.size() * zoom);
+}
+
+QImage PagePipeline::scaleImage(const QImage &original, qreal zoom, const QSize &size)
+{
+    // 缩小用面积平均（不产生摩尔纹）；放大时 Qt 的双线性插值已经足够
+    if (zoom < 1.0) {
+        return ImageScaler::scale(original, size.expandedTo(QSize(1, 1)));
+    }
+    return toDisplayFormat(original.scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
+}
+
+QImage PagePipeline::composeSpread(const QVector<QImage> &pages, const QSize &bounds, bool rightToLeft)
+{
+    qreal aspectSum = 0;
+    for (const QImage &page : pages) {
+        if (!page.isNull()) {
+            aspectSum += qreal(page.width()) / page.height();
+        }
+    }
+    if (aspectSum <= 0 || bounds.isEmpty()) {
+        return QImage();
+    }
+
+    // 共同高度：既不超过 bounds 的高度，并排后的总宽度也不超过 bounds 的宽度
+    const int height = qMax(1, qMin(bounds.height(), int(bounds.width() / aspectSum)));
+    QVector<QImage> scaled;
+    int width = 0;
+    for (const QImage &page : pages) {
+        if (page.isNull()) {
+            continue;
+        }
+        const QSize size(qMax(1, qRound(qreal(page.width()) * height / page.height())), height);
+        const QImage image = page.height() == height
+            ? page : scaleImage(page, qreal(height) / page.height(), size);
+        width += image.width();
+        scaled.append(image);
+    }
+
+    QImage spread(width, height, QImage::Format_RGB32);
+    spread.fill(Qt::white);
+    QPainter painter(&spread);
+    int x = 0;
+    for (int i = 0; i < scaled.size(); ++i) {
+        const QImage &image = scaled.at(rightToLeft ? scaled.size() - 1 - i : i);
+        painter.drawImage(x, 0, image);
+        x += image.width();
+    }
+    painter.end();
+    return spread;
+}
+
+QImage PagePipeline::toDisplayFormat(const QImage &image)
+{
+    // 与光栅后端 QPixmap 的内部格式一致，GUI线程上转换时不需要逐像素处理
+    const QImage::Format format = image.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied
+                                                          : QImage::Format_RGB32;
+    return image.format() == format ? image : image.convertToFormat(format);
+}
@@ -1,5 +1,12 @@
 #include "../../include/ui/ReaderWidget.h"
 #include "../../include/core/ComicParser.h"
+#include "../../include/core/CacheManager.h"
+#include "../../include/core/cache/CacheWarmup.h"
+#include "../../include/core/config/ConfigManager.h"
+#include "ui/reader/PagePipeline.h"
+#include "ui/reader/TiledPageView.h"
+#include "ui/reader/ContinuousPageView.h"
+#include "ui/reader/AnimatedPagePlayer.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QToolBar>
@@ -8,28 +15,106 @@
 #include <QSpinBox>
 #include <QLabel>
 #include <QScrollArea>
+#include <QStackedWidget>
 #include <QPixmap>
 #include <QFileInfo>
 #include <QMessageBox>
 #include <QProgressDialog>
-#include <QApplication>
+#include <QTimer>
+#include <QSignalBlocker>
+#include <QResizeEvent>
+#include <QAction>
+#include <QFileDialog>
+#include <QScrollBar>
 
 ReaderWidget::ReaderWidget(QWidget *parent)
     : QWidget(parent)
     , comicParser(new ComicParser(this))
     , currentPage(0)
     , zoomFactor(1.0)
+    , tiledPage(false)
+    , continuousMode(false)
+    , spreadMode(false)
+    , rightToLeft(ConfigManager::instance()->getReadingDirection() != 0)
+    , autoCrop(false)
+    , panelMode(false)
+    , currentPanel(0)
+    , pagePipeline(new PagePipeline(this))
+    , animationPlayer(new AnimatedPagePlayer(this))
+    , loadingTimer(new QTimer(this))
+    , rescaleTimer(new QTimer(this))
+    , settleTimer(new QTimer(this))
+    , overlayTimer(new QTimer(this))
+    , turnPending(false)
+    , presentPending(false)
 {
     setupUI();
     
+    // 页面加载流水线：结果回到GUI线程显示，缩放结果直接是设备像素
+    pagePipeline->setDevicePixelRatio(devicePixelRatioF());
+    connect(pagePipeline, &PagePipeline::pageReady, this, &ReaderWidget::onPageReady);
+    connect(pagePipeline, &PagePipeline::pageFailed, this, &ReaderWidget::onPageFailed);
+    connect(pagePipeline, &PagePipeline::scalePrepared, this, &ReaderWidget::onScalePrepared);
+    connect(pagePipeline, &PagePipeline::spreadReady, this, &ReaderWidget::onSpreadReady);
+    connect(pagePipeline, &PagePipeline::spreadPrepared, this, &ReaderWidget::onSpreadPrepared);
+    connect(pagePipeline, &PagePipeline::pageSizeProbed, this, &ReaderWidget::onPageSizeProbed);
+    connect(pagePipeline, &PagePipeline::contentBoundsDetected, this, &ReaderWidget::onContentBoundsDetected);
+    connect(pagePipeline, &PagePipeline::panelsDetected, this, &ReaderWidget::onPanelsDetected);
+    rescaleTimer->setSingleShot(true);
+    rescaleTimer->setInterval(80);
+    connect(rescaleTimer, &QTimer::timeout, this, &ReaderWidget::startSmoothRescale);
+    connect(pagePipeline, &PagePipeline::previewReady, this, &ReaderWidget::onPreviewReady);
+    connect(pagePipeline, &PagePipeline::animationReady, this, &ReaderWidget::onAnimationReady);
+    connect(animationPlayer, &AnimatedPagePlayer::frameReady, this, &ReaderWidget::onAnimationFrame);
+    
+    // 连续翻页时间隔小于此值的翻页合并，停下后才完整加载
+    settleTimer->setSingleShot(true);
+    settleTimer->setInterval(150);
+    connect(settleTimer, &QTimer::timeout, this, &ReaderWidget::updatePageDisplay);
+    loadingTimer->setSingleShot(true);
+    loadingTimer->setInterval(150);
+    connect(loadingTimer, &QTimer::timeout, this, [this]() {
+        showMessage("加载中...");
+    });
+    overlayTimer->setInterval(500);
+    connect(overlayTimer, &QTimer::timeout, this, &ReaderWidget::updatePerformanceOverlay);
+    
     // 连接解析器信号
     connect(comicParser, &ComicParser::parseCompleted, this, [this](bool success) {
         if (success) {
             const auto& info = comicParser->getComicInfo();
+            archiveFingerprint = ArchiveFingerprint::fromFile(info.filePath);
+            pagePipeline->setComic(info.filePath, archiveFingerprint);
+            animationPlayer->stop();
+            originalPixmap = QPixmap();
+            originalImage = QImage();
+            pageSize = QSize();
+            spreadLayout.reset(info.pageCount);
+            spreadPages.clear();
+            preparingSpreads.clear();
+            contentBounds.clear();
+            pagePanels.clear();
+            panelRequests.clear();
+            currentPanel = 0;
+            if (autoCrop) {
+                // 各页边距在后台检测，适应宽度/高度时已有结果的页面直接使用
+                pagePipeline->detectContentBounds(info.pageCount);
+            }
+            if (spreadMode) {
+                // 跨页划分需要各页尺寸，宽页面单独显示
+                pagePipeline->probePageSizes(info.pageCount);
+            }
             pageSpinBox->setMaximum(info.pageCount);
             pageLabel->setText(QString("/ %1").arg(info.pageCount));
-            if (info.pageCount > 0) {
-                currentPage = 0;
+            currentPage = 0;
+            if (panelNavigation()) {
+                requestPanelsAhead();
+            }
+            if (continuousMode) {
+                // 先按估计尺寸排版，各页真实尺寸在后台读取
+                continuousView->setPageCount(info.pageCount);
+                onPageChanged();
+            } else if (info.pageCount > 0) {
                 updatePageDisplay();
             }
         } else {
@@ -40,6 +125,46 @@ ReaderWidget::ReaderWidget(QWidget *parent)
     connect(comicParser, &ComicParser::error, this, [this](const QString& error) {
         QMessageBox::critical(this, "解析错误", error);
     });
+    
+    setContinuousMode(ConfigManager::instance()->getValue("reader/continuousScroll", false).toBool());
+    setSpreadMode(ConfigManager::instance()->isDoublePageMode());
+    setPerformanceOverlay(ConfigManager::instance()->getValue("reader/performanceOverlay", false).toBool());
+    setAutoCrop(ConfigManager::instance()->getValue("reader/autoCrop", false).toBool());
+    setPanelMode(ConfigManager::instance()->getValue("reader/panelMode", false).toBool());
+    connect(ConfigManager::instance(), &ConfigManager::configChanged, this,
+            [this](const QString &key, const QVariant &value) {
+        if (key == "Reading/DoublePageMode") {
+            setSpreadMode(value.toBool());
+        } else if (key == "Reading/Direction" && rightToLeft != (value.toInt() != 0)) {
+            rightToLeft = value.toInt() != 0;
+            spreadPages.clear();
+            // 分格的顺序与阅读方向有关，按新的方向重新取得
+            pagePanels.clear();
+            panelRequests.clear();
+            if (panelNavigation() && comicParser->getComicInfo().pageCount > 0) {
+                requestPanelsAhead();
+            }
+            if (spreadMode && comicParser->getComicInfo().pageCount > 0) {
+                updatePageDisplay();
+            }
+        }
+    });
+    
+    // 界面显示后在后台预热最近阅读的漫画
+    if (ConfigManager::instance()->getValue("cache/warmupOnStartup", true).toBool()) {
+        QTimer::singleShot(0, this, []() {
+            CacheWarmup::instance()->start();
+        });
+    }
+}
+
+ReaderWidget::~ReaderWidget()
+{
+    // 设置了环境变量时退出前导出翻页延迟统计，便于比较不同版本
+    const QString metricsPath = qEnvironmentVariable("COMICREADER_TURN_METRICS");
+    if (!metricsPath.isEmpty()) {
+        exportTurnMetrics(metricsPath);
+    }
 }
 
 void ReaderWidget::setupUI()
@@ -58,12 +183,27 @@ void ReaderWidget::setupUI()
     fitWidthButton = new QPushButton("适应宽度", this);
     fitHeightButton = new QPushButton("适应高度", this);
     resetZoomButton = new QPushButton("重置缩放", this);
+    continuousButton = new QPushButton("条漫模式", this);
+    spreadButton = new QPushButton("双页模式", this);
+    autoCropButton = new QPushButton("裁切白边", this);
+    panelButton = new QPushButton("分格阅读", this);
+    performanceButton = new QPushButton("性能", this);
     
     // 设置组件属性
     pageSpinBox->setMinimum(1);
     zoomSlider->setRange(10, 500);
     zoomSlider->setValue(100);
     zoomSlider->setToolTip("缩放比例");
+    continuousButton->setCheckable(true);
+    continuousButton->setToolTip("所有页面纵向连续排列，适合条漫");
+    spreadButton->setCheckable(true);
+    spreadButton->setToolTip("两页并排显示，宽页面单独显示");
+    autoCropButton->setCheckable(true);
+    autoCropButton->setToolTip("适应宽度/高度时忽略页面四周的空白边距");
+    panelButton->setCheckable(true);
+    panelButton->setToolTip("翻页键逐格移动，每格放大到适应窗口，适合小屏幕");
+    performanceButton->setCheckable(true);
+    performanceButton->setToolTip("显示翻页延迟（p50/p95/p99）和页面数据来源");
     
     // 添加到工具栏
     toolBar->addWidget(prevButton);
@@ -80,6 +220,13 @@ void ReaderWidget::setupUI()
     toolBar->addWidget(fitWidthButton);
     toolBar->addWidget(fitHeightButton);
     toolBar->addWidget(resetZoomButton);
+    toolBar->addWidget(autoCropButton);
+    toolBar->addWidget(panelButton);
+    toolBar->addSeparator();
+    toolBar->addWidget(continuousButton);
+    toolBar->addWidget(spreadButton);
+    toolBar->addSeparator();
+    toolBar->addWidget(performanceButton);
     
     // 创建滚动区域
     scrollArea = new QScrollArea(this);
@@ -90,9 +237,45 @@ void ReaderWidget::setupUI()
     scrollArea->setWidget(imageLabel);
     scrollArea->setWidgetResizable(true);
     
+    // 超长条漫、超大扫描页分块绘制
+    pageView = new TiledPageView(this);
+    displayStack = new QStackedWidget(this);
+    displayStack->addWidget(scrollArea);
+    displayStack->addWidget(pageView);
+    
+    // 条漫模式：连续滚动，只加载视口附近的页面
+    continuousView = new ContinuousPageView(pagePipeline, this);
+    displayStack->addWidget(continuousView);
+    
     // 布局
     mainLayout->addWidget(toolBar);
-    mainLayout->addWidget(scrollArea);
+    mainLayout->addWidget(displayStack);
+    
+    // 性能浮层：不参与布局，叠在页面右上角；右键菜单导出或重置统计
+    performanceOverlay = new QLabel(this);
+    performanceOverlay->setStyleSheet("background-color: rgba(0, 0, 0, 160); color: white;"
+                                      "font-family: monospace; padding: 6px; border-radius: 4px;");
+    performanceOverlay->setContextMenuPolicy(Qt::ActionsContextMenu);
+    QAction *exportAction = new QAction("导出为 JSON...", performanceOverlay);
+    QAction *resetAction = new QAction("重置统计", performanceOverlay);
+    performanceOverlay->addAction(exportAction);
+    performanceOverlay->addAction(resetAction);
+    performanceOverlay->hide();
+    connect(exportAction, &QAction::triggered, this, [this]() {
+        const QString fileName = QFileDialog::getSaveFileName(this, "导出翻页延迟统计", "page-turn-metrics.json",
+                                                              "JSON 文件 (*.json)");
+        if (!fileName.isEmpty() && !exportTurnMetrics(fileName)) {
+            QMessageBox::warning(this, "错误", "无法写入文件：" + fileName);
+        }
+    });
+    connect(resetAction, &QAction::triggered, this, [this]() {
+        pagePipeline->metrics()->reset();
+        updatePerformanceOverlay();
+    });
+    
+    // 新页面开始绘制时结束翻页计时
+    imageLabel->installEventFilter(this);
+    pageView->viewport()->installEventFilter(this);
     
     // 连接信号
     connect(prevButton, &QPushButton::clicked, this, &ReaderWidget::previousPage);
@@ -102,10 +285,22 @@ void ReaderWidget::setupUI()
     connect(fitWidthButton, &QPushButton::clicked, this, &ReaderWidget::fitToWidth);
     connect(fitHeightButton, &QPushButton::clicked, this, &ReaderWidget::fitToHeight);
     connect(resetZoomButton, &QPushButton::clicked, this, &ReaderWidget::resetZoom);
+    connect(continuousButton, &QPushButton::toggled, this, &ReaderWidget::setContinuousMode);
+    connect(spreadButton, &QPushButton::toggled, this, &ReaderWidget::setSpreadMode);
+    connect(autoCropButton, &QPushButton::toggled, this, &ReaderWidget::setAutoCrop);
+    connect(panelButton, &QPushButton::toggled, this, &ReaderWidget::setPanelMode);
+    connect(performanceButton, &QPushButton::toggled, this, &ReaderWidget::setPerformanceOverlay);
+    connect(continuousView, &ContinuousPageView::currentPageChanged, this, [this](int page) {
+        currentPage = page;
+        onPageChanged();
+    });
 }
 
 void ReaderWidget::openComic(const QString &filePath)
 {
+    // 用户已经打开漫画，停止后台预热，把I/O让给当前漫画
+    CacheWarmup::instance()->cancel();
+    
     // 显示进度对话框
     QProgressDialog *progressDialog = new QProgressDialog("正在解析漫画文件...", "取消", 0, 100, this);
     progressDialog->setWindowModality(Qt::WindowModal);
@@ -129,18 +324,47 @@ void ReaderWidget::openComic(const QString &filePath)
 
 void ReaderWidget::nextPage()
 {
+    if (spreadMode) {
+        const QVector<int> pages = spreadLayout.pages(spreadLayout.spreadOf(currentPage) + 1);
+        if (!pages.isEmpty()) {
+            currentPage = pages.first();
+            showNavigatedPage();
+        }
+        return;
+    }
+    
+    // 分格阅读：先在当前页中逐格移动，最后一格之后才翻到下一页的第一格
+    if (stepPanel(1)) {
+        return;
+    }
+    
     const auto& info = comicParser->getComicInfo();
     if (currentPage < info.pageCount - 1) {
         currentPage++;
-        updatePageDisplay();
+        currentPanel = 0;
+        showNavigatedPage();
     }
 }
 
 void ReaderWidget::previousPage()
 {
+    if (spreadMode) {
+        const QVector<int> pages = spreadLayout.pages(spreadLayout.spreadOf(currentPage) - 1);
+        if (!pages.isEmpty()) {
+            currentPage = pages.first();
+            showNavigatedPage();
+        }
+        return;
+    }
+    
+    if (stepPanel(-1)) {
+        return;
+    }
+    
     if (currentPage > 0) {
         currentPage--;
-        updatePageDisplay();
+        currentPanel = LAST_PANEL;
+        showNavigatedPage();
     }
 }
 
@@ -149,7 +373,8 @@ void ReaderWidget::goToPage(int page)
     const auto& info = comicParser->getComicInfo();
     if (page >= 1 && page <= info.pageCount) {
         currentPage = page - 1;
-        updatePageDisplay();
+        currentPanel = 0;
+        showNavigatedPage();
     }
 }
 
@@ -172,30 +397,374 @@ void ReaderWidget::resetZoom()
 
 void ReaderWidget::fitToWidth()
 {
-    if (!originalPixmap.isNull()) {
-        int targetWidth = scrollArea->viewport()->width() - 20; // 留一些边距
-        if (targetWidth > 0) {
-            double ratio = double(targetWidth) / originalPixmap.width();
-            int newValue = qRound(ratio * 100);
-            zoomSlider->setValue(qBound(10, newValue, 500));
-        }
+    const int newValue = fitZoomValue(Qt::Horizontal);
+    if (newValue > 0) {
+        zoomSlider->setValue(newValue);
+        scrollToContent();
     }
 }
 
 void ReaderWidget::fitToHeight()
 {
-    if (!originalPixmap.isNull()) {
-        int targetHeight = scrollArea->viewport()->height() - 20; // 留一些边距
-        if (targetHeight > 0) {
-            double ratio = double(targetHeight) / originalPixmap.height();
-            int newValue = qRound(ratio * 100);
-            zoomSlider->setValue(qBound(10, newValue, 500));
+    const int newValue = fitZoomValue(Qt::Vertical);
+    if (newValue > 0) {
+        zoomSlider->setValue(newValue);
+        scrollToContent();
+    }
+}
+
+void ReaderWidget::setAutoCrop(bool enabled)
+{
+    ConfigManager::instance()->setValue("reader/autoCrop", enabled);
+    {
+        QSignalBlocker blocker(autoCropButton);
+        autoCropButton->setChecked(enabled);
+    }
+    if (enabled == autoCrop) {
+        return;
+    }
+    autoCrop = enabled;
+    // 已经检测过的页面从缓存中直接取得结果
+    const int pageCount = comicParser->getComicInfo().pageCount;
+    if (enabled && pageCount > 0 && contentBounds.size() < pageCount) {
+        pagePipeline->detectContentBounds(pageCount);
+    }
+}
+
+void ReaderWidget::setPanelMode(bool enabled)
+{
+    ConfigManager::instance()->setValue("reader/panelMode", enabled);
+    {
+        QSignalBlocker blocker(panelButton);
+        panelButton->setChecked(enabled);
+    }
+    if (enabled == panelMode) {
+        return;
+    }
+    panelMode = enabled;
+    currentPanel = 0;
+    if (panelNavigation() && comicParser->getComicInfo().pageCount > 0) {
+        requestPanelsAhead();
+        showCurrentPanel();
+    }
+}
+
+void ReaderWidget::setPerformanceOverlay(bool enabled)
+{
+    ConfigManager::instance()->setValue("reader/performanceOverlay", enabled);
+    {
+        QSignalBlocker blocker(performanceButton);
+        performanceButton->setChecked(enabled);
+    }
+    performanceOverlay->setVisible(enabled);
+    if (enabled) {
+        updatePerformanceOverlay();
+        performanceOverlay->raise();
+        overlayTimer->start();
+    } else {
+        overlayTimer->stop();
+    }
+}
+
+bool ReaderWidget::exportTurnMetrics(const QString &filePath) const
+{
+    return pagePipeline->metrics()->exportToFile(filePath);
+}
+
+void ReaderWidget::setContinuousMode(bool enabled)
+{
+    if (enabled == continuousMode) {
+        return;
+    }
+    continuousMode = enabled;
+    ConfigManager::instance()->setValue("reader/continuousScroll", enabled);
+    {
+        QSignalBlocker blocker(continuousButton);
+        continuousButton->setChecked(enabled);
+    }
+    if (enabled && spreadMode) {
+        // 两种模式互斥
+        spreadMode = false;
+        spreadPages.clear();
+        QSignalBlocker blocker(spreadButton);
+        spreadButton->setChecked(false);
+        ConfigManager::instance()->setDoublePageMode(false);
+    }
+    updateZoomControls();
+    
+    const int pageCount = comicParser->getComicInfo().pageCount;
+    if (enabled) {
+        animationPlayer->stop();
+        pagePipeline->cancel();
+        loadingTimer->stop();
+        rescaleTimer->stop();
+        displayStack->setCurrentWidget(continuousView);
+        if (pageCount > 0) {
+            continuousView->setPageCount(pageCount);
+            continuousView->scrollToPage(currentPage);
+        }
+    } else {
+        // 释放条漫模式加载的页面，回到单页显示
+        continuousView->clear();
+        displayStack->setCurrentWidget(tiledPage ? static_cast<QWidget *>(pageView) : scrollArea);
+        pageSize = QSize();
+        if (pageCount > 0) {
+            updatePageDisplay();
+        }
+    }
+}
+
+void ReaderWidget::setSpreadMode(bool enabled)
+{
+    if (enabled == spreadMode) {
+        return;
+    }
+    spreadMode = enabled;
+    spreadPages.clear();
+    animationPlayer->stop();
+    ConfigManager::instance()->setDoublePageMode(enabled);
+    {
+        QSignalBlocker blocker(spreadButton);
+        spreadButton->setChecked(enabled);
+    }
+    updateZoomControls();
+    
+    const int pageCount = comicParser->getComicInfo().pageCount;
+    if (enabled && pageCount > 0) {
+        pagePipeline->probePageSizes(pageCount);
+    }
+    if (enabled && continuousMode) {
+        // 退出条漫模式时会按双页模式重新显示当前页
+        setContinuousMode(false);
+        return;
+    }
+    if (!continuousMode && pageCount > 0) {
+        pagePipeline->cancel();
+        rescaleTimer->stop();
+        updatePageDisplay();
+    }
+}
+
+void ReaderWidget::updateZoomControls()
+{
+    // 条漫模式适应宽度、双页模式适应窗口，缩放控件不可用
+    const bool zoomable = !continuousMode && !spreadMode;
+    for (QWidget *widget : {static_cast<QWidget *>(zoomSlider), static_cast<QWidget *>(fitWidthButton),
+                            static_cast<QWidget *>(fitHeightButton), static_cast<QWidget *>(resetZoomButton),
+                            static_cast<QWidget *>(autoCropButton), static_cast<QWidget *>(panelButton)}) {
+        widget->setEnabled(zoomable);
+    }
+}
+
+void ReaderWidget::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    
+    // 跨页按窗口大小合成，窗口大小稳定后重新合成
+    if (spreadMode && !spreadPages.isEmpty()) {
+        rescaleTimer->start();
+    }
+    positionPerformanceOverlay();
+}
+
+bool ReaderWidget::eventFilter(QObject *watched, QEvent *event)
+{
+    // 翻页结果交给界面后的第一次绘制：记录绘制等待和整个翻页的延迟
+    if (event->type() == QEvent::Paint && presentPending
+        && (watched == imageLabel || watched == pageView->viewport())) {
+        PageTurnMetrics *metrics = pagePipeline->metrics();
+        metrics->record(PageTurnMetrics::Paint, presentClock.nsecsElapsed());
+        metrics->record(PageTurnMetrics::Turn, turnClock.nsecsElapsed());
+        turnPending = false;
+        presentPending = false;
+    }
+    return QWidget::eventFilter(watched, event);
+}
+
+void ReaderWidget::changeEvent(QEvent *event)
+{
+    QWidget::changeEvent(event);
+    
+#if QT_VERSION >= QT_VERSION_CHECK(6, 6, 0)
+    // 窗口移到设备像素比不同的显示器：按新的分辨率重新生成当前页面
+    if (event->type() == QEvent::DevicePixelRatioChange
+        && !qFuzzyCompare(devicePixelRatioF(), pagePipeline->devicePixelRatio())) {
+        pagePipeline->setDevicePixelRatio(devicePixelRatioF());
+        if (continuousMode) {
+            return;
+        }
+        if (spreadMode) {
+            spreadPages.clear();
+            updatePageDisplay();
+        } else if (pageSize.isValid()) {
+            updateZoomDisplay();
         }
     }
+#endif
+}
+
+int ReaderWidget::fitZoomValue(Qt::Orientation orientation) const
+{
+    // 返回适应宽度/高度对应的缩放滑块值，无法计算时返回0
+    if (!pageSize.isValid()) {
+        return 0;
+    }
+    // 自动裁边时适应内容范围而不是整页
+    const QSize fitSize = contentRect().size();
+    double ratio = 0;
+    if (orientation == Qt::Horizontal) {
+        int targetWidth = viewportSize().width() - 20; // 留一些边距
+        ratio = double(targetWidth) / fitSize.width();
+    } else {
+        int targetHeight = viewportSize().height() - 20; // 留一些边距
+        ratio = double(targetHeight) / fitSize.height();
+    }
+    if (ratio <= 0) {
+        return 0;
+    }
+    return qBound(10, qRound(ratio * 100), 500);
+}
+
+QRect ReaderWidget::contentRect() const
+{
+    // 当前页要显示的范围：自动裁边且已经检测出边距时为内容范围，否则为整页
+    const QRect page(QPoint(0, 0), pageSize);
+    if (!autoCrop || continuousMode || spreadMode) {
+        return page;
+    }
+    const QRect bounds = contentBounds.value(currentPage);
+    return bounds.isValid() && page.contains(bounds) ? bounds : page;
+}
+
+void ReaderWidget::scrollToContent()
+{
+    // 适应内容范围后边距在视口之外
+    const QRect content = contentRect();
+    if (content.size() != pageSize) {
+        scrollToRect(content);
+    }
+}
+
+void ReaderWidget::scrollToRect(const QRect &rect)
+{
+    // 滚动到原图中 rect 的左上角，rect 比视口小的方向居中；缩放后的图片在下一次事件循环才排版完成
+    if (tiledPage) {
+        return;
+    }
+    const int page = currentPage;
+    QTimer::singleShot(0, this, [this, page, rect]() {
+        if (page != currentPage || tiledPage || currentPixmap.isNull() || !pageSize.isValid()) {
+            return;
+        }
+        // 图片在标签中居中，比视口大的方向从标签的边缘开始
+        const QSizeF shown = QSizeF(currentPixmap.size()) / currentPixmap.devicePixelRatio();
+        const qreal scale = shown.width() / pageSize.width();
+        const QSize viewport = scrollArea->viewport()->size();
+        const QPointF origin((imageLabel->width() - shown.width()) / 2, (imageLabel->height() - shown.height()) / 2);
+        const QRectF target(origin + QPointF(rect.topLeft()) * scale, QSizeF(rect.size()) * scale);
+        const int x = target.width() + 20 <= viewport.width() ? qRound(target.center().x() - viewport.width() / 2.0)
+                                                               : qRound(target.left()) - 10;
+        const int y = target.height() + 20 <= viewport.height() ? qRound(target.center().y() - viewport.height() / 2.0)
+                                                                 : qRound(target.top()) - 10;
+        scrollArea->horizontalScrollBar()->setValue(x);
+        scrollArea->verticalScrollBar()->setValue(y);
+    });
+}
+
+bool ReaderWidget::panelNavigation() const
+{
+    return panelMode && !continuousMode && !spreadMode;
+}
+
+QVector<QRect> ReaderWidget::currentPanels() const
+{
+    // 分格按原图坐标记录，与当前页的尺寸不符时（页面按缩小的分辨率显示等）不使用
+    const QVector<QRect> panels = pagePanels.value(currentPage);
+    const QRect page(QPoint(0, 0), pageSize);
+    for (const QRect &panel : panels) {
+        if (!page.contains(panel)) {
+            return QVector<QRect>();
+        }
+    }
+    return panels;
+}
+
+bool ReaderWidget::stepPanel(int step)
+{
+    // 分格已经预先检测好，逐格移动只需改变缩放和滚动位置；当前页的分格还没有时按整页翻页
+    if (!panelNavigation() || !pageSize.isValid()) {
+        return false;
+    }
+    const QVector<QRect> panels = currentPanels();
+    if (panels.isEmpty()) {
+        return false;
+    }
+    const int current = currentPanel == LAST_PANEL ? panels.size() - 1 : qBound(0, currentPanel, panels.size() - 1);
+    const int next = current + step;
+    if (next < 0 || next >= panels.size()) {
+        return false;
+    }
+    currentPanel = next;
+    showCurrentPanel();
+    return true;
+}
+
+void ReaderWidget::showCurrentPanel()
+{
+    if (!panelNavigation() || !pageSize.isValid()) {
+        return;
+    }
+    requestPanelsAhead();
+    const QVector<QRect> panels = currentPanels();
+    if (panels.isEmpty()) {
+        return;
+    }
+    if (currentPanel == LAST_PANEL || currentPanel >= panels.size()) {
+        currentPanel = panels.size() - 1;
+    }
+    currentPanel = qMax(0, currentPanel);
+    
+    // 整格放大到适应视口（留一些边距），再滚动到这一格
+    const QRect panel = panels.at(currentPanel);
+    const QSize viewport = scrollArea->viewport()->size() - QSize(20, 20);
+    const qreal ratio = qMin(qreal(viewport.width()) / panel.width(), qreal(viewport.height()) / panel.height());
+    if (ratio > 0) {
+        zoomSlider->setValue(qBound(10, qRound(ratio * 100), 500));
+    }
+    scrollToRect(panel);
+}
+
+void ReaderWidget::requestPanelsAhead()
+{
+    // 检测始终领先于阅读位置：当前页优先，其后几页以最低优先级在后台检测
+    const int pageCount = comicParser->getComicInfo().pageCount;
+    for (int page = currentPage; page < qMin(pageCount, currentPage + 1 + PANEL_LOOKAHEAD); ++page) {
+        if (pagePanels.contains(page) || panelRequests.contains(page)) {
+            continue;
+        }
+        panelRequests.insert(page);
+        pagePipeline->requestPanels(page, rightToLeft, page == currentPage);
+    }
+}
+
+void ReaderWidget::onPanelsDetected(int page, bool rightToLeft, const QSize &size, const QVector<QRect> &panels)
+{
+    if (rightToLeft != this->rightToLeft) {
+        return;
+    }
+    panelRequests.remove(page);
+    pagePanels.insert(page, panels);
+    onPageSizeProbed(page, size);
+    // 当前页先按整页显示了：分格到达后再移到要显示的格
+    if (page == currentPage) {
+        showCurrentPanel();
+    }
 }
 
 void ReaderWidget::onPageChanged()
 {
+    // 页面已经在加载，不再经由 goToPage() 重复请求
+    QSignalBlocker blocker(pageSpinBox);
     pageSpinBox->setValue(currentPage + 1);
 }
 
@@ -206,45 +775,571 @@ void ReaderWidget::onZoomChanged(int value)
     updateZoomDisplay();
 }
 
+void ReaderWidget::showNavigatedPage()
+{
+    // 按住翻页键或拖动页码框时翻页很快：中间页面只显示内存中已有的结果或低分辨率预览，
+    // 不启动完整的解码和缩放；停下 settleTimer 的间隔后再完整加载最后到达的页面
+    const bool rapid = navigationClock.isValid() && navigationClock.elapsed() < settleTimer->interval();
+    navigationClock.start();
+    animationPlayer->stop();
+    if (panelNavigation()) {
+        requestPanelsAhead();
+    }
+    turnClock.start();
+    turnPending = !continuousMode;
+    presentPending = false;
+    if (!rapid || continuousMode) {
+        settleTimer->stop();
+        updatePageDisplay();
+        return;
+    }
+    
+    settleTimer->start();
+    onPageChanged();
+    if (spreadMode) {
+        // 跨页合成需要完整解码各页，停下后再合成
+        pagePipeline->cancel();
+        loadingTimer->stop();
+        return;
+    }
+    if (showCachedPage()) {
+        return;
+    }
+    
+    // 之前的请求（包括正在解码的中间页面）在下一个阶段开始前作废；完成前保留上一页的显示
+    originalPixmap = QPixmap();
+    originalImage = QImage();
+    pageSize = QSize();
+    loadingTimer->stop();
+    pagePipeline->requestPreview(currentPage);
+}
+
+bool ReaderWidget::showCachedPage()
+{
+    // 内存中已有该页面（及当前缩放比例的结果）时直接显示，无需经过流水线
+    QElapsedTimer timer;
+    timer.start();
+    CacheManager *cache = CacheManager::instance();
+    const QPixmap cached = cache->getCachedPixmap(pageCacheKey(currentPage));
+    const QPixmap scaled = cached.isNull() || isNativeScale(zoomFactor)
+        ? cached
+        : cache->getCachedPixmap(zoomCacheKey(currentPage, zoomSlider->value(), devicePixelRatioF()));
+    if (turnPending) {
+        pagePipeline->metrics()->record(PageTurnMetrics::CacheLookup, timer.nsecsElapsed());
+    }
+    if (scaled.isNull()) {
+        return false;
+    }
+    if (turnPending) {
+        pagePipeline->metrics()->recordSource(PageTurnMetrics::PixmapCache);
+    }
+    pagePipeline->cancel();
+    loadingTimer->stop();
+    rescaleTimer->stop();
+    originalPixmap = cached;
+    originalImage = QImage();
+    pageSize = cached.size();
+    showPixmap(scaled.cacheKey() == cached.cacheKey() ? nativeOriginal() : scaled);
+    markPresented();
+    if (panelNavigation()) {
+        showCurrentPanel();
+    } else if (autoCrop) {
+        scrollToContent();
+    }
+    return true;
+}
+
+void ReaderWidget::requestPageAnimation()
+{
+    // 只有 GIF/WebP 页面可能是动画，其他页面不必再读取数据
+    const QString suffix = QFileInfo(comicParser->getComicInfo().pageList.value(currentPage)).suffix().toLower();
+    if ((suffix != "gif" && suffix != "webp") || continuousMode || spreadMode || tiledPage) {
+        return;
+    }
+    pagePipeline->requestAnimation(pagePipeline->generation(), currentPage);
+}
+
+void ReaderWidget::onAnimationReady(int generation, int page, const QByteArray &data)
+{
+    if (!pagePipeline->isCurrent(generation) || page != currentPage || continuousMode || spreadMode
+        || tiledPage || !pageSize.isValid() || needsTiling(zoomFactor)) {
+        return;
+    }
+    // 已经显示的第一帧保留到动画的第一帧解码完成
+    animationPlayer->start(data, pageSize * (zoomFactor * devicePixelRatioF()), devicePixelRatioF());
+}
+
+void ReaderWidget::onAnimationFrame(const QImage &frame)
+{
+    if (tiledPage || continuousMode || spreadMode) {
+        return;
+    }
+    // 帧已经是显示尺寸，只替换图片，不改变滚动位置
+    currentPixmap = QPixmap::fromImage(frame);
+    imageLabel->setPixmap(currentPixmap);
+}
+
+void ReaderWidget::markPresented()
+{
+    if (turnPending && !presentPending) {
+        presentClock.start();
+        presentPending = true;
+    }
+}
+
+void ReaderWidget::updatePerformanceOverlay()
+{
+    if (!performanceOverlay->isVisible()) {
+        return;
+    }
+    
+    const PageTurnMetrics::Snapshot snapshot = pagePipeline->metrics()->snapshot();
+    auto ms = [](double micros) { return QString::number(micros / 1000.0, 'f', 1); };
+    
+    const LatencyHistogram::Snapshot &turn = snapshot.stages[PageTurnMetrics::Turn];
+    QStringList lines;
+    lines << QString("翻页   p50 %1  p95 %2  p99 %3 ms  (%4 次)")
+                 .arg(ms(turn.percentileMicros(50)), ms(turn.percentileMicros(95)), ms(turn.percentileMicros(99)))
+                 .arg(turn.count);
+    
+    static const char *const stageLabels[] = { "翻页", "查缓存", "读取", "解压", "解码", "缩放", "绘制" };
+    for (int stage = PageTurnMetrics::CacheLookup; stage < PageTurnMetrics::StageCount; ++stage) {
+        const LatencyHistogram::Snapshot &histogram = snapshot.stages[stage];
+        if (histogram.count == 0) {
+            continue;
+        }
+        lines << QString("%1 p50 %2  p95 %3  p99 %4 ms")
+                     .arg(QString::fromUtf8(stageLabels[stage]), -6)
+                     .arg(ms(histogram.percentileMicros(50)), ms(histogram.percentileMicros(95)),
+                          ms(histogram.percentileMicros(99)));
+    }
+    
+    static const char *const sourceLabels[] = { "位图", "解码图", "内存", "磁盘", "归档" };
+    const qint64 total = snapshot.sourceTotal();
+    QStringList sources;
+    for (int source = 0; source < PageTurnMetrics::SourceCount; ++source) {
+        if (snapshot.sources[source] > 0) {
+            sources << QString("%1 %2%").arg(QString::fromUtf8(sourceLabels[source]))
+                           .arg(100.0 * snapshot.sources[source] / total, 0, 'f', 0);
+        }
+    }
+    lines << "来源   " + (sources.isEmpty() ? QString("-") : sources.join("  "));
+    
+    performanceOverlay->setText(lines.join('\n'));
+    performanceOverlay->adjustSize();
+    positionPerformanceOverlay();
+}
+
+void ReaderWidget::positionPerformanceOverlay()
+{
+    const QRect area = displayStack->geometry();
+    performanceOverlay->move(area.right() - performanceOverlay->width() - 12, area.top() + 12);
+}
+
 void ReaderWidget::updatePageDisplay()
 {
+    animationPlayer->stop();
     const auto& info = comicParser->getComicInfo();
     if (currentPage >= 0 && currentPage < info.pageCount) {
-        // 显示加载提示
-        imageLabel->setText("加载中...");
-        QApplication::processEvents();
-        
-        // 加载当前页面图像
-        QPixmap pixmap = comicParser->getPagePixmap(currentPage);
-        if (!pixmap.isNull()) {
-            originalPixmap = pixmap;
-            currentPixmap = pixmap;
-            updateZoomDisplay();
-        } else {
-            imageLabel->setText(QString("无法加载页面 %1").arg(currentPage + 1));
+        if (spreadMode && !continuousMode) {
+            showSpread();
+            return;
         }
         
         onPageChanged();
+        
+        if (continuousMode) {
+            continuousView->scrollToPage(currentPage);
+            return;
+        }
+        
+        if (showCachedPage()) {
+            requestPageAnimation();
+            return;
+        }
+        
+        // 读取、解码和缩放都在工作线程进行，GUI线程不等待；完成前保留上一页的显示
+        originalPixmap = QPixmap();
+        originalImage = QImage();
+        pageSize = QSize();
+        pagePipeline->requestPage(currentPage, zoomFactor);
+        loadingTimer->start();
     }
 }
 
 void ReaderWidget::updateZoomDisplay()
 {
-    if (!originalPixmap.isNull()) {
-        if (qAbs(zoomFactor - 1.0) < 0.01) {
-            // 原始大小，直接使用原图
-            currentPixmap = originalPixmap;
+    // 快速翻页中：settleTimer 到时会按新的缩放比例完整加载当前页，这里不能提前触发解码
+    if (settleTimer->isActive()) {
+        return;
+    }
+    
+    if (!pageSize.isValid()) {
+        // 页面还在加载：按新的缩放比例重新请求
+        updatePageDisplay();
+        return;
+    }
+    
+    pagePipeline->cancel();
+    rescaleTimer->stop();
+    
+    // 动画继续播放，之后的帧按新的缩放比例解码；超大时分块绘制，不再播放
+    if (animationPlayer->isPlaying()) {
+        if (needsTiling(zoomFactor)) {
+            animationPlayer->stop();
         } else {
-            // 缩放图像
-            QSize newSize = originalPixmap.size() * zoomFactor;
-            currentPixmap = originalPixmap.scaled(
-                newSize,
-                Qt::KeepAspectRatio,
-                Qt::SmoothTransformation
-            );
+            animationPlayer->setFrameSize(pageSize * (zoomFactor * devicePixelRatioF()), devicePixelRatioF());
+        }
+    }
+    
+    if (originalPixmap.isNull() && originalImage.isNull()) {
+        // 页面是按缩小的分辨率解码的：先缩放当前显示的图片作为预览，停止拖动后按新的缩放比例重新加载
+        const QPixmap cached = CacheManager::instance()->getCachedPixmap(
+            zoomCacheKey(currentPage, zoomSlider->value(), devicePixelRatioF()));
+        if (!cached.isNull()) {
+            showPixmap(cached);
+            return;
+        }
+        if (!tiledPage && !currentPixmap.isNull() && !needsTiling(zoomFactor)) {
+            QPixmap preview = currentPixmap.scaled(pageSize * (zoomFactor * devicePixelRatioF()),
+                                                   Qt::KeepAspectRatio, Qt::FastTransformation);
+            preview.setDevicePixelRatio(devicePixelRatioF());
+            showPixmap(preview);
+        }
+        rescaleTimer->start();
+        return;
+    }
+    
+    // 超大页面（或放大后超大）分块绘制，只缩放可见区域
+    if (needsTiling(zoomFactor)) {
+        if (originalImage.isNull()) {
+            originalImage = originalPixmap.toImage();
+        }
+        showTiled(originalImage);
+        return;
+    }
+    
+    if (originalPixmap.isNull()) {
+        // 原图本身超大时没有整张的 QPixmap，needsTiling() 已经处理
+        return;
+    }
+    
+    if (isNativeScale(zoomFactor)) {
+        // 原图像素与设备像素一一对应，直接使用原图
+        showPixmap(nativeOriginal());
+        return;
+    }
+    
+    // 最近用过的缩放比例直接使用缓存（按设备像素比区分）
+    const QPixmap cached = CacheManager::instance()->getCachedPixmap(
+        zoomCacheKey(currentPage, zoomSlider->value(), devicePixelRatioF()));
+    if (!cached.isNull()) {
+        showPixmap(cached);
+        return;
+    }
+    
+    // 先用最近邻缩放立即给出预览，停止拖动后在工作线程做高质量缩放再替换
+    // 当前显示的图片足够大时从它缩放，避免每次都读取整张原图
+    const QSize newSize = originalPixmap.size() * (zoomFactor * devicePixelRatioF());
+    const QPixmap &source = (!tiledPage && currentPixmap.width() >= newSize.width()
+                             && currentPixmap.height() >= newSize.height())
+                            ? currentPixmap : originalPixmap;
+    QPixmap preview = source.scaled(newSize, Qt::KeepAspectRatio, Qt::FastTransformation);
+    preview.setDevicePixelRatio(devicePixelRatioF());
+    showPixmap(preview);
+    rescaleTimer->start();
+}
+
+void ReaderWidget::startSmoothRescale()
+{
+    if (spreadMode) {
+        spreadPages.clear();
+        updatePageDisplay();
+        return;
+    }
+    if (pageSize.isValid() && originalPixmap.isNull() && originalImage.isNull()) {
+        // 没有原图：按新的缩放比例重新解码（放大到需要时才解码完整分辨率）
+        updatePageDisplay();
+        return;
+    }
+    if (originalPixmap.isNull() || tiledPage || isNativeScale(zoomFactor)) {
+        return;
+    }
+    if (originalImage.isNull()) {
+        originalImage = originalPixmap.toImage();
+    }
+    pagePipeline->requestScale(currentPage, originalImage, zoomFactor);
+}
+
+void ReaderWidget::onPageReady(int generation, int page, qreal zoom, const QSize &size,
+                               const QImage &original, const QImage &display)
+{
+    if (!pagePipeline->isCurrent(generation) || page != currentPage) {
+        return;
+    }
+    loadingTimer->stop();
+    
+    // 只重新缩放时原图不变，不必再转换
+    const bool newPage = !pageSize.isValid();
+    if (newPage) {
+        originalImage = original;
+        pageSize = size;
+        spreadLayout.setPageSize(page, pageSize);
+        // 超大原图不转换成整张 QPixmap，也不放入内存缓存
+        if (!original.isNull() && !PagePipeline::isLargeImage(pageSize)) {
+            originalPixmap = QPixmap::fromImage(original);
+            CacheManager::instance()->cachePixmap(pageCacheKey(page), originalPixmap);
+        }
+    }
+    
+    if (display.isNull()) {
+        showTiled(original);
+    } else if (!original.isNull() && display.cacheKey() == original.cacheKey() && !originalPixmap.isNull()) {
+        showPixmap(originalPixmap);
+    } else {
+        const QPixmap scaled = QPixmap::fromImage(display);
+        CacheManager::instance()->cachePixmap(
+            zoomCacheKey(page, qRound(zoom * 100), display.devicePixelRatio()), scaled);
+        showPixmap(scaled);
+    }
+    markPresented();
+    
+    if (newPage) {
+        prescaleFitTargets();
+        requestPageAnimation();
+        if (panelNavigation()) {
+            showCurrentPanel();
+        } else if (autoCrop) {
+            scrollToContent();
         }
-        
-        imageLabel->setPixmap(currentPixmap);
-        imageLabel->resize(currentPixmap.size());
     }
 }
+
+void ReaderWidget::onPreviewReady(int generation, int page, const QSize &size, const QImage &preview)
+{
+    if (!pagePipeline->isCurrent(generation) || page != currentPage) {
+        return;
+    }
+    
+    // 预览只是占位：快速放大到显示尺寸，不记录页面尺寸，停下后仍完整加载
+    const QSize displaySize = size * (zoomFactor * devicePixelRatioF());
+    if (displaySize.isEmpty() || PagePipeline::isLargeImage(displaySize)) {
+        return;
+    }
+    QPixmap pixmap = QPixmap::fromImage(preview.scaled(displaySize, Qt::IgnoreAspectRatio, Qt::FastTransformation));
+    pixmap.setDevicePixelRatio(devicePixelRatioF());
+    showPixmap(pixmap);
+}
+
+void ReaderWidget::onScalePrepared(int page, qreal zoom, const QImage &display)
+{
+    CacheManager::instance()->cachePixmap(zoomCacheKey(page, qRound(zoom * 100), display.devicePixelRatio()),
+                                          QPixmap::fromImage(display));
+}
+
+void ReaderWidget::showSpread()
+{
+    // 总是从跨页的第一页开始显示
+    const int spread = spreadLayout.spreadOf(currentPage);
+    const QVector<int> pages = spreadLayout.pages(spread);
+    if (pages.isEmpty()) {
+        return;
+    }
+    currentPage = pages.first();
+    onPageChanged();
+    
+    const QSize bounds = scrollArea->viewport()->size();
+    QElapsedTimer timer;
+    timer.start();
+    const QPixmap cached = CacheManager::instance()->getCachedPixmap(
+        spreadCacheKey(pages, bounds, rightToLeft, devicePixelRatioF()));
+    if (turnPending) {
+        pagePipeline->metrics()->record(PageTurnMetrics::CacheLookup, timer.nsecsElapsed());
+    }
+    if (!cached.isNull()) {
+        // 预先合成好的跨页直接显示
+        pagePipeline->cancel();
+        loadingTimer->stop();
+        spreadPages = pages;
+        if (turnPending) {
+            pagePipeline->metrics()->recordSource(PageTurnMetrics::PixmapCache);
+        }
+        showPixmap(cached);
+        markPresented();
+    } else if (pages != spreadPages) {
+        // 合成完成前保留上一个跨页的显示
+        spreadPages = pages;
+        pagePipeline->requestSpread(pages, bounds, rightToLeft);
+        loadingTimer->start();
+    }
+    prepareSpreadsAhead(spread, bounds);
+}
+
+void ReaderWidget::prepareSpreadsAhead(int spread, const QSize &bounds)
+{
+    CacheManager *cache = CacheManager::instance();
+    const int count = qMax(1, ConfigManager::instance()->getPreloadCount());
+    for (int i = 1; i <= count; ++i) {
+        const QVector<int> pages = spreadLayout.pages(spread + i);
+        if (pages.isEmpty()) {
+            break;
+        }
+        const QString key = spreadCacheKey(pages, bounds, rightToLeft, devicePixelRatioF()).toString();
+        if (preparingSpreads.contains(key) || cache->hasPixmap(key)) {
+            continue;
+        }
+        preparingSpreads.insert(key);
+        pagePipeline->prepareSpread(pages, bounds, rightToLeft);
+    }
+}
+
+void ReaderWidget::onSpreadReady(int generation, const QVector<int> &pages, const QImage &spread)
+{
+    if (!pagePipeline->isCurrent(generation) || pages != spreadPages) {
+        return;
+    }
+    loadingTimer->stop();
+    const QPixmap pixmap = QPixmap::fromImage(spread);
+    CacheManager::instance()->cachePixmap(
+        spreadCacheKey(pages, scrollArea->viewport()->size(), rightToLeft, spread.devicePixelRatio()), pixmap);
+    showPixmap(pixmap);
+    markPresented();
+}
+
+void ReaderWidget::onSpreadPrepared(const QVector<int> &pages, const QSize &bounds, bool rightToLeft,
+                                    const QImage &spread)
+{
+    const CacheKey key = spreadCacheKey(pages, bounds, rightToLeft, spread.devicePixelRatio());
+    preparingSpreads.remove(key.toString());
+    CacheManager::instance()->cachePixmap(key, QPixmap::fromImage(spread));
+}
+
+void ReaderWidget::onPageSizeProbed(int page, const QSize &size)
+{
+    // 宽页面改变了跨页划分：当前跨页不同时重新显示
+    if (!spreadLayout.setPageSize(page, size) || !spreadMode || continuousMode || spreadPages.isEmpty()) {
+        return;
+    }
+    if (spreadLayout.pages(spreadLayout.spreadOf(currentPage)) != spreadPages) {
+        updatePageDisplay();
+    }
+}
+
+void ReaderWidget::onContentBoundsDetected(int page, const QSize &size, const QRect &bounds)
+{
+    // 各页的尺寸也同时得到，双页模式的划分不必再读取
+    contentBounds.insert(page, bounds);
+    onPageSizeProbed(page, size);
+}
+
+void ReaderWidget::prescaleFitTargets()
+{
+    // 在后台预先生成适应宽度/高度的缩放结果，点击按钮时直接从缓存显示
+    if (originalImage.isNull() || PagePipeline::isLargeImage(pageSize)) {
+        return;
+    }
+    CacheManager *cache = CacheManager::instance();
+    for (Qt::Orientation orientation : {Qt::Horizontal, Qt::Vertical}) {
+        const int value = fitZoomValue(orientation);
+        if (value <= 0 || isNativeScale(value / 100.0) || value == zoomSlider->value() || needsTiling(value / 100.0)
+            || cache->hasPixmap(zoomCacheKey(currentPage, value, devicePixelRatioF()).toString())) {
+            continue;
+        }
+        pagePipeline->prescale(currentPage, originalImage, value / 100.0);
+    }
+}
+
+void ReaderWidget::onPageFailed(int generation, int page)
+{
+    if (!pagePipeline->isCurrent(generation)) {
+        return;
+    }
+    loadingTimer->stop();
+    turnPending = false;
+    showMessage(QString("无法加载页面 %1").arg(page + 1));
+}
+
+CacheKey ReaderWidget::pageCacheKey(int page) const
+{
+    const auto& info = comicParser->getComicInfo();
+    return CacheKey(info.filePath, archiveFingerprint, page, CacheWarmup::pageVariant());
+}
+
+CacheKey ReaderWidget::zoomCacheKey(int page, int zoomPercent, qreal ratio) const
+{
+    // 缩放结果是设备像素的图片，不同设备像素比的结果不能互相代替
+    const auto& info = comicParser->getComicInfo();
+    return CacheKey(info.filePath, archiveFingerprint, page, QString("zoom:%1@%2x").arg(zoomPercent).arg(ratio));
+}
+
+CacheKey ReaderWidget::spreadCacheKey(const QVector<int> &pages, const QSize &bounds, bool rightToLeft,
+                                      qreal ratio) const
+{
+    // 以合成结果的设备像素尺寸为键
+    const auto& info = comicParser->getComicInfo();
+    const QSize size = bounds * ratio;
+    return CacheKey(info.filePath, archiveFingerprint, pages.value(0),
+                    QString("spread:%1:%2x%3:%4").arg(pages.size()).arg(size.width()).arg(size.height())
+                    .arg(rightToLeft ? "rtl" : "ltr"));
+}
+
+void ReaderWidget::showPixmap(const QPixmap &pixmap)
+{
+    if (tiledPage) {
+        tiledPage = false;
+        pageView->clear();
+    }
+    currentPixmap = pixmap;
+    imageLabel->setPixmap(currentPixmap);
+    imageLabel->resize((QSizeF(currentPixmap.size()) / currentPixmap.devicePixelRatio()).toSize());
+    displayStack->setCurrentWidget(scrollArea);
+}
+
+void ReaderWidget::showTiled(const QImage &image)
+{
+    animationPlayer->stop();
+    // 分块视图只引用原图（通常是映射内存），不另外保存整张缩放图
+    if (!tiledPage || pageView->image().cacheKey() != image.cacheKey()) {
+        pageView->setImage(image, pagePipeline->pyramidFor(image));
+    }
+    pageView->setZoom(zoomFactor);
+    tiledPage = true;
+    currentPixmap = QPixmap();
+    imageLabel->clear();
+    displayStack->setCurrentWidget(pageView);
+}
+
+void ReaderWidget::showMessage(const QString &text)
+{
+    imageLabel->setText(text);
+    displayStack->setCurrentWidget(scrollArea);
+}
+
+bool ReaderWidget::needsTiling(qreal zoom) const
+{
+    return pageSize.isValid()
+        && (PagePipeline::isLargeImage(pageSize)
+            || PagePipeline::isLargeImage(pageSize * (zoom * devicePixelRatioF())));
+}
+
+bool ReaderWidget::isNativeScale(qreal zoom) const
+{
+    // 原图的一个像素正好对应一个设备像素
+    return qAbs(zoom * devicePixelRatioF() - 1.0) < 0.01;
+}
+
+QPixmap ReaderWidget::nativeOriginal() const
+{
+    // 原图按设备像素比标记后显示，Qt 绘制时不再缩放
+    if (qFuzzyCompare(originalPixmap.devicePixelRatio(), devicePixelRatioF())) {
+        return originalPixmap;
+    }
+    QPixmap pixmap = originalPixmap;
+    pixmap.setDevicePixelRatio(devicePixelRatioF());
+    return pixmap;
+}
+
+QSize ReaderWidget::viewportSize() const
+{
+    return tiledPage ? pageView->viewport()->size() : scrollArea->viewport()->size();
+}
@@ -0,0 +1,74 @@
+#include "ui/reader/SpreadLayout.h"
+
+SpreadLayout::SpreadLayout()
+{
+}
+
+void SpreadLayout::reset(int pageCount)
+{
+    m_sizes = QVector<QSize>(qMax(0, pageCount));
+    rebuild();
+}
+
+bool SpreadLayout::setPageSize(int page, const QSize &size)
+{
+    if (page < 0 || page >= m_sizes.size() || m_sizes[page] == size) {
+        return false;
+    }
+    const bool wasWide = isWidePage(m_sizes[page]);
+    m_sizes[page] = size;
+    if (isWidePage(size) == wasWide) {
+        return false;
+    }
+    rebuild();
+    return true;
+}
+
+int SpreadLayout::spreadOf(int page) const
+{
+    if (m_pageSpreads.isEmpty()) {
+        return -1;
+    }
+    return m_pageSpreads.at(qBound(0, page, m_pageSpreads.size() - 1));
+}
+
+QVector<int> SpreadLayout::pages(int spread) const
+{
+    QVector<int> result;
+    if (spread < 0 || spread >= m_spreadStarts.size()) {
+        return result;
+    }
+    const int end = spread + 1 < m_spreadStarts.size() ? m_spreadStarts.at(spread + 1) : m_sizes.size();
+    for (int page = m_spreadStarts.at(spread); page < end; ++page) {
+        result.append(page);
+    }
+    return result;
+}
+
+bool SpreadLayout::isWidePage(const QSize &size)
+{
+    return size.isValid() && size.width() > size.height();
+}
+
+void SpreadLayout::rebuild()
+{
+    m_spreadStarts.clear();
+    m_pageSpreads.resize(m_sizes.size());
+
+    int page = 0;
+    while (page < m_sizes.size()) {
+        const int spread = m_spreadStarts.size();
+        m_spreadStarts.append(page);
+        m_pageSpreads[page] = spread;
+
+        // 封面、宽页面、最后一页以及后面紧跟宽页面的页面单独显示
+        const bool single = page == 0 || page + 1 >= m_sizes.size()
+                            || isWidePage(m_sizes.at(page)) || isWidePage(m_sizes.at(page + 1));
+        if (!single) {
+            m_pageSpreads[page + 1] = spread;
+            page += 2;
+        } else {
+            page += 1;
+        }
+    }
+}
@@ -0,0 +1,368 @@
+#include "ui/reader/TiledPageView.h"
+#include "core/image/ImagePyramid.h"
+#include <QPainter>
+#include <QPaintEvent>
+#include <QResizeEvent>
+#include <QScrollBar>
+#include <QThread>
+#include <QtMath>
+#include <cmath>
+
+namespace {
+
+// 预览图的最大像素数，只用于分块绘制完成前的占位
+const qint64 PREVIEW_PIXELS = 1024 * 1024;
+
+// 空闲缓冲区最多保留的数量
+const int MAX_FREE_BUFFERS = 16;
+
+} // namespace
+
+TiledPageView::TiledPageView(QWidget *parent)
+    : QAbstractScrollArea(parent)
+    , m_zoom(1.0)
+    , m_devicePixelRatio(1.0)
+    , m_imageSerial(0)
+    , m_generation(0)
+{
+    viewport()->setAutoFillBackground(false);
+    horizontalScrollBar()->setSingleStep(20);
+    verticalScrollBar()->setSingleStep(20);
+    m_renderPool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() / 2));
+}
+
+TiledPageView::~TiledPageView()
+{
+    m_generation.fetchAndAddOrdered(1);
+    m_renderPool.clear();
+    m_renderPool.waitForDone();
+}
+
+void TiledPageView::setImage(const QImage &image, const QSharedPointer<ImagePyramid> &pyramid)
+{
+    m_image = image;
+    m_pyramid = pyramid;
+    if (!m_pyramid && !m_image.isNull()) {
+        m_pyramid = QSharedPointer<ImagePyramid>::create(m_image);
+    }
+    m_preview = QImage();
+    ++m_imageSerial;
+    m_scaledSize = m_image.size() * m_zoom;
+    invalidateTiles();
+    updateScrollBars();
+    horizontalScrollBar()->setValue(0);
+    verticalScrollBar()->setValue(0);
+    buildPreview();
+    viewport()->update();
+}
+
+void TiledPageView::setZoom(qreal zoom)
+{
+    if (qFuzzyCompare(zoom, m_zoom)) {
+        return;
+    }
+
+    // 保持视口中心对应的图片位置不变
+    const QRect visible = visibleContentRect();
+    const QPointF center = visible.isValid() ? QPointF(visible.center()) / m_zoom : QPointF();
+
+    m_zoom = zoom;
+    m_scaledSize = m_image.size() * m_zoom;
+    invalidateTiles();
+    updateScrollBars();
+    if (visible.isValid()) {
+        horizontalScrollBar()->setValue(qRound(center.x() * m_zoom - viewport()->width() / 2.0));
+        verticalScrollBar()->setValue(qRound(center.y() * m_zoom - viewport()->height() / 2.0));
+    }
+    viewport()->update();
+}
+
+void TiledPageView::clear()
+{
+    setImage(QImage());
+}
+
+int TiledPageView::tileCapacity() const
+{
+    // 视口加上四周各一个分块的边距，再留一倍余量给来回滚动
+    const int columns = (viewport()->width() + TILE_SIZE - 1) / TILE_SIZE + 3;
+    const int rows = (viewport()->height() + TILE_SIZE - 1) / TILE_SIZE + 3;
+    return columns * rows * 2;
+}
+
+void TiledPageView::paintEvent(QPaintEvent *event)
+{
+    updateDevicePixelRatio();
+    QPainter painter(viewport());
+    painter.fillRect(event->rect(), Qt::white);
+    if (m_image.isNull() || m_scaledSize.isEmpty()) {
+        return;
+    }
+
+    const QPoint offset = contentOffset();
+    const QRect visible = visibleContentRect();
+    const QRect dirty = event->rect().translated(-offset) & QRect(QPoint(0, 0), m_scaledSize);
+    if (dirty.isEmpty()) {
+        return;
+    }
+
+    const int firstColumn = dirty.left() / TILE_SIZE;
+    const int lastColumn = dirty.right() / TILE_SIZE;
+    const int firstRow = dirty.top() / TILE_SIZE;
+    const int lastRow = dirty.bottom() / TILE_SIZE;
+    const qreal previewScale = m_preview.isNull() ? 0 : qreal(m_preview.width()) / m_image.width();
+
+    for (int row = firstRow; row <= lastRow; ++row) {
+        for (int column = firstColumn; column <= lastColumn; ++column) {
+            const QRect tileRect = QRect(column * TILE_SIZE, row * TILE_SIZE, TILE_SIZE, TILE_SIZE)
+                                   & QRect(QPoint(0, 0), m_scaledSize);
+            const QRect target = tileRect.translated(offset);
+
+            auto it = m_tiles.find(tileKey(column, row));
+            if (it != m_tiles.end()) {
+                touchTile(it.value());
+                painter.drawImage(QRectF(target), it->image,
+                                  QRectF(QPointF(0, 0), QSizeF(tileRect.size()) * m_devicePixelRatio));
+            } else if (previewScale > 0) {
+                // 分块还没有绘制好，先显示预览图的对应区域
+                const QRectF source(tileRect.x() / m_zoom * previewScale, tileRect.y() / m_zoom * previewScale,
+                                    tileRect.width() / m_zoom * previewScale,
+                                    tileRect.height() / m_zoom * previewScale);
+                painter.drawImage(QRectF(target), m_preview, source);
+            }
+        }
+    }
+
+    requestTiles(visible);
+}
+
+void TiledPageView::resizeEvent(QResizeEvent *event)
+{
+    QAbstractScrollArea::resizeEvent(event);
+    updateScrollBars();
+    trimCache();
+}
+
+void TiledPageView::scrollContentsBy(int dx, int dy)
+{
+    Q_UNUSED(dx);
+    Q_UNUSED(dy);
+    // 滚走的分块不再需要，排队中尚未开始的请求直接丢弃
+    m_renderPool.clear();
+    m_pending.clear();
+    if (m_preview.isNull()) {
+        buildPreview();     // 预览任务可能也被丢弃了
+    }
+    viewport()->update();
+}
+
+quint64 TiledPageView::tileKey(int column, int row)
+{
+    return (quint64(quint32(row)) << 32) | quint32(column);
+}
+
+QImage TiledPageView::renderTile(ImagePyramid *pyramid, qreal zoom, qreal ratio, const QRect &tileRect,
+                                 QImage buffer)
+{
+    if (buffer.size() != tileBufferSize(ratio) || buffer.format() != QImage::Format_ARGB32_Premultiplied) {
+        buffer = QImage(tileBufferSize(ratio), QImage::Format_ARGB32_Premultiplied);
+    }
+    buffer.setDevicePixelRatio(ratio);
+    buffer.fill(Qt::white);
+
+    // 缩小时使用金字塔中不小于设备像素尺寸的最小一层（第一次用到时在这里生成）
+    const QImage source = pyramid->level(ImagePyramid::levelFor(zoom * ratio));
+
+    // 变换后绘制，光栅引擎只处理落在分块内的像素，只读取原图对应的区域；
+    // 缓冲区标记了设备像素比，绘制时自动换算成设备像素
+    QPainter painter(&buffer);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform, !qFuzzyCompare(zoom * ratio, 1.0));
+    painter.translate(-tileRect.x(), -tileRect.y());
+    painter.scale(zoom, zoom);
+    painter.drawImage(QRectF(QPointF(0, 0), QSizeF(pyramid->size())), source);
+    painter.end();
+    return buffer;
+}
+
+QPoint TiledPageView::contentOffset() const
+{
+    // 图片小于视口时居中显示
+    const int x = m_scaledSize.width() < viewport()->width()
+        ? (viewport()->width() - m_scaledSize.width()) / 2 : -horizontalScrollBar()->value();
+    const int y = m_scaledSize.height() < viewport()->height()
+        ? (viewport()->height() - m_scaledSize.height()) / 2 : -verticalScrollBar()->value();
+    return QPoint(x, y);
+}
+
+QRect TiledPageView::visibleContentRect() const
+{
+    return QRect(-contentOffset(), viewport()->size()) & QRect(QPoint(0, 0), m_scaledSize);
+}
+
+void TiledPageView::updateScrollBars()
+{
+    const QSize viewportSize = viewport()->size();
+    horizontalScrollBar()->setRange(0, qMax(0, m_scaledSize.width() - viewportSize.width()));
+    horizontalScrollBar()->setPageStep(viewportSize.width());
+    verticalScrollBar()->setRange(0, qMax(0, m_scaledSize.height() - viewportSize.height()));
+    verticalScrollBar()->setPageStep(viewportSize.height());
+}
+
+void TiledPageView::requestTiles(const QRect &visible)
+{
+    if (visible.isEmpty()) {
+        return;
+    }
+
+    // 可见分块优先，其次是四周一圈边距
+    const QRect bounds(QPoint(0, 0), m_scaledSize);
+    const QRect margin = visible.adjusted(-TILE_SIZE, -TILE_SIZE, TILE_SIZE, TILE_SIZE) & bounds;
+    const int generation = m_generation.loadAcquire();
+
+    for (int pass = 0; pass < 2; ++pass) {
+        const QRect area = pass == 0 ? visible : margin;
+        for (int row = area.top() / TILE_SIZE; row <= area.bottom() / TILE_SIZE; ++row) {
+            for (int column = area.left() / TILE_SIZE; column <= area.right() / TILE_SIZE; ++column) {
+                const quint64 key = tileKey(column, row);
+                if (m_tiles.contains(key) || m_pending.contains(key)) {
+                    continue;
+                }
+                m_pending.insert(key);
+
+                const QRect tileRect(column * TILE_SIZE, row * TILE_SIZE, TILE_SIZE, TILE_SIZE);
+                const QSharedPointer<ImagePyramid> pyramid = m_pyramid;
+                const qreal zoom = m_zoom;
+                const qreal ratio = m_devicePixelRatio;
+                QImage buffer = takeBuffer();
+                m_renderPool.start([this, generation, key, pyramid, zoom, ratio, tileRect, buffer]() mutable {
+                    if (generation != m_generation.loadAcquire()) {
+                        return;
+                    }
+                    // 缓冲区只由本任务持有，绘制时不会发生拷贝
+                    const QImage tile = renderTile(pyramid.data(), zoom, ratio, tileRect, std::move(buffer));
+                    QMetaObject::invokeMethod(this, [this, generation, key, tile]() {
+                        onTileRendered(generation, key, tile);
+                    }, Qt::QueuedConnection);
+                }, pass == 0 ? 1 : 0);
+            }
+        }
+    }
+}
+
+void TiledPageView::onTileRendered(int generation, quint64 key, const QImage &tile)
+{
+    if (generation != m_generation.loadAcquire()) {
+        recycleBuffer(tile);
+        return;
+    }
+    m_pending.remove(key);
+    insertTile(key, tile);
+
+    const int column = int(key & 0xffffffff);
+    const int row = int(key >> 32);
+    viewport()->update(QRect(column * TILE_SIZE, row * TILE_SIZE, TILE_SIZE, TILE_SIZE)
+                       .translated(contentOffset()));
+}
+
+void TiledPageView::insertTile(quint64 key, const QImage &image)
+{
+    auto it = m_tiles.find(key);
+    if (it != m_tiles.end()) {
+        recycleBuffer(it->image);
+        it->image = image;
+        touchTile(it.value());
+        return;
+    }
+
+    m_lru.push_front(key);
+    Tile tile;
+    tile.image = image;
+    tile.order = m_lru.begin();
+    m_tiles.insert(key, tile);
+    trimCache();
+}
+
+void TiledPageView::touchTile(Tile &tile)
+{
+    m_lru.splice(m_lru.begin(), m_lru, tile.order);
+}
+
+void TiledPageView::trimCache()
+{
+    const int capacity = tileCapacity();
+    while (m_tiles.size() > capacity && !m_lru.empty()) {
+        const quint64 key = m_lru.back();
+        m_lru.pop_back();
+        auto it = m_tiles.find(key);
+        if (it != m_tiles.end()) {
+            recycleBuffer(it->image);
+            m_tiles.erase(it);
+        }
+    }
+}
+
+void TiledPageView::invalidateTiles()
+{
+    m_generation.fetchAndAddOrdered(1);
+    m_renderPool.clear();
+    m_pending.clear();
+    for (auto it = m_tiles.begin(); it != m_tiles.end(); ++it) {
+        recycleBuffer(it->image);
+    }
+    m_tiles.clear();
+    m_lru.clear();
+}
+
+void TiledPageView::recycleBuffer(const QImage &buffer)
+{
+    if (m_freeBuffers.size() < MAX_FREE_BUFFERS && buffer.size() == tileBufferSize(m_devicePixelRatio)) {
+        m_freeBuffers.append(buffer);
+    }
+}
+
+QSize TiledPageView::tileBufferSize(qreal ratio)
+{
+    const int size = qCeil(TILE_SIZE * ratio);
+    return QSize(size, size);
+}
+
+void TiledPageView::updateDevicePixelRatio()
+{
+    // 分块缓存按设备分辨率区分：窗口移到另一块显示器后重新绘制
+    const qreal ratio = devicePixelRatioF();
+    if (qFuzzyCompare(ratio, m_devicePixelRatio)) {
+        return;
+    }
+    m_devicePixelRatio = ratio;
+    invalidateTiles();
+    m_freeBuffers.clear();
+}
+
+QImage TiledPageView::takeBuffer()
+{
+    return m_freeBuffers.isEmpty() ? QImage() : m_freeBuffers.takeLast();
+}
+
+void TiledPageView::buildPreview()
+{
+    if (m_image.isNull()) {
+        return;
+    }
+
+    const qint64 pixels = qint64(m_image.width()) * m_image.height();
+    const qreal scale = pixels > PREVIEW_PIXELS ? std::sqrt(qreal(PREVIEW_PIXELS) / pixels) : 1.0;
+    const QSize previewSize = (QSizeF(m_image.size()) * scale).toSize().expandedTo(QSize(1, 1));
+    // 金字塔中已经有较小的层时从它取样，不必再访问整张原图
+    const QImage source = m_pyramid->builtLevel(scale);
+    const int serial = m_imageSerial;
+
+    m_renderPool.start([this, source, previewSize, serial]() {
+        const QImage preview = source.scaled(previewSize, Qt::IgnoreAspectRatio, Qt::FastTransformation);
+        QMetaObject::invokeMethod(this, [this, preview, serial]() {
+            if (serial == m_imageSerial) {
+                m_preview = preview;
+                viewport()->update();
+            }
+        }, Qt::QueuedConnection);
+    }, 2);
+}
@@ -1,6 +1,6 @@
 #include "../../../include/ui/settings/SettingsDialog.h"
 #include "../../../include/core/ConfigManager.h"
-#include "../../../include/core/cache/CacheManager.h"
+#include "../../../include/core/CacheManager.h"
 #include "../../../include/network/DownloadManager.h"
 #include <QApplication>
 #include <QStandardPaths>
@@ -15,6 +15,51 @@
 #include <QPalette>
 #include <QDebug>
 
+namespace {
+
+// 缓存统计表的行
+enum CacheStatisticsRow {
+    StatEntries,
+    StatSize,
+    StatHits,
+    StatMisses,
+    StatHitRatio,
+    StatInsertions,
+    StatEvictions,
+    StatUnusedEvictions,
+    StatBytesIn,
+    StatBytesOut,
+    StatReadLatency,
+    StatWriteLatency,
+    StatRowCount
+};
+
+QString formatBytes(qint64 bytes)
+{
+    if (bytes >= 1024 * 1024 * 1024) {
+        return QString("%1 GB").arg(bytes / (1024.0 * 1024.0 * 1024.0), 0, 'f', 2);
+    }
+    if (bytes >= 1024 * 1024) {
+        return QString("%1 MB").arg(bytes / (1024.0 * 1024.0), 0, 'f', 1);
+    }
+    if (bytes >= 1024) {
+        return QString("%1 KB").arg(bytes / 1024.0, 0, 'f', 1);
+    }
+    return QString("%1 B").arg(bytes);
+}
+
+QString formatLatency(const LatencyHistogram::Snapshot &latency)
+{
+    if (latency.count == 0) {
+        return "-";
+    }
+    return QString("p50 %1 ms / p99 %2 ms")
+        .arg(latency.percentileMicros(50) / 1000.0, 0, 'f', 2)
+        .arg(latency.percentileMicros(99) / 1000.0, 0, 'f', 2);
+}
+
+} // namespace
+
 SettingsDialog::SettingsDialog(QWidget *parent)
     : QDialog(parent)
     , m_mainLayout(nullptr)
@@ -24,6 +69,8 @@ SettingsDialog::SettingsDialog(QWidget *parent)
     , m_cancelButton(nullptr)
     , m_applyButton(nullptr)
     , m_resetButton(nullptr)
+    , m_cacheUsageLabel(nullptr)
+    , m_cacheStatisticsTree(nullptr)
     , m_configManager(ConfigManager::instance())
     , m_hasUnsavedChanges(false)
     , m_primaryColor(Qt::blue)
@@ -32,6 +79,9 @@ SettingsDialog::SettingsDialog(QWidget *parent)
     , m_customBackgroundColor(Qt::white)
     , m_colorButtonGroup(nullptr)
 {
+    m_cacheStatisticsTimer = new QTimer(this);
+    m_cacheStatisticsTimer->setInterval(1000);
+
     setWindowTitle("设置");
     setWindowIcon(QIcon(":/icons/toolbar/settings"));
     setModal(true);
@@ -377,6 +427,10 @@ void SettingsDialog::setupCachePage()
     m_memoryCacheSizeSpinBox->setToolTip("用于缓存图片的内存大小");
     memoryCacheLayout->addRow("内存缓存大小:", m_memoryCacheSizeSpinBox);
     
+    m_adaptMemoryPressureCheckBox = new QCheckBox("内存紧张时自动缩减缓存");
+    m_adaptMemoryPressureCheckBox->setToolTip("根据系统和cgroup的可用内存及内存压力（PSI）逐步缩减缓存，先释放解码后的图片");
+    memoryCacheLayout->addRow("", m_adaptMemoryPressureCheckBox);
+    
     layout->addWidget(memoryCacheGroup);
     
     // 磁盘缓存设置组
@@ -406,6 +460,11 @@ void SettingsDialog::setupCachePage()
     cacheDirLayout->addWidget(m_browseCacheDirectoryButton);
     diskFormLayout->addRow("缓存目录:", cacheDirLayout);
     
+    m_compressDiskCacheCheckBox = new QCheckBox("压缩解码页面和元数据");
+    m_compressDiskCacheCheckBox->setToolTip("JPEG/WebP 等已压缩的图片原样存储，解码后的像素和元数据使用快速压缩");
+    m_compressDiskCacheCheckBox->setEnabled(false);
+    diskFormLayout->addRow("", m_compressDiskCacheCheckBox);
+    
     diskCacheLayout->addLayout(diskFormLayout);
     layout->addWidget(diskCacheGroup);
     
@@ -442,6 +501,38 @@ void SettingsDialog::setupCachePage()
     
     layout->addWidget(statusGroup);
     
+    // 缓存统计（打开缓存页面时每秒刷新）
+    QGroupBox *statisticsGroup = new QGroupBox("缓存统计");
+    QVBoxLayout *statisticsLayout = new QVBoxLayout(statisticsGroup);
+    
+    m_cacheStatisticsTree = new QTreeWidget();
+    m_cacheStatisticsTree->setColumnCount(3);
+    m_cacheStatisticsTree->setHeaderLabels(QStringList() << "指标" << "内存" << "磁盘");
+    m_cacheStatisticsTree->setRootIsDecorated(false);
+    m_cacheStatisticsTree->setSelectionMode(QAbstractItemView::NoSelection);
+    
+    const QStringList rowNames = QStringList()
+        << "条目数" << "占用" << "命中" << "未命中" << "命中率" << "插入" << "淘汰"
+        << "未命中即淘汰" << "写入字节" << "读出字节" << "读取延迟" << "写入延迟";
+    for (int row = 0; row < StatRowCount; ++row) {
+        QTreeWidgetItem *item = new QTreeWidgetItem(m_cacheStatisticsTree);
+        item->setText(0, rowNames.value(row));
+    }
+    m_cacheStatisticsTree->topLevelItem(StatUnusedEvictions)->setToolTip(0, "插入后一次也没有被使用就被淘汰的条目，数值偏高说明预加载过多或缓存过小");
+    m_cacheStatisticsTree->resizeColumnToContents(0);
+    statisticsLayout->addWidget(m_cacheStatisticsTree);
+    
+    QHBoxLayout *statisticsButtonLayout = new QHBoxLayout();
+    m_exportCacheStatisticsButton = new QPushButton("导出统计");
+    m_exportCacheStatisticsButton->setToolTip("将缓存统计导出为JSON文件");
+    m_resetCacheStatisticsButton = new QPushButton("重置统计");
+    statisticsButtonLayout->addStretch();
+    statisticsButtonLayout->addWidget(m_exportCacheStatisticsButton);
+    statisticsButtonLayout->addWidget(m_resetCacheStatisticsButton);
+    statisticsLayout->addLayout(statisticsButtonLayout);
+    
+    layout->addWidget(statisticsGroup);
+    
     layout->addStretch();
     
     m_tabWidget->addTab(m_cachePage, "缓存");
@@ -829,12 +920,15 @@ void SettingsDialog::connectSignals()
     
     // 缓存页面信号
     connect(m_memoryCacheSizeSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), this, &SettingsDialog::onSettingChanged);
+    connect(m_adaptMemoryPressureCheckBox, &QCheckBox::toggled, this, &SettingsDialog::onSettingChanged);
     connect(m_enableDiskCacheCheckBox, &QCheckBox::toggled, [this](bool enabled) {
         m_diskCacheSizeSpinBox->setEnabled(enabled);
         m_cacheDirectoryLineEdit->setEnabled(enabled);
         m_browseCacheDirectoryButton->setEnabled(enabled);
+        m_compressDiskCacheCheckBox->setEnabled(enabled);
         onSettingChanged();
     });
+    connect(m_compressDiskCacheCheckBox, &QCheckBox::toggled, this, &SettingsDialog::onSettingChanged);
     connect(m_diskCacheSizeSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), this, &SettingsDialog::onSettingChanged);
     connect(m_browseCacheDirectoryButton, &QPushButton::clicked, this, &SettingsDialog::onBrowseClicked);
     connect(m_cacheCleanupIntervalSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), this, &SettingsDialog::onSettingChanged);
@@ -848,6 +942,12 @@ void SettingsDialog::connectSignals()
             updateCacheUsage();
         }
     });
+    connect(m_exportCacheStatisticsButton, &QPushButton::clicked, this, &SettingsDialog::onExportCacheStatisticsClicked);
+    connect(m_resetCacheStatisticsButton, &QPushButton::clicked, [this]() {
+        CacheManager::instance()->resetStatistics();
+        updateCacheStatistics();
+    });
+    connect(m_cacheStatisticsTimer, &QTimer::timeout, this, &SettingsDialog::updateCacheStatistics);
     
     // 网络页面信号
     connect(m_useProxyCheckBox, &QCheckBox::toggled, [this](bool enabled) {
@@ -993,9 +1093,11 @@ void SettingsDialog::resetToDefaults()
     
     // 缓存设置默认值
     m_memoryCacheSizeSpinBox->setValue(100);
+    m_adaptMemoryPressureCheckBox->setChecked(true);
     m_enableDiskCacheCheckBox->setChecked(true);
     m_diskCacheSizeSpinBox->setValue(500);
     m_cacheDirectoryLineEdit->setText(QStandardPaths::writableLocation(QStandardPaths::CacheLocation));
+    m_compressDiskCacheCheckBox->setChecked(true);
     m_cacheCleanupIntervalSpinBox->setValue(30);
     m_cacheMaxAgeSpinBox->setValue(7);
     
@@ -1094,10 +1196,12 @@ void SettingsDialog::loadSettings()
     
     // 缓存设置
     m_memoryCacheSizeSpinBox->setValue(m_configManager->getValue("cache/memoryCacheSize", 100).toInt());
+    m_adaptMemoryPressureCheckBox->setChecked(m_configManager->getValue("cache/adaptToMemoryPressure", true).toBool());
     m_enableDiskCacheCheckBox->setChecked(m_configManager->getValue("cache/enableDiskCache", true).toBool());
     m_diskCacheSizeSpinBox->setValue(m_configManager->getValue("cache/diskCacheSize", 500).toInt());
     m_cacheDirectoryLineEdit->setText(m_configManager->getValue("cache/cacheDirectory", 
         QStandardPaths::writableLocation(QStandardPaths::CacheLocation)).toString());
+    m_compressDiskCacheCheckBox->setChecked(m_configManager->getValue("cache/compressDiskCache", true).toBool());
     m_cacheCleanupIntervalSpinBox->setValue(m_configManager->getValue("cache/cleanupInterval", 30).toInt());
     m_cacheMaxAgeSpinBox->setValue(m_configManager->getValue("cache/maxAge", 7).toInt());
     
@@ -1199,18 +1303,23 @@ void SettingsDialog::saveSettings()
     
     // 缓存设置
     m_configManager->setValue("cache/memoryCacheSize", m_memoryCacheSizeSpinBox->value());
+    m_configManager->setValue("cache/adaptToMemoryPressure", m_adaptMemoryPressureCheckBox->isChecked());
     m_configManager->setValue("cache/enableDiskCache", m_enableDiskCacheCheckBox->isChecked());
     m_configManager->setValue("cache/diskCacheSize", m_diskCacheSizeSpinBox->value());
     m_configManager->setValue("cache/cacheDirectory", m_cacheDirectoryLineEdit->text());
+    m_configManager->setValue("cache/compressDiskCache", m_compressDiskCacheCheckBox->isChecked());
     m_configManager->setValue("cache/cleanupInterval", m_cacheCleanupIntervalSpinBox->value());
     m_configManager->setValue("cache/maxAge", m_cacheMaxAgeSpinBox->value());
     
     // 应用缓存设置
     CacheManager *cacheManager = CacheManager::instance();
     cacheManager->setMaxMemoryCacheSize(m_memoryCacheSizeSpinBox->value());
+    cacheManager->setAdaptToMemoryPressure(m_adaptMemoryPressureCheckBox->isChecked());
     cacheManager->setMaxDiskCacheSize(m_diskCacheSizeSpinBox->value());
     cacheManager->setCacheDirectory(m_cacheDirectoryLineEdit->text());
+    cacheManager->setCompressionEnabled(m_compressDiskCacheCheckBox->isChecked());
     cacheManager->setAutoCleanupInterval(m_cacheCleanupIntervalSpinBox->value());
+    cacheManager->setDiskCacheMaxAge(m_cacheMaxAgeSpinBox->value());
     
     // 网络设置
     m_configManager->setValue("network/useProxy", m_useProxyCheckBox->isChecked());
@@ -1309,6 +1418,14 @@ void SettingsDialog::onPageChanged(int index)
     if (index == 3) { // 缓存页面
         updateCacheUsage();
     }
+    
+    // 只在缓存页面可见时刷新统计
+    if (m_tabWidget->widget(index) == m_cachePage) {
+        updateCacheStatistics();
+        m_cacheStatisticsTimer->start();
+    } else {
+        m_cacheStatisticsTimer->stop();
+    }
 }
 
 void SettingsDialog::onSettingChanged()
@@ -1538,11 +1655,62 @@ void SettingsDialog::updateCacheUsage()
         QString usageText = QString("内存缓存: %1 MB, 磁盘缓存: %2 MB")
             .arg(memoryUsage)
             .arg(diskUsage);
+        if (cacheManager->isDiskUsagePending()) {
+            usageText += " (统计中)";
+        }
         
         m_cacheUsageLabel->setText(usageText);
     }
 }
 
+void SettingsDialog::updateCacheStatistics()
+{
+    if (!m_cacheStatisticsTree) {
+        return;
+    }
+    
+    const CacheStatistics stats = CacheManager::instance()->getStatistics();
+    
+    auto setRow = [this](int row, const QString &memory, const QString &disk) {
+        QTreeWidgetItem *item = m_cacheStatisticsTree->topLevelItem(row);
+        item->setText(1, memory);
+        item->setText(2, disk);
+    };
+    
+    const QString diskPending = stats.diskUsagePending ? QString(" (统计中)") : QString();
+    setRow(StatEntries, QString::number(stats.memoryCacheCount), QString::number(stats.diskCacheCount) + diskPending);
+    setRow(StatSize, QString("%1 / %2").arg(formatBytes(stats.memoryCacheSize), formatBytes(stats.memoryCacheLimit)),
+           formatBytes(stats.diskCacheSize) + diskPending);
+    setRow(StatHits, QString::number(stats.memory.hits), QString::number(stats.disk.hits));
+    setRow(StatMisses, QString::number(stats.memory.misses), QString::number(stats.disk.misses));
+    setRow(StatHitRatio, QString("%1%").arg(stats.memory.hitRatio() * 100.0, 0, 'f', 1),
+           QString("%1%").arg(stats.disk.hitRatio() * 100.0, 0, 'f', 1));
+    setRow(StatInsertions, QString::number(stats.memory.insertions), QString::number(stats.disk.insertions));
+    setRow(StatEvictions, QString::number(stats.memory.evictions), QString::number(stats.disk.evictions));
+    setRow(StatUnusedEvictions, QString::number(stats.memory.unusedEvictions), "-");
+    setRow(StatBytesIn, formatBytes(stats.memory.bytesIn), formatBytes(stats.disk.bytesIn));
+    setRow(StatBytesOut, formatBytes(stats.memory.bytesOut), formatBytes(stats.disk.bytesOut));
+    setRow(StatReadLatency, "-", formatLatency(stats.diskReadLatency));
+    setRow(StatWriteLatency, "-", formatLatency(stats.diskWriteLatency));
+    
+    m_cacheStatisticsTree->topLevelItem(StatEntries)->setToolTip(1, QString("淘汰策略: %1").arg(stats.evictionPolicy));
+}
+
+void SettingsDialog::onExportCacheStatisticsClicked()
+{
+    QString fileName = QFileDialog::getSaveFileName(this, "导出缓存统计",
+        QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation) + "/ComicReader_CacheStatistics.json",
+        "JSON文件 (*.json)");
+    
+    if (!fileName.isEmpty()) {
+        if (CacheManager::instance()->exportStatistics(fileName)) {
+            QMessageBox::information(this, "导出成功", "缓存统计已成功导出到文件。");
+        } else {
+            QMessageBox::warning(this, "导出失败", "无法导出缓存统计到指定文件。");
+        }
+    }
+}
+
 void SettingsDialog::validateSettings()
 {
     // 这里可以添加设置验证逻辑
@@ -0,0 +1,230 @@
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QRandomGenerator>
+#include <QSet>
+#include <QStringList>
+#include <QTextStream>
+#include <QVector>
+#include <cmath>
+
+#include "core/cache/CacheEvictionPolicy.h"
+
+/**
+ * 缓存访问轨迹回放基准
+ *
+ * 用法：
+ *   CacheTraceBenchmark [轨迹文件] [--capacity 32,64,128]
+ *
+ * 轨迹文件由设置了 COMICREADER_CACHE_TRACE 环境变量的 ComicReader 记录，
+ * 每行为 "G <键> <字节数>"（查找，未命中时字节数为0）或 "P <键> <字节数>"（插入）。
+ * 不指定轨迹文件时生成合成轨迹：热门缩略图的 Zipf 访问，穿插整库缩略图重建和长篇连续阅读。
+ */
+
+namespace {
+
+struct TraceEvent {
+    char op;
+    QString key;
+    qint64 bytes;
+};
+
+struct ReplayResult {
+    qint64 lookups = 0;
+    qint64 hits = 0;
+    qint64 lookupBytes = 0;
+    qint64 hitBytes = 0;
+    qint64 elapsedNs = 0;
+};
+
+bool loadTrace(const QString &path, QVector<TraceEvent> &events)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return false;
+    }
+
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine().trimmed();
+        if (line.isEmpty() || line.startsWith('#')) {
+            continue;
+        }
+
+        const QList<QByteArray> fields = line.split(' ');
+        if (fields.size() != 3 || (fields[0] != "G" && fields[0] != "P")) {
+            continue;
+        }
+
+        TraceEvent event;
+        event.op = fields[0].at(0);
+        event.key = QString::fromLatin1(fields[1]);
+        event.bytes = fields[2].toLongLong();
+        events.append(event);
+    }
+
+    return true;
+}
+
+// 按缓存未命中后再插入的方式生成一次访问
+void appendAccess(QVector<TraceEvent> &events, QSet<QString> &known, const QString &key, qint64 bytes)
+{
+    events.append({'G', key, known.contains(key) ? bytes : 0});
+    if (!known.contains(key)) {
+        events.append({'P', key, bytes});
+        known.insert(key);
+    }
+}
+
+QVector<TraceEvent> generateSyntheticTrace()
+{
+    QVector<TraceEvent> events;
+    QSet<QString> known;
+    QRandomGenerator random(20240601);
+
+    // 热门缩略图：400个，按 Zipf(0.9) 分布访问
+    const int hotCount = 400;
+    const qint64 thumbnailBytes = 150 * 200 * 4;
+    QVector<double> cdf(hotCount);
+    double total = 0.0;
+    for (int i = 0; i < hotCount; ++i) {
+        total += 1.0 / std::pow(double(i + 1), 0.9);
+        cdf[i] = total;
+    }
+
+    const qint64 pageBytes = 1200 * 1800 * 4;
+    int scanId = 0;
+    int pageId = 0;
+
+    for (int round = 0; round < 20; ++round) {
+        // 浏览书库
+        for (int i = 0; i < 2000; ++i) {
+            const double r = random.generateDouble() * total;
+            const int index = int(std::lower_bound(cdf.begin(), cdf.end(), r) - cdf.begin());
+            appendAccess(events, known, QStringLiteral("thumb:%1").arg(index), thumbnailBytes);
+        }
+
+        // 修改缩略图尺寸后整库重建，每个缩略图只访问一次
+        if (round % 5 == 4) {
+            for (int i = 0; i < 3000; ++i) {
+                appendAccess(events, known, QStringLiteral("rebuild:%1").arg(scanId++), thumbnailBytes);
+            }
+        }
+
+        // 连续阅读一本60页的漫画，每页预加载后再显示一次
+        for (int i = 0; i < 60; ++i) {
+            const QString key = QStringLiteral("page:%1").arg(pageId++);
+            appendAccess(events, known, key, pageBytes);
+            appendAccess(events, known, key, pageBytes);
+        }
+    }
+
+    return events;
+}
+
+ReplayResult replay(CacheEvictionPolicy *policy, const QVector<TraceEvent> &events)
+{
+    ReplayResult result;
+    QHash<QString, qint64> sizes;
+    QSet<QString> pendingMisses;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for (const TraceEvent &event : events) {
+        if (event.op == 'G') {
+            ++result.lookups;
+            policy->recordAccess(event.key);
+
+            const qint64 size = sizes.value(event.key, event.bytes);
+            if (policy->contains(event.key)) {
+                ++result.hits;
+                result.hitBytes += size;
+                result.lookupBytes += size;
+            } else if (size > 0) {
+                // 已知大小的未命中：模拟重新加载后插入
+                result.lookupBytes += size;
+                policy->insert(event.key, size);
+            } else {
+                pendingMisses.insert(event.key);
+            }
+        } else {
+            sizes.insert(event.key, event.bytes);
+            if (pendingMisses.remove(event.key)) {
+                result.lookupBytes += event.bytes;
+            }
+            if (!policy->contains(event.key)) {
+                policy->insert(event.key, event.bytes);
+            }
+        }
+    }
+
+    result.elapsedNs = timer.nsecsElapsed();
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+
+    QString tracePath;
+    QList<qint64> capacitiesMB = {32, 64, 128, 256};
+
+    const QStringList args = app.arguments();
+    for (int i = 1; i < args.size(); ++i) {
+        if (args[i] == "--capacity" && i + 1 < args.size()) {
+            capacitiesMB.clear();
+            for (const QString &value : args[++i].split(',')) {
+                capacitiesMB.append(value.toLongLong());
+            }
+        } else {
+            tracePath = args[i];
+        }
+    }
+
+    QVector<TraceEvent> events;
+    if (tracePath.isEmpty()) {
+        events = generateSyntheticTrace();
+        out << "Synthetic trace: " << events.size() << " events\n";
+    } else if (loadTrace(tracePath, events)) {
+        out << "Trace " << tracePath << ": " << events.size() << " events\n";
+    } else {
+        out << "Failed to open trace file: " << tracePath << "\n";
+        return 1;
+    }
+
+    out << QStringLiteral("%1 %2 %3 %4 %5\n")
+               .arg("Policy", -12).arg("MB", 6).arg("Hit%", 8).arg("ByteHit%", 10).arg("ns/op", 8);
+
+    for (qint64 capacityMB : capacitiesMB) {
+        // FIFO 等价于旧版按插入时间淘汰的实现
+        QList<CacheEvictionPolicy *> policies = {
+            new LruEvictionPolicy(false),
+            new LruEvictionPolicy(true),
+            new TinyLfuEvictionPolicy()
+        };
+
+        for (CacheEvictionPolicy *policy : policies) {
+            policy->setCapacity(capacityMB * 1024 * 1024);
+            const ReplayResult result = replay(policy, events);
+
+            const double hitRatio = result.lookups ? 100.0 * result.hits / result.lookups : 0.0;
+            const double byteHitRatio = result.lookupBytes ? 100.0 * result.hitBytes / result.lookupBytes : 0.0;
+            const double nsPerOp = events.isEmpty() ? 0.0 : double(result.elapsedNs) / events.size();
+
+            out << QStringLiteral("%1 %2 %3 %4 %5\n")
+                       .arg(policy->name(), -12)
+                       .arg(capacityMB, 6)
+                       .arg(hitRatio, 8, 'f', 2)
+                       .arg(byteHitRatio, 10, 'f', 2)
+                       .arg(nsPerOp, 8, 'f', 0);
+        }
+
+        qDeleteAll(policies);
+    }
+
+    return 0;
+}
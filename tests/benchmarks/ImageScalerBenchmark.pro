@@ -0,0 +1,26 @@
+QT += core gui
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+# 包含主项目的头文件路径
+INCLUDEPATH += ../../include/
+
+# 页面缩放基准
+SOURCES += \
+    ImageScalerBenchmark.cpp \
+    ../../src/core/image/ImageScaler.cpp
+
+HEADERS += \
+    ../../include/core/image/ImageScaler.h
+
+# 目标名称
+TARGET = ImageScalerBenchmark
+
+# 输出目录
+CONFIG(debug, debug|release) {
+    DESTDIR = ../../build/benchmarks/debug
+    OBJECTS_DIR = ../../build/benchmarks/debug/obj
+} else {
+    DESTDIR = ../../build/benchmarks/release
+    OBJECTS_DIR = ../../build/benchmarks/release/obj
+}
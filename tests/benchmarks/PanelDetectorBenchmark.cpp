@@ -0,0 +1,192 @@
+#include <QGuiApplication>
+#include <QBuffer>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QImage>
+#include <QPainter>
+#include <QRandomGenerator>
+#include <QStringList>
+#include <QTextStream>
+#include <QThreadPool>
+#include <QVector>
+#include <atomic>
+#include <functional>
+
+#include "core/image/ImageScaler.h"
+#include "core/image/PanelDetector.h"
+
+/**
+ * 分格检测基准：典型的 2000×3000 页面上各步骤和各实现的耗时，以及所有核心并行时每秒处理的页数
+ *
+ * 用法：
+ *   PanelDetectorBenchmark [图片文件...] [--runs 20] [--pages 200]
+ *
+ * 不指定图片时生成几张合成页面：随机的3～4行、每行1～3格，格内有网点和线条，
+ * 以 JPEG 编码后作为输入（与归档中的页面一样需要解码）。
+ */
+
+namespace {
+
+struct Page {
+    QString name;
+    QByteArray data;
+    QImage image;
+};
+
+QImage generatePage(quint32 seed)
+{
+    QImage image(2000, 3000, QImage::Format_RGB32);
+    image.fill(Qt::white);
+    QPainter painter(&image);
+    QRandomGenerator random(seed);
+
+    const int rows = 3 + random.bounded(2);
+    const int gutter = 40 + random.bounded(60);
+    const int rowHeight = (3000 - 200 - gutter * (rows - 1)) / rows;
+    for (int row = 0; row < rows; ++row) {
+        const int columns = 1 + random.bounded(3);
+        const int columnWidth = (2000 - 200 - gutter * (columns - 1)) / columns;
+        for (int column = 0; column < columns; ++column) {
+            const QRect panel(100 + column * (columnWidth + gutter), 100 + row * (rowHeight + gutter),
+                              columnWidth, rowHeight);
+            // 网点底色、线条和边框
+            painter.setPen(Qt::NoPen);
+            painter.setBrush(QColor(90, 90, 90));
+            for (int y = panel.top(); y < panel.top() + panel.height() / 3; y += 6) {
+                for (int x = panel.left(); x < panel.right(); x += 6) {
+                    painter.drawEllipse(QPointF(x + 3, y + 3), 1.5, 1.5);
+                }
+            }
+            painter.setPen(QPen(Qt::black, 2));
+            for (int i = 0; i < 40; ++i) {
+                painter.drawLine(panel.left() + random.bounded(panel.width()), panel.top() + random.bounded(panel.height()),
+                                 panel.left() + random.bounded(panel.width()), panel.top() + random.bounded(panel.height()));
+            }
+            painter.setBrush(Qt::NoBrush);
+            painter.setPen(QPen(Qt::black, 6));
+            painter.drawRect(panel.adjusted(3, 3, -3, -3));
+        }
+    }
+    painter.end();
+    return image;
+}
+
+QByteArray encodeJpeg(const QImage &image)
+{
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    image.save(&buffer, "JPEG", 85);
+    return data;
+}
+
+// 重复 runs 次的平均毫秒数（先预热一次）
+double measure(int runs, const std::function<void()> &work)
+{
+    work();
+    QElapsedTimer timer;
+    timer.start();
+    for (int run = 0; run < runs; ++run) {
+        work();
+    }
+    return timer.nsecsElapsed() / 1e6 / runs;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QGuiApplication app(argc, argv);
+    QTextStream out(stdout);
+
+    QStringList imagePaths;
+    int runs = 20;
+    int pageCount = 200;
+
+    const QStringList args = app.arguments();
+    for (int i = 1; i < args.size(); ++i) {
+        if (args[i] == "--runs" && i + 1 < args.size()) {
+            runs = qMax(1, args[++i].toInt());
+        } else if (args[i] == "--pages" && i + 1 < args.size()) {
+            pageCount = qMax(1, args[++i].toInt());
+        } else {
+            imagePaths.append(args[i]);
+        }
+    }
+
+    QVector<Page> pages;
+    if (imagePaths.isEmpty()) {
+        for (quint32 seed = 1; seed <= 4; ++seed) {
+            const QImage image = generatePage(seed);
+            pages.append({QStringLiteral("synthetic page %1").arg(seed), encodeJpeg(image), image});
+        }
+    }
+    for (const QString &path : imagePaths) {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) {
+            out << "Failed to open image: " << path << "\n";
+            return 1;
+        }
+        const QByteArray data = file.readAll();
+        const QImage image = QImage::fromData(data);
+        if (image.isNull()) {
+            out << "Failed to load image: " << path << "\n";
+            return 1;
+        }
+        pages.append({path, data, image});
+    }
+
+    // CPU不支持的实现跳过
+    const ImageScaler::InstructionSet best = ImageScaler::supportedInstructionSet();
+    QVector<ImageScaler::InstructionSet> sets = {ImageScaler::Scalar};
+    if (best == ImageScaler::AVX2) {
+        sets.append(ImageScaler::SSE41);
+    }
+    if (best != ImageScaler::Scalar) {
+        sets.append(best);
+    }
+
+    for (const Page &page : pages) {
+        const QImage gray = PanelDetector::analysisImage(page.image);
+        out << page.name << ": " << page.image.width() << "x" << page.image.height()
+            << " -> " << gray.width() << "x" << gray.height() << ", "
+            << PanelDetector::detect(page.image).size() << " panels\n";
+        out << QStringLiteral("%1 %2 %3 %4 %5\n")
+                   .arg("Kernels", -10).arg("binarize", 10).arg("cut ms", 10)
+                   .arg("downscale", 10).arg("JPEG ms", 10);
+
+        for (ImageScaler::InstructionSet set : sets) {
+            ImageScaler::setInstructionSet(set);
+            const double binarizeMs = measure(runs, [&gray]() { PanelDetector::binarize(gray, 255, 40); });
+            const double cutMs = measure(runs, [&gray]() { PanelDetector::detectInAnalysisImage(gray); });
+            const double downscaleMs = measure(runs, [&page]() { PanelDetector::analysisImage(page.image); });
+            const double jpegMs = measure(runs, [&page]() { PanelDetector::detect(page.data); });
+            out << QStringLiteral("%1 %2 %3 %4 %5\n")
+                       .arg(ImageScaler::instructionSetName(set), -10)
+                       .arg(binarizeMs, 10, 'f', 3)
+                       .arg(cutMs, 10, 'f', 3)
+                       .arg(downscaleMs, 10, 'f', 2)
+                       .arg(jpegMs, 10, 'f', 2);
+        }
+        out << "\n";
+    }
+
+    // 阅读器中的用法：每页一个任务，所有核心并行，从 JPEG 数据开始
+    ImageScaler::setInstructionSet(best);
+    QThreadPool pool;
+    std::atomic<int> panels(0);
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < pageCount; ++i) {
+        const QByteArray data = pages.at(i % pages.size()).data;
+        pool.start([data, &panels]() { panels += PanelDetector::detect(data).size(); });
+    }
+    pool.waitForDone();
+    const double seconds = timer.nsecsElapsed() / 1e9;
+    out << pageCount << " pages on " << pool.maxThreadCount() << " threads: "
+        << QString::number(seconds, 'f', 2) << " s, "
+        << QString::number(pageCount / seconds, 'f', 1) << " pages/s, "
+        << panels.load() << " panels\n";
+
+    return 0;
+}
@@ -0,0 +1,32 @@
+QT += core gui
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+# 包含主项目的头文件路径
+INCLUDEPATH += ../../include/
+
+# 分格检测基准
+SOURCES += \
+    PanelDetectorBenchmark.cpp \
+    ../../src/core/image/PanelDetector.cpp \
+    ../../src/core/image/ImageDecoder.cpp \
+    ../../src/core/image/ImagePyramid.cpp \
+    ../../src/core/image/ImageScaler.cpp
+
+HEADERS += \
+    ../../include/core/image/PanelDetector.h \
+    ../../include/core/image/ImageDecoder.h \
+    ../../include/core/image/ImagePyramid.h \
+    ../../include/core/image/ImageScaler.h
+
+# 目标名称
+TARGET = PanelDetectorBenchmark
+
+# 输出目录
+CONFIG(debug, debug|release) {
+    DESTDIR = ../../build/benchmarks/debug
+    OBJECTS_DIR = ../../build/benchmarks/debug/obj
+} else {
+    DESTDIR = ../../build/benchmarks/release
+    OBJECTS_DIR = ../../build/benchmarks/release/obj
+}
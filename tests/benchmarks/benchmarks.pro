@@ -0,0 +1,29 @@
+QT += core
+QT -= gui
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+# 包含主项目的头文件路径
+INCLUDEPATH += ../../include/
+
+# 缓存轨迹回放基准
+SOURCES += \
+    CacheTraceBenchmark.cpp \
+    ../../src/core/cache/CacheEvictionPolicy.cpp \
+    ../../src/core/cache/FrequencySketch.cpp
+
+HEADERS += \
+    ../../include/core/cache/CacheEvictionPolicy.h \
+    ../../include/core/cache/FrequencySketch.h
+
+# 目标名称
+TARGET = CacheTraceBenchmark
+
+# 输出目录
+CONFIG(debug, debug|release) {
+    DESTDIR = ../../build/benchmarks/debug
+    OBJECTS_DIR = ../../build/benchmarks/debug/obj
+} else {
+    DESTDIR = ../../build/benchmarks/release
+    OBJECTS_DIR = ../../build/benchmarks/release/obj
+}
@@ -1,15 +1,25 @@
-#include <QCoreApplication>
+#include <QGuiApplication>
 #include <QTest>
 #include <QDebug>
 
 #include "unit/TestCacheManager.h"
-#include "unit/TestBookmarkManager.h"
-#include "unit/TestErrorHandler.h"
-#include "unit/TestConfigManager.h"
+#include "unit/TestLibraryScanner.h"
+#include "unit/TestImageScaler.h"
+#include "unit/TestImageDecoder.h"
+#include "unit/TestImagePyramid.h"
+#include "unit/TestContentBounds.h"
+#include "unit/TestPanelDetector.h"
+#include "unit/TestPageTurnMetrics.h"
+#include "unit/TestSpreadLayout.h"
+#include "unit/TestPagePipeline.h"
 
 int main(int argc, char *argv[])
 {
-    QCoreApplication app(argc, argv);
+    // 缓存测试使用 QPixmap，需要 QGuiApplication；没有指定平台时不依赖显示器
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QGuiApplication app(argc, argv);
     
     int result = 0;
     
@@ -22,21 +32,57 @@ int main(int argc, char *argv[])
         result += QTest::qExec(&test, argc, argv);
     }
     
-    // 运行BookmarkManager测试
+    // 运行LibraryScanner测试
+    {
+        TestLibraryScanner test;
+        result += QTest::qExec(&test, argc, argv);
+    }
+    
+    // 运行ImageScaler测试
+    {
+        TestImageScaler test;
+        result += QTest::qExec(&test, argc, argv);
+    }
+    
+    // 运行ImageDecoder测试
+    {
+        TestImageDecoder test;
+        result += QTest::qExec(&test, argc, argv);
+    }
+    
+    // 运行ImagePyramid测试
+    {
+        TestImagePyramid test;
+        result += QTest::qExec(&test, argc, argv);
+    }
+    
+    // 运行ContentBounds测试
+    {
+        TestContentBounds test;
+        result += QTest::qExec(&test, argc, argv);
+    }
+    
+    // 运行PanelDetector测试
+    {
+        TestPanelDetector test;
+        result += QTest::qExec(&test, argc, argv);
+    }
+    
+    // 运行PageTurnMetrics测试
     {
-        TestBookmarkManager test;
+        TestPageTurnMetrics test;
         result += QTest::qExec(&test, argc, argv);
     }
     
-    // 运行ErrorHandler测试
+    // 运行SpreadLayout测试
     {
-        TestErrorHandler test;
+        TestSpreadLayout test;
         result += QTest::qExec(&test, argc, argv);
     }
     
-    // 运行ConfigManager测试
+    // 运行PagePipeline测试
     {
-        TestConfigManager test;
+        TestPagePipeline test;
         result += QTest::qExec(&test, argc, argv);
     }
     
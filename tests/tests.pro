@@ -1,4 +1,4 @@
-QT += testlib core widgets network
+QT += testlib core widgets network gui-private
 CONFIG += testcase
 
 # 包含主项目的头文件路径
@@ -11,28 +11,88 @@ DEPENDPATH += ../
 SOURCES += \
     main.cpp \
     unit/TestCacheManager.cpp \
-    unit/TestBookmarkManager.cpp \
-    unit/TestErrorHandler.cpp \
-    unit/TestConfigManager.cpp
+    unit/TestLibraryScanner.cpp \
+    unit/TestImageScaler.cpp \
+    unit/TestImageDecoder.cpp \
+    unit/TestImagePyramid.cpp \
+    unit/TestContentBounds.cpp \
+    unit/TestPanelDetector.cpp \
+    unit/TestPageTurnMetrics.cpp \
+    unit/TestSpreadLayout.cpp \
+    unit/TestPagePipeline.cpp
 
 HEADERS += \
     unit/TestCacheManager.h \
-    unit/TestBookmarkManager.h \
-    unit/TestErrorHandler.h \
-    unit/TestConfigManager.h
+    unit/TestLibraryScanner.h \
+    unit/TestImageScaler.h \
+    unit/TestImageDecoder.h \
+    unit/TestImagePyramid.h \
+    unit/TestContentBounds.h \
+    unit/TestPanelDetector.h \
+    unit/TestPageTurnMetrics.h \
+    unit/TestSpreadLayout.h \
+    unit/TestPagePipeline.h
 
 # 主项目的源文件（测试需要）
 SOURCES += \
     ../src/core/cache/CacheManager.cpp \
+    ../src/core/cache/CacheCompressor.cpp \
+    ../src/core/cache/CacheEvictionPolicy.cpp \
+    ../src/core/cache/FrequencySketch.cpp \
+    ../src/core/cache/CacheStatistics.cpp \
+    ../src/core/cache/LatencyHistogram.cpp \
+    ../src/core/cache/MemoryPressureMonitor.cpp \
+    ../src/core/cache/TimerWheel.cpp \
+    ../src/core/cache/DiskCacheIndex.cpp \
+    ../src/core/cache/MurmurHash3.cpp \
+    ../src/core/cache/CacheKey.cpp \
+    ../src/core/cache/CacheWarmup.cpp \
+    ../src/core/cache/MemoryGovernor.cpp \
+    ../src/core/cache/MappedImageStore.cpp \
+    ../src/core/image/AnimatedImageDecoder.cpp \
+    ../src/core/image/ContentBounds.cpp \
+    ../src/core/image/ImageDecoder.cpp \
+    ../src/core/image/ImagePyramid.cpp \
+    ../src/core/image/ImageScaler.cpp \
+    ../src/core/image/PanelDetector.cpp \
+    ../src/core/metrics/PageTurnMetrics.cpp \
+    ../src/ui/library/LibraryScanner.cpp \
+    ../src/ui/reader/PagePipeline.cpp \
+    ../src/ui/reader/SpreadLayout.cpp \
     ../src/core/bookmark/BookmarkManager.cpp \
     ../src/utils/error/ErrorHandler.cpp \
-    ../src/core/ConfigManager.cpp
+    ../src/core/config/ConfigManager.cpp \
+    ../src/core/parser/ComicParser.cpp
 
 HEADERS += \
     ../include/core/CacheManager.h \
+    ../include/core/cache/CacheCompressor.h \
+    ../include/core/cache/CacheEvictionPolicy.h \
+    ../include/core/cache/FrequencySketch.h \
+    ../include/core/cache/CacheStatistics.h \
+    ../include/core/cache/LatencyHistogram.h \
+    ../include/core/cache/MemoryPressureMonitor.h \
+    ../include/core/cache/TimerWheel.h \
+    ../include/core/cache/DiskCacheIndex.h \
+    ../include/core/cache/MurmurHash3.h \
+    ../include/core/cache/CacheKey.h \
+    ../include/core/cache/CacheWarmup.h \
+    ../include/core/cache/MemoryGovernor.h \
+    ../include/core/cache/MappedImageStore.h \
+    ../include/core/image/AnimatedImageDecoder.h \
+    ../include/core/image/ContentBounds.h \
+    ../include/core/image/ImageDecoder.h \
+    ../include/core/image/ImagePyramid.h \
+    ../include/core/image/ImageScaler.h \
+    ../include/core/image/PanelDetector.h \
+    ../include/core/metrics/PageTurnMetrics.h \
+    ../include/ui/library/LibraryScanner.h \
+    ../include/ui/reader/PagePipeline.h \
+    ../include/ui/reader/SpreadLayout.h \
     ../include/core/bookmark/BookmarkManager.h \
     ../include/utils/error/ErrorHandler.h \
-    ../include/core/ConfigManager.h
+    ../include/core/config/ConfigManager.h \
+    ../include/core/ComicParser.h
 
 # 目标名称
 TARGET = ComicReaderTests
@@ -6,6 +6,15 @@
 #include <QTemporaryDir>
 #include <QPixmap>
 #include "../../include/core/CacheManager.h"
+#include "../../include/core/cache/CacheCompressor.h"
+#include "../../include/core/cache/CacheEvictionPolicy.h"
+#include "../../include/core/cache/FrequencySketch.h"
+#include "../../include/core/cache/TimerWheel.h"
+#include "../../include/core/cache/DiskCacheIndex.h"
+#include "../../include/core/cache/CacheKey.h"
+#include "../../include/core/cache/CacheWarmup.h"
+#include "../../include/core/cache/MemoryGovernor.h"
+#include "../../include/core/cache/MappedImageStore.h"
 
 class TestCacheManager : public QObject
 {
@@ -22,14 +31,43 @@ private slots:
     void testMemoryCacheCapacity();
     void testMemoryCacheEviction();
     
+    // 淘汰策略测试
+    void testFrequencySketch();
+    void testTinyLfuScanResistance();
+    void testEvictionPolicyRejectsOversized();
+    
+    // 内存压力测试
+    void testMemoryPressureParsing();
+    void testMemoryPressureClassification();
+    void testMemoryPressureShrinksDecodedFirst();
+    void testMemoryGovernorReclaimsByPriority();
+    
+    // 到期测试
+    void testTimerWheelExpiry();
+    void testMemoryEntryTtl();
+    void testDiskIndexTracksWrites();
+    
+    // 缓存键测试
+    void testMurmurHash3Vectors();
+    void testCacheKeyShardedLayout();
+    void testCacheKeyInvalidatesChangedArchive();
+    void testWarmupTargetSelection();
+    
     // 磁盘缓存测试
     void testDiskCacheBasic();
     void testDiskCacheCompression();
+    void testCompressorRoundTrip();
+    void testCompressedImagesStoredRaw();
+    void testDecodedImageDiskRoundTrip();
+    void testMappedImageStore();
     void testDiskCacheCleanup();
     
     // 缓存统计测试
     void testCacheStatistics();
     void testCacheSizeCalculation();
+    void testTierCounters();
+    void testLatencyHistogram();
+    void testStatisticsJsonExport();
     
     // 错误处理测试
     void testInvalidPaths();
@@ -39,6 +77,7 @@ private:
     CacheManager *m_cacheManager;
     QTemporaryDir *m_tempDir;
     
+    void waitForDiskIndex();
     QPixmap createTestPixmap(int width = 100, int height = 100);
     QString generateTestKey(const QString &prefix = "test");
 };
@@ -0,0 +1,73 @@
+#include "TestContentBounds.h"
+#include <QBuffer>
+#include <QImage>
+#include <QRandomGenerator>
+
+void TestContentBounds::testDetection()
+{
+    // 各实现的行、列统计与标量实现一致，宽度不是向量宽度的整数倍
+    QImage gray(1013, 517, QImage::Format_Grayscale8);
+    QRandomGenerator random(7);
+    for (int y = 0; y < gray.height(); ++y) {
+        uchar *line = gray.scanLine(y);
+        for (int x = 0; x < gray.width(); ++x) {
+            line[x] = uchar(random.bounded(256));
+        }
+    }
+    const ImageScaler::InstructionSet best = ImageScaler::supportedInstructionSet();
+    ImageScaler::setInstructionSet(ImageScaler::Scalar);
+    const ContentBounds::Profile expected = ContentBounds::profile(gray, 100, 400);
+    ImageScaler::setInstructionSet(best);
+    const ContentBounds::Profile actual = ContentBounds::profile(gray, 100, 400);
+    QCOMPARE(actual.rowSum, expected.rowSum);
+    QCOMPARE(actual.rowSumSq, expected.rowSumSq);
+    QCOMPARE(actual.columnSum, expected.columnSum);
+    QCOMPARE(actual.columnSumSq, expected.columnSumSq);
+    QCOMPARE(actual.columnSum.size(), gray.width());
+    
+    // 白边中间是有内容的区域，边距上有几个灰尘点
+    const QRect content(100, 150, 560, 860);
+    QImage page(800, 1200, QImage::Format_RGB32);
+    page.fill(Qt::white);
+    for (int y = content.top(); y <= content.bottom(); ++y) {
+        QRgb *line = reinterpret_cast<QRgb *>(page.scanLine(y));
+        for (int x = content.left(); x <= content.right(); ++x) {
+            const int value = ((x / 8 + y / 8) % 2) ? 30 : 220;
+            line[x] = qRgb(value, value, value);
+        }
+    }
+    page.setPixel(20, 30, qRgb(0, 0, 0));
+    page.setPixel(700, 1100, qRgb(0, 0, 0));
+    
+    // 结果包含全部内容，外面只多出很少的边距
+    const int tolerance = 16;
+    const QRect bounds = ContentBounds::detect(page);
+    QVERIFY2(bounds.contains(content), qPrintable(QString("bounds %1,%2 %3x%4").arg(bounds.x()).arg(bounds.y())
+                                                  .arg(bounds.width()).arg(bounds.height())));
+    QVERIFY(content.adjusted(-tolerance, -tolerance, tolerance, tolerance).contains(bounds));
+    
+    // 按缩小的分辨率解码 JPEG 后检测，结果换算回原图坐标
+    QByteArray jpeg;
+    QBuffer buffer(&jpeg);
+    buffer.open(QIODevice::WriteOnly);
+    QVERIFY(page.save(&buffer, "JPEG", 90));
+    QSize fullSize;
+    const QRect fromData = ContentBounds::detect(jpeg, &fullSize);
+    QCOMPARE(fullSize, page.size());
+    QVERIFY(fromData.contains(content));
+    QVERIFY(content.adjusted(-tolerance, -tolerance, tolerance, tolerance).contains(fromData));
+    
+    // 黑边同样可以识别
+    QImage inverted = page;
+    inverted.invertPixels();
+    QVERIFY(ContentBounds::detect(inverted).contains(content));
+    QVERIFY(content.adjusted(-tolerance, -tolerance, tolerance, tolerance).contains(ContentBounds::detect(inverted)));
+    
+    // 空白页和没有边距的页面不裁切
+    QImage blank(800, 1200, QImage::Format_RGB32);
+    blank.fill(Qt::white);
+    QCOMPARE(ContentBounds::detect(blank), blank.rect());
+    const QImage full = page.copy(content);
+    QCOMPARE(ContentBounds::detect(full), full.rect());
+    QCOMPARE(ContentBounds::detect(QImage()), QRect());
+}
@@ -0,0 +1,18 @@
+#ifndef TESTCONTENTBOUNDS_H
+#define TESTCONTENTBOUNDS_H
+
+#include <QObject>
+#include <QTest>
+#include "../../include/core/image/ContentBounds.h"
+#include "../../include/core/image/ImageScaler.h"
+
+class TestContentBounds : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    // 内容边界测试
+    void testDetection();
+};
+
+#endif // TESTCONTENTBOUNDS_H
@@ -0,0 +1,104 @@
+#include "TestImageDecoder.h"
+#include <QBuffer>
+#include <QImage>
+#include <QImageReader>
+#include <QImageWriter>
+
+void TestImageDecoder::testReducedJpegDecoding()
+{
+    // 只需要 scale 倍大小时选择满足要求的最大缩小倍数
+    QCOMPARE(ImageDecoder::reducedSize(QSize(6000, 8000), 1.0), QSize(6000, 8000));
+    QCOMPARE(ImageDecoder::reducedSize(QSize(6000, 8000), 0.02), QSize(750, 1000));
+    QCOMPARE(ImageDecoder::reducedSize(QSize(6000, 8000), 0.2), QSize(1500, 2000));
+    QCOMPARE(ImageDecoder::reducedSize(QSize(6000, 8000), 0.3), QSize(3000, 4000));
+    QCOMPARE(ImageDecoder::reducedSize(QSize(6000, 8000), 0.6), QSize(6000, 8000));
+    // 不能整除时向下取整的尺寸仍不小于需要的尺寸
+    QCOMPARE(ImageDecoder::reducedSize(QSize(6007, 8001), 0.125), QSize(6007 / 4, 8001 / 4));
+    
+    if (!QImageWriter::supportedImageFormats().contains("jpeg")) {
+        QSKIP("JPEG image format plugin not available");
+    }
+    QImage source(2400, 1600, QImage::Format_RGB32);
+    source.fill(QColor(0x40, 0x80, 0xc0));
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    QVERIFY(source.save(&buffer, "JPG", 90));
+    
+    QCOMPARE(ImageDecoder::imageSize(data), source.size());
+    
+    QSize fullSize;
+    const QImage reduced = ImageDecoder::decode(data, 0.1, &fullSize);
+    QCOMPARE(fullSize, source.size());
+    QCOMPARE(reduced.size(), QSize(300, 200));
+    const QImage full = ImageDecoder::decode(data);
+    QCOMPARE(full.size(), source.size());
+    
+    // 缩略图保持宽高比缩放到 bounds 以内
+    QCOMPARE(ImageDecoder::decodeToFit(data, QSize(128, 128)).size(), QSize(128, 85));
+}
+
+void TestImageDecoder::testPreviewDecoding()
+{
+    if (!QImageWriter::supportedImageFormats().contains("jpeg")) {
+        QSKIP("JPEG image format plugin not available");
+    }
+    QImage source(2400, 1600, QImage::Format_RGB32);
+    source.fill(QColor(0x40, 0x80, 0xc0));
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    QVERIFY(source.save(&buffer, "JPG", 90));
+    
+    // 预览只在能缩小解码时解码：PNG 返回空图片
+    QCOMPARE(ImageDecoder::decodeReduced(data, 0.1).size(), QSize(300, 200));
+    QByteArray png;
+    QBuffer pngBuffer(&png);
+    pngBuffer.open(QIODevice::WriteOnly);
+    QVERIFY(source.save(&pngBuffer, "PNG"));
+    QSize pngSize;
+    QVERIFY(ImageDecoder::decodeReduced(png, 0.1, &pngSize).isNull());
+    QCOMPARE(pngSize, source.size());
+}
+
+void TestImageDecoder::testAnimatedGifStreaming()
+{
+    // 4×4 的三帧 GIF：依次为红、绿、蓝，每帧50毫秒，无限循环
+    const QByteArray gif = QByteArray::fromHex(
+        "47494638396104000400810000ff000000ff000000ff00000021ff0b4e45545343415045322e30030100000021f90400"
+        "050000002c000000000400040000020d044110044110044110044110050021f90400050000002c000000000400040000"
+        "020d0cc3300cc3300cc3300cc330050021f90400050000002c000000000400040000020d144551144551144551144551"
+        "05003b");
+    if (!QImageReader::supportedImageFormats().contains("gif")) {
+        QSKIP("GIF image format plugin not available");
+    }
+    QVERIFY(AnimatedImageDecoder::isAnimated(gif));
+    
+    AnimatedImageDecoder decoder(gif);
+    QVERIFY(decoder.isValid());
+    QCOMPARE(decoder.size(), QSize(4, 4));
+    QCOMPARE(decoder.frameCount(), 3);
+    QCOMPARE(decoder.loopCount(), -1);
+    
+    // 逐帧解码，末尾之后从第一帧重新开始
+    const QRgb colors[] = { qRgb(255, 0, 0), qRgb(0, 255, 0), qRgb(0, 0, 255) };
+    for (int i = 0; i < 7; ++i) {
+        AnimatedImageDecoder::Frame frame;
+        QVERIFY(decoder.readFrame(&frame));
+        QCOMPARE(frame.image.size(), QSize(4, 4));
+        QCOMPARE(frame.delay, 50);
+        QCOMPARE(frame.image.pixel(2, 2) & 0xffffff, colors[i % 3] & 0xffffff);
+    }
+    
+    // 静态图片不是动画；损坏的数据不能解码
+    QImage still(4, 4, QImage::Format_RGB32);
+    still.fill(Qt::red);
+    QByteArray png;
+    QBuffer buffer(&png);
+    buffer.open(QIODevice::WriteOnly);
+    QVERIFY(still.save(&buffer, "PNG"));
+    QVERIFY(!AnimatedImageDecoder::isAnimated(png));
+    AnimatedImageDecoder broken(QByteArray("not an image"));
+    AnimatedImageDecoder::Frame frame;
+    QVERIFY(!broken.readFrame(&frame));
+}
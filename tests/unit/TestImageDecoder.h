@@ -0,0 +1,20 @@
+#ifndef TESTIMAGEDECODER_H
+#define TESTIMAGEDECODER_H
+
+#include <QObject>
+#include <QTest>
+#include "../../include/core/image/ImageDecoder.h"
+#include "../../include/core/image/AnimatedImageDecoder.h"
+
+class TestImageDecoder : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    // 图片解码测试
+    void testReducedJpegDecoding();
+    void testPreviewDecoding();
+    void testAnimatedGifStreaming();
+};
+
+#endif // TESTIMAGEDECODER_H
@@ -0,0 +1,53 @@
+#include "TestImagePyramid.h"
+#include <QImage>
+
+void TestImagePyramid::testLevels()
+{
+    // 选择不小于目标尺寸的最小一层
+    QCOMPARE(ImagePyramid::levelFor(1.5), 0);
+    QCOMPARE(ImagePyramid::levelFor(0.6), 0);
+    QCOMPARE(ImagePyramid::levelFor(0.5), 1);
+    QCOMPARE(ImagePyramid::levelFor(0.3), 1);
+    QCOMPARE(ImagePyramid::levelFor(0.2), 2);
+    QCOMPARE(ImagePyramid::levelFor(0.01), 3);
+    
+    // 水平渐变：各层按需生成，奇数尺寸向上取整
+    QImage source(1001, 600, QImage::Format_RGB32);
+    for (int y = 0; y < source.height(); ++y) {
+        QRgb *line = reinterpret_cast<QRgb *>(source.scanLine(y));
+        for (int x = 0; x < source.width(); ++x) {
+            const int value = x * 255 / (source.width() - 1);
+            line[x] = qRgb(value, value, 255 - value);
+        }
+    }
+    ImagePyramid pyramid(source);
+    QCOMPARE(pyramid.levelSize(1), QSize(501, 300));
+    QCOMPARE(pyramid.levelSize(3), QSize(126, 75));
+    QVERIFY(!pyramid.hasLevel(2));
+    QCOMPARE(pyramid.levelBytes(), qint64(0));
+    
+    // 从第2层缩放的结果与直接从原图缩放几乎一致
+    const QSize target(200, 120);
+    const QImage fromPyramid = pyramid.scaled(target);
+    QVERIFY(pyramid.hasLevel(2));
+    QVERIFY(!pyramid.hasLevel(1));
+    QVERIFY(!pyramid.hasLevel(3));
+    QCOMPARE(fromPyramid.size(), target);
+    const QImage direct = ImageScaler::scale(source, target);
+    int maxDifference = 0;
+    for (int y = 0; y < target.height(); ++y) {
+        const QRgb *a = reinterpret_cast<const QRgb *>(fromPyramid.constScanLine(y));
+        const QRgb *b = reinterpret_cast<const QRgb *>(direct.constScanLine(y));
+        for (int x = 0; x < target.width(); ++x) {
+            maxDifference = qMax(maxDifference, qAbs(qRed(a[x]) - qRed(b[x])));
+            maxDifference = qMax(maxDifference, qAbs(qBlue(a[x]) - qBlue(b[x])));
+        }
+    }
+    QVERIFY2(maxDifference <= 3, qPrintable(QString("max difference %1").arg(maxDifference)));
+    
+    // 没有生成的层退回到已有的较大一层
+    QCOMPARE(pyramid.builtLevel(0.05).size(), pyramid.levelSize(2));
+    QCOMPARE(pyramid.builtLevel(0.3).size(), source.size());
+    QVERIFY(pyramid.levelBytes() > 0);
+    QCOMPARE(pyramid.scaledToFit(QSize(100, 100)).size(), source.size().scaled(QSize(100, 100), Qt::KeepAspectRatio));
+}
@@ -0,0 +1,18 @@
+#ifndef TESTIMAGEPYRAMID_H
+#define TESTIMAGEPYRAMID_H
+
+#include <QObject>
+#include <QTest>
+#include "../../include/core/image/ImagePyramid.h"
+#include "../../include/core/image/ImageScaler.h"
+
+class TestImagePyramid : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    // 多级缩放测试
+    void testLevels();
+};
+
+#endif // TESTIMAGEPYRAMID_H
@@ -0,0 +1,50 @@
+#include "TestImageScaler.h"
+#include <QImage>
+#include <QRandomGenerator>
+
+void TestImageScaler::testKernelsAgree()
+{
+    // 随机的预乘像素，宽度不是向量宽度的整数倍，覆盖各实现的尾部处理
+    QImage source(1013, 517, QImage::Format_ARGB32_Premultiplied);
+    QRandomGenerator random(42);
+    for (int y = 0; y < source.height(); ++y) {
+        QRgb *line = reinterpret_cast<QRgb *>(source.scanLine(y));
+        for (int x = 0; x < source.width(); ++x) {
+            const int alpha = random.bounded(256);
+            line[x] = qRgba(random.bounded(alpha + 1), random.bounded(alpha + 1), random.bounded(alpha + 1), alpha);
+        }
+    }
+    
+    const ImageScaler::InstructionSet best = ImageScaler::supportedInstructionSet();
+    for (ImageScaler::Filter filter : {ImageScaler::Area, ImageScaler::Lanczos3}) {
+        for (const QSize &size : {QSize(333, 251), QSize(1500, 97)}) {
+            // SIMD 实现与标量实现逐字节一致，多线程与单线程一致
+            ImageScaler::setInstructionSet(ImageScaler::Scalar);
+            const QImage expected = ImageScaler::scale(source, size, filter, 1);
+            ImageScaler::setInstructionSet(best);
+            const QImage actual = ImageScaler::scale(source, size, filter, 4);
+            QCOMPARE(actual.size(), size);
+            QCOMPARE(actual, expected);
+            
+            // 振铃不能使颜色分量超过 alpha
+            for (int y = 0; y < actual.height(); ++y) {
+                const QRgb *line = reinterpret_cast<const QRgb *>(actual.constScanLine(y));
+                for (int x = 0; x < actual.width(); ++x) {
+                    const int alpha = qAlpha(line[x]);
+                    QVERIFY(qRed(line[x]) <= alpha && qGreen(line[x]) <= alpha && qBlue(line[x]) <= alpha);
+                }
+            }
+        }
+    }
+    
+    // 纯色图片缩放后颜色不变
+    QImage solid(640, 480, QImage::Format_RGB32);
+    solid.fill(QColor(0x33, 0x66, 0x99));
+    for (ImageScaler::Filter filter : {ImageScaler::Area, ImageScaler::Lanczos3}) {
+        const QImage scaled = ImageScaler::scale(solid, QSize(211, 157), filter);
+        QCOMPARE(scaled.format(), QImage::Format_RGB32);
+        QCOMPARE(scaled.pixel(0, 0), solid.pixel(0, 0));
+        QCOMPARE(scaled.pixel(105, 78), solid.pixel(0, 0));
+        QCOMPARE(scaled.pixel(210, 156), solid.pixel(0, 0));
+    }
+}
@@ -0,0 +1,17 @@
+#ifndef TESTIMAGESCALER_H
+#define TESTIMAGESCALER_H
+
+#include <QObject>
+#include <QTest>
+#include "../../include/core/image/ImageScaler.h"
+
+class TestImageScaler : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    // 图片缩放测试
+    void testKernelsAgree();
+};
+
+#endif // TESTIMAGESCALER_H
@@ -0,0 +1,287 @@
+#include "TestLibraryScanner.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSignalSpy>
+#include <QThread>
+#include "../../include/core/CacheManager.h"
+
+namespace {
+
+const int SCAN_TIMEOUT_MS = 10000;
+
+} // namespace
+
+void TestLibraryScanner::initTestCase()
+{
+    // 元数据任务在工作线程中使用缓存，单例要先在主线程创建
+    CacheManager::instance();
+}
+
+void TestLibraryScanner::init()
+{
+    m_tempDir = new QTemporaryDir();
+    QVERIFY(m_tempDir->isValid());
+}
+
+void TestLibraryScanner::cleanup()
+{
+    delete m_tempDir;
+    m_tempDir = nullptr;
+}
+
+QString TestLibraryScanner::filePath(const QString &relativePath) const
+{
+    return m_tempDir->path() + QLatin1Char('/') + relativePath;
+}
+
+void TestLibraryScanner::writeFile(const QString &relativePath, const QByteArray &content)
+{
+    const QString path = filePath(relativePath);
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write(content);
+}
+
+bool TestLibraryScanner::runScan(LibraryScanner &scanner, const QStringList &roots, bool recursive,
+                                 const QHash<QString, LibraryScanner::Fingerprint> &known, ScanResult *result,
+                                 bool verifyKnown)
+{
+    QSignalSpy finishedSpy(&scanner, &LibraryScanner::finished);
+    const QMetaObject::Connection batchConnection = connect(&scanner, &LibraryScanner::batchReady, this,
+        [result](const QVector<LibraryScanner::Entry> &entries) {
+            for (const LibraryScanner::Entry &entry : entries) {
+                result->entries.insert(entry.filePath, entry);
+            }
+        });
+    const QMetaObject::Connection missingConnection = connect(&scanner, &LibraryScanner::filesMissing, this,
+        [result](const QStringList &filePaths) {
+            result->missing += filePaths;
+        });
+
+    scanner.start(roots, recursive, known, QSize(), verifyKnown);
+    const bool finished = finishedSpy.wait(SCAN_TIMEOUT_MS);
+
+    disconnect(batchConnection);
+    disconnect(missingConnection);
+    result->missing.sort();
+    return finished && finishedSpy.count() == 1 && !finishedSpy.first().first().toBool();
+}
+
+QHash<QString, LibraryScanner::Fingerprint> TestLibraryScanner::fingerprints(const ScanResult &result)
+{
+    QHash<QString, LibraryScanner::Fingerprint> known;
+    for (auto it = result.entries.constBegin(); it != result.entries.constEnd(); ++it) {
+        known.insert(it.key(), it->fingerprint);
+    }
+    return known;
+}
+
+void TestLibraryScanner::testFindsComicFiles()
+{
+    writeFile("a.cbz");
+    writeFile("sub/b.zip");
+    writeFile("sub/deep/c.CBZ");
+    writeFile("notes.txt");
+    writeFile(".hidden.cbz");
+    writeFile("sub/.cache/d.cbz");
+
+    LibraryScanner scanner;
+    scanner.setMetadataExtractor([](const QString &path) {
+        return QStringList() << QFileInfo(path).completeBaseName();
+    });
+    ScanResult result;
+    QVERIFY(runScan(scanner, QStringList() << m_tempDir->path(), true, {}, &result));
+    QVERIFY(!scanner.isScanning());
+
+    QStringList found = result.entries.keys();
+    found.sort();
+    QCOMPARE(found, QStringList() << filePath("a.cbz") << filePath("sub/b.zip") << filePath("sub/deep/c.CBZ"));
+    QVERIFY(result.missing.isEmpty());
+
+    // 指纹与文件当前状态一致，元数据来自提取函数
+    const LibraryScanner::Entry entry = result.entries.value(filePath("sub/b.zip"));
+    QVERIFY(entry.fingerprint.isValid());
+    QCOMPARE(entry.fingerprint, LibraryScanner::Fingerprint::fromFile(entry.filePath));
+    QCOMPARE(LibraryScanner::Fingerprint::fromString(entry.fingerprint.toString()), entry.fingerprint);
+    QCOMPARE(entry.metadata, QStringList() << "b");
+}
+
+void TestLibraryScanner::testNonRecursiveScan()
+{
+    writeFile("a.cbz");
+    writeFile("sub/b.cbz");
+
+    LibraryScanner scanner;
+    ScanResult result;
+    QVERIFY(runScan(scanner, QStringList() << m_tempDir->path(), false, {}, &result));
+    QCOMPARE(result.entries.keys(), QStringList() << filePath("a.cbz"));
+
+    // 没有读过子目录，其中的已知文件不能判断为丢失
+    ScanResult rescan;
+    QHash<QString, LibraryScanner::Fingerprint> known = fingerprints(result);
+    known.insert(filePath("sub/b.cbz"), LibraryScanner::Fingerprint::fromFile(filePath("sub/b.cbz")));
+    QVERIFY(runScan(scanner, QStringList() << m_tempDir->path(), false, known, &rescan));
+    QVERIFY(rescan.entries.isEmpty());
+    QVERIFY(rescan.missing.isEmpty());
+}
+
+void TestLibraryScanner::testUnchangedFilesSkipped()
+{
+    for (int i = 0; i < 40; ++i) {
+        writeFile(QString("dir%1/comic%2.cbz").arg(i % 4).arg(i));
+    }
+
+    LibraryScanner scanner;
+    ScanResult first;
+    QVERIFY(runScan(scanner, QStringList() << m_tempDir->path(), true, {}, &first));
+    QCOMPARE(first.entries.size(), 40);
+
+    ScanResult second;
+    QVERIFY(runScan(scanner, QStringList() << m_tempDir->path(), true, fingerprints(first), &second));
+    QVERIFY(second.entries.isEmpty());
+    QVERIFY(second.missing.isEmpty());
+}
+
+void TestLibraryScanner::testModifiedAndAddedFiles()
+{
+    writeFile("a.cbz");
+    writeFile("sub/b.cbz");
+
+    LibraryScanner scanner;
+    ScanResult first;
+    QVERIFY(runScan(scanner, QStringList() << m_tempDir->path(), true, {}, &first));
+    QCOMPARE(first.entries.size(), 2);
+
+    writeFile("sub/b.cbz", QByteArray("a longer comic"));
+    writeFile("sub/new/c.cbz");
+
+    ScanResult second;
+    QVERIFY(runScan(scanner, QStringList() << m_tempDir->path(), true, fingerprints(first), &second));
+    QStringList changed = second.entries.keys();
+    changed.sort();
+    QCOMPARE(changed, QStringList() << filePath("sub/b.cbz") << filePath("sub/new/c.cbz"));
+    QCOMPARE(second.entries.value(filePath("sub/b.cbz")).fingerprint.size, qint64(14));
+    QVERIFY(second.missing.isEmpty());
+}
+
+void TestLibraryScanner::testRenamedAndRemovedFiles()
+{
+    writeFile("a.cbz");
+    writeFile("sub/b.cbz");
+    writeFile("sub/c.cbz");
+
+    LibraryScanner scanner;
+    ScanResult first;
+    QVERIFY(runScan(scanner, QStringList() << m_tempDir->path(), true, {}, &first));
+    QCOMPARE(first.entries.size(), 3);
+
+    QVERIFY(QFile::rename(filePath("a.cbz"), filePath("renamed.cbz")));
+    QVERIFY(QFile::remove(filePath("sub/b.cbz")));
+
+    // 改名后的文件按新文件处理，原来的路径和删除的文件都报告为丢失
+    ScanResult second;
+    QVERIFY(runScan(scanner, QStringList() << m_tempDir->path(), true, fingerprints(first), &second));
+    QCOMPARE(second.entries.keys(), QStringList() << filePath("renamed.cbz"));
+    QCOMPARE(second.missing, QStringList() << filePath("a.cbz") << filePath("sub/b.cbz"));
+}
+
+void TestLibraryScanner::testUnreadableDirectoryKeepsKnownFiles()
+{
+    writeFile("a.cbz");
+    writeFile("locked/b.cbz");
+
+    LibraryScanner scanner;
+    ScanResult first;
+    QVERIFY(runScan(scanner, QStringList() << m_tempDir->path(), true, {}, &first));
+    QCOMPARE(first.entries.size(), 2);
+
+    const QString locked = filePath("locked");
+    const QFileDevice::Permissions permissions = QFile::permissions(locked);
+    QVERIFY(QFile::setPermissions(locked, QFileDevice::Permissions()));
+    if (!QDir(locked).entryList(QDir::Files).isEmpty()) {
+        QFile::setPermissions(locked, permissions);
+        QSKIP("Directory permissions are not enforced for this user");
+    }
+
+    // 读不了的目录和空目录不同，其中的已知文件不能报告为丢失
+    ScanResult second;
+    const bool finished = runScan(scanner, QStringList() << m_tempDir->path(), true, fingerprints(first), &second);
+    QFile::setPermissions(locked, permissions);
+    QVERIFY(finished);
+    QVERIFY(second.entries.isEmpty());
+    QVERIFY(second.missing.isEmpty());
+}
+
+void TestLibraryScanner::testVerifyKnownOutsideRoots()
+{
+    writeFile("library/a.cbz");
+    writeFile("other/b.cbz");
+
+    LibraryScanner::Fingerprint gone;
+    gone.size = 5;
+    gone.modifiedNs = 1;
+    QHash<QString, LibraryScanner::Fingerprint> known;
+    known.insert(filePath("library/a.cbz"), LibraryScanner::Fingerprint::fromFile(filePath("library/a.cbz")));
+    known.insert(filePath("other/b.cbz"), LibraryScanner::Fingerprint::fromFile(filePath("other/b.cbz")));
+    known.insert(filePath("removed/c.cbz"), gone);
+
+    // 不检查时只报告扫描目录中的变化
+    LibraryScanner scanner;
+    ScanResult plain;
+    QVERIFY(runScan(scanner, QStringList() << filePath("library"), true, known, &plain));
+    QVERIFY(plain.entries.isEmpty());
+    QVERIFY(plain.missing.isEmpty());
+
+    // 检查已知文件：不存在的报告为丢失，修改过的重新提取
+    writeFile("other/b.cbz", QByteArray("changed content"));
+    ScanResult verified;
+    QVERIFY(runScan(scanner, QStringList() << filePath("library"), true, known, &verified, true));
+    QCOMPARE(verified.entries.keys(), QStringList() << filePath("other/b.cbz"));
+    QCOMPARE(verified.missing, QStringList() << filePath("removed/c.cbz"));
+
+    // 没有扫描目录时只检查已知文件
+    ScanResult knownOnly;
+    QVERIFY(runScan(scanner, QStringList(), true, known, &knownOnly, true));
+    QCOMPARE(knownOnly.entries.keys(), QStringList() << filePath("other/b.cbz"));
+    QCOMPARE(knownOnly.missing, QStringList() << filePath("removed/c.cbz"));
+}
+
+void TestLibraryScanner::testCancelMidScan()
+{
+    for (int i = 0; i < 64; ++i) {
+        writeFile(QString("dir%1/comic%2.cbz").arg(i % 8).arg(i));
+    }
+
+    LibraryScanner scanner;
+    scanner.setMetadataExtractor([](const QString &) {
+        QThread::msleep(50);
+        return QStringList();
+    });
+
+    QSignalSpy finishedSpy(&scanner, &LibraryScanner::finished);
+    QSignalSpy progressSpy(&scanner, &LibraryScanner::progress);
+    int batches = 0;
+    connect(&scanner, &LibraryScanner::batchReady, this, [&batches]() { ++batches; });
+
+    scanner.start(QStringList() << m_tempDir->path(), true, {});
+    QTest::qWait(50);
+    scanner.cancel();
+    QVERIFY(!scanner.isScanning());
+    QCOMPARE(finishedSpy.count(), 1);
+    QCOMPARE(finishedSpy.first().first().toBool(), true);
+
+    // 取消之后工作线程晚到的结果全部丢弃
+    const int progressBeforeCancel = progressSpy.count();
+    QTest::qWait(500);
+    QCOMPARE(finishedSpy.count(), 1);
+    QCOMPARE(batches, 0);
+    QCOMPARE(progressSpy.count(), progressBeforeCancel);
+
+    // 取消后可以立即开始新的扫描
+    scanner.setMetadataExtractor(LibraryScanner::MetadataExtractor());
+    ScanResult result;
+    QVERIFY(runScan(scanner, QStringList() << m_tempDir->path(), true, {}, &result));
+    QCOMPARE(result.entries.size(), 64);
+}
@@ -0,0 +1,52 @@
+#ifndef TESTLIBRARYSCANNER_H
+#define TESTLIBRARYSCANNER_H
+
+#include <QObject>
+#include <QTest>
+#include <QTemporaryDir>
+#include <QHash>
+#include "../../include/ui/library/LibraryScanner.h"
+
+class TestLibraryScanner : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    // 遍历测试
+    void testFindsComicFiles();
+    void testNonRecursiveScan();
+
+    // 增量扫描测试
+    void testUnchangedFilesSkipped();
+    void testModifiedAndAddedFiles();
+    void testRenamedAndRemovedFiles();
+
+    // 丢失文件判断测试
+    void testUnreadableDirectoryKeepsKnownFiles();
+    void testVerifyKnownOutsideRoots();
+
+    // 取消测试
+    void testCancelMidScan();
+
+private:
+    struct ScanResult {
+        QHash<QString, LibraryScanner::Entry> entries;
+        QStringList missing;
+    };
+
+    QTemporaryDir *m_tempDir;
+
+    QString filePath(const QString &relativePath) const;
+    void writeFile(const QString &relativePath, const QByteArray &content = QByteArray("comic"));
+    // 扫描到结束，返回是否在超时前收到 finished(false)
+    bool runScan(LibraryScanner &scanner, const QStringList &roots, bool recursive,
+                 const QHash<QString, LibraryScanner::Fingerprint> &known, ScanResult *result,
+                 bool verifyKnown = false);
+    static QHash<QString, LibraryScanner::Fingerprint> fingerprints(const ScanResult &result);
+};
+
+#endif // TESTLIBRARYSCANNER_H
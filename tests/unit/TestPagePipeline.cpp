@@ -0,0 +1,252 @@
+#include "TestPagePipeline.h"
+#include <QBuffer>
+#include <QSignalSpy>
+#include <QThread>
+#include <QUuid>
+#include <algorithm>
+#include "../../include/core/CacheManager.h"
+#include "../../include/core/cache/CacheWarmup.h"
+
+namespace {
+
+const QSize PAGE_SIZE(200, 300);
+const QColor PAGE_COLORS[] = { QColor(0xc0, 0x20, 0x20), QColor(0x20, 0xc0, 0x20), QColor(0x20, 0x20, 0xc0) };
+
+} // namespace
+
+void TestPagePipeline::initTestCase()
+{
+    // 流水线在工作线程中使用缓存，单例要先在主线程创建
+    CacheManager::instance();
+}
+
+QString TestPagePipeline::prepareComic(int pageCount, ArchiveFingerprint *fingerprint)
+{
+    const QString filePath = QString("/nonexistent/%1.cbz").arg(QUuid::createUuid().toString(QUuid::WithoutBraces));
+    fingerprint->size = 1024;
+    fingerprint->modifiedMs = 1700000000000LL;
+
+    for (int page = 0; page < pageCount; ++page) {
+        QByteArray png;
+        QBuffer buffer(&png);
+        buffer.open(QIODevice::WriteOnly);
+        solidPage(PAGE_SIZE, PAGE_COLORS[page % 3]).save(&buffer, "PNG");
+        CacheManager::instance()->cacheData(CacheKey(filePath, *fingerprint, page, CacheWarmup::rawPageVariant()), png);
+    }
+    return filePath;
+}
+
+QImage TestPagePipeline::solidPage(const QSize &size, const QColor &color)
+{
+    QImage image(size, QImage::Format_RGB32);
+    image.fill(color);
+    return image;
+}
+
+void TestPagePipeline::testPageDelivered()
+{
+    ArchiveFingerprint fingerprint;
+    const QString filePath = prepareComic(3, &fingerprint);
+
+    PagePipeline pipeline;
+    pipeline.setComic(filePath, fingerprint);
+    QSignalSpy readySpy(&pipeline, &PagePipeline::pageReady);
+
+    const int generation = pipeline.requestPage(1, 0.5);
+    QVERIFY(pipeline.isCurrent(generation));
+    QVERIFY(readySpy.wait(5000));
+    QCOMPARE(readySpy.count(), 1);
+
+    const QList<QVariant> arguments = readySpy.takeFirst();
+    QCOMPARE(arguments.at(0).toInt(), generation);
+    QCOMPARE(arguments.at(1).toInt(), 1);
+    QCOMPARE(arguments.at(3).toSize(), PAGE_SIZE);
+    const QImage display = arguments.at(5).value<QImage>();
+    QCOMPARE(display.size(), PAGE_SIZE / 2);
+    QCOMPARE(QColor(display.pixel(50, 75)), PAGE_COLORS[1]);
+}
+
+void TestPagePipeline::testStaleRequestsDiscarded()
+{
+    ArchiveFingerprint fingerprint;
+    const QString filePath = prepareComic(3, &fingerprint);
+
+    PagePipeline pipeline;
+    pipeline.setComic(filePath, fingerprint);
+    QSignalSpy readySpy(&pipeline, &PagePipeline::pageReady);
+    QSignalSpy failedSpy(&pipeline, &PagePipeline::pageFailed);
+
+    // 连续翻页：只有最后一次请求的页面交给界面
+    const int first = pipeline.requestPage(0, 1.0);
+    const int second = pipeline.requestPage(2, 1.0);
+    QVERIFY(second > first);
+    QVERIFY(!pipeline.isCurrent(first));
+    QVERIFY(readySpy.wait(5000));
+    QTest::qWait(200);
+    QCOMPARE(readySpy.count(), 1);
+    QCOMPARE(readySpy.first().at(0).toInt(), second);
+    QCOMPARE(readySpy.first().at(1).toInt(), 2);
+
+    // 工作线程已经完成、结果还在排队时取消，结果同样被丢弃
+    readySpy.clear();
+    pipeline.requestPage(1, 1.0);
+    QThread::msleep(500);
+    pipeline.cancel();
+    QTest::qWait(200);
+    QCOMPARE(readySpy.count(), 0);
+
+    // 切换漫画使之前的请求全部失效
+    pipeline.requestPage(0, 1.0);
+    ArchiveFingerprint otherFingerprint;
+    pipeline.setComic(prepareComic(1, &otherFingerprint), otherFingerprint);
+    QTest::qWait(500);
+    QCOMPARE(readySpy.count(), 0);
+    QCOMPARE(failedSpy.count(), 0);
+}
+
+void TestPagePipeline::testRescaleAndPrescale()
+{
+    ArchiveFingerprint fingerprint;
+    const QString filePath = prepareComic(1, &fingerprint);
+    const QImage original = solidPage(PAGE_SIZE, PAGE_COLORS[0]);
+
+    PagePipeline pipeline;
+    pipeline.setComic(filePath, fingerprint);
+    QSignalSpy readySpy(&pipeline, &PagePipeline::pageReady);
+    QSignalSpy preparedSpy(&pipeline, &PagePipeline::scalePrepared);
+
+    // 只重新缩放已经解码的原图，不再读取和解码
+    const int generation = pipeline.requestScale(0, original, 2.0);
+    QVERIFY(readySpy.wait(5000));
+    QCOMPARE(readySpy.first().at(0).toInt(), generation);
+    QCOMPARE(readySpy.first().at(2).toReal(), 2.0);
+    QCOMPARE(readySpy.first().at(5).value<QImage>().size(), PAGE_SIZE * 2);
+
+    // 预先缩放（适应宽度/高度）的结果单独发出，不影响代数
+    pipeline.prescale(0, original, 0.5);
+    QVERIFY(preparedSpy.wait(5000));
+    QVERIFY(pipeline.isCurrent(generation));
+    QCOMPARE(preparedSpy.first().at(0).toInt(), 0);
+    QCOMPARE(preparedSpy.first().at(1).toReal(), 0.5);
+    const QImage prepared = preparedSpy.first().at(2).value<QImage>();
+    QCOMPARE(prepared.size(), PAGE_SIZE / 2);
+    QCOMPARE(QColor(prepared.pixel(50, 75)), PAGE_COLORS[0]);
+
+    // 换漫画后之前的预先缩放作废
+    preparedSpy.clear();
+    pipeline.prescale(0, original, 0.25);
+    ArchiveFingerprint otherFingerprint;
+    pipeline.setComic(prepareComic(1, &otherFingerprint), otherFingerprint);
+    QTest::qWait(500);
+    QCOMPARE(preparedSpy.count(), 0);
+}
+
+void TestPagePipeline::testIsLargeImage()
+{
+    QVERIFY(!PagePipeline::isLargeImage(QSize(2000, 3000)));
+    QVERIFY(!PagePipeline::isLargeImage(QSize(4096, 4096)));
+    QVERIFY(PagePipeline::isLargeImage(QSize(4097, 4096)));
+    // 像素数不多但单边过长（长条漫画）
+    QVERIFY(!PagePipeline::isLargeImage(QSize(800, 16384)));
+    QVERIFY(PagePipeline::isLargeImage(QSize(800, 16385)));
+    QVERIFY(!PagePipeline::isLargeImage(QSize()));
+}
+
+void TestPagePipeline::testFetchAndProbePages()
+{
+    ArchiveFingerprint fingerprint;
+    const QString filePath = prepareComic(3, &fingerprint);
+
+    PagePipeline pipeline;
+    pipeline.setComic(filePath, fingerprint);
+    QSignalSpy fetchedSpy(&pipeline, &PagePipeline::pageFetched);
+    QSignalSpy probedSpy(&pipeline, &PagePipeline::pageSizeProbed);
+
+    // 连续滚动的请求不受代数影响，结果为未缩放的原图
+    const int generation = pipeline.generation();
+    pipeline.fetchPage(1);
+    pipeline.fetchPage(1);
+    // 结果交给界面之前释放的页面不再发出
+    pipeline.fetchPage(2);
+    pipeline.releasePage(2);
+    QVERIFY(fetchedSpy.wait(5000));
+    QTest::qWait(200);
+    QCOMPARE(fetchedSpy.count(), 1);
+    QCOMPARE(fetchedSpy.first().at(0).toInt(), 1);
+    const QImage original = fetchedSpy.first().at(1).value<QImage>();
+    QCOMPARE(original.size(), PAGE_SIZE);
+    QCOMPARE(QColor(original.pixel(100, 150)), PAGE_COLORS[1]);
+    QCOMPARE(pipeline.generation(), generation);
+
+    // 只读取图片头得到各页尺寸，供预先排版
+    pipeline.probePageSizes(3);
+    QTRY_COMPARE_WITH_TIMEOUT(probedSpy.count(), 3, 5000);
+    QList<int> pages;
+    for (const QList<QVariant> &arguments : probedSpy) {
+        pages.append(arguments.at(0).toInt());
+        QCOMPARE(arguments.at(1).toSize(), PAGE_SIZE);
+    }
+    std::sort(pages.begin(), pages.end());
+    QCOMPARE(pages, QList<int>() << 0 << 1 << 2);
+}
+
+void TestPagePipeline::testComposeSpread()
+{
+    const QImage narrow = solidPage(QSize(100, 200), Qt::red);
+    const QImage wide = solidPage(QSize(300, 200), Qt::blue);
+
+    // 缩放到同一高度后并排，整体适应 bounds（这里宽度是限制）
+    const QImage spread = PagePipeline::composeSpread(QVector<QImage>() << narrow << wide, QSize(200, 300), false);
+    QCOMPARE(spread.size(), QSize(200, 100));
+    QCOMPARE(spread.pixel(25, 50), QColor(Qt::red).rgb());
+    QCOMPARE(spread.pixel(100, 50), QColor(Qt::blue).rgb());
+
+    // 从右到左时第一页在右边
+    const QImage rightToLeft = PagePipeline::composeSpread(QVector<QImage>() << narrow << wide, QSize(200, 300), true);
+    QCOMPARE(rightToLeft.size(), spread.size());
+    QCOMPARE(rightToLeft.pixel(25, 50), QColor(Qt::blue).rgb());
+    QCOMPARE(rightToLeft.pixel(175, 50), QColor(Qt::red).rgb());
+
+    // 高度是限制时按 bounds 的高度缩放
+    const QImage tall = PagePipeline::composeSpread(QVector<QImage>() << narrow << narrow, QSize(1000, 150), false);
+    QCOMPARE(tall.size(), QSize(150, 150));
+
+    // 缺少的页面跳过；没有页面或 bounds 为空时没有结果
+    QCOMPARE(PagePipeline::composeSpread(QVector<QImage>() << QImage() << narrow, QSize(400, 200), false).size(),
+             narrow.size());
+    QVERIFY(PagePipeline::composeSpread(QVector<QImage>(), QSize(400, 200), false).isNull());
+    QVERIFY(PagePipeline::composeSpread(QVector<QImage>() << narrow, QSize(), false).isNull());
+}
+
+void TestPagePipeline::testDevicePixelRatio()
+{
+    ArchiveFingerprint fingerprint;
+    const QString filePath = prepareComic(2, &fingerprint);
+    const QImage original = solidPage(PAGE_SIZE, PAGE_COLORS[0]);
+
+    PagePipeline pipeline;
+    pipeline.setComic(filePath, fingerprint);
+    pipeline.setDevicePixelRatio(2.0);
+    QCOMPARE(pipeline.devicePixelRatio(), 2.0);
+    QSignalSpy readySpy(&pipeline, &PagePipeline::pageReady);
+    QSignalSpy preparedSpy(&pipeline, &PagePipeline::scalePrepared);
+
+    // zoom 以逻辑像素为单位：2倍屏上缩小一半正好是原图的设备像素，图片标记设备像素比
+    pipeline.requestPage(1, 0.5);
+    QVERIFY(readySpy.wait(5000));
+    QCOMPARE(readySpy.first().at(2).toReal(), 0.5);
+    QCOMPARE(readySpy.first().at(3).toSize(), PAGE_SIZE);
+    const QImage display = readySpy.first().at(5).value<QImage>();
+    QCOMPARE(display.size(), PAGE_SIZE);
+    QCOMPARE(display.devicePixelRatio(), 2.0);
+
+    pipeline.prescale(0, original, 0.25);
+    QVERIFY(preparedSpy.wait(5000));
+    const QImage prepared = preparedSpy.first().at(2).value<QImage>();
+    QCOMPARE(prepared.size(), PAGE_SIZE / 2);
+    QCOMPARE(prepared.devicePixelRatio(), 2.0);
+
+    // 无效的比例按1处理
+    pipeline.setDevicePixelRatio(0);
+    QCOMPARE(pipeline.devicePixelRatio(), 1.0);
+}
@@ -0,0 +1,41 @@
+#ifndef TESTPAGEPIPELINE_H
+#define TESTPAGEPIPELINE_H
+
+#include <QObject>
+#include <QTest>
+#include <QColor>
+#include "../../include/ui/reader/PagePipeline.h"
+
+class TestPagePipeline : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    // 代数测试
+    void testPageDelivered();
+    void testStaleRequestsDiscarded();
+
+    // 缩放测试
+    void testRescaleAndPrescale();
+
+    // 大图判断测试
+    void testIsLargeImage();
+
+    // 连续滚动测试
+    void testFetchAndProbePages();
+
+    // 双页合成测试
+    void testComposeSpread();
+
+    // 高分屏测试
+    void testDevicePixelRatio();
+
+private:
+    // 把 pageCount 页纯色 PNG 作为原始数据放入缓存，返回虚构的归档路径；页面不必从归档读取
+    QString prepareComic(int pageCount, ArchiveFingerprint *fingerprint);
+    static QImage solidPage(const QSize &size, const QColor &color);
+};
+
+#endif // TESTPAGEPIPELINE_H
@@ -0,0 +1,49 @@
+#include "TestPageTurnMetrics.h"
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+
+void TestPageTurnMetrics::testWindows()
+{
+    PageTurnMetrics metrics;
+    
+    // 一个窗口的慢翻页（约5毫秒）之后是两个窗口的快翻页（约10微秒），慢样本被轮换掉
+    for (int i = 0; i < PageTurnMetrics::WINDOW_SIZE; ++i) {
+        metrics.record(PageTurnMetrics::Turn, 5 * 1000 * 1000);
+    }
+    QVERIFY(metrics.snapshot().stages[PageTurnMetrics::Turn].percentileMicros(50) >= 4096);
+    for (int i = 0; i < 2 * PageTurnMetrics::WINDOW_SIZE; ++i) {
+        metrics.record(PageTurnMetrics::Turn, 10 * 1000);
+    }
+    PageTurnMetrics::Snapshot snapshot = metrics.snapshot();
+    const LatencyHistogram::Snapshot &turn = snapshot.stages[PageTurnMetrics::Turn];
+    QCOMPARE(turn.count, qint64(PageTurnMetrics::WINDOW_SIZE));
+    QVERIFY(turn.percentileMicros(99) <= 16);
+    QCOMPARE(snapshot.stages[PageTurnMetrics::Decode].count, qint64(0));
+    
+    // 数据来源
+    metrics.recordSource(PageTurnMetrics::PixmapCache);
+    metrics.recordSource(PageTurnMetrics::PixmapCache);
+    metrics.recordSource(PageTurnMetrics::Archive);
+    snapshot = metrics.snapshot();
+    QCOMPARE(snapshot.sources[PageTurnMetrics::PixmapCache], qint64(2));
+    QCOMPARE(snapshot.sourceTotal(), qint64(3));
+    
+    // 导出
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    QString filePath = tempDir.filePath("page_turn_metrics.json");
+    QVERIFY(metrics.exportToFile(filePath));
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QJsonObject json = QJsonDocument::fromJson(file.readAll()).object();
+    QVERIFY(json.contains("build"));
+    QCOMPARE(json["sources"].toObject()["archive"].toInt(), 1);
+    QJsonObject turnJson = json["stages"].toObject()["turn"].toObject();
+    QVERIFY(turnJson.contains("p95Us"));
+    
+    metrics.reset();
+    QCOMPARE(metrics.snapshot().stages[PageTurnMetrics::Turn].count, qint64(0));
+    QCOMPARE(metrics.snapshot().sourceTotal(), qint64(0));
+}
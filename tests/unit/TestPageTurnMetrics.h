@@ -0,0 +1,17 @@
+#ifndef TESTPAGETURNMETRICS_H
+#define TESTPAGETURNMETRICS_H
+
+#include <QObject>
+#include <QTest>
+#include "../../include/core/metrics/PageTurnMetrics.h"
+
+class TestPageTurnMetrics : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    // 翻页指标测试
+    void testWindows();
+};
+
+#endif // TESTPAGETURNMETRICS_H
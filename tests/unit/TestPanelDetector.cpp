@@ -0,0 +1,77 @@
+#include "TestPanelDetector.h"
+#include <QBuffer>
+#include <QImage>
+#include <QPainter>
+
+void TestPanelDetector::testDetection()
+{
+    // 2000×3000 的页面：第一行两格、第二行一整格、第三行三格，格间空白约80像素，格内有斜线
+    const QVector<QRect> drawn = {
+        QRect(100, 100, 860, 900), QRect(1040, 100, 860, 900),
+        QRect(100, 1080, 1800, 800),
+        QRect(100, 1960, 560, 940), QRect(720, 1960, 560, 940), QRect(1340, 1960, 560, 940)
+    };
+    QImage page(2000, 3000, QImage::Format_RGB32);
+    page.fill(Qt::white);
+    QPainter painter(&page);
+    for (const QRect &panel : drawn) {
+        painter.setPen(QPen(Qt::black, 8));
+        painter.drawRect(panel.adjusted(4, 4, -4, -4));
+        painter.setPen(QPen(Qt::darkGray, 3));
+        for (int offset = 0; offset < panel.width() + panel.height(); offset += 60) {
+            painter.drawLine(panel.left() + qMin(offset, panel.width()), panel.top() + qMax(0, offset - panel.width()),
+                             panel.left() + qMax(0, offset - panel.height()), panel.top() + qMin(offset, panel.height()));
+        }
+    }
+    // 页码不算一格
+    painter.fillRect(QRect(990, 2940, 20, 30), Qt::black);
+    painter.end();
+    
+    // 二值化的各实现与标量实现一致
+    const QImage gray = PanelDetector::analysisImage(page);
+    QVERIFY(qMax(gray.width(), gray.height()) <= PanelDetector::ANALYSIS_SIZE);
+    const ImageScaler::InstructionSet best = ImageScaler::supportedInstructionSet();
+    ImageScaler::setInstructionSet(ImageScaler::Scalar);
+    const QImage expectedMask = PanelDetector::binarize(gray, 250, 40);
+    const QVector<QRect> expected = PanelDetector::detect(page);
+    ImageScaler::setInstructionSet(best);
+    QCOMPARE(PanelDetector::binarize(gray, 250, 40), expectedMask);
+    const QVector<QRect> panels = PanelDetector::detect(page);
+    QCOMPARE(panels, expected);
+    
+    // 按阅读顺序找到全部六格，每格只比画出的范围略大
+    const int tolerance = 16;
+    QCOMPARE(panels.size(), drawn.size());
+    for (int i = 0; i < drawn.size(); ++i) {
+        QVERIFY2(panels[i].contains(drawn[i].adjusted(4, 4, -4, -4)), qPrintable(QString("panel %1").arg(i)));
+        QVERIFY(drawn[i].adjusted(-tolerance, -tolerance, tolerance, tolerance).contains(panels[i]));
+    }
+    
+    // 从右到左阅读时同一行中的顺序相反
+    const QVector<QRect> rightToLeft = PanelDetector::detect(page, true);
+    QCOMPARE(rightToLeft.size(), drawn.size());
+    QCOMPARE(rightToLeft[0], panels[1]);
+    QCOMPARE(rightToLeft[1], panels[0]);
+    QCOMPARE(rightToLeft[2], panels[2]);
+    QCOMPARE(rightToLeft[3], panels[5]);
+    QCOMPARE(rightToLeft[5], panels[3]);
+    
+    // 从 JPEG 数据检测的结果换算回原图坐标
+    QByteArray jpeg;
+    QBuffer buffer(&jpeg);
+    buffer.open(QIODevice::WriteOnly);
+    QVERIFY(page.save(&buffer, "JPEG", 90));
+    QSize fullSize;
+    const QVector<QRect> fromData = PanelDetector::detect(jpeg, false, &fullSize);
+    QCOMPARE(fullSize, page.size());
+    QCOMPARE(fromData.size(), drawn.size());
+    for (int i = 0; i < drawn.size(); ++i) {
+        QVERIFY(drawn[i].adjusted(-tolerance, -tolerance, tolerance, tolerance).contains(fromData[i]));
+    }
+    
+    // 空白页和整页一幅画都没有分格
+    QImage blank(2000, 3000, QImage::Format_RGB32);
+    blank.fill(Qt::white);
+    QVERIFY(PanelDetector::detect(blank).isEmpty());
+    QVERIFY(PanelDetector::detect(page.copy(drawn[2])).isEmpty());
+}
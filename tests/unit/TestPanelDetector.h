@@ -0,0 +1,18 @@
+#ifndef TESTPANELDETECTOR_H
+#define TESTPANELDETECTOR_H
+
+#include <QObject>
+#include <QTest>
+#include "../../include/core/image/PanelDetector.h"
+#include "../../include/core/image/ImageScaler.h"
+
+class TestPanelDetector : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    // 分格检测测试
+    void testDetection();
+};
+
+#endif // TESTPANELDETECTOR_H
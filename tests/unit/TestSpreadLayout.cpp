@@ -0,0 +1,82 @@
+#include "TestSpreadLayout.h"
+
+void TestSpreadLayout::testCoverAndPairs()
+{
+    // 尺寸未知的页面按竖版处理：封面单独，其余两两成对，最后剩下的一页单独
+    SpreadLayout layout;
+    layout.reset(6);
+    QCOMPARE(layout.pageCount(), 6);
+    QCOMPARE(layout.spreadCount(), 4);
+    QCOMPARE(layout.pages(0), QVector<int>() << 0);
+    QCOMPARE(layout.pages(1), QVector<int>() << 1 << 2);
+    QCOMPARE(layout.pages(2), QVector<int>() << 3 << 4);
+    QCOMPARE(layout.pages(3), QVector<int>() << 5);
+    QCOMPARE(layout.spreadOf(2), 1);
+    QCOMPARE(layout.spreadOf(5), 3);
+
+    // 竖版页面的尺寸不改变划分
+    QVERIFY(!layout.setPageSize(1, QSize(1000, 1500)));
+    QVERIFY(!layout.setPageSize(1, QSize(1000, 1500)));
+    QCOMPARE(layout.spreadCount(), 4);
+
+    // 超出范围的页面归到最近的跨页
+    QCOMPARE(layout.spreadOf(-1), 0);
+    QCOMPARE(layout.spreadOf(100), 3);
+    QVERIFY(layout.pages(4).isEmpty());
+}
+
+void TestSpreadLayout::testWidePagesStandAlone()
+{
+    SpreadLayout layout;
+    layout.reset(7);
+
+    // 宽页面单独显示，它前面的页面也单独显示，后面的页面重新配对
+    QVERIFY(layout.setPageSize(3, QSize(2000, 1400)));
+    QCOMPARE(layout.spreadCount(), 5);
+    QCOMPARE(layout.pages(0), QVector<int>() << 0);
+    QCOMPARE(layout.pages(1), QVector<int>() << 1 << 2);
+    QCOMPARE(layout.pages(2), QVector<int>() << 3);
+    QCOMPARE(layout.pages(3), QVector<int>() << 4 << 5);
+    QCOMPARE(layout.pages(4), QVector<int>() << 6);
+
+    QVERIFY(layout.setPageSize(2, QSize(2000, 1400)));
+    QCOMPARE(layout.pages(1), QVector<int>() << 1);
+    QCOMPARE(layout.pages(2), QVector<int>() << 2);
+    QCOMPARE(layout.pages(3), QVector<int>() << 3);
+    QCOMPARE(layout.spreadOf(5), 4);
+
+    // 宽的封面仍然单独显示；同样的尺寸再次设置不改变划分
+    layout.setPageSize(0, QSize(3000, 2000));
+    QCOMPARE(layout.pages(0), QVector<int>() << 0);
+    QCOMPARE(layout.pages(1), QVector<int>() << 1);
+    QVERIFY(!layout.setPageSize(3, QSize(2000, 1400)));
+
+    // 恢复为竖版后重新配对
+    QVERIFY(layout.setPageSize(2, QSize(1000, 1400)));
+    QVERIFY(layout.setPageSize(3, QSize(1000, 1400)));
+    QCOMPARE(layout.spreadCount(), 4);
+    QCOMPARE(layout.pages(2), QVector<int>() << 3 << 4);
+
+    QVERIFY(SpreadLayout::isWidePage(QSize(2000, 1400)));
+    QVERIFY(!SpreadLayout::isWidePage(QSize(1400, 1400)));
+    QVERIFY(!SpreadLayout::isWidePage(QSize()));
+}
+
+void TestSpreadLayout::testEmptyAndSinglePage()
+{
+    SpreadLayout layout;
+    QCOMPARE(layout.spreadCount(), 0);
+    QCOMPARE(layout.spreadOf(0), -1);
+
+    layout.reset(1);
+    QCOMPARE(layout.spreadCount(), 1);
+    QCOMPARE(layout.pages(0), QVector<int>() << 0);
+
+    layout.reset(2);
+    QCOMPARE(layout.spreadCount(), 2);
+    QCOMPARE(layout.pages(1), QVector<int>() << 1);
+
+    layout.reset(0);
+    QCOMPARE(layout.spreadCount(), 0);
+    QVERIFY(!layout.setPageSize(0, QSize(2000, 1000)));
+}
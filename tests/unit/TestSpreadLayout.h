@@ -0,0 +1,19 @@
+#ifndef TESTSPREADLAYOUT_H
+#define TESTSPREADLAYOUT_H
+
+#include <QObject>
+#include <QTest>
+#include "../../include/ui/reader/SpreadLayout.h"
+
+class TestSpreadLayout : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    // 跨页划分测试
+    void testCoverAndPairs();
+    void testWidePagesStandAlone();
+    void testEmptyAndSinglePage();
+};
+
+#endif // TESTSPREADLAYOUT_H